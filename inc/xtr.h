@@ -136,15 +136,72 @@ extern "C"
  * O(n) operation on construction and destruction.
  *
  * Basically: `calloc()` instead of `malloc()` and `memset(...,0,...)` just
- * before `free()`.
+ * before `free()`. Reallocations copy the content to a new allocation and
+ * wipe the old one, instead of letting `realloc()` leave copies behind.
  */
-#ifndef XTR_CLEAR_ALLOCATED
-    #define XTR_CLEAR_ALLOCATED 1
+#ifndef XTR_CLEAR_HEAP
+    #define XTR_CLEAR_HEAP 0
+#endif
+
+/**
+ * @def XTR_SIMD
+ * Enables the SIMD-accelerated (SSE2, AVX2) implementations of the
+ * performance-critical loops, like the substring search.
+ *
+ * Only the instruction sets the compiler targets are used, e.g. AVX2
+ * requires `-mavx2` or `-march=native` on a supporting CPU.
+ * Set it to 0 to force the portable scalar implementations.
+ */
+#ifndef XTR_SIMD
+    #define XTR_SIMD 1
+#endif
+
+/**
+ * @def XTR_THREADS
+ * Enables the multi-threaded implementations of the `_parallel` functions,
+ * using POSIX threads or Windows threads.
+ *
+ * Requires linking against the threads library (e.g. `-pthread`).
+ * When disabled, the `_parallel` functions run serially.
+ */
+#ifndef XTR_THREADS
+    #define XTR_THREADS 0
+#endif
+
+/**
+ * @def XTR_PARALLEL_MIN_LEN
+ * Minimum amount of haystack bytes searched by each thread of the
+ * `_parallel` functions.
+ *
+ * Smaller haystacks are split among fewer threads or searched serially,
+ * as starting a thread costs more than searching a few KiB.
+ */
+#ifndef XTR_PARALLEL_MIN_LEN
+    #define XTR_PARALLEL_MIN_LEN (1024U * 1024U)
+#endif
+
+/**
+ * @def XTR_REGEX_CACHE_SIZE
+ * Bytes of DFA states cached by each of the up to three automata of a
+ * compiled regular expression.
+ *
+ * The automata are built lazily while searching. When a cache is full, it
+ * is flushed and rebuilt from the current state: memory stays bounded and
+ * searches stay linear, at the price of computing some states again.
+ */
+#ifndef XTR_REGEX_CACHE_SIZE
+    #define XTR_REGEX_CACHE_SIZE (128U * 1024U)
 #endif
 
 // ------------------- Constants --------------------------------------
+/**
+ * Size of the header of the opaque xtr_t preceding the content: capacity,
+ * used length, reference count and buffer pointer.
+ */
+#define XTR_HEADER_SIZE    (sizeof(size_t) * 3U + sizeof(void*))
+
 // Assuming enough memory
-#define XTR_MAX_CAPACITY   (SIZE_MAX - sizeof(size_t) * 2U - 1U)
+#define XTR_MAX_CAPACITY   (SIZE_MAX - XTR_HEADER_SIZE - 1U)
 
 #define XTR_UNKNOWN_STRLEN SIZE_MAX
 
@@ -163,23 +220,303 @@ extern "C"
  * Opaque xtring structure.
  *
  * Keeps track of the data length, of the allocated buffer length (which
- * may be longer than the data), keeps everything null-terminated for
- * compatibility with the C-strings.
+ * may be longer than the data), of the amount of owners sharing it and
+ * keeps everything null-terminated for compatibility with the C-strings.
+ *
+ * The content starts at the `buffer` pointer, after the head room left in
+ * the storage by removals from the head, like xtr_truncate_head().
  *
- *                                +-- content always null-terminated
- *                                |
- *                                |          +-- buffer always null-terminated
- *                                |          |
- *                                v          v
+ *                                                +-- content always null-terminated
+ *                                                |
+ *                                                |          +-- buffer always null-terminated
+ *                                                |          |
+ *                                                v          v
  *
- *         [capacity][used][abcde\0.........\0]
+ *         [capacity][used][refs][buffer][...abcde\0.........\0]
+ *                                           ^buffer
  *
- *                          \___/            used (5, excl. null terminator)
- *                               \_________/ available free space (11)
- *                          \______________/ capacity (16, excl. null term.)
+ *                                        \_/                 head room (3)
+ *                                           \___/            used (5, excl. null terminator)
+ *                                                \_________/ free space after content (11)
+ *                                           \______________/ capacity field (16, excl. null term.)
+ *                                        \_________________/ xtr_capacity() (19, incl. head room)
+ *
+ * xtr_available() counts both the head room and the free space (14).
  */
 typedef struct xtr xtr_t;
 
+/**
+ * Opaque compiled search pattern.
+ *
+ * Holds a copy of a needle together with the precomputed search tables, so
+ * the same needle can be searched in many xtrings paying the preprocessing
+ * cost only once. Immutable after creation, thus it can be shared across
+ * threads.
+ */
+typedef struct xtr_pattern xtr_pattern_t;
+
+/**
+ * Opaque compiled set of needles, searched all at once.
+ *
+ * Built from an array of needles, it finds occurrences of any of them in a
+ * single pass over the haystack, independently of the amount of needles.
+ * Immutable after creation, thus it can be shared across threads.
+ */
+typedef struct xtr_multipattern xtr_multipattern_t;
+
+/**
+ * Opaque incremental searcher of a pattern in a stream of chunks.
+ *
+ * Finds occurrences also when they straddle two or more chunks, keeping
+ * only the last `needle_len - 1` bytes of the previous chunks rather than
+ * the entire stream.
+ */
+typedef struct xtr_stream_search xtr_stream_search_t;
+
+/**
+ * Opaque compiled regular expression.
+ *
+ * Searches in linear time with a lazily built DFA, caching its states
+ * inside the regex: searching modifies it, thus it must not be used by
+ * multiple threads at once. Compile one per thread instead.
+ */
+typedef struct xtr_regex xtr_regex_t;
+
+/**
+ * Opaque suffix array index of a text, for many searches in the same text.
+ *
+ * Holds a copy of the text together with its suffix array and LCP array,
+ * in a single block that can be saved and loaded back without copying,
+ * e.g. memory-mapped. Immutable after creation, thus it can be shared
+ * across threads.
+ */
+typedef struct xtr_index xtr_index_t;
+
+/**
+ * Opaque CSV tokenizer: the dialect and the fields found in the last text.
+ *
+ * Reused across texts, it keeps its memory, so parsing many texts of
+ * similar size does not allocate after the first ones. Parsing modifies
+ * it, thus it must not be used by multiple threads at once.
+ */
+typedef struct xtr_csv xtr_csv_t;
+
+/**
+ * Opaque index of the line starts of a text, for random access to its lines.
+ *
+ * Stores the line starts compactly, bit-packed as distances within blocks
+ * of 64 lines, taking about 2 bytes per line for lines of typical length.
+ * Immutable after creation, thus it can be shared across threads.
+ */
+typedef struct xtr_line_index xtr_line_index_t;
+
+/**
+ * Opaque rope: a long text stored as a balanced tree of xtring pieces.
+ *
+ * Inserting, deleting, concatenating and splitting at any offset take
+ * O(log n) instead of the O(n) shifting of a contiguous xtring, which
+ * makes it fit to assemble large texts by editing them anywhere.
+ * It must not be modified by multiple threads at once.
+ */
+typedef struct xtr_rope xtr_rope_t;
+
+/**
+ * Needle occurrence found when searching for many needles at once.
+ */
+typedef struct
+{
+    /** Index of the first byte of the occurrence in the haystack. */
+    size_t index;
+    /** Index of the found needle in the array the set was built from. */
+    size_t needle_id;
+} xtr_match_t;
+
+/**
+ * Section of an xtring matched by a regular expression.
+ */
+typedef struct
+{
+    /** Index of the first byte of the match in the haystack. */
+    size_t index;
+    /** Amount of bytes of the match, may be 0. */
+    size_t length;
+} xtr_region_t;
+
+/**
+ * Read-only slice of an xtring or of any byte array, without a copy.
+ *
+ * A view does not own its bytes: it is a pointer and a length, passed by
+ * value and never freed. It stays valid only as long as the viewed memory
+ * does, so a view of an xtring must not outlive it nor be used after
+ * the xtring is modified or reallocated. Use xtr_from_view() to copy it
+ * into an xtring that outlives its source.
+ * A view with NULL `bytes` is the equivalent of a NULL xtring: it is what
+ * the functions creating views store on invalid inputs. They return the
+ * views through pointers, like the rest of the library.
+ */
+typedef struct
+{
+    /** First byte of the view, not null-terminated. */
+    const uint8_t* bytes;
+    /** Amount of bytes of the view. */
+    size_t length;
+} xtr_view_t;
+
+/**
+ * Owning slice of an xtring: a view that keeps its parent xtring alive.
+ *
+ * Created with xtr_slice_shared(), xtr_slice_pop_head() or
+ * xtr_split_slices() without copying any byte: the slice holds a reference
+ * to the parent, as xtr_share() does, so it stays valid after the parent's
+ * owner frees it. The parent is shared, thus read-only, as long as any
+ * slice of it exists. Freed with xtr_slice_free().
+ * A slice with a NULL `parent` is the equivalent of a NULL xtring.
+ */
+typedef struct
+{
+    /** Bytes of the slice, within the parent's content. */
+    xtr_view_t view;
+    /** Xtring owning the bytes, internal. */
+    xtr_t* parent;
+} xtr_slice_t;
+
+/**
+ * Iterator over the contiguous pieces of a rope, from any offset on.
+ *
+ * Meant to be allocated on the stack, initialised with xtr_rope_iter_init()
+ * and advanced with xtr_rope_next(). The fields are internal state, not to
+ * be accessed. The rope must outlive the iterator and not be modified
+ * while in use.
+ */
+typedef struct
+{
+    const xtr_rope_t* rope;
+    /** Offset in the rope of the next piece. */
+    size_t offset;
+} xtr_rope_iter_t;
+
+/**
+ * Gap buffer: an xtring being edited at a movable cursor.
+ *
+ * The text lives in the single allocation of an xtring, with the free space
+ * as a gap at the cursor: `[before cursor][gap][after cursor]`. Inserting
+ * and deleting at the cursor only resize the gap, in O(1) amortised, while
+ * moving the cursor by `d` bytes moves `d` bytes across the gap.
+ * Meant to be allocated on the stack, initialised with xtr_gapbuf_init() and
+ * turned back into an xtring with xtr_gapbuf_to_xtr(). The fields are
+ * internal state, not to be accessed.
+ */
+typedef struct
+{
+    /** Holds the text: its `used` bytes are the ones before the cursor. */
+    xtr_t* xtr;
+    /** Index of the first byte after the gap, up to the capacity. */
+    size_t gap_end;
+} xtr_gapbuf_t;
+
+/**
+ * Cursor over the successive occurrences of a needle in an xtring.
+ *
+ * Meant to be allocated on the stack, initialised with xtr_cursor_init()
+ * or xtr_cursor_init_pattern() and advanced with xtr_find_next(): no heap
+ * memory is used. The fields are internal state, not to be accessed.
+ * The cursor borrows the haystack and the needle, which must outlive it
+ * and not be modified while in use.
+ */
+typedef struct
+{
+    const xtr_t* haystack;
+    const xtr_t* needle;
+    const xtr_pattern_t* pattern;
+    /** Index of the haystack where the next search starts. */
+    size_t position;
+    /** Precomputed search state of `needle`, storage for an internal type. */
+    size_t twoway[4];
+} xtr_cursor_t;
+
+/**
+ * Iterator over the chunks of an xtring, yielding them one at a time.
+ *
+ * Meant to be allocated on the stack, initialised with xtr_split_iter_init()
+ * or xtr_split_iter_init_every() and advanced with xtr_split_next(): no heap
+ * memory is used and the xtring is scanned only up to the last requested
+ * chunk. The fields are internal state, not to be accessed.
+ * The iterator borrows the xtring and the separator, which must outlive it
+ * and not be modified while in use.
+ */
+typedef struct
+{
+    /** Occurrences of the separator, unused for fixed-width chunks. */
+    xtr_cursor_t cursor;
+    const xtr_t* xtr;
+    /** Length of the fixed-width chunks, 0 when splitting on a separator. */
+    size_t chunk_len;
+    /** Index of the next chunk's first byte, SIZE_MAX after the last chunk. */
+    size_t chunk_start;
+} xtr_split_iter_t;
+
+/**
+ * Iterator over the lines of an xtring, yielding them one at a time.
+ *
+ * Meant to be allocated on the stack, initialised with xtr_line_iter_init()
+ * and advanced with xtr_line_next(). The fields are internal state, not to
+ * be accessed. The iterator borrows the xtring, which must outlive it and
+ * not be modified while in use.
+ */
+typedef struct
+{
+    const xtr_t* xtr;
+    /** Index of the next line's first byte, SIZE_MAX after the last line. */
+    size_t line_start;
+    /** Index of the first byte of the 64 ones `newlines` is about. */
+    size_t scanned;
+    /** Newlines not yet yielded among the scanned bytes, one per bit. */
+    uint64_t newlines;
+} xtr_line_iter_t;
+
+/**
+ * Set of byte values, for searches of any byte among many.
+ *
+ * Built once with xtr_charset_init() or xtr_charset_init_bytes(), it can
+ * be allocated on the stack and shared across threads. Membership of every
+ * byte is checked in O(1), independently of the amount of bytes in the set.
+ * The field is internal state, not to be accessed.
+ */
+typedef struct
+{
+    /** Membership of byte `b`: bit `(b >> 4) & 7` of `bitmap[(b >> 7) * 16 + (b & 15)]`,
+     * a layout allowing SIMD lookups by the low and high nibble of the bytes. */
+    uint8_t bitmap[32];
+} xtr_charset_t;
+
+/**
+ * Capacity policy of the xtrings reallocated by xtr_extend_head() and xtr_extend_tail()
+ * because they ran out of space.
+ *
+ * Reallocating with spare room beyond the needed length makes a sequence of
+ * N small appends copy O(N) bytes in total rather than O(N^2).
+ */
+typedef struct
+{
+    /**
+     * New capacity in percent of the needed length. 200 doubles it,
+     * 150 grows it by half, 100 or less reallocates exactly the needed length.
+     * Values above 10000 count as 10000.
+     */
+    size_t factor_percent;
+    /**
+     * Upper bound of the spare bytes added beyond the needed length, to limit
+     * the wasted memory of large xtrings. 0 for no bound.
+     */
+    size_t max_slack;
+    /**
+     * The whole allocation, xtring metadata included, is rounded up to a multiple of
+     * this size, so the allocator's size class padding becomes usable capacity.
+     * 0 or 1 for no rounding.
+     */
+    size_t size_class;
+} xtr_growth_t;
+
 // =================== NEW XTRINGS ============================================
 // ------------------- New empty xtrings ------------------------------------------
 /**
@@ -216,6 +553,9 @@ xtr_new(size_t capacity);
  * Frees the allocated memory of xtring after usage and sets the xtring pointer
  * to NULL to avoid use-after-free.
  *
+ * For a shared xtring (see xtr_share()) only this reference is dropped:
+ * the memory is freed by its last owner.
+ *
  * Example:
  *         xtr_t* xtring = xtr_new_empty();
  *         // ... usage of the xtring
@@ -434,6 +774,8 @@ xtr_expanded(const xtr_t* xtr, size_t at_least);
  *
  * Ensures the `at_least - xtr_length(xtr)` available allocated free space at the
  * clone's end, to have some space ready for expansions without reallocation.
+ * Unless the xtring is shared, uses XTR_REALLOC, which often grows the
+ * allocation in place without copying the content (except with XTR_CLEAR_HEAP).
  * @param [in,out] pxtr point to the original xtring to copy. Pointed xtr_t*
  *        will be replaced by a larger copy, if a reallocation happens.
  *        Frees the previous xtring. Untouched on failure.
@@ -480,6 +822,77 @@ xtr_truncated(const xtr_t* xtr, size_t at_most);
 XTR_API xtr_t*
 xtr_truncate(xtr_t** pxtr, size_t at_most);
 
+// ------------------- Shared xtrings ------------------------------------
+/**
+ * Adds an owner to the xtring, without copying it.
+ *
+ * Every owner must call xtr_release() (or xtr_free()) on its reference;
+ * the memory is freed by the last one. The reference count is atomic,
+ * so the owners may live on different threads.
+ *
+ * All owners hold the same pointer, so while shared the xtring is read-only.
+ * The functions replacing the xtring through a `xtr_t**` copy it on write:
+ * xtr_extend_tail(), xtr_truncate() and the `_cow` variants of the in-place
+ * functions, like xtr_push_tail_cow(), xtr_truncate_head_cow() or
+ * xtr_trim_cow(). The in-place functions taking a `xtr_t*`, like
+ * xtr_push_tail(), xtr_truncate_head(), xtr_trim() or xtr_reverse(), cannot
+ * hand a copy back: on a shared xtring they leave it unaltered and report it
+ * through their return value.
+ *
+ * Example:
+ *         xtr_t* payload = xtr_from_str("data");
+ *         xtr_t* consumer = xtr_share(payload);  // Same xtring, 2 owners
+ *         xtr_trim(consumer, "a");  // false: shared, nothing changes
+ *         xtr_trim_cow(&consumer, "a");  // Now a trimmed copy, 1 owner each
+ *
+ * @param [in] xtr to share.
+ * @return `xtr` itself or NULL when `xtr` is NULL.
+ */
+XTR_API xtr_t*
+xtr_share(xtr_t* xtr);
+
+/**
+ * Drops a reference obtained from xtr_share() and sets the pointer to NULL.
+ *
+ * Same as xtr_free(), named to pair with xtr_share().
+ *
+ * @param [in,out] pxtr **address** of the xtring-pointer.
+ */
+XTR_API void
+xtr_release(xtr_t** pxtr);
+
+/**
+ * Checks whether the xtring has more than one owner.
+ *
+ * @param [in] xtr to check.
+ * @return true if shared, false if it has a single owner or is NULL.
+ */
+XTR_API bool
+xtr_is_shared(const xtr_t* xtr);
+
+/**
+ * Amount of owners of the xtring.
+ *
+ * @param [in] xtr to check.
+ * @return the reference count, 1 if not shared, 0 if `xtr` is NULL.
+ */
+XTR_API size_t
+xtr_references(const xtr_t* xtr);
+
+/**
+ * Makes the xtring private to the caller, copying it only if shared.
+ *
+ * A shared xtring is copied with the same capacity, the caller's reference to
+ * the original is released and replaced by the copy.
+ *
+ * @param [in,out] pxtr point to the xtring. Pointed xtr_t* is replaced by the
+ *        copy, if one is needed. Untouched on failure.
+ * @return the private xtring or NULL in case of malloc failure or when `pxtr`
+ *         or `*pxtr` is NULL. Note: on success the returned value matches `*pxtr`.
+ */
+XTR_API xtr_t*
+xtr_unshare(xtr_t** pxtr);
+
 // ------------------- Xtring properties (getters) ------------------------------------
 /**
  * Xtring length = amount of currently **used** bytes in the allocated buffer.
@@ -504,6 +917,11 @@ xtr_length(const xtr_t* xtr);
  * Buffer size of the xtring = **maximum** possible length the xtring can reach without
  * reallocating.
  *
+ * Includes the head room, i.e. the bytes freed at the start by
+ * xtr_truncate_head() and similar, which are reused by the following pushes.
+ * The capacity tracked internally, counting from where the content starts,
+ * excludes it.
+ *
  *             capacity (buffer size)
  *             __________________
  *            /                  \
@@ -755,6 +1173,54 @@ xtr_startswith(const xtr_t* xtr, const xtr_t* prefix);
 XTR_API bool
 xtr_endswith(const xtr_t* xtr, const xtr_t* suffix);
 
+/**
+ * Compares the two xtrings like xtr_cmp(), ignoring the case of the ASCII letters.
+ *
+ * Bytes are compared as if the letters A-Z were lowercase, so e.g. "ABC" is
+ * equal to "abc" and "_" (0x5F) sorts before "A" (compared as "a", 0x61).
+ * Non-ASCII bytes are compared as-is. The case is folded on the fly,
+ * without any copy of the xtrings.
+ *
+ * @param [in] a first xtring
+ * @param [in] b second xtring
+ * @return same values as xtr_cmp()
+ */
+XTR_API int
+xtr_cmp_icase(const xtr_t* a, const xtr_t* b);
+
+/**
+ * Checks if two xtrings have the same length and the same content, ignoring
+ * the case of the ASCII letters, e.g. for HTTP header names.
+ *
+ * @param [in] a first xtring
+ * @param [in] b second xtring
+ * @return true when both NULL, or both are the same pointer, or both have
+ *         the same length and same content except for the ASCII letter case.
+ *         False otherwise.
+ */
+XTR_API bool
+xtr_is_equal_icase(const xtr_t* a, const xtr_t* b);
+
+/**
+ * Like xtr_startswith(), ignoring the case of the ASCII letters.
+ *
+ * @param [in] xtr to check the beginning of
+ * @param [in] prefix to check whether matches `xtr`'s head
+ * @return true if `xtr` starts with `prefix` or if they are both NULL, false otherwise.
+ */
+XTR_API bool
+xtr_startswith_icase(const xtr_t* xtr, const xtr_t* prefix);
+
+/**
+ * Like xtr_endswith(), ignoring the case of the ASCII letters.
+ *
+ * @param [in] xtr to check the end of
+ * @param [in] suffix to check whether matches `xtr`'s tail
+ * @return true if `xtr` ends with `suffix` or if they are both NULL, false otherwise.
+ */
+XTR_API bool
+xtr_endswith_icase(const xtr_t* xtr, const xtr_t* suffix);
+
 XTR_API bool
 xtr_is_spaces(const xtr_t* xtr);
 XTR_API bool
@@ -777,10 +1243,25 @@ xtr_is_printable(const xtr_t* xtr);
  * The allocated memory (capability) remains the same. To shorten the buffer
  * use xtr_compress_free();
  * @param [in,out] xtr xtring to erase.
+ *        Left unaltered if shared, see xtr_clear_cow().
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_clear(xtr_t* xtr);
 
+/**
+ * Like xtr_clear(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by an empty xtring with the same capacity.
+ * @param [in,out] pxtr pointer to the xtring to erase. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_clear_cow(xtr_t** pxtr);
+
 /**
  * Removes `len` bytes from the xtring start and returns them as a new xtring.
  *
@@ -790,17 +1271,33 @@ xtr_clear(xtr_t* xtr);
  *         xtr after:  "lo world!"
  *         returned:   "Hel"
  *
- * O(n) operation, as it requires the rest of the altered string to be
- * shifted with `memmove`.
+ * O(len) operation, copying only the popped bytes: the rest of the content
+ * stays in place, with the freed bytes before it reused by xtr_push_head().
  * @param [in,out] xtr xtring to pop from an alter, modified in-place.
+ *        Left unaltered if shared, see xtr_pop_head_cow().
  * @param [in] len amount of bytes to pop. If more than the length of `xtr`, a copy
  *        of the entire `xtr` is provided and the modified `xtr` is emptied.
  * @return new xtring with the popped prefix of `xtr`, with the bytes in the
- *        same order as they appeared in the original.
+ *        same order as they appeared in the original. NULL in case of malloc
+ *        failure or when `xtr` is NULL or shared, thus left unaltered.
  */
 XTR_API xtr_t*
 xtr_pop_head(xtr_t* xtr, size_t len);
 
+/**
+ * Like xtr_pop_head(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to pop from. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] len same as for xtr_pop_head().
+ * @return same as xtr_pop_head(), NULL also in case of malloc failure of the copy
+ *         or when `pxtr` or `*pxtr` is NULL.
+ */
+XTR_API xtr_t*
+xtr_pop_head_cow(xtr_t** pxtr, size_t len);
+
 /**
  * Removes `len` bytes from the xtring end and returns them as a new xtring.
  *
@@ -811,14 +1308,30 @@ xtr_pop_head(xtr_t* xtr, size_t len);
  *
  * O(1) operation.
  * @param [in,out] xtr xtring to pop from an alter, modified in-place.
+ *        Left unaltered if shared, see xtr_pop_tail_cow().
  * @param [in] len amount of bytes to pop. If more than the length of `xtr`, a copy
  *        of the entire `xtr` is provided and the modified `xtr` is emptied.
  * @return new xtring with the popped prefix of `xtr`, with the bytes in the
- *        same order as they appeared in the original.
+ *        same order as they appeared in the original. NULL in case of malloc
+ *        failure or when `xtr` is NULL or shared, thus left unaltered.
  */
 XTR_API xtr_t*
 xtr_pop_tail(xtr_t* xtr, size_t len);
 
+/**
+ * Like xtr_pop_tail(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to pop from. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] len same as for xtr_pop_tail().
+ * @return same as xtr_pop_tail(), NULL also in case of malloc failure of the copy
+ *         or when `pxtr` or `*pxtr` is NULL.
+ */
+XTR_API xtr_t*
+xtr_pop_tail_cow(xtr_t** pxtr, size_t len);
+
 /**
  * Removes `len` bytes from the xtring start.
  *
@@ -828,15 +1341,31 @@ xtr_pop_tail(xtr_t* xtr, size_t len);
  *         xtr before: "Hello world!"
  *         xtr after:  "lo world!"
  *
- * O(n) operation, as it requires the rest of the altered string to be
- * shifted with `memmove`.
+ * O(1) operation: the rest of the content stays in place, with the freed
+ * bytes before it reused by xtr_push_head().
  * @param [in,out] xtr xtring to truncate, modified in-place.
+ *        Left unaltered if shared, see xtr_truncate_head_cow().
  * @param [in] len amount of bytes to erase. If more than the length of `xtr`, the
  *        entire `xtr` is emptied.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_truncate_head(xtr_t* xtr, size_t len);
 
+/**
+ * Like xtr_truncate_head(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to truncate. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] len same as for xtr_truncate_head().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_truncate_head_cow(xtr_t** pxtr, size_t len);
+
 /**
  * Removes `len` bytes from the xtring end.
  *
@@ -848,12 +1377,28 @@ xtr_truncate_head(xtr_t* xtr, size_t len);
  *
  * O(1) operation.
  * @param [in,out] xtr xtring to truncate, modified in-place.
+ *        Left unaltered if shared, see xtr_truncate_tail_cow().
  * @param [in] len amount of bytes to erase. If more than the length of `xtr`, the
  *        entire `xtr` is emptied.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_truncate_tail(xtr_t* xtr, size_t len);
 
+/**
+ * Like xtr_truncate_tail(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to truncate. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] len same as for xtr_truncate_tail().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_truncate_tail_cow(xtr_t** pxtr, size_t len);
+
 /**
  * Trims (strips) any provided characters from the end of the string.
  *
@@ -865,12 +1410,28 @@ xtr_truncate_tail(xtr_t* xtr, size_t len);
  *         xtr_trim_tail(xtr["Hello world!\r\n"], NULL) --> xtr["Hello world!"]
  *         xtr_trim_tail(xtr["Hello world!AAAAAAA"], "ABC") --> xtr["Hello world!"]
  * @param [in,out] xtr xtring to trim in-place.
+ *        Left unaltered if shared, see xtr_trim_tail_cow().
  * @param [in] chars characters to remove, regardless of their order of appearance.
  *        NULL for all whitespace characters.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_trim_tail(xtr_t* xtr, const char* chars);
 
+/**
+ * Like xtr_trim_tail(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to trim. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] chars same as for xtr_trim_tail().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_trim_tail_cow(xtr_t** pxtr, const char* chars);
+
 /**
  * Trims (strips) any provided characters from the start of the string.
  *
@@ -882,12 +1443,28 @@ xtr_trim_tail(xtr_t* xtr, const char* chars);
  *         xtr_trim_head(xtr["\r\n Hello world!\r\n"], NULL) --> xtr["Hello world!\r\n"]
  *         xtr_trim_head(xtr["===Hello world!"], "=-+") --> xtr["Hello world!"]
  * @param [in,out] xtr xtring to trim in-place.
+ *        Left unaltered if shared, see xtr_trim_head_cow().
  * @param [in] chars characters to remove, regardless of their order of appearance.
  *        NULL for all whitespace characters.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void  // O(n) operation!
+XTR_API bool
 xtr_trim_head(xtr_t* xtr, const char* chars);
 
+/**
+ * Like xtr_trim_head(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to trim. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] chars same as for xtr_trim_head().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_trim_head_cow(xtr_t** pxtr, const char* chars);
+
 /**
  * Trims (strips) any provided characters from the start and end of the string.
  *
@@ -899,12 +1476,28 @@ xtr_trim_head(xtr_t* xtr, const char* chars);
  *         xtr_trim(xtr["\r\n Hello world!\r\n"], NULL) --> xtr["Hello world!"]
  *         xtr_trim(xtr["===Hello world!==="], "=-+") --> xtr["Hello world!"]
  * @param [in,out] xtr xtring to trim in-place.
+ *        Left unaltered if shared, see xtr_trim_cow().
  * @param [in] chars characters to remove, regardless of their order of appearance.
  *        NULL for all whitespace characters.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_trim(xtr_t* xtr, const char* chars);
 
+/**
+ * Like xtr_trim(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to trim. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] chars same as for xtr_trim().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_trim_cow(xtr_t** pxtr, const char* chars);
+
 /**
  * Truncates the provided substring from the start of the xtring, if present.
  *
@@ -916,11 +1509,27 @@ xtr_trim(xtr_t* xtr, const char* chars);
  *         xtr_truncate_prefix(xtr["Hello world!"], "abc!") --> xtr["Hello world!"]
  *         xtr_truncate_prefix(xtr["...Hello world!"], ".") --> xtr["..Hello world!"]
  * @param [in,out] xtr xtring to truncate in-place. NULL does nothing.
+ *        Left unaltered if shared, see xtr_truncate_prefix_cow().
  * @param [in] prefix substring to remove from the xtring's head, if present. NULL does nothing.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_truncate_prefix(xtr_t* xtr, const char* prefix);
 
+/**
+ * Like xtr_truncate_prefix(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to truncate. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] prefix same as for xtr_truncate_prefix().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_truncate_prefix_cow(xtr_t** pxtr, const char* prefix);
+
 /**
  * Truncates the provided substring from the end of the xtring, if present.
  *
@@ -932,11 +1541,27 @@ xtr_truncate_prefix(xtr_t* xtr, const char* prefix);
  *         xtr_truncate_suffix(xtr["Hello world!"], "abc!") --> xtr["Hello world!"]
  *         xtr_truncate_suffix(xtr["Hello world..."], ".") --> xtr["Hello world.."]
  * @param [in,out] xtr xtring to truncate in-place. NULL does nothing.
+ *        Left unaltered if shared, see xtr_truncate_suffix_cow().
  * @param [in] suffix substring to remove from the xtring's tail, if present. NULL does nothing.
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_truncate_suffix(xtr_t* xtr, const char* suffix);
 
+/**
+ * Like xtr_truncate_suffix(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy of just the remaining bytes.
+ * @param [in,out] pxtr pointer to the xtring to truncate. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] suffix same as for xtr_truncate_suffix().
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_truncate_suffix_cow(xtr_t** pxtr, const char* suffix);
+
 // ------------------- Alter the Xtring's allocated memory ------------------------------------
 
 XTR_API xtr_t*
@@ -957,6 +1582,25 @@ xtr_resize_free_double(xtr_t** pxtr);
 XTR_API xtr_t*
 xtr_compress_free(xtr_t** pxtr);
 
+/**
+ * Ensures room for at least `additional` more bytes, reallocating the xtring
+ * if necessary, freeing the old one.
+ *
+ * Reallocates exactly to the needed length, copying the content once, so the
+ * following xtr_push_tail() or xtr_extend_tail() calls within the reserved
+ * room copy only their extension. Does nothing if there is already enough
+ * free space and the xtring is not shared.
+ * @param [in,out] pxtr pointer to the xtring to grow. Pointed xtr_t*
+ *        will be replaced by a larger copy, if a reallocation happens.
+ *        Frees the previous xtring. Untouched on failure.
+ * @param [in] additional amount of free bytes wanted after the content.
+ * @return the reserved xtring or NULL in case of malloc failure, size overflow
+ *         or when `pxtr` or `*pxtr` is NULL.
+ *         Note: on success the returned value matches `*pxtr`.
+ */
+XTR_API xtr_t*
+xtr_reserve(xtr_t** pxtr, size_t additional);
+
 // ------------------- Reverse the xtring's content ------------------------------------
 /**
  * Creates a reversed (end-to-start) copy of the xtring.
@@ -971,18 +1615,36 @@ xtr_reversed(const xtr_t* xtr);
  * Reverses (end-to-start) the xtring in-place.
  *
  * @param [in,out] xtr to reverse. Does nothing on NULL input.
+ *        Left unaltered if shared, see xtr_reverse_cow().
+ * @return false if `xtr` is NULL or shared, thus left unaltered, true otherwise.
  */
-XTR_API void
+XTR_API bool
 xtr_reverse(xtr_t* xtr);
 
+/**
+ * Like xtr_reverse(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy with the same capacity, which is then altered.
+ * @param [in,out] pxtr pointer to the xtring to reverse. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @return false in case of malloc failure or when `pxtr` or `*pxtr` is NULL,
+ *         true otherwise.
+ */
+XTR_API bool
+xtr_reverse_cow(xtr_t** pxtr);
+
 // ------------------- Search for substrings ------------------------------------
 /**
  * Counts how many times a substring appears in the xtring.
  *
+ * Occurrences do not overlap: the search resumes after the end of each
+ * found occurrence, e.g. "aa" appears 2 times in "aaaaa".
+ *
  * @param [in] haystack xtring to search in.
  * @param [in] needle pattern to search for (substring).
- * @return amount or #XTR_NOT_FOUND in case of NULL pointers. Returns zero if
- *         `needle` is too short to fit the `haystack`.
+ * @return amount or #XTR_NOT_FOUND in case of NULL pointers or empty `needle`.
+ *         Returns zero if `needle` is too long to fit the `haystack`.
  */
 XTR_API size_t
 xtr_occurrences(const xtr_t* haystack, const xtr_t* needle);
@@ -1026,15 +1688,80 @@ xtr_find(const xtr_t* haystack, const xtr_t* needle);
 XTR_API size_t
 xtr_find_from(const xtr_t* haystack, const xtr_t* needle, size_t start);
 
-XTR_API const size_t*
-xtr_find_all(const xtr_t* haystack, const xtr_t* needle);
-
 /**
- * Searches for a substring `needle` in the xtring within an index range.
+ * Searches for all occurrences of a substring in the xtring.
  *
+ * Same occurrences as xtr_occurrences() counts: they do not overlap.
+ * To process them one at a time without allocating, use xtr_find_next().
+ *
+ * @param [out] amount of found occurrences, i.e. length of the returned array
  * @param [in] haystack xtring to search in
  * @param [in] needle pattern to search for
- * @param [in] start first index to check, inclusive
+ * @return sorted array of the indices of the occurrences, to be freed with
+ *         free() (#XTR_FREE) after usage, or NULL in case of NULL pointers,
+ *         empty `needle` or malloc failure.
+ */
+XTR_API size_t*
+xtr_find_all(size_t* amount, const xtr_t* haystack, const xtr_t* needle);
+
+/**
+ * Prepares a cursor to iterate over the occurrences of a substring in the
+ * xtring with xtr_find_next().
+ *
+ * The needle is preprocessed once here, not at every xtr_find_next() call.
+ * The cursor yields no occurrences if any pointer is NULL or `needle` is
+ * empty.
+ *
+ * Example:
+ *
+ *     xtr_cursor_t cursor;
+ *     xtr_cursor_init(&cursor, haystack, needle);
+ *     for (size_t i = xtr_find_next(&cursor); i != XTR_NOT_FOUND;
+ *          i = xtr_find_next(&cursor))
+ *     {
+ *         // Occurrence at index i
+ *     }
+ *
+ * @param [out] cursor to initialise. Does nothing if NULL.
+ * @param [in] haystack xtring to search in
+ * @param [in] needle pattern to search for
+ */
+XTR_API void
+xtr_cursor_init(xtr_cursor_t* cursor, const xtr_t* haystack, const xtr_t* needle);
+
+/**
+ * Prepares a cursor to iterate over the occurrences of a compiled pattern
+ * in the xtring with xtr_find_next().
+ *
+ * Same as xtr_cursor_init() but using the search tables of the pattern.
+ *
+ * @param [out] cursor to initialise. Does nothing if NULL.
+ * @param [in] haystack xtring to search in
+ * @param [in] pattern compiled needle to search for
+ */
+XTR_API void
+xtr_cursor_init_pattern(xtr_cursor_t* cursor, const xtr_t* haystack, const xtr_pattern_t* pattern);
+
+/**
+ * Searches for the next occurrence of the cursor's needle.
+ *
+ * Occurrences do not overlap, as in xtr_occurrences(): each search resumes
+ * after the end of the previous occurrence.
+ *
+ * @param [in,out] cursor initialised with xtr_cursor_init() or
+ *                 xtr_cursor_init_pattern()
+ * @return index of the occurrence or #XTR_NOT_FOUND when there are no
+ *         further occurrences (or on NULL input).
+ */
+XTR_API size_t
+xtr_find_next(xtr_cursor_t* cursor);
+
+/**
+ * Searches for a substring `needle` in the xtring within an index range.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] needle pattern to search for
+ * @param [in] start first index to check, inclusive
  * @param [in] end end of search, excluded (points to byte after last)
  * @return index to the found section or #XTR_NOT_FOUND if not found.
  *         #XTR_NOT_FOUND is also returned if the indexes
@@ -1044,141 +1771,1885 @@ xtr_find_all(const xtr_t* haystack, const xtr_t* needle);
 XTR_API size_t
 xtr_find_within(const xtr_t* haystack, const xtr_t* needle, size_t start, size_t end);
 
-// ------------------- Splitting ------------------------------------
+/**
+ * Searches for the last occurrence of a substring in the xtring.
+ *
+ * Scans from the end backwards, so the runtime is proportional to the
+ * distance of the occurrence from the end of the xtring, e.g. to find
+ * the extension of a file name or the last field of a line.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] needle pattern to search for
+ * @return index to the start of the last found section or #XTR_NOT_FOUND
+ *         if not found. #XTR_NOT_FOUND is also returned if any pointer is
+ *         NULL, if any xtring is empty, if `needle` does not fit into
+ *         `haystack` at all.
+ */
+XTR_API size_t
+xtr_rfind(const xtr_t* haystack, const xtr_t* needle);
 
-XTR_API xtr_t**
-xtr_split(size_t* amount_of_chunks, const xtr_t* xtr, const xtr_t* separator);
+/**
+ * Searches for the last occurrence of a substring `needle` in the xtring
+ * within an index range.
+ *
+ * Same as xtr_rfind(), but the occurrence must lie entirely within the range.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] needle pattern to search for
+ * @param [in] start first index to check, inclusive
+ * @param [in] end end of search, excluded (points to byte after last)
+ * @return index to the start of the last found section or #XTR_NOT_FOUND
+ *         if not found. #XTR_NOT_FOUND is also returned if the indexes
+ *         are out of range, if any pointer is NULL, if any xtring is empty,
+ *         if `needle` does not fit into `haystack` at all.
+ */
+XTR_API size_t
+xtr_rfind_within(const xtr_t* haystack, const xtr_t* needle, size_t start, size_t end);
 
-XTR_API xtr_t**
-xtr_split_every(size_t* amount_of_chunks, const xtr_t* xtr, size_t chunk_len);
+/**
+ * Searches for a substring in the xtring, ignoring the case of the ASCII letters.
+ *
+ * The case is folded on the fly while scanning, without any copy of the
+ * xtrings. Same worst-case linear runtime as xtr_find().
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] needle pattern to search for
+ * @return index to the found section or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned if any pointer is NULL, if any
+ *         xtring is empty, if `needle` does not fit into `haystack` at all.
+ */
+XTR_API size_t
+xtr_find_icase(const xtr_t* haystack, const xtr_t* needle);
+
+// ------------------- Search for sets of bytes ------------------------------------
 
-// ------------------- Concatenation ------------------------------------
 /**
- * Concatenates two xtrings into a third one.
+ * Initialises a set with the bytes of a C-string.
  *
- * Can be also used to concatenate `a` with itself.
- * @param [in] a first half.
- * @param [in] b second half. May also be `a`.
- * @return the new xtring containing `a+b` or NULL in case of malloc failure,
- *         NULL inputs or size overflow.
+ * @param [out] set to initialise. Does nothing if NULL.
+ * @param [in] chars null-terminated bytes to put into the set, regardless of
+ *        their order. NULL for the whitespace characters " \t\n\v\f\r".
  */
-XTR_API xtr_t*
-xtr_concat(const xtr_t* a, const xtr_t* b);
+XTR_API void
+xtr_charset_init(xtr_charset_t* set, const char* chars);
 
 /**
- * New xtring with the content repeated `repetition` times.
+ * Initialises a set with the bytes of an array, which may include zeros.
  *
- * Does not reserve any additional capacity for expansions.
- * @param [in] xtr xtring to repeat.
- * @param [in] repetitions amount of times to repeat `xtr`. `0` for an empty xtring.
- * @return the new xtring or NULL in case of malloc failure.
+ * @param [out] set to initialise. Does nothing if NULL.
+ * @param [in] bytes to put into the set, regardless of their order.
+ *        May be NULL if `len` is 0, for an empty set.
+ * @param [in] len amount of bytes in the array
  */
-XTR_API xtr_t*
-xtr_repeated(const xtr_t* xtr, size_t repetitions);
+XTR_API void
+xtr_charset_init_bytes(xtr_charset_t* set, const uint8_t* bytes, size_t len);
 
-// ------------------- Appending ------------------------------------
+/**
+ * Checks whether a byte is in the set.
+ *
+ * @param [in] set of bytes
+ * @param [in] byte value to check
+ * @return true if `byte` is in the set, false otherwise or if `set` is NULL
+ */
+XTR_API bool
+xtr_charset_contains(const xtr_charset_t* set, uint8_t byte);
 
 /**
- * Appends the extension to the existing xtring's start, if there is enough capacity.
- * Otherwise does nothing.
+ * Searches for the first byte of the xtring which is in the set.
  *
- * If there is some capacity but not enough for the
- * full extension, it also does nothing - no partial copy is performed.
+ * Checks 16 (SSSE3) or 32 (AVX2) bytes at once when available.
  *
- * @param [in,out] xtr xtring to extend
- * @param [in] extension xtring to add as extension
- * @return Amount of bytes extended. Zero if any pointer is NULL or if `xtr` has not
- *         enough space for the full extension.
+ * Example:
+ *
+ *         xtr_find_first_of(xtr["key=value;x"], set["=;"]) --> 3
+ *
+ * @param [in] xtr xtring to search in
+ * @param [in] set of bytes to search for
+ * @return index of the found byte or #XTR_NOT_FOUND if not found
+ *         or if any pointer is NULL.
  */
 XTR_API size_t
-xtr_push_head(xtr_t* xtr, const xtr_t* extension);
+xtr_find_first_of(const xtr_t* xtr, const xtr_charset_t* set);
 
 /**
- * Appends the extension to the existing xtring's end, if there is enough capacity.
- * Otherwise does nothing.
+ * Searches for the first byte of the xtring which is not in the set.
  *
- * If there is some capacity but not enough for the
- * full extension, it also does nothing - no partial copy is performed.
+ * Example:
  *
- * @param [in,out] xtr xtring to extend
- * @param [in] extension xtring to add as extension
- * @return Amount of bytes extended. Zero if any pointer is NULL or if `xtr` has not
- *         enough space for the full extension.
+ *         xtr_find_first_not_of(xtr["  \tabc "], set[" \t"]) --> 3
+ *
+ * @param [in] xtr xtring to search in
+ * @param [in] set of bytes to skip
+ * @return index of the found byte or #XTR_NOT_FOUND if not found
+ *         or if any pointer is NULL.
  */
 XTR_API size_t
-xtr_push_tail(xtr_t* xtr, const xtr_t* extension);
+xtr_find_first_not_of(const xtr_t* xtr, const xtr_charset_t* set);
 
 /**
- * Appends the extension to the existing xtring's start, reallocating the xtring
- * if necessary, freeing the old one.
+ * Searches for the last byte of the xtring which is in the set.
  *
- * @param [in,out] pxtr pointer to the original xtring to extend. Pointed xtr_t*
- *        will be replaced by a larger copy, if a reallocation happens.
- *        Frees the previous xtring. Untouched on failure.
- * @param [in] extension xtring to add as extension
- * @return the new xtring or NULL in case of malloc failure or when `pxtr` or `*pxtr` is NULL.
- *         Note: on success the returned value matches `*pxtr`. On failure the
- *         returned value is NULL and *pxtr is unchanged.
+ * @param [in] xtr xtring to search in
+ * @param [in] set of bytes to search for
+ * @return index of the found byte or #XTR_NOT_FOUND if not found
+ *         or if any pointer is NULL.
  */
-XTR_API xtr_t*
-xtr_extend_head(xtr_t** pxtr, const xtr_t* extension);
+XTR_API size_t
+xtr_find_last_of(const xtr_t* xtr, const xtr_charset_t* set);
 
 /**
- * Appends the extension to the existing xtring's end, reallocating the xtring
- * if necessary, freeing the old one.
+ * Searches for the last byte of the xtring which is not in the set.
  *
- * @param [in,out] pxtr pointer to the original xtring to extend. Pointed xtr_t*
- *        will be replaced by a larger copy, if a reallocation happens.
- *        Frees the previous xtring. Untouched on failure.
- * @param [in] extension xtring to add as extension
- * @return the new xtring or NULL in case of malloc failure or when `pxtr` or `*pxtr` is NULL.
- *         Note: on success the returned value matches `*pxtr`. On failure the
- *         returned value is NULL and *pxtr is unchanged.
+ * @param [in] xtr xtring to search in
+ * @param [in] set of bytes to skip
+ * @return index of the found byte or #XTR_NOT_FOUND if not found
+ *         or if any pointer is NULL.
  */
-XTR_API xtr_t*
-xtr_extend_tail(xtr_t** pxtr, const xtr_t* extension);
+XTR_API size_t
+xtr_find_last_not_of(const xtr_t* xtr, const xtr_charset_t* set);
 
-// ------------------- Encoding ------------------------------------
 /**
- * Converts a binary xtring to a hex string in ASCII encoding.
+ * Length of the initial part of the xtring consisting only of bytes in the set.
  *
- * Example: xtr[13, 1, 130] --> "0D0182"
+ * Like `strspn()`, but with a precomputed set.
  *
- * @param [in] bin xtring to convert to hex
- * @param [in] upper true to use uppercase hex characters ABCDEF rather than abcdef
- * @param [in] separator optional string to place between each byte. NULL or empty
- *        string for no separator
- * @return a new xtring with the hex characters in ASCII encoding or NULL in
- *         case of malloc failure.
+ * Example:
+ *
+ *         xtr_span(xtr["123abc"], set["0123456789"]) --> 3
+ *
+ * @param [in] xtr xtring to inspect
+ * @param [in] set of bytes to accept
+ * @return amount of leading bytes in the set, 0 if any pointer is NULL.
  */
-XTR_API xtr_t*
-xtr_to_hex(const xtr_t* bin, bool upper, const char* separator);
+XTR_API size_t
+xtr_span(const xtr_t* xtr, const xtr_charset_t* set);
 
+// ------------------- Search with compiled patterns ------------------------------------
 /**
- * Converts a hexadeciaml text string in ASCII encoding to a binary xtring.
+ * Compiles a needle into a reusable search pattern.
  *
- * Example: "0x0D 01 82" --> xtr[13, 1, 130]s
+ * The needle is copied, so it can be altered or freed afterwards.
+ * The preprocessing (critical factorisation, skip tables, choice of the
+ * fastest algorithm for the needle's length) happens here once, instead
+ * of at each search as with xtr_find().
  *
- * Properties:
- * - Ignores any whitespaces, comma, and underscores - typically used as byte
- *   separators.
- * - Ignores any `#` sign - typically used when expressing RGB colors as hex.
- * - Ignores any `0x` or `0X` prefixes, even if they appear multiple times.
- * - Case insensitive (A-F or a-f are both OK).
+ * @param [in] needle pattern to search for (substring)
+ * @return the new pattern or NULL in case of malloc failure, NULL `needle`
+ *         or empty `needle`.
+ */
+XTR_API xtr_pattern_t*
+xtr_pattern_new(const xtr_t* needle);
+
+/**
+ * Frees the compiled pattern after usage and sets the pattern pointer
+ * to NULL to avoid use-after-free.
  *
- * @param [in] hex hexadecimal string (ASCII characters 0-9A-F)
- * @param [in] len optional length of the hex string, if already known.
- *             Pass #XTR_UNKNOWN_STRLEN otherwise: this function will run strlen() internally.
- * @return a new xtring with the binary values or NULL in case of conversion failure (e.g.,
- * non-hex character found) or malloc failure
+ * @param [in,out] ppattern **address** of the pattern-pointer.
  */
-XTR_API xtr_t*
-xtr_from_hex(const char* hex, size_t len);
+XTR_API void
+xtr_pattern_free(xtr_pattern_t** ppattern);
 
-XTR_API xtr_t*
-xtr_base64_decode(const xtr_t* b64_text);
-XTR_API xtr_t*
-xtr_base64_encode(const xtr_t* binary);
+/**
+ * Searches for a compiled pattern in the xtring.
+ *
+ * Same as xtr_find(), without preprocessing the needle again.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] pattern compiled needle to search for
+ * @return index to the found section or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned if any pointer is NULL,
+ *         if `haystack` is empty, if the needle does not fit into `haystack` at all.
+ */
+XTR_API size_t
+xtr_pattern_find(const xtr_t* haystack, const xtr_pattern_t* pattern);
+
+/**
+ * Searches for a compiled pattern in the xtring starting from an index.
+ *
+ * Same as xtr_find_from(), without preprocessing the needle again.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] pattern compiled needle to search for
+ * @param [in] start first index to check, inclusive
+ * @return index to the found section or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned if the index
+ *         is out of range, if any pointer is NULL, if `haystack` is empty,
+ *         if the needle does not fit into `haystack` at all.
+ */
+XTR_API size_t
+xtr_pattern_find_from(const xtr_t* haystack, const xtr_pattern_t* pattern, size_t start);
+
+/**
+ * Counts how many times a compiled pattern appears in the xtring.
+ *
+ * Same as xtr_occurrences(): occurrences do not overlap.
+ *
+ * @param [in] haystack xtring to search in.
+ * @param [in] pattern compiled needle to search for.
+ * @return amount or #XTR_NOT_FOUND in case of NULL pointers.
+ *         Returns zero if the needle is too long to fit the `haystack`.
+ */
+XTR_API size_t
+xtr_pattern_count(const xtr_t* haystack, const xtr_pattern_t* pattern);
+
+/**
+ * Checks whether a compiled pattern exists in the xtring.
+ *
+ * Same as xtr_contains(), without preprocessing the needle again.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] pattern compiled needle to search for
+ * @return true if the pattern is found, false otherwise. False is also returned
+ *         when any pointer is NULL, if `haystack` is empty or
+ *         if the needle does not fit into `haystack` at all.
+ */
+XTR_API bool
+xtr_pattern_contains(const xtr_t* haystack, const xtr_pattern_t* pattern);
+
+// ------------------- Search for many needles at once ------------------------------------
+/**
+ * Compiles many needles into a set searchable in a single pass (Aho-Corasick).
+ *
+ * The needles are copied into the set, so they can be altered or freed
+ * afterwards. Each needle is identified by its index in the `needles` array.
+ * NULL or empty needles are allowed, but never found.
+ *
+ * @param [in] needles array of patterns to search for
+ * @param [in] amount length of the `needles` array
+ * @return the new set or NULL in case of malloc failure, NULL `needles`,
+ *         zero `amount` or if the needles are too many or too long to be
+ *         indexed with 32-bit integers.
+ */
+XTR_API xtr_multipattern_t*
+xtr_multipattern_new(const xtr_t* const* needles, size_t amount);
+
+/**
+ * Frees the compiled set of needles after usage and sets the pointer
+ * to NULL to avoid use-after-free.
+ *
+ * @param [in,out] ppatterns **address** of the set-pointer.
+ */
+XTR_API void
+xtr_multipattern_free(xtr_multipattern_t** ppatterns);
+
+/**
+ * Amount of needles the set was built from, including empty ones.
+ *
+ * Useful to allocate the array for xtr_count_each().
+ *
+ * @param [in] patterns compiled set of needles
+ * @return amount of needles or 0 if NULL.
+ */
+XTR_API size_t
+xtr_multipattern_amount(const xtr_multipattern_t* patterns);
+
+/**
+ * Searches for the first occurrence of any of the needles in the xtring.
+ *
+ * The first occurrence is the one starting at the lowest index.
+ * If multiple needles start there, the longest one is reported.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] patterns compiled set of needles to search for
+ * @param [out] needle_id index of the found needle, #XTR_NOT_FOUND if none.
+ *              May be NULL if not needed.
+ * @return index of the found occurrence or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned if `haystack` or `patterns`
+ *         is NULL or if `haystack` is empty.
+ */
+XTR_API size_t
+xtr_find_any(const xtr_t* haystack, const xtr_multipattern_t* patterns, size_t* needle_id);
+
+/**
+ * Searches for all occurrences of all the needles in the xtring, in a single pass.
+ *
+ * All occurrences are reported, also overlapping ones, sorted by the index
+ * of their end: e.g. needles "he" and "she" in "ushers" yield
+ * {index 1, "she"} and then {index 2, "he"}.
+ *
+ * @param [out] amount length of the returned array, 0 on error.
+ * @param [in] haystack xtring to search in
+ * @param [in] patterns compiled set of needles to search for
+ * @return array of occurrences, to be freed with free() (#XTR_FREE) after usage,
+ *         even when empty. NULL in case of malloc failure or NULL pointers.
+ */
+XTR_API xtr_match_t*
+xtr_find_all_any(size_t* amount, const xtr_t* haystack, const xtr_multipattern_t* patterns);
+
+/**
+ * Counts how many times each needle appears in the xtring, in a single pass.
+ *
+ * Occurrences of the same needle do not overlap, as in xtr_occurrences(),
+ * while occurrences of different needles may overlap.
+ *
+ * @param [out] counts array to fill with the amount of occurrences of each
+ *              needle, indexed by needle ID. Must be
+ *              xtr_multipattern_amount() long.
+ * @param [in] haystack xtring to search in
+ * @param [in] patterns compiled set of needles to search for
+ * @return total amount of occurrences, or #XTR_NOT_FOUND in case of
+ *         malloc failure or NULL pointers.
+ */
+XTR_API size_t
+xtr_count_each(size_t* counts, const xtr_t* haystack, const xtr_multipattern_t* patterns);
+
+// ------------------- Search with regular expressions ------------------------------------
+/**
+ * Compiles a regular expression, searchable in linear time.
+ *
+ * The expression is matched byte by byte, as ASCII. Supported syntax:
+ * - literal bytes, `\` escaping any punctuation byte, `\t` `\n` `\r`
+ *   `\f` `\v` and `\xHH` for hexadecimal byte values
+ * - `.` matching any byte except `\n`
+ * - classes such as `[a-z_]` and negated classes such as `[^,;]`, also
+ *   matching `\n`; the shorthand classes `\d` `\w` `\s` and their
+ *   negations `\D` `\W` `\S`, also within classes
+ * - grouping with `(...)` or `(?:...)`, without capturing
+ * - alternation with `|`
+ * - the greedy repetitions `*` `+` `?` `{n}` `{n,}` `{n,m}` with at most
+ *   1000 repetitions, lazy when followed by `?`
+ * - `^` as first byte of the expression and `$` as last one, anchoring the
+ *   whole expression to the start and end of the haystack: `^(a|b)$` is
+ *   valid, `^a|b` is not
+ *
+ * Backreferences and lookarounds are not supported, as they are not
+ * matchable in linear time, nor are capturing groups.
+ * Matches are leftmost-first, as in Perl or PCRE: the match starting at the
+ * lowest index, preferring the left side of alternations and the longest
+ * greedy (shortest lazy) repetitions. Repeated groups that can match the
+ * empty string, like `(a|)*`, may match differently than in backtracking
+ * engines, as in RE2.
+ *
+ * @param [in] pattern null-terminated regular expression
+ * @return the new regex or NULL in case of malloc failure, NULL `pattern`,
+ *         invalid syntax or if the expression is too large to compile.
+ */
+XTR_API xtr_regex_t*
+xtr_regex_new(const char* pattern);
+
+/**
+ * Frees the compiled regular expression after usage and sets the regex
+ * pointer to NULL to avoid use-after-free.
+ *
+ * @param [in,out] pregex **address** of the regex-pointer.
+ */
+XTR_API void
+xtr_regex_free(xtr_regex_t** pregex);
+
+/**
+ * Checks whether the entire xtring matches the regular expression.
+ *
+ * Use xtr_regex_find() to check for a match anywhere in the xtring instead.
+ * Runs in time linear in the xtring length.
+ *
+ * @param [in] xtr xtring to check
+ * @param [in,out] regex compiled regular expression, caching the DFA states
+ * @return true if the whole xtring matches, false otherwise or if any
+ *         pointer is NULL.
+ */
+XTR_API bool
+xtr_regex_match(const xtr_t* xtr, xtr_regex_t* regex);
+
+/**
+ * Searches for the first match of the regular expression in the xtring.
+ *
+ * Runs in time linear in the haystack length, scanning it at most twice.
+ * Expressions starting with literal bytes skip to their occurrences with
+ * the substring search of xtr_find().
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in,out] regex compiled regular expression, caching the DFA states
+ * @param [out] length amount of bytes of the match, 0 if none.
+ *              May be NULL if not needed.
+ * @return index of the match or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned if `haystack` or `regex` is NULL.
+ */
+XTR_API size_t
+xtr_regex_find(const xtr_t* haystack, xtr_regex_t* regex, size_t* length);
+
+/**
+ * Searches for the first match of the regular expression in the xtring
+ * starting from an index.
+ *
+ * Same as xtr_regex_find(), ignoring any match starting before `start`.
+ * A `^` anchor never matches after index 0.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in,out] regex compiled regular expression, caching the DFA states
+ * @param [in] start first index where the match may start, inclusive
+ * @param [out] length amount of bytes of the match, 0 if none.
+ *              May be NULL if not needed.
+ * @return index of the match or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned if `haystack` or `regex` is NULL
+ *         or if `start` is beyond the haystack length.
+ */
+XTR_API size_t
+xtr_regex_find_from(const xtr_t* haystack, xtr_regex_t* regex, size_t start, size_t* length);
+
+/**
+ * Searches for all the matches of the regular expression in the xtring.
+ *
+ * Matches do not overlap: each search resumes at the end of the previous
+ * match, or one byte after it for empty matches.
+ * Typically scans the haystack once or twice in total, but takes O(n^2) time
+ * in the worst case: each search may scan up to the end of the haystack
+ * before settling on a shorter match. E.g. `x*y|x` on a run of n `x` bytes
+ * finds n one-byte matches, each after scanning the rest of the run.
+ *
+ * @param [out] amount length of the returned array, 0 on error.
+ * @param [in] haystack xtring to search in
+ * @param [in,out] regex compiled regular expression, caching the DFA states
+ * @return array of matches sorted by index, to be freed with free()
+ *         (#XTR_FREE) after usage, even when empty. NULL in case of malloc
+ *         failure or NULL pointers.
+ */
+XTR_API xtr_region_t*
+xtr_regex_find_all(size_t* amount, const xtr_t* haystack, xtr_regex_t* regex);
+
+// ------------------- Approximate search ------------------------------------
+/**
+ * Searches for the first section of the xtring within a maximum edit
+ * distance from the needle.
+ *
+ * The edit distance is the Levenshtein one: the fewest byte insertions,
+ * deletions and substitutions turning one array into the other.
+ * The occurrence ends where the distance first drops to `max_edits` or
+ * fewer, moved forward while the distance keeps decreasing, e.g. "abc"
+ * with 1 edit is found in "xabcx" as "abc" rather than "ab".
+ * Of the sections ending there, it starts where the fewest edits are needed,
+ * the longest on ties.
+ *
+ * Uses the bit-parallel algorithm by Myers, processing 64 needle bytes per
+ * operation, in about `len(haystack) * min(len(needle), max_edits) / 64`
+ * operations.
+ *
+ * @param [in] haystack xtring to search in
+ * @param [in] needle pattern to search for
+ * @param [in] max_edits most edits to turn the found section into `needle`
+ * @param [out] length amount of bytes of the found section, 0 if none.
+ *              May be NULL if not needed.
+ * @return index of the found section or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned in case of NULL pointers or
+ *         malloc failure. Returns 0 with length 0 if `needle` is not longer
+ *         than `max_edits`.
+ */
+XTR_API size_t
+xtr_find_approx(const xtr_t* haystack, const xtr_t* needle, size_t max_edits, size_t* length);
+
+/**
+ * Computes the edit (Levenshtein) distance between two xtrings.
+ *
+ * Skips their common prefix and suffix, then runs the bit-parallel
+ * algorithm by Myers only along a band around the diagonal, doubling its
+ * width until it contains the distance: about
+ * `max(len(a), len(b)) * distance / 64` operations.
+ *
+ * @param [in] a xtring to compare
+ * @param [in] b xtring to compare
+ * @return the fewest byte insertions, deletions and substitutions turning
+ *         `a` into `b` or #XTR_NOT_FOUND in case of NULL pointers or
+ *         malloc failure.
+ */
+XTR_API size_t
+xtr_edit_distance(const xtr_t* a, const xtr_t* b);
+
+// ------------------- Search with a suffix array index ------------------------------------
+/**
+ * Builds the suffix array index of a text, to find any needle in it in
+ * `O(len(needle) * log(len(text)))` rather than scanning the text.
+ *
+ * The suffix array is built in linear time with the SA-IS algorithm, the
+ * LCP array (longest common prefixes of adjacent suffixes) from it in
+ * linear time. The index takes 9 bytes per text byte; building it needs
+ * about 4 more, temporarily.
+ *
+ * @param [in] text xtring to index, copied into the index
+ * @return the new index or NULL in case of malloc failure, NULL `text` or
+ *         texts of 4 GiB or longer.
+ */
+XTR_API xtr_index_t*
+xtr_index_new(const xtr_t* text);
+
+/**
+ * Loads an index from the serialised form of xtr_index_bytes().
+ *
+ * The bytes are **not copied**: the index reads them directly, so they
+ * must outlive the index and stay unaltered, e.g. a memory-mapped file.
+ * The header is validated, not the arrays: searching in corrupted arrays
+ * gives wrong results, but never reads outside of them nor returns positions
+ * beyond the text.
+ *
+ * @param [in] bytes serialised index, aligned to 4 bytes, written by a
+ *             machine with the same byte order
+ * @param [in] size amount of bytes of the serialised index
+ * @return the new index or NULL in case of malloc failure, NULL `bytes`,
+ *         misaligned `bytes` or invalid header or size.
+ */
+XTR_API xtr_index_t*
+xtr_index_from_bytes(const uint8_t* bytes, size_t size);
+
+/**
+ * Frees the index after usage and sets the index pointer to NULL to avoid
+ * use-after-free. The bytes an index was loaded from are not freed.
+ *
+ * @param [in,out] pindex **address** of the index-pointer.
+ */
+XTR_API void
+xtr_index_free(xtr_index_t** pindex);
+
+/**
+ * Provides the serialised form of the index, to be saved and loaded back
+ * with xtr_index_from_bytes().
+ *
+ * @param [in] index suffix array index
+ * @param [out] size amount of bytes of the serialised index, 0 if `index`
+ *              is NULL. May be NULL if not needed.
+ * @return the serialised index, valid as long as the index, or NULL if
+ *         `index` is NULL.
+ */
+XTR_API const uint8_t*
+xtr_index_bytes(const xtr_index_t* index, size_t* size);
+
+/**
+ * Checks whether a substring exists in the indexed text.
+ *
+ * @param [in] index suffix array index of the text to search in
+ * @param [in] needle pattern to search for
+ * @return true if found, false otherwise, in case of NULL pointers or
+ *         empty `needle`.
+ */
+XTR_API bool
+xtr_index_contains(const xtr_index_t* index, const xtr_t* needle);
+
+/**
+ * Counts how many times a substring appears in the indexed text.
+ *
+ * Unlike xtr_occurrences(), overlapping occurrences are counted too,
+ * e.g. "aa" appears 4 times in "aaaaa".
+ *
+ * @param [in] index suffix array index of the text to search in
+ * @param [in] needle pattern to search for
+ * @return amount or #XTR_NOT_FOUND in case of NULL pointers or empty `needle`.
+ */
+XTR_API size_t
+xtr_index_occurrences(const xtr_index_t* index, const xtr_t* needle);
+
+/**
+ * Searches for the first occurrence of a substring in the indexed text.
+ *
+ * The occurrences are found in `O(len(needle) * log(len(text)))`, then
+ * scanned for the lowest index: use xtr_index_contains() if the index is
+ * not needed.
+ *
+ * @param [in] index suffix array index of the text to search in
+ * @param [in] needle pattern to search for
+ * @return index of the first occurrence or #XTR_NOT_FOUND if not found.
+ *         #XTR_NOT_FOUND is also returned in case of NULL pointers or
+ *         empty `needle`.
+ */
+XTR_API size_t
+xtr_index_find(const xtr_index_t* index, const xtr_t* needle);
+
+/**
+ * Searches for all occurrences of a substring in the indexed text,
+ * overlapping ones included.
+ *
+ * @param [out] amount of found occurrences, i.e. length of the returned array
+ * @param [in] index suffix array index of the text to search in
+ * @param [in] needle pattern to search for
+ * @return sorted array of the indices of the occurrences, to be freed with
+ *         free() (#XTR_FREE) after usage, even when empty. NULL in case of
+ *         NULL pointers, empty `needle` or malloc failure.
+ */
+XTR_API size_t*
+xtr_index_find_all(size_t* amount, const xtr_index_t* index, const xtr_t* needle);
+
+/**
+ * Searches for the longest substring appearing at least twice in the
+ * indexed text, possibly overlapping, from the LCP array in linear time.
+ *
+ * @param [in] index suffix array index of the text to search in
+ * @param [out] length amount of bytes of the repeated substring, 0 if none.
+ *              May be NULL if not needed.
+ * @return index of one of its occurrences or #XTR_NOT_FOUND if no byte
+ *         is repeated or `index` is NULL.
+ */
+XTR_API size_t
+xtr_index_longest_repeat(const xtr_index_t* index, size_t* length);
+
+// ------------------- Search in streams of chunks ------------------------------------
+/**
+ * Allocates a searcher of a compiled pattern in a stream of chunks.
+ *
+ * Example:
+ *         xtr_stream_search_t* search = xtr_stream_search_new(pattern);
+ *         while (receive(&chunk))
+ *         {
+ *             xtr_stream_search_feed(search, chunk);
+ *             size_t offset;
+ *             while ((offset = xtr_stream_search_next(search)) != XTR_NOT_FOUND)
+ *             {
+ *                 // ... occurrence at `offset` bytes from the stream start
+ *             }
+ *         }
+ *         xtr_stream_search_free(&search);
+ *
+ * @param [in] pattern compiled needle to search for. Not copied: it must
+ *        outlive the searcher. The same pattern may be used by many searchers.
+ * @return the new searcher or NULL in case of malloc failure or NULL `pattern`.
+ */
+XTR_API xtr_stream_search_t*
+xtr_stream_search_new(const xtr_pattern_t* pattern);
+
+/**
+ * Frees the stream searcher after usage and sets the pointer
+ * to NULL to avoid use-after-free.
+ *
+ * @param [in,out] psearch **address** of the searcher-pointer.
+ */
+XTR_API void
+xtr_stream_search_free(xtr_stream_search_t** psearch);
+
+/**
+ * Restarts the searcher for a new stream, forgetting the carried-over bytes.
+ *
+ * @param [in,out] search stream searcher. Does nothing on NULL input.
+ */
+XTR_API void
+xtr_stream_search_reset(xtr_stream_search_t* search);
+
+/**
+ * Appends the next chunk of the stream to search in.
+ *
+ * The chunk is not copied: it must not be altered or freed until
+ * xtr_stream_search_next() returns #XTR_NOT_FOUND, which means that the
+ * chunk is completely searched. Feeding a new chunk before that skips the
+ * remaining occurrences in the current one.
+ *
+ * @param [in,out] search stream searcher. Does nothing on NULL input.
+ * @param [in] chunk next part of the stream. Does nothing on NULL input.
+ */
+XTR_API void
+xtr_stream_search_feed(xtr_stream_search_t* search, const xtr_t* chunk);
+
+/**
+ * Searches for the next occurrence of the pattern in the stream.
+ *
+ * Occurrences do not overlap, as in xtr_occurrences(), and may start in
+ * previously fed chunks when they straddle the chunk boundaries.
+ *
+ * @param [in,out] search stream searcher
+ * @return offset of the occurrence from the start of the stream, i.e. the
+ *         amount of stream bytes before it, or #XTR_NOT_FOUND when the last
+ *         fed chunk has no further occurrences (or on NULL input).
+ */
+XTR_API size_t
+xtr_stream_search_next(xtr_stream_search_t* search);
+
+// ------------------- Search with multiple threads ------------------------------------
+
+/**
+ * Counts how many times a substring appears in the xtring, splitting the
+ * search among multiple threads.
+ *
+ * Same result as xtr_occurrences(): occurrences do not overlap.
+ * The haystack is split into ranges of at least #XTR_PARALLEL_MIN_LEN bytes,
+ * so smaller haystacks are searched serially. Searches serially also
+ * when #XTR_THREADS is disabled.
+ *
+ * @param [in] haystack xtring to search in.
+ * @param [in] needle pattern to search for (substring).
+ * @param [in] threads maximum amount of threads to use, including the
+ *             calling one; 0 for one per available processor.
+ * @return amount or #XTR_NOT_FOUND in case of malloc failure, NULL pointers
+ *         or empty `needle`. Zero if `needle` is too long to fit the `haystack`.
+ */
+XTR_API size_t
+xtr_occurrences_parallel(const xtr_t* haystack, const xtr_t* needle, size_t threads);
+
+/**
+ * Searches for all occurrences of a substring in the xtring, splitting the
+ * search among multiple threads.
+ *
+ * Same occurrences as xtr_occurrences() counts: they do not overlap.
+ * See xtr_occurrences_parallel() about the amount of threads.
+ *
+ * @param [out] amount of found occurrences, i.e. length of the returned array
+ * @param [in] haystack xtring to search in.
+ * @param [in] needle pattern to search for (substring).
+ * @param [in] threads maximum amount of threads to use, including the
+ *             calling one; 0 for one per available processor.
+ * @return sorted array of the indices of the occurrences, to be freed with
+ *         free() (#XTR_FREE) after usage, or NULL in case of NULL pointers,
+ *         empty `needle` or malloc failure.
+ */
+XTR_API size_t*
+xtr_find_all_parallel(size_t* amount,
+                      const xtr_t* haystack,
+                      const xtr_t* needle,
+                      size_t threads);
+
+// ------------------- Splitting ------------------------------------
+
+/**
+ * Splits the xtring into the chunks between the occurrences of a separator.
+ *
+ * Occurrences of the separator do not overlap, as in xtr_occurrences().
+ * Separators at the start or end of the xtring and consecutive ones
+ * produce empty chunks, e.g. splitting ",a,,b" on "," produces
+ * "", "a", "", "b". Without separators, the only chunk is a copy of `xtr`.
+ *
+ * @param [out] amount_of_chunks length of the returned array
+ * @param [in] xtr xtring to split
+ * @param [in] separator substring between the chunks, not included in them
+ * @return array of new xtrings, to be freed each with xtr_free() and the
+ *         array with free() (#XTR_FREE), or NULL in case of NULL pointers,
+ *         empty `separator` or malloc failure.
+ */
+XTR_API xtr_t**
+xtr_split(size_t* amount_of_chunks, const xtr_t* xtr, const xtr_t* separator);
+
+/**
+ * Splits the xtring into the chunks between the bytes of a set.
+ *
+ * Every byte in the set separates two chunks, so consecutive separators
+ * and separators at the start or end produce empty chunks, e.g.
+ * splitting "a, b" on set[", "] produces "a", "", "b".
+ *
+ * @param [out] amount_of_chunks length of the returned array
+ * @param [in] xtr xtring to split
+ * @param [in] separators set of bytes between the chunks, not included in them
+ * @return array of new xtrings, to be freed each with xtr_free() and the
+ *         array with free() (#XTR_FREE), or NULL in case of NULL pointers
+ *         or malloc failure.
+ */
+XTR_API xtr_t**
+xtr_split_any(size_t* amount_of_chunks, const xtr_t* xtr, const xtr_charset_t* separators);
+
+/**
+ * Like xtr_split(), writing views of the chunks into an array provided by
+ * the caller, without any allocation.
+ *
+ * Mimics `snprintf()`: returns the amount of chunks even when they do not
+ * all fit into the array, so passing NULL and 0 counts the chunks.
+ *
+ * @param [out] chunks array of views of the chunks in `xtr`, may be NULL
+ *        if `max_chunks` is 0
+ * @param [in] max_chunks length of the `chunks` array: the following
+ *        chunks are counted but not written
+ * @param [in] xtr xtring to split, which must outlive the views
+ * @param [in] separator substring between the chunks, not included in them
+ * @return total amount of chunks or #XTR_NOT_FOUND in case of NULL pointers
+ *         or empty `separator`.
+ */
+XTR_API size_t
+xtr_split_views_into(xtr_view_t* chunks,
+                     size_t max_chunks,
+                     const xtr_t* xtr,
+                     const xtr_t* separator);
+
+/**
+ * Like xtr_split(), returning views of the chunks in a single allocation.
+ *
+ * @param [out] amount_of_chunks length of the returned array
+ * @param [in] xtr xtring to split, which must outlive the views
+ * @param [in] separator substring between the chunks, not included in them
+ * @return array of views of the chunks in `xtr`, to be freed with free()
+ *         (#XTR_FREE), or NULL in case of NULL pointers, empty `separator`
+ *         or malloc failure.
+ */
+XTR_API xtr_view_t*
+xtr_split_views(size_t* amount_of_chunks, const xtr_t* xtr, const xtr_t* separator);
+
+/**
+ * Like xtr_split(), placing the array and all the chunks into a single
+ * allocation, freed at once.
+ *
+ * The chunks are xtrings with no free space, which can be used with
+ * any function not freeing nor reallocating them: they must not be freed
+ * individually with xtr_free() nor be extended with e.g. xtr_extend_tail().
+ * Clone a chunk with xtr_clone() to get an independent xtring.
+ *
+ * @param [out] amount_of_chunks length of the returned array
+ * @param [in] xtr xtring to split
+ * @param [in] separator substring between the chunks, not included in them
+ * @return array of the chunks, to be freed with free() (#XTR_FREE) only,
+ *         or NULL in case of NULL pointers, empty `separator` or malloc failure.
+ */
+XTR_API xtr_t**
+xtr_split_packed(size_t* amount_of_chunks, const xtr_t* xtr, const xtr_t* separator);
+
+/**
+ * Splits the xtring into chunks of the same length, except for the last
+ * one, which may be shorter.
+ *
+ * Example: splitting "abcdefg" every 3 bytes produces "abc", "def", "g".
+ *
+ * @param [out] amount_of_chunks length of the returned array, may be NULL
+ * @param [in] xtr xtring to split
+ * @param [in] chunk_len length of each chunk
+ * @return array of new xtrings, to be freed each with xtr_free() and the
+ *         array with free() (#XTR_FREE), or NULL in case of NULL or empty
+ *         `xtr`, zero `chunk_len` or malloc failure.
+ */
+XTR_API xtr_t**
+xtr_split_every(size_t* amount_of_chunks, const xtr_t* xtr, size_t chunk_len);
+
+/**
+ * Initialises an iterator over the chunks between the occurrences of a
+ * separator, the same chunks xtr_split() produces.
+ *
+ * Example, skipping to the third field without looking past it:
+ *
+ *         xtr_split_iter_t iter;
+ *         xtr_view_t field;
+ *         xtr_split_iter_init(&iter, line, comma);
+ *         for (size_t i = 0; i < 3 && xtr_split_next(&iter, &field); i++) {}
+ *
+ * @param [out] iter iterator to initialise, does nothing if NULL
+ * @param [in] xtr xtring to split, borrowed by the iterator
+ * @param [in] separator substring between the chunks, borrowed by the iterator.
+ *        The iterator yields no chunks if `xtr` is NULL or if `separator`
+ *        is NULL or empty.
+ */
+XTR_API void
+xtr_split_iter_init(xtr_split_iter_t* iter, const xtr_t* xtr, const xtr_t* separator);
+
+/**
+ * Initialises an iterator over the fixed-width chunks xtr_split_every()
+ * produces.
+ *
+ * @param [out] iter iterator to initialise, does nothing if NULL
+ * @param [in] xtr xtring to split, borrowed by the iterator
+ * @param [in] chunk_len length of each chunk, except for the shorter last one.
+ *        The iterator yields no chunks if `xtr` is NULL or empty or if
+ *        `chunk_len` is 0.
+ */
+XTR_API void
+xtr_split_iter_init_every(xtr_split_iter_t* iter, const xtr_t* xtr, size_t chunk_len);
+
+/**
+ * Yields the next chunk of an iterator, scanning just up to its end.
+ *
+ * @param [in,out] iter initialised iterator
+ * @param [out] chunk view of the next chunk in the xtring
+ * @return true if a chunk is written into `chunk`, false after the last
+ *         chunk, also for all following calls, or in case of NULL pointers.
+ */
+XTR_API bool
+xtr_split_next(xtr_split_iter_t* iter, xtr_view_t* chunk);
+
+// ------------------- Lines ------------------------------------
+/**
+ * Initialises an iterator over the lines of an xtring.
+ *
+ * Lines end with LF or CRLF, which are not part of them. A trailing
+ * newline does not start a further line, e.g. "a\n\nb\n" has the lines
+ * "a", "" and "b". A CR not followed by LF is part of the line, also at the
+ * end of the last one, e.g. "a\r" has the line "a\r". An empty xtring
+ * has no lines.
+ *
+ * @param [out] iter iterator to initialise, does nothing if NULL
+ * @param [in] xtr xtring to iterate over, borrowed by the iterator.
+ *        The iterator yields no lines if it is NULL.
+ */
+XTR_API void
+xtr_line_iter_init(xtr_line_iter_t* iter, const xtr_t* xtr);
+
+/**
+ * Yields the next line of an iterator.
+ *
+ * Scans 64 bytes at a time for newlines, with SIMD when available, and
+ * remembers those found, so each line costs O(1) plus its length / 64.
+ *
+ * @param [in,out] iter initialised iterator
+ * @param [out] line view of the next line, without its line ending
+ * @return true if a line is written into `line`, false after the last
+ *         line, also for all following calls, or in case of NULL pointers.
+ */
+XTR_API bool
+xtr_line_next(xtr_line_iter_t* iter, xtr_view_t* line);
+
+/**
+ * Builds the index of the line starts of a text, with the same lines
+ * xtr_line_next() yields.
+ *
+ * @param [in] text text to index, borrowed by the index: it must outlive the
+ *        index and not be modified
+ * @return the index or NULL in case of NULL `text` or malloc failure.
+ */
+XTR_API xtr_line_index_t*
+xtr_line_index_new(const xtr_t* text);
+
+/**
+ * Frees the index and sets its pointer to NULL.
+ *
+ * @param [in, out] pindex pointer to the index to free. Does nothing on NULL.
+ */
+XTR_API void
+xtr_line_index_free(xtr_line_index_t** pindex);
+
+/**
+ * Amount of lines of the indexed text.
+ *
+ * @param [in] index line index
+ * @return amount of lines, 0 if `index` is NULL.
+ */
+XTR_API size_t
+xtr_line_index_lines(const xtr_line_index_t* index);
+
+/**
+ * Index in the text of the first byte of a line, in O(1).
+ *
+ * @param [in] index line index
+ * @param [in] line index of the line, from 0
+ * @return offset of the line or #XTR_NOT_FOUND if `index` is NULL or `line`
+ *         is out of range.
+ */
+XTR_API size_t
+xtr_line_index_offset(const xtr_line_index_t* index, size_t line);
+
+/**
+ * Line containing a byte of the text, in O(log(lines)).
+ *
+ * The newline ending a line belongs to it.
+ *
+ * @param [in] index line index
+ * @param [in] offset index of the byte in the text
+ * @return index of the line or #XTR_NOT_FOUND if `index` is NULL or `offset`
+ *         is out of the text.
+ */
+XTR_API size_t
+xtr_line_index_line_at(const xtr_line_index_t* index, size_t offset);
+
+/**
+ * View of a line of the text, in O(1).
+ *
+ * @param [out] view where to store the view of the line without its line
+ *        ending, a NULL view on failure. NULL does nothing.
+ * @param [in] index line index
+ * @param [in] line index of the line, from 0
+ * @return true on success, false if `view` or `index` is NULL or `line` is
+ *         out of range.
+ */
+XTR_API bool
+xtr_line_index_line(xtr_view_t* view, const xtr_line_index_t* index, size_t line);
+
+// ------------------- CSV parsing ------------------------------------
+/**
+ * Allocates a CSV tokenizer for a dialect, e.g. `','` and `'"'` for CSV
+ * or `'\t'` and `'"'` for TSV.
+ *
+ * Fields are separated by the separator byte, records by newlines, either
+ * LF or CRLF. A field starting and ending with the quote byte is quoted:
+ * separators and newlines within it are part of the field and a quote within
+ * it is escaped by doubling it, as in RFC 4180.
+ *
+ * @param [in] separator byte between the fields of a record
+ * @param [in] quote byte around quoted fields
+ * @return the tokenizer or NULL in case of malloc failure or if the bytes
+ *         are equal or are a line ending.
+ */
+XTR_API xtr_csv_t*
+xtr_csv_new(uint8_t separator, uint8_t quote);
+
+/**
+ * Frees the tokenizer and sets its pointer to NULL.
+ *
+ * @param [in, out] pcsv pointer to the tokenizer to free. Does nothing on NULL.
+ */
+XTR_API void
+xtr_csv_free(xtr_csv_t** pcsv);
+
+/**
+ * Finds all records and fields of a text, replacing those of the previous one.
+ *
+ * Scans 64 bytes at a time, with SIMD when available: the bytes within quotes
+ * are masked out of the separators and newlines with a prefix xor of the
+ * quotes, so the runtime does not depend on the amount of quoted fields.
+ * Nothing is copied: the fields are then accessed as views of the text,
+ * which must outlive the tokenizer's use and not be modified.
+ *
+ * Empty lines are records with a single empty field. A trailing newline
+ * does not start a further record.
+ *
+ * @param [in, out] csv tokenizer to store the fields in
+ * @param [in] text CSV content, borrowed until the next parsing
+ * @return true on success, false in case of NULL pointers, malloc failure
+ *         or a quoted field left open at the end of the text. On failure
+ *         the tokenizer holds no records.
+ */
+XTR_API bool
+xtr_csv_parse(xtr_csv_t* csv, const xtr_t* text);
+
+/**
+ * Amount of records found by the last parsing.
+ *
+ * @param [in] csv tokenizer
+ * @return amount of records, 0 if `csv` is NULL.
+ */
+XTR_API size_t
+xtr_csv_records(const xtr_csv_t* csv);
+
+/**
+ * Amount of fields of a record found by the last parsing.
+ *
+ * @param [in] csv tokenizer
+ * @param [in] record index of the record
+ * @return amount of fields, at least 1, or 0 if `csv` is NULL or `record`
+ *         is out of range.
+ */
+XTR_API size_t
+xtr_csv_fields(const xtr_csv_t* csv, size_t record);
+
+/**
+ * View of a field in the parsed text, without the quotes around a quoted
+ * field: doubled quotes within it are left as they are.
+ *
+ * @param [out] view where to store the view of the field, a NULL view on
+ *        failure. NULL does nothing.
+ * @param [in] csv tokenizer
+ * @param [in] record index of the record
+ * @param [in] field index of the field within the record
+ * @return true on success, false if `view` or `csv` is NULL or the indices
+ *         are out of range.
+ */
+XTR_API bool
+xtr_csv_field(xtr_view_t* view, const xtr_csv_t* csv, size_t record, size_t field);
+
+/**
+ * Copy of a field in the parsed text, without the quotes around a quoted
+ * field and with its doubled quotes collapsed into one.
+ *
+ * @param [in] csv tokenizer
+ * @param [in] record index of the record
+ * @param [in] field index of the field within the record
+ * @return new xtring or NULL if `csv` is NULL, the indices are out of range
+ *         or in case of malloc failure.
+ */
+XTR_API xtr_t*
+xtr_csv_field_unescaped(const xtr_csv_t* csv, size_t record, size_t field);
+
+// ------------------- Concatenation ------------------------------------
+/**
+ * Concatenates two xtrings into a third one.
+ *
+ * Can be also used to concatenate `a` with itself.
+ * @param [in] a first half.
+ * @param [in] b second half. May also be `a`.
+ * @return the new xtring containing `a+b` or NULL in case of malloc failure,
+ *         NULL inputs or size overflow.
+ */
+XTR_API xtr_t*
+xtr_concat(const xtr_t* a, const xtr_t* b);
+
+/**
+ * New xtring with the content repeated `repetition` times.
+ *
+ * Does not reserve any additional capacity for expansions.
+ * @param [in] xtr xtring to repeat.
+ * @param [in] repetitions amount of times to repeat `xtr`. `0` for an empty xtring.
+ * @return the new xtring or NULL in case of malloc failure.
+ */
+XTR_API xtr_t*
+xtr_repeated(const xtr_t* xtr, size_t repetitions);
+
+// ------------------- Appending ------------------------------------
+
+/**
+ * Appends the extension to the existing xtring's start, if there is enough capacity.
+ * Otherwise does nothing.
+ *
+ * If there is some capacity but not enough for the
+ * full extension, it also does nothing - no partial copy is performed.
+ *
+ * O(length of the extension) when the bytes removed from the head by
+ * xtr_truncate_head() and similar leave enough room before the content.
+ * Otherwise the content is moved once, leaving half of the free space before
+ * it for the following pushes.
+ *
+ * @param [in,out] xtr xtring to extend
+ *        Left unaltered if shared, see xtr_push_head_cow().
+ * @param [in] extension xtring to add as extension
+ * @return Amount of bytes extended. Zero if any pointer is NULL or if `xtr` has not
+ *         enough space for the full extension or is shared.
+ */
+XTR_API size_t
+xtr_push_head(xtr_t* xtr, const xtr_t* extension);
+
+/**
+ * Like xtr_push_head(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy with the same capacity, which is then altered.
+ * @param [in,out] pxtr pointer to the xtring to extend. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] extension xtring to add as extension
+ * @return same as xtr_push_head(), zero also in case of malloc failure of the copy
+ *         or when `pxtr` or `*pxtr` is NULL.
+ */
+XTR_API size_t
+xtr_push_head_cow(xtr_t** pxtr, const xtr_t* extension);
+
+/**
+ * Appends the extension to the existing xtring's end, if there is enough capacity.
+ * Otherwise does nothing.
+ *
+ * If there is some capacity but not enough for the
+ * full extension, it also does nothing - no partial copy is performed.
+ * The room freed at the start by xtr_truncate_head() and similar counts as
+ * capacity: the content is moved back to the start when needed.
+ *
+ * @param [in,out] xtr xtring to extend
+ *        Left unaltered if shared, see xtr_push_tail_cow().
+ * @param [in] extension xtring to add as extension
+ * @return Amount of bytes extended. Zero if any pointer is NULL or if `xtr` has not
+ *         enough space for the full extension or is shared.
+ */
+XTR_API size_t
+xtr_push_tail(xtr_t* xtr, const xtr_t* extension);
+
+/**
+ * Like xtr_push_tail(), but copies the xtring on write if it is shared.
+ *
+ * A shared xtring is left to its other owners: the caller's reference is
+ * released and replaced by a copy with the same capacity, which is then altered.
+ * @param [in,out] pxtr pointer to the xtring to extend. Pointed xtr_t* is
+ *        replaced by the copy, if one is needed. Untouched on failure.
+ * @param [in] extension xtring to add as extension
+ * @return same as xtr_push_tail(), zero also in case of malloc failure of the copy
+ *         or when `pxtr` or `*pxtr` is NULL.
+ */
+XTR_API size_t
+xtr_push_tail_cow(xtr_t** pxtr, const xtr_t* extension);
+
+/**
+ * Growth policy used by xtr_extend_head() and xtr_extend_tail().
+ *
+ * Initially doubles the needed length without a slack bound, rounding the
+ * allocation to 16 bytes.
+ * @param [out] growth where to store the current global growth policy.
+ *        NULL does nothing.
+ */
+XTR_API void
+xtr_growth(xtr_growth_t* growth);
+
+/**
+ * Replaces the growth policy used by xtr_extend_head() and xtr_extend_tail().
+ *
+ * Not thread-safe: set it before other threads use the library.
+ * @param [in] growth new global growth policy.
+ */
+XTR_API void
+xtr_set_growth(xtr_growth_t growth);
+
+/**
+ * Appends the extension to the existing xtring's start, reallocating the xtring
+ * if necessary, freeing the old one.
+ *
+ * A reallocation follows the growth policy set with xtr_set_growth(), placing
+ * the spare room before the content for the following prepends.
+ *
+ * @param [in,out] pxtr pointer to the original xtring to extend. Pointed xtr_t*
+ *        will be replaced by a larger copy, if a reallocation happens.
+ *        Frees the previous xtring. Untouched on failure.
+ * @param [in] extension xtring to add as extension
+ * @return the new xtring or NULL in case of malloc failure or when `pxtr` or `*pxtr` is NULL.
+ *         Note: on success the returned value matches `*pxtr`. On failure the
+ *         returned value is NULL and *pxtr is unchanged.
+ */
+XTR_API xtr_t*
+xtr_extend_head(xtr_t** pxtr, const xtr_t* extension);
+
+/**
+ * Appends the extension to the existing xtring's end, reallocating the xtring
+ * if necessary, freeing the old one.
+ *
+ * A reallocation follows the growth policy set with xtr_set_growth(), placing
+ * the spare room after the content for the following appends. Amortised
+ * O(length of the extension).
+ *
+ * @param [in,out] pxtr pointer to the original xtring to extend. Pointed xtr_t*
+ *        will be replaced by a larger copy, if a reallocation happens.
+ *        Frees the previous xtring. Untouched on failure.
+ * @param [in] extension xtring to add as extension
+ * @return the new xtring or NULL in case of malloc failure or when `pxtr` or `*pxtr` is NULL.
+ *         Note: on success the returned value matches `*pxtr`. On failure the
+ *         returned value is NULL and *pxtr is unchanged.
+ */
+XTR_API xtr_t*
+xtr_extend_tail(xtr_t** pxtr, const xtr_t* extension);
+
+/**
+ * Like xtr_extend_head() but with a per-call growth policy.
+ *
+ * @param [in,out] pxtr pointer to the original xtring to extend.
+ * @param [in] extension xtring to add as extension
+ * @param [in] growth capacity policy in case of reallocation. NULL for the global one.
+ * @return the new xtring or NULL in case of malloc failure or when `pxtr` or `*pxtr` is NULL.
+ */
+XTR_API xtr_t*
+xtr_extend_head_growth(xtr_t** pxtr, const xtr_t* extension, const xtr_growth_t* growth);
+
+/**
+ * Like xtr_extend_tail() but with a per-call growth policy.
+ *
+ * @param [in,out] pxtr pointer to the original xtring to extend.
+ * @param [in] extension xtring to add as extension
+ * @param [in] growth capacity policy in case of reallocation. NULL for the global one.
+ * @return the new xtring or NULL in case of malloc failure or when `pxtr` or `*pxtr` is NULL.
+ */
+XTR_API xtr_t*
+xtr_extend_tail_growth(xtr_t** pxtr, const xtr_t* extension, const xtr_growth_t* growth);
+
+// ------------------- Encoding ------------------------------------
+/**
+ * Converts a binary xtring to a hex string in ASCII encoding.
+ *
+ * Example: xtr[13, 1, 130] --> "0D0182"
+ *
+ * @param [in] bin xtring to convert to hex
+ * @param [in] upper true to use uppercase hex characters ABCDEF rather than abcdef
+ * @param [in] separator optional string to place between each byte. NULL or empty
+ *        string for no separator
+ * @return a new xtring with the hex characters in ASCII encoding or NULL in
+ *         case of malloc failure.
+ */
+XTR_API xtr_t*
+xtr_to_hex(const xtr_t* bin, bool upper, const char* separator);
+
+/**
+ * Converts a hexadeciaml text string in ASCII encoding to a binary xtring.
+ *
+ * Example: "0x0D 01 82" --> xtr[13, 1, 130]s
+ *
+ * Properties:
+ * - Ignores any whitespaces, comma, and underscores - typically used as byte
+ *   separators.
+ * - Ignores any `#` sign - typically used when expressing RGB colors as hex.
+ * - Ignores any `0x` or `0X` prefixes, even if they appear multiple times.
+ * - Case insensitive (A-F or a-f are both OK).
+ *
+ * @param [in] hex hexadecimal string (ASCII characters 0-9A-F)
+ * @param [in] len optional length of the hex string, if already known.
+ *             Pass #XTR_UNKNOWN_STRLEN otherwise: this function will run strlen() internally.
+ * @return a new xtring with the binary values or NULL in case of conversion failure (e.g.,
+ * non-hex character found) or malloc failure
+ */
+XTR_API xtr_t*
+xtr_from_hex(const char* hex, size_t len);
+
+XTR_API xtr_t*
+xtr_base64_decode(const xtr_t* b64_text);
+XTR_API xtr_t*
+xtr_base64_encode(const xtr_t* binary);
+
+// ------------------- Zero-copy views ------------------------------------
+/**
+ * View of the whole content of an xtring.
+ *
+ * @param [out] view where to store the view, a NULL view on failure.
+ *        NULL does nothing.
+ * @param [in] xtr xtring to view
+ * @return true on success, false if `view` or `xtr` is NULL.
+ */
+XTR_API bool
+xtr_view(xtr_view_t* view, const xtr_t* xtr);
+
+/**
+ * View of a section of an xtring.
+ *
+ * @param [out] view where to store the view, a NULL view on failure.
+ *        NULL does nothing.
+ * @param [in] xtr xtring to view
+ * @param [in] start index of the first byte of the view
+ * @param [in] len amount of bytes of the view. If it goes past the end of
+ *        `xtr`, the view ends at the end of `xtr`: pass `SIZE_MAX` to view
+ *        everything from `start` on.
+ * @return true on success, false if `view` or `xtr` is NULL or `start` is
+ *         greater than its length. A view at `start` equal to the length is
+ *         empty.
+ */
+XTR_API bool
+xtr_view_range(xtr_view_t* view, const xtr_t* xtr, size_t start, size_t len);
+
+/**
+ * View of a byte array.
+ *
+ * @param [out] view where to store the view, a NULL view on failure.
+ *        NULL does nothing.
+ * @param [in] bytes array to view, may be NULL
+ * @param [in] len amount of bytes of `bytes` to view
+ * @return true on success, false if `view` or `bytes` is NULL.
+ */
+XTR_API bool
+xtr_view_from_bytes(xtr_view_t* view, const uint8_t* bytes, size_t len);
+
+/**
+ * View of a C-string, excluding its null terminator.
+ *
+ * @param [out] view where to store the view, a NULL view on failure.
+ *        NULL does nothing.
+ * @param [in] str null-terminated string to view, may be NULL
+ * @return true on success, false if `view` or `str` is NULL.
+ */
+XTR_API bool
+xtr_view_from_str(xtr_view_t* view, const char* str);
+
+/**
+ * View of a section of another view, like xtr_view_range() does for xtrings.
+ *
+ * @param [out] sub where to store the section, a NULL view on failure.
+ *        NULL does nothing.
+ * @param [in] view view to take the section of
+ * @param [in] start index of the first byte of the section within `view`
+ * @param [in] len amount of bytes of the section, cut at the end of `view`
+ * @return true on success, false if `sub` is NULL, `view` is a NULL view or
+ *         `start` is greater than its length.
+ */
+XTR_API bool
+xtr_view_sub(xtr_view_t* sub, xtr_view_t view, size_t start, size_t len);
+
+/**
+ * Copies the viewed bytes into a new xtring, which does not depend on the
+ * viewed memory anymore.
+ *
+ * @param [in] view view to copy
+ * @return new xtring or NULL in case of a NULL view or malloc failure.
+ */
+XTR_API xtr_t*
+xtr_from_view(xtr_view_t view);
+
+/**
+ * Like xtr_is_empty() for views.
+ *
+ * @param [in] view view to inspect
+ * @return true if `view` has length 0, including the NULL view.
+ */
+XTR_API bool
+xtr_view_is_empty(xtr_view_t view);
+
+/**
+ * Like xtr_is_zeros() for views.
+ *
+ * @param [in] view view to inspect
+ * @return true if `view` contains only zeros, false otherwise or if empty.
+ */
+XTR_API bool
+xtr_view_is_zeros(xtr_view_t view);
+
+/**
+ * Like xtr_is_spaces() and the other classifiers, for views.
+ *
+ * @param [in] view view to inspect
+ * @return true if every byte of `view` is in the class, false otherwise
+ *         or if empty.
+ */
+XTR_API bool
+xtr_view_is_spaces(xtr_view_t view);
+XTR_API bool
+xtr_view_is_alpha(xtr_view_t view);
+XTR_API bool
+xtr_view_is_alphanum(xtr_view_t view);
+XTR_API bool
+xtr_view_is_digits(xtr_view_t view);
+XTR_API bool
+xtr_view_is_upper(xtr_view_t view);
+XTR_API bool
+xtr_view_is_lower(xtr_view_t view);
+XTR_API bool
+xtr_view_is_printable(xtr_view_t view);
+
+/**
+ * Like xtr_cmp() for views: NULL views behave like NULL xtrings.
+ *
+ * @param [in] a first view
+ * @param [in] b second view
+ * @return same values as xtr_cmp()
+ */
+XTR_API int
+xtr_view_cmp(xtr_view_t a, xtr_view_t b);
+
+/**
+ * Like xtr_is_equal() for views.
+ *
+ * @param [in] a first view
+ * @param [in] b second view
+ * @return true when both NULL or both have the same length and content.
+ */
+XTR_API bool
+xtr_view_is_equal(xtr_view_t a, xtr_view_t b);
+
+/**
+ * Like xtr_startswith() for views.
+ *
+ * @param [in] view view to check the beginning of
+ * @param [in] prefix to check whether matches `view`'s head
+ * @return true if `view` starts with `prefix` or if they are both NULL, false otherwise.
+ */
+XTR_API bool
+xtr_view_startswith(xtr_view_t view, xtr_view_t prefix);
+
+/**
+ * Like xtr_endswith() for views.
+ *
+ * @param [in] view view to check the end of
+ * @param [in] suffix to check whether matches `view`'s tail
+ * @return true if `view` ends with `suffix` or if they are both NULL, false otherwise.
+ */
+XTR_API bool
+xtr_view_endswith(xtr_view_t view, xtr_view_t suffix);
+
+/**
+ * Like xtr_find() for views.
+ *
+ * @param [in] haystack view to search in
+ * @param [in] needle pattern to search for
+ * @return index in `haystack` of the first occurrence or #XTR_NOT_FOUND if
+ *         not found, if any view is NULL or empty or if `needle` does not
+ *         fit into `haystack`.
+ */
+XTR_API size_t
+xtr_view_find(xtr_view_t haystack, xtr_view_t needle);
+
+/**
+ * Like xtr_rfind() for views.
+ *
+ * @param [in] haystack view to search in
+ * @param [in] needle pattern to search for
+ * @return index in `haystack` of the last occurrence or #XTR_NOT_FOUND,
+ *         in the same cases as xtr_view_find().
+ */
+XTR_API size_t
+xtr_view_rfind(xtr_view_t haystack, xtr_view_t needle);
+
+/**
+ * Like xtr_contains() for views.
+ *
+ * @param [in] haystack view to search in
+ * @param [in] needle pattern to search for
+ * @return true if the pattern is found, false otherwise.
+ */
+XTR_API bool
+xtr_view_contains(xtr_view_t haystack, xtr_view_t needle);
+
+/**
+ * Like xtr_to_hex() for views.
+ *
+ * @param [in] bin view to convert to hex
+ * @param [in] upper true to use uppercase hex characters ABCDEF rather than abcdef
+ * @param [in] separator optional string to place between each byte. NULL or empty
+ *        string for no separator
+ * @return a new xtring with the hex characters in ASCII encoding or NULL in
+ *         case of a NULL view or malloc failure.
+ */
+XTR_API xtr_t*
+xtr_view_to_hex(xtr_view_t bin, bool upper, const char* separator);
+
+/**
+ * Like xtr_base64_encode() for views.
+ *
+ * @param [in] binary view to encode
+ * @return a new xtring with the padded base64 text or NULL in case of a NULL
+ *         view or malloc failure.
+ */
+XTR_API xtr_t*
+xtr_view_base64_encode(xtr_view_t binary);
+
+// ------------------- Owning slices ------------------------------------
+/**
+ * Owning slice of a section of an xtring, sharing its buffer.
+ *
+ * O(1): no bytes are copied, the parent gains one owner instead.
+ * While the slice exists the parent is shared, see xtr_share(): its owner
+ * alters it through the copy-on-write functions, like xtr_trim_cow().
+ * If the slice pins a much larger parent for long, use xtr_slice_compact().
+ *
+ * Example:
+ *         xtr_t* received = xtr_from_str("key=value");
+ *         xtr_slice_t key;
+ *         xtr_slice_shared(&key, received, 0U, 3U);
+ *         xtr_free(&received);  // "key" still valid, the buffer is alive
+ *         xtr_slice_free(&key);  // Buffer freed here
+ *
+ * @param [out] slice where to store the new slice, a NULL slice on failure.
+ *        NULL does nothing.
+ * @param [in] parent xtring to slice
+ * @param [in] start index of the first byte of the slice
+ * @param [in] len amount of bytes of the slice, cut at the end of `parent`,
+ *        as in xtr_view_range()
+ * @return true on success, false if `slice` or `parent` is NULL or `start` is
+ *         greater than the length of `parent`.
+ */
+XTR_API bool
+xtr_slice_shared(xtr_slice_t* slice, xtr_t* parent, size_t start, size_t len);
+
+/**
+ * Owning slice of a section of another slice, sharing the same parent.
+ *
+ * @param [out] sub where to store the new slice, a NULL slice on failure.
+ *        NULL does nothing. Must not be `slice` itself.
+ * @param [in] slice slice to take the section of
+ * @param [in] start index of the first byte of the section within `slice`
+ * @param [in] len amount of bytes of the section, cut at the end of `slice`
+ * @return true on success, false if `sub` or `slice` is NULL, `slice` is a
+ *         NULL slice or `start` is greater than its length.
+ */
+XTR_API bool
+xtr_slice_sub(xtr_slice_t* sub, const xtr_slice_t* slice, size_t start, size_t len);
+
+/**
+ * Releases the slice's reference to its parent and clears the slice.
+ *
+ * The parent is freed if this was its last owner.
+ *
+ * @param [in,out] slice slice to free, a NULL slice afterwards. May be NULL.
+ */
+XTR_API void
+xtr_slice_free(xtr_slice_t* slice);
+
+/**
+ * Removes `len` bytes from the slice start and returns them as a new slice
+ * of the same parent.
+ *
+ * Like xtr_pop_head(), but O(1) and without copies, as only the slices change.
+ *
+ * @param [out] popped where to store the new slice with the popped prefix,
+ *        a NULL slice on failure. NULL does nothing. Must not be `slice` itself.
+ * @param [in,out] slice slice to pop from, shortened in-place.
+ * @param [in] len amount of bytes to pop, cut at the length of `slice`.
+ * @return true on success, false if `popped` or `slice` is NULL or `slice`
+ *         is a NULL slice, which are then left untouched.
+ */
+XTR_API bool
+xtr_slice_pop_head(xtr_slice_t* popped, xtr_slice_t* slice, size_t len);
+
+/**
+ * Removes `len` bytes from the slice end and returns them as a new slice
+ * of the same parent.
+ *
+ * Like xtr_pop_tail(), but without copies, as only the slices change.
+ *
+ * @param [out] popped where to store the new slice with the popped suffix,
+ *        a NULL slice on failure. NULL does nothing. Must not be `slice` itself.
+ * @param [in,out] slice slice to pop from, shortened in-place.
+ * @param [in] len amount of bytes to pop, cut at the length of `slice`.
+ * @return true on success, false if `popped` or `slice` is NULL or `slice`
+ *         is a NULL slice, which are then left untouched.
+ */
+XTR_API bool
+xtr_slice_pop_tail(xtr_slice_t* popped, xtr_slice_t* slice, size_t len);
+
+/**
+ * Like xtr_split(), returning owning slices of the chunks instead of copies.
+ *
+ * Each slice holds its own reference to `xtr`, so they can be freed
+ * independently with xtr_slice_free() or all together with xtr_slices_free().
+ *
+ * @param [out] amount_of_chunks length of the returned array
+ * @param [in] xtr xtring to split, shared by the slices
+ * @param [in] separator substring between the chunks, not included in them
+ * @return array of slices, to be freed with xtr_slices_free(), or NULL in case
+ *         of NULL pointers, empty `separator` or malloc failure.
+ */
+XTR_API xtr_slice_t*
+xtr_split_slices(size_t* amount_of_chunks, xtr_t* xtr, const xtr_t* separator);
+
+/**
+ * Frees every slice of an array and the array itself, setting the array
+ * pointer to NULL.
+ *
+ * @param [in,out] pslices **address** of the array of slices. May be NULL.
+ * @param [in] amount length of the array
+ */
+XTR_API void
+xtr_slices_free(xtr_slice_t** pslices, size_t amount);
+
+/**
+ * Moves the slice's bytes into an exactly-sized private xtring, releasing
+ * the parent.
+ *
+ * For when a small slice would keep a large parent alive: the copy costs
+ * O(length of the slice) and frees the parent if this slice was its last owner.
+ * A slice already spanning its parent's whole buffer is left as it is.
+ *
+ * @param [in,out] slice slice to compact, untouched on failure.
+ * @return true on success, false in case of a NULL slice or malloc failure.
+ */
+XTR_API bool
+xtr_slice_compact(xtr_slice_t* slice);
+
+// ------------------- Ropes ------------------------------------
+/**
+ * New empty rope.
+ *
+ * @return the new rope or NULL in case of malloc failure.
+ */
+XTR_API xtr_rope_t*
+xtr_rope_new(void);
+
+/**
+ * Frees the rope and its pieces, setting the rope pointer to NULL.
+ *
+ * @param [in,out] prope **address** of the rope-pointer. May be NULL.
+ */
+XTR_API void
+xtr_rope_free(xtr_rope_t** prope);
+
+/**
+ * Total amount of bytes in the rope.
+ *
+ * @param [in] rope to measure
+ * @return the length in bytes, 0 if `rope` is NULL.
+ */
+XTR_API size_t
+xtr_rope_length(const xtr_rope_t* rope);
+
+/**
+ * Inserts a copy of an xtring at any offset of the rope.
+ *
+ * O(log n + m) for `m` bytes inserted. To insert without copying, see
+ * xtr_rope_insert_shared().
+ * Short adjacent pieces are merged, so many small insertions do not
+ * make a tree of single bytes.
+ *
+ * @param [in,out] rope to insert into, untouched on failure.
+ * @param [in] offset index of the rope before which to insert. `0` inserts at
+ *        the start, xtr_rope_length() at the end.
+ * @param [in] text xtring to insert
+ * @return true on success, false in case of NULL pointers, `offset` past the
+ *         end of the rope or malloc failure.
+ */
+XTR_API bool
+xtr_rope_insert(xtr_rope_t* rope, size_t offset, const xtr_t* text);
+
+/**
+ * Inserts an xtring at any offset of the rope without copying it, in O(log n).
+ *
+ * The rope holds a reference to `text` like xtr_share() does, so `text` is
+ * shared and read-only until the rope drops the inserted bytes or is freed.
+ *
+ * @param [in,out] rope to insert into, untouched on failure.
+ * @param [in] offset index of the rope before which to insert. `0` inserts at
+ *        the start, xtr_rope_length() at the end.
+ * @param [in] text xtring to insert, gaining the rope as owner
+ * @return true on success, false in case of NULL pointers, `offset` past the
+ *         end of the rope or malloc failure.
+ */
+XTR_API bool
+xtr_rope_insert_shared(xtr_rope_t* rope, size_t offset, xtr_t* text);
+
+/**
+ * Removes a section of the rope, in O(log n).
+ *
+ * @param [in,out] rope to delete from, untouched on failure.
+ * @param [in] offset index of the first byte to delete
+ * @param [in] len amount of bytes to delete, cut at the end of the rope
+ * @return true on success, false in case of NULL rope, `offset` past the end
+ *         of the rope or malloc failure.
+ */
+XTR_API bool
+xtr_rope_delete(xtr_rope_t* rope, size_t offset, size_t len);
+
+/**
+ * Appends the whole content of another rope, in O(log n), freeing it.
+ *
+ * @param [in,out] rope to append to, untouched on failure.
+ * @param [in,out] pother **address** of the rope to append, which is freed
+ *        and set to NULL on success. Untouched on failure.
+ * @return true on success, false in case of NULL pointers, `*pother` being the
+ *         same as `rope` or malloc failure.
+ */
+XTR_API bool
+xtr_rope_concat(xtr_rope_t* rope, xtr_rope_t** pother);
+
+/**
+ * Splits the rope in two at an offset, in O(log n).
+ *
+ * @param [in,out] rope to split, keeping the bytes before `offset`.
+ *        Untouched on failure.
+ * @param [in] offset index of the first byte to move into the new rope
+ * @return new rope with the bytes from `offset` on, or NULL in case of NULL
+ *         rope, `offset` past the end of the rope or malloc failure.
+ */
+XTR_API xtr_rope_t*
+xtr_rope_split(xtr_rope_t* rope, size_t offset);
+
+/**
+ * New xtring with the whole content of the rope, contiguous.
+ *
+ * @param [in] rope to copy
+ * @return the new xtring or NULL in case of NULL rope or malloc failure.
+ */
+XTR_API xtr_t*
+xtr_rope_flatten(const xtr_rope_t* rope);
+
+/**
+ * Initialises an iterator over the pieces of the rope, starting at an offset.
+ *
+ * Example:
+ *         xtr_rope_iter_t iter;
+ *         xtr_view_t piece;
+ *         xtr_rope_iter_init(&iter, rope, 0U);
+ *         while (xtr_rope_next(&iter, &piece))
+ *         {
+ *             fwrite(piece.bytes, 1U, piece.length, file);
+ *         }
+ *
+ * @param [out] iter iterator to initialise. May be NULL.
+ * @param [in] rope rope to iterate over. If NULL, the iterator yields nothing.
+ * @param [in] offset index of the first byte to yield
+ */
+XTR_API void
+xtr_rope_iter_init(xtr_rope_iter_t* iter, const xtr_rope_t* rope, size_t offset);
+
+/**
+ * Advances the iterator to the next contiguous piece of the rope.
+ *
+ * O(log n) per piece. The first piece starts at the initial offset and may
+ * thus be the end of a stored piece.
+ *
+ * @param [in,out] iter initialised iterator
+ * @param [out] piece view of the piece, not empty
+ * @return true if a piece was found, false at the end of the rope or in case
+ *         of NULL pointers.
+ */
+XTR_API bool
+xtr_rope_next(xtr_rope_iter_t* iter, xtr_view_t* piece);
+
+// ------------------- Gap buffers ------------------------------------
+/**
+ * Initialises a gap buffer taking over an xtring, with the cursor at its end.
+ *
+ * O(1): the xtring's allocation becomes the gap buffer's, with its available
+ * space as the gap. A shared xtring is copied first, see xtr_unshare().
+ *
+ * Example:
+ *         xtr_gapbuf_t gapbuf;
+ *         xtr_t* text = xtr_from_str("Hello!");
+ *         xtr_gapbuf_init(&gapbuf, &text);  // text is NULL now
+ *         xtr_gapbuf_move(&gapbuf, 5U);
+ *         xtr_view_t world;
+ *         xtr_view_from_str(&world, " world");
+ *         xtr_gapbuf_insert(&gapbuf, world);
+ *         text = xtr_gapbuf_to_xtr(&gapbuf);  // "Hello world!"
+ *
+ * @param [out] gapbuf gap buffer to initialise
+ * @param [in,out] pxtr **address** of the xtring to take over, set to NULL
+ *        on success. Untouched on failure.
+ * @return true on success, false in case of NULL pointers or malloc failure.
+ */
+XTR_API bool
+xtr_gapbuf_init(xtr_gapbuf_t* gapbuf, xtr_t** pxtr);
+
+/**
+ * Frees the text of a gap buffer.
+ *
+ * @param [in,out] gapbuf gap buffer to free. May be NULL.
+ */
+XTR_API void
+xtr_gapbuf_free(xtr_gapbuf_t* gapbuf);
+
+/**
+ * Closes the gap and hands the text back as an xtring, leaving the gap buffer
+ * freed.
+ *
+ * O(bytes after the cursor), thus O(1) when the cursor is at the end:
+ * the xtring is the same allocation, not a copy.
+ *
+ * @param [in,out] gapbuf gap buffer to convert
+ * @return the xtring with the whole text or NULL if `gapbuf` is NULL or freed.
+ */
+XTR_API xtr_t*
+xtr_gapbuf_to_xtr(xtr_gapbuf_t* gapbuf);
+
+/**
+ * Amount of bytes of text in the gap buffer, excluding the gap.
+ *
+ * @param [in] gapbuf gap buffer to measure
+ * @return the text length, 0 if `gapbuf` is NULL or freed.
+ */
+XTR_API size_t
+xtr_gapbuf_length(const xtr_gapbuf_t* gapbuf);
+
+/**
+ * Position of the cursor: the amount of bytes before it.
+ *
+ * @param [in] gapbuf gap buffer to check
+ * @return the cursor position, 0 if `gapbuf` is NULL or freed.
+ */
+XTR_API size_t
+xtr_gapbuf_cursor(const xtr_gapbuf_t* gapbuf);
+
+/**
+ * Moves the cursor, in O(distance moved).
+ *
+ * @param [in,out] gapbuf gap buffer whose cursor to move
+ * @param [in] position new position of the cursor, from `0` (before the
+ *        first byte) to xtr_gapbuf_length() (after the last one)
+ * @return true on success, false in case of NULL or freed `gapbuf` or
+ *         `position` past the end of the text.
+ */
+XTR_API bool
+xtr_gapbuf_move(xtr_gapbuf_t* gapbuf, size_t position);
+
+/**
+ * Inserts bytes at the cursor, placing the cursor after them.
+ *
+ * O(length of `text`) amortised: when the gap is too small, the allocation
+ * grows by at least its size, copying the text once.
+ *
+ * @param [in,out] gapbuf gap buffer to insert into, untouched on failure.
+ * @param [in] text bytes to insert, not pointing into the gap buffer itself
+ * @return true on success, false in case of NULL or freed `gapbuf`, NULL view,
+ *         size overflow or malloc failure.
+ */
+XTR_API bool
+xtr_gapbuf_insert(xtr_gapbuf_t* gapbuf, xtr_view_t text);
+
+/**
+ * Deletes bytes after the cursor, like the Delete key, in O(1).
+ *
+ * @param [in,out] gapbuf gap buffer to delete from
+ * @param [in] len amount of bytes to delete, cut at the end of the text
+ * @return amount of bytes deleted, 0 if `gapbuf` is NULL or freed.
+ */
+XTR_API size_t
+xtr_gapbuf_delete(xtr_gapbuf_t* gapbuf, size_t len);
+
+/**
+ * Deletes bytes before the cursor, like the Backspace key, in O(1).
+ *
+ * @param [in,out] gapbuf gap buffer to delete from
+ * @param [in] len amount of bytes to delete, cut at the start of the text
+ * @return amount of bytes deleted, 0 if `gapbuf` is NULL or freed.
+ */
+XTR_API size_t
+xtr_gapbuf_backspace(xtr_gapbuf_t* gapbuf, size_t len);
+
+/**
+ * View of the text before the cursor, valid until the next change.
+ *
+ * @param [out] view where to store the view of the bytes before the cursor,
+ *        a NULL view on failure. NULL does nothing.
+ * @param [in] gapbuf gap buffer to view
+ * @return true on success, false if `view` or `gapbuf` is NULL or `gapbuf`
+ *         is freed.
+ */
+XTR_API bool
+xtr_gapbuf_before(xtr_view_t* view, const xtr_gapbuf_t* gapbuf);
+
+/**
+ * View of the text after the cursor, valid until the next change.
+ *
+ * @param [out] view where to store the view of the bytes after the cursor,
+ *        a NULL view on failure. NULL does nothing.
+ * @param [in] gapbuf gap buffer to view
+ * @return true on success, false if `view` or `gapbuf` is NULL or `gapbuf`
+ *         is freed.
+ */
+XTR_API bool
+xtr_gapbuf_after(xtr_view_t* view, const xtr_gapbuf_t* gapbuf);
 
 // ------------------- Utils ------------------------------------
 XTR_API const char*
@@ -0,0 +1,491 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+/** @internal Bits per bit-vector word, i.e. needle bytes per block. */
+#define APPROX_WORD_BITS 64U
+/** @internal Initial band half-width of xtr_edit_distance(), doubled as needed. */
+#define APPROX_MIN_BAND 64U
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/** @internal State of a block of 64 rows of the column. */
+typedef struct
+{
+    /** Rows where the distance grows or shrinks by 1 from the row above. */
+    uint64_t pv;
+    uint64_t mv;
+    /** Distance at the last row of the block. */
+    uint64_t score;
+} approx_block_t;
+
+/**
+ * @internal
+ * Bit vectors of Myers' algorithm for one needle, the column of the
+ * dynamic programming matrix split into blocks of 64 rows.
+ */
+typedef struct
+{
+    /** Length of the needle, i.e. rows of the matrix. */
+    size_t len;
+    /** Amount of blocks. */
+    size_t words;
+    /** Bit of the last row within the last block. */
+    uint64_t last_high;
+    /** Match masks: `words` of them per entry of `rows`, entry 0 all clear. */
+    uint64_t* peq;
+    approx_block_t* blocks;
+    /** Heap memory of the vectors, NULL if stored locally. */
+    void* allocated;
+    /** Entry in `peq` of the masks of each byte, 0 if not in the needle.
+     * Needles of a single block have one entry per byte instead. */
+    uint16_t rows[256];
+    /** Storage of needles of a single block, avoiding the allocation. */
+    uint64_t local_peq[256];
+    approx_block_t local_block;
+} approx_t;
+#pragma clang diagnostic pop
+
+/**
+ * @internal
+ * Builds the match masks of a needle, optionally reversed.
+ *
+ * @return false in case of malloc failure
+ */
+static bool
+approx_init(approx_t* const v, const uint8_t* const needle, const size_t len, const bool reversed)
+{
+    v->len = len;
+    v->words = (len + APPROX_WORD_BITS - 1U) / APPROX_WORD_BITS;
+    v->last_high = UINT64_C(1) << ((len - 1U) % APPROX_WORD_BITS);
+    v->allocated = NULL;
+    size_t entries = 256U;
+    if (v->words == 1U)
+    {
+        for (size_t byte = 0U; byte < 256U; byte++)
+        {
+            v->rows[byte] = (uint16_t) byte;
+        }
+        v->peq = v->local_peq;
+        v->blocks = &v->local_block;
+    }
+    else
+    {
+        memset(v->rows, 0, sizeof(v->rows));
+        entries = 1U;
+        for (size_t i = 0U; i < len; i++)
+        {
+            if (v->rows[needle[i]] == 0U)
+            {
+                v->rows[needle[i]] = (uint16_t) entries++;
+            }
+        }
+        if (v->words > SIZE_MAX / (sizeof(approx_block_t) + entries * sizeof(uint64_t)))
+        {
+            return false;
+        }
+        v->allocated =
+            XTR_MALLOC(v->words * (sizeof(approx_block_t) + entries * sizeof(uint64_t)));
+        if (v->allocated == NULL)
+        {
+            return false;
+        }
+        v->blocks = v->allocated;
+        v->peq = (uint64_t*) (v->blocks + v->words);
+    }
+    memset(v->peq, 0, entries * v->words * sizeof(uint64_t));
+    for (size_t i = 0U; i < len; i++)
+    {
+        const uint8_t byte = reversed ? needle[len - 1U - i] : needle[i];
+        v->peq[v->rows[byte] * v->words + i / APPROX_WORD_BITS] |=
+            UINT64_C(1) << (i % APPROX_WORD_BITS);
+    }
+    return true;
+}
+
+/** @internal Amount of rows of a block: 64 except for the last one. */
+static size_t
+approx_block_rows(const approx_t* const v, const size_t block)
+{
+    return block + 1U < v->words ? APPROX_WORD_BITS : v->len - block * APPROX_WORD_BITS;
+}
+
+/**
+ * @internal
+ * Resets a block to the distances of an empty haystack: growing by 1 per row,
+ * starting from `above`, the distance at the row before the block.
+ */
+static void
+approx_block_reset(approx_t* const v, const size_t block, const uint64_t above)
+{
+    v->blocks[block].pv = UINT64_MAX;
+    v->blocks[block].mv = 0U;
+    v->blocks[block].score = above + approx_block_rows(v, block);
+}
+
+/**
+ * @internal
+ * Advances a block by one haystack byte (Myers 1999, figure 9).
+ *
+ * @param [in,out] block state of the block
+ * @param [in] eq match mask of the byte in this block
+ * @param [in] hin horizontal delta at the row before the block: -1, 0 or +1
+ * @param [in] high bit of the last row of the block
+ * @return horizontal delta at the last row of the block: -1, 0 or +1
+ */
+XTR_INLINE static int
+approx_advance(approx_block_t* const block, uint64_t eq, const int hin, const uint64_t high)
+{
+    // Branchless: the carries between blocks are unpredictable
+    const uint64_t hin_pos = (uint64_t) (hin > 0);
+    const uint64_t hin_neg = (uint64_t) (hin < 0);
+    const uint64_t pv = block->pv;
+    const uint64_t mv = block->mv;
+    const uint64_t xv = eq | mv;
+    eq |= hin_neg;
+    const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    const uint64_t hout_pos = (uint64_t) ((ph & high) != 0U);
+    const uint64_t hout_neg = (uint64_t) ((mh & high) != 0U);
+    ph = (ph << 1U) | hin_pos;
+    mh = (mh << 1U) | hin_neg;
+    block->pv = mh | ~(xv | ph);
+    block->mv = ph & xv;
+    block->score = block->score + hout_pos - hout_neg;
+    return (int) hout_pos - (int) hout_neg;
+}
+
+/**
+ * @internal
+ * Advances all blocks from `first` to `last` by one haystack byte.
+ *
+ * @return horizontal delta at the last row of block `last`
+ */
+XTR_INLINE static int
+approx_advance_blocks(approx_t* const v,
+                      const uint64_t* const eq,
+                      const size_t first,
+                      const size_t last,
+                      int carry)
+{
+    approx_block_t* const blocks = v->blocks;
+    const size_t full = XTR_MIN(last + 1U, v->words - 1U);
+    size_t block = first;
+    for (; block < full; block++)
+    {
+        carry = approx_advance(&blocks[block], eq[block], carry, UINT64_C(1) << 63U);
+    }
+    if (block == last)
+    {
+        carry = approx_advance(&blocks[block], eq[block], carry, v->last_high);
+    }
+    return carry;
+}
+
+/**
+ * @internal
+ * Finds the end of the first approximate occurrence of a needle of a
+ * single block, as approx_search_end() does, keeping the vectors in
+ * registers.
+ */
+static size_t
+approx_search_end_single(const approx_t* const v,
+                         const uint8_t* const text,
+                         const size_t len,
+                         const size_t max_edits)
+{
+    const uint64_t* const peq = v->peq;
+    const uint64_t high = v->last_high;
+    uint64_t pv = UINT64_MAX;
+    uint64_t mv = 0U;
+    uint64_t score = v->len;
+    uint64_t best = (uint64_t) max_edits + 1U;
+    size_t end = XTR_NOT_FOUND;
+    for (size_t i = 0U; i < len; i++)
+    {
+        const uint64_t eq = peq[text[i]];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        const uint64_t ph = mv | ~(xh | pv);
+        const uint64_t mh = pv & xh;
+        score = score + (uint64_t) ((ph & high) != 0U) - (uint64_t) ((mh & high) != 0U);
+        const uint64_t ph_shifted = ph << 1U;
+        pv = (mh << 1U) | ~(xv | ph_shifted);
+        mv = ph_shifted & xv;
+        if (score < best)
+        {
+            best = score;
+            end = i + 1U;
+        }
+        else if (end != XTR_NOT_FOUND)
+        {
+            break;
+        }
+    }
+    return end;
+}
+
+/**
+ * @internal
+ * Finds where the first approximate occurrence ends: the first index where
+ * the distance to the needle drops within `max_edits`, moved forward as long
+ * as the distance keeps decreasing.
+ *
+ * Only the blocks up to the last one with distances within `max_edits` are
+ * advanced (Ukkonen's cut-off), the others holding larger distances anyway.
+ *
+ * @param [in,out] v bit vectors of the needle, longer than `max_edits`
+ * @return index after the end of the occurrence, #XTR_NOT_FOUND if none
+ */
+static size_t
+approx_search_end(approx_t* const v,
+                  const uint8_t* const text,
+                  const size_t len,
+                  const size_t max_edits)
+{
+    if (v->words == 1U)
+    {
+        return approx_search_end_single(v, text, len, max_edits);
+    }
+    const uint64_t k = max_edits;
+    const size_t last = v->words - 1U;
+    approx_block_t* const blocks = v->blocks;
+    size_t y = XTR_MIN(last, max_edits / APPROX_WORD_BITS);
+    for (size_t block = 0U; block <= y; block++)
+    {
+        approx_block_reset(v, block, block * APPROX_WORD_BITS);
+    }
+    size_t end = XTR_NOT_FOUND;
+    uint64_t best = k + 1U;
+    for (size_t i = 0U; i < len; i++)
+    {
+        const uint64_t* const eq = &v->peq[v->rows[text[i]] * v->words];
+        const int carry = approx_advance_blocks(v, eq, 0U, y, 0);
+        if (y < last && blocks[y].score + (uint64_t) (carry < 0) <= k + (uint64_t) (carry > 0) &&
+            ((eq[y + 1U] & 1U) != 0U || carry < 0))
+        {
+            y++;
+            // Distances of the new block before this byte
+            approx_block_reset(
+                v, y, blocks[y - 1U].score - (uint64_t) (carry > 0) + (uint64_t) (carry < 0));
+            approx_advance_blocks(v, eq, y, y, carry);
+        }
+        else
+        {
+            while (y > 0U && blocks[y].score >= k + approx_block_rows(v, y))
+            {
+                y--;
+            }
+        }
+        if (y == last && blocks[last].score < best)
+        {
+            best = blocks[last].score;
+            end = i + 1U;
+        }
+        else if (end != XTR_NOT_FOUND)
+        {
+            break;
+        }
+    }
+    return end;
+}
+
+/**
+ * @internal
+ * Finds where the approximate occurrence ending at `end` starts, running the
+ * reversed needle backwards from `end`.
+ *
+ * @param [in,out] v bit vectors of the reversed needle
+ * @return lowest index where the occurrence with the fewest edits starts
+ */
+static size_t
+approx_search_start(approx_t* const v,
+                    const uint8_t* const text,
+                    const size_t end,
+                    const size_t max_edits)
+{
+    for (size_t block = 0U; block < v->words; block++)
+    {
+        approx_block_reset(v, block, block * APPROX_WORD_BITS);
+    }
+    const size_t last = v->words - 1U;
+    const size_t longest = XTR_MIN(end, v->len + max_edits);
+    uint64_t best = v->blocks[last].score;
+    size_t best_len = 0U;
+    for (size_t i = 1U; i <= longest; i++)
+    {
+        const uint64_t* const eq = &v->peq[v->rows[text[end - i]] * v->words];
+        // Anchored at `end`: the distance of the row before the needle grows
+        approx_advance_blocks(v, eq, 0U, last, 1);
+        if (v->blocks[last].score <= best)
+        {
+            best = v->blocks[last].score;
+            best_len = i;
+        }
+    }
+    return end - best_len;
+}
+
+XTR_API size_t
+xtr_find_approx(const xtr_t* const haystack,
+                const xtr_t* const needle,
+                const size_t max_edits,
+                size_t* const length)
+{
+    if (length != NULL)
+    {
+        *length = 0U;
+    }
+    if (haystack == NULL || needle == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    if (needle->used <= max_edits)
+    {
+        return 0U;  // Deleting the whole needle is enough
+    }
+    approx_t v;
+    if (!approx_init(&v, needle->buffer, needle->used, false))
+    {
+        return XTR_NOT_FOUND;
+    }
+    const size_t end = approx_search_end(&v, haystack->buffer, haystack->used, max_edits);
+    XTR_FREE(v.allocated);
+    if (end == XTR_NOT_FOUND)
+    {
+        return XTR_NOT_FOUND;
+    }
+    if (!approx_init(&v, needle->buffer, needle->used, true))
+    {
+        return XTR_NOT_FOUND;
+    }
+    const size_t start = approx_search_start(&v, haystack->buffer, end, max_edits);
+    XTR_FREE(v.allocated);
+    if (length != NULL)
+    {
+        *length = end - start;
+    }
+    return start;
+}
+
+/**
+ * @internal
+ * Computes the edit distance between the needle and the text, if at most
+ * `band`, advancing only the blocks of rows within `band` of the diagonal of
+ * each column. Longer text than needle.
+ *
+ * Blocks entering the band start from overestimated distances and the ones
+ * leaving it are replaced by distances growing at each byte: both only alter
+ * distances larger than `band`, never underestimating them.
+ *
+ * @param [in,out] v bit vectors of the needle, not longer than the text
+ * @param [in] band at least the difference of the lengths
+ * @return the edit distance if at most `band`, otherwise an upper bound of it
+ */
+static size_t
+approx_banded_distance(approx_t* const v,
+                       const uint8_t* const text,
+                       const size_t len,
+                       const size_t band)
+{
+    size_t first = 0U;
+    size_t last = (XTR_MIN(v->len, band) - 1U) / APPROX_WORD_BITS;
+    for (size_t block = 0U; block <= last; block++)
+    {
+        approx_block_reset(v, block, block * APPROX_WORD_BITS);
+    }
+    for (size_t i = 1U; i <= len; i++)
+    {
+        const size_t lowest_row = XTR_MIN(v->len, i + band);
+        for (; last < (lowest_row - 1U) / APPROX_WORD_BITS; last++)
+        {
+            approx_block_reset(v, last + 1U, v->blocks[last].score);
+        }
+        if (i > band + 1U)
+        {
+            first = (i - band - 1U) / APPROX_WORD_BITS;
+        }
+        approx_advance_blocks(v, &v->peq[v->rows[text[i - 1U]] * v->words], first, last, 1);
+    }
+    return (size_t) v->blocks[v->words - 1U].score;
+}
+
+XTR_API size_t
+xtr_edit_distance(const xtr_t* const a, const xtr_t* const b)
+{
+    if (a == NULL || b == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    // Common prefixes and suffixes cost no edits
+    const size_t shortest = XTR_MIN(a->used, b->used);
+    size_t prefix = 0U;
+    while (prefix < shortest && a->buffer[prefix] == b->buffer[prefix])
+    {
+        prefix++;
+    }
+    size_t suffix = 0U;
+    while (suffix < shortest - prefix &&
+           a->buffer[a->used - 1U - suffix] == b->buffer[b->used - 1U - suffix])
+    {
+        suffix++;
+    }
+    // The shorter one as needle, to advance fewer blocks
+    const xtr_t* const needle = a->used <= b->used ? a : b;
+    const xtr_t* const text = a->used <= b->used ? b : a;
+    const size_t needle_len = needle->used - prefix - suffix;
+    const size_t text_len = text->used - prefix - suffix;
+    if (needle_len == 0U)
+    {
+        return text_len;
+    }
+    approx_t v;
+    if (!approx_init(&v, &needle->buffer[prefix], needle_len, false))
+    {
+        return XTR_NOT_FOUND;
+    }
+    size_t band = XTR_MAX(text_len - needle_len, APPROX_MIN_BAND);
+    size_t distance = approx_banded_distance(&v, &text->buffer[prefix], text_len, band);
+    while (distance > band)
+    {
+        // The overestimated distance is an upper bound: a band that wide is
+        // exact. Wide bands cost nearly as the whole matrix, so skip to it.
+        const size_t wider = band >= needle_len / 4U ? text_len : band * 2U;
+        band = XTR_MIN(wider, distance);
+        distance = approx_banded_distance(&v, &text->buffer[prefix], text_len, band);
+    }
+    XTR_FREE(v.allocated);
+    return distance;
+}
@@ -71,37 +71,49 @@ base64_decode_buffer(uint8_t* const binary, const uint8_t text[4])
 XTR_API xtr_t*
 xtr_base64_encode(const xtr_t* const binary)
 {
-    const size_t b64_text_len = ((binary->used + 2U) * 4U) / 3U;
-    if (b64_text_len < (binary->used + 2U))
+    if (binary == NULL)
+    {
+        return NULL;
+    }
+    xtr_view_t view;
+    xtr_view(&view, binary);
+    return xtr_view_base64_encode(view);
+}
+
+XTR_API xtr_t*
+xtr_view_base64_encode(const xtr_view_t binary)
+{
+    if (binary.bytes == NULL || binary.length / 3U >= SIZE_MAX / 4U)
     {
         return NULL;
     }  // Integer overflow
+    const size_t b64_text_len = (binary.length + 2U) / 3U * 4U;
     xtr_t* const b64_text = xtr_new(b64_text_len);
     if (b64_text == NULL)
     {
         return NULL;
     }
-    const size_t remainder = binary->used % 3U;
-    const size_t trail_start_idx = binary->used - remainder;
+    const size_t remainder = binary.length % 3U;
+    const size_t trail_start_idx = binary.length - remainder;
     size_t bin_idx = 0U;
     size_t text_idx = 0U;
     while (bin_idx < trail_start_idx)
     {
-        base64_encode_buffer(&b64_text->buffer[text_idx], &binary->buffer[bin_idx]);
+        base64_encode_buffer(&b64_text->buffer[text_idx], &binary.bytes[bin_idx]);
         bin_idx += 3U;
         text_idx += 4U;
     }
     uint8_t trail[3U] = {0, 0, 0};
     if (remainder == 2U)
     {
-        trail[0] = binary->buffer[trail_start_idx];
-        trail[1] = binary->buffer[trail_start_idx + 1U];
+        trail[0] = binary.bytes[trail_start_idx];
+        trail[1] = binary.bytes[trail_start_idx + 1U];
         base64_encode_buffer(&b64_text->buffer[text_idx], trail);
         b64_text->buffer[text_idx + 3U] = BASE64_PADDING;
     }
     else if (remainder == 1U)
     {
-        trail[0] = binary->buffer[trail_start_idx];
+        trail[0] = binary.bytes[trail_start_idx];
         base64_encode_buffer(&b64_text->buffer[text_idx], trail);
         b64_text->buffer[text_idx + 2U] = BASE64_PADDING;
         b64_text->buffer[text_idx + 3U] = BASE64_PADDING;
@@ -0,0 +1,342 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/** @internal Whitespace characters, as by isspace() in the "C" locale. */
+#define WHITESPACE " \t\n\v\f\r"
+
+XTR_API void
+xtr_charset_init_bytes(xtr_charset_t* const set, const uint8_t* const bytes, const size_t len)
+{
+    if (set == NULL)
+    {
+        return;
+    }
+    memset(set->bitmap, 0, sizeof(set->bitmap));
+    for (size_t i = 0U; bytes != NULL && i < len; i++)
+    {
+        set->bitmap[XTR_CHARSET_ROW(bytes[i])] |= XTR_CHARSET_BIT(bytes[i]);
+    }
+}
+
+XTR_API void
+xtr_charset_init(xtr_charset_t* const set, const char* const chars)
+{
+    const char* const members = chars == NULL ? WHITESPACE : chars;
+    xtr_charset_init_bytes(set, (const uint8_t*) members, strlen(members));
+}
+
+XTR_API bool
+xtr_charset_contains(const xtr_charset_t* const set, const uint8_t byte)
+{
+    return set != NULL && (set->bitmap[XTR_CHARSET_ROW(byte)] & XTR_CHARSET_BIT(byte)) != 0U;
+}
+
+#if defined(XTR_AVX2)
+/**
+ * @internal
+ * Checks the membership of 32 bytes at once with the nibble lookup: the low
+ * nibble of each byte selects its row of the bitmap, the high nibble its bit.
+ *
+ * @param [in] block bytes to check
+ * @param [in] rows_low bitmap rows of the bytes 0x00-0x7F, in both lanes
+ * @param [in] rows_high bitmap rows of the bytes 0x80-0xFF, in both lanes
+ * @return bit-mask with a set bit for each byte in the set
+ */
+XTR_INLINE static uint32_t
+members32(const __m256i block, const __m256i rows_low, const __m256i rows_high)
+{
+    const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64,
+                                          -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16,
+                                          32, 64, -128);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i low = _mm256_and_si256(block, nibble);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+    const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(rows_high, low),
+                                           _mm256_shuffle_epi8(rows_low, low),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8(8), high));
+    const __m256i bit = _mm256_shuffle_epi8(bits, high);
+    return (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+}
+#elif defined(XTR_SSSE3)
+/**
+ * @internal
+ * Checks the membership of 16 bytes at once, as members32().
+ */
+XTR_INLINE static uint32_t
+members16(const __m128i block, const __m128i rows_low, const __m128i rows_high)
+{
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i low = _mm_and_si128(block, nibble);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(block, 4), nibble);
+    const __m128i is_low = _mm_cmplt_epi8(high, _mm_set1_epi8(8));
+    const __m128i row = _mm_or_si128(_mm_and_si128(is_low, _mm_shuffle_epi8(rows_low, low)),
+                                     _mm_andnot_si128(is_low, _mm_shuffle_epi8(rows_high, low)));
+    const __m128i bit = _mm_shuffle_epi8(bits, high);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit));
+}
+#elif defined(XTR_SSE2)
+/**
+ * @internal
+ * Most members of a set for SSE2 to compare with each one of them, as it has
+ * no byte shuffle for the nibble lookup.
+ */
+#define CHARSET_SSE2_MAX_MEMBERS 8U
+/** @internal Shortest array worth listing the members of the set for. */
+#define CHARSET_SSE2_MIN_LEN 64U
+
+/**
+ * @internal
+ * Lists the members of a small set, each broadcast to a vector.
+ *
+ * @param [out] vectors one vector per member
+ * @param [in] set to list
+ * @return amount of members, 0 if more than #CHARSET_SSE2_MAX_MEMBERS
+ */
+static size_t
+charset_vectors(__m128i* const vectors, const xtr_charset_t* const set)
+{
+    size_t amount = 0U;
+    for (size_t row = 0U; row < sizeof(set->bitmap); row++)
+    {
+        for (unsigned int bit = 0U; set->bitmap[row] != 0U && bit < 8U; bit++)
+        {
+            if ((set->bitmap[row] & (1U << bit)) == 0U)
+            {
+                continue;
+            }
+            if (amount == CHARSET_SSE2_MAX_MEMBERS)
+            {
+                return 0U;
+            }
+            const size_t byte = ((row >> 4U) << 7U) | (bit << 4U) | (row & 0x0FU);
+            vectors[amount++] = _mm_set1_epi8((char) byte);
+        }
+    }
+    return amount;
+}
+
+/**
+ * @internal
+ * Checks the membership of 16 bytes at once, comparing with each member.
+ */
+XTR_INLINE static uint32_t
+members16(const __m128i block, const __m128i* const vectors, const size_t amount)
+{
+    __m128i found = _mm_setzero_si128();
+    for (size_t i = 0U; i < amount; i++)
+    {
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(block, vectors[i]));
+    }
+    return (uint32_t) _mm_movemask_epi8(found);
+}
+#endif
+
+size_t
+xtr_charset_scan(const xtr_charset_t* const set,
+                 const uint8_t* const bytes,
+                 const size_t len,
+                 const bool member)
+{
+    size_t i = 0U;
+#if defined(XTR_AVX2)
+    const __m256i rows_low =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) set->bitmap));
+    const __m256i rows_high =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (set->bitmap + 16U)));
+    const uint32_t flip = member ? 0U : UINT32_MAX;
+    for (; i + 32U <= len; i += 32U)
+    {
+        const __m256i block = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        const uint32_t mask = members32(block, rows_low, rows_high) ^ flip;
+        if (mask != 0U)
+        {
+            return i + xtr_ctz32(mask);
+        }
+    }
+#elif defined(XTR_SSSE3)
+    const __m128i rows_low = _mm_loadu_si128((const __m128i*) set->bitmap);
+    const __m128i rows_high = _mm_loadu_si128((const __m128i*) (set->bitmap + 16U));
+    const uint32_t flip = member ? 0U : 0xFFFFU;
+    for (; i + 16U <= len; i += 16U)
+    {
+        const __m128i block = _mm_loadu_si128((const __m128i*) (bytes + i));
+        const uint32_t mask = members16(block, rows_low, rows_high) ^ flip;
+        if (mask != 0U)
+        {
+            return i + xtr_ctz32(mask);
+        }
+    }
+#elif defined(XTR_SSE2)
+    __m128i vectors[CHARSET_SSE2_MAX_MEMBERS];
+    const size_t amount = len >= CHARSET_SSE2_MIN_LEN ? charset_vectors(vectors, set) : 0U;
+    const uint32_t flip = member ? 0U : 0xFFFFU;
+    for (; amount != 0U && i + 16U <= len; i += 16U)
+    {
+        const __m128i block = _mm_loadu_si128((const __m128i*) (bytes + i));
+        const uint32_t mask = members16(block, vectors, amount) ^ flip;
+        if (mask != 0U)
+        {
+            return i + xtr_ctz32(mask);
+        }
+    }
+#endif
+    for (; i < len; i++)
+    {
+        if (xtr_charset_contains(set, bytes[i]) == member)
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * @internal
+ * Mirror of xtr_charset_scan(), from the end of the array backwards.
+ *
+ * @return index of the found byte, #XTR_NOT_FOUND if none
+ */
+static size_t
+charset_scan_reverse(const xtr_charset_t* const set,
+                     const uint8_t* const bytes,
+                     size_t len,
+                     const bool member)
+{
+#if defined(XTR_AVX2)
+    const __m256i rows_low =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) set->bitmap));
+    const __m256i rows_high =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (set->bitmap + 16U)));
+    const uint32_t flip = member ? 0U : UINT32_MAX;
+    while (len >= 32U)
+    {
+        len -= 32U;
+        const __m256i block = _mm256_loadu_si256((const __m256i*) (bytes + len));
+        const uint32_t mask = members32(block, rows_low, rows_high) ^ flip;
+        if (mask != 0U)
+        {
+            return len + xtr_msb32(mask);
+        }
+    }
+#elif defined(XTR_SSSE3)
+    const __m128i rows_low = _mm_loadu_si128((const __m128i*) set->bitmap);
+    const __m128i rows_high = _mm_loadu_si128((const __m128i*) (set->bitmap + 16U));
+    const uint32_t flip = member ? 0U : 0xFFFFU;
+    while (len >= 16U)
+    {
+        len -= 16U;
+        const __m128i block = _mm_loadu_si128((const __m128i*) (bytes + len));
+        const uint32_t mask = members16(block, rows_low, rows_high) ^ flip;
+        if (mask != 0U)
+        {
+            return len + xtr_msb32(mask);
+        }
+    }
+#elif defined(XTR_SSE2)
+    __m128i vectors[CHARSET_SSE2_MAX_MEMBERS];
+    const size_t amount = len >= CHARSET_SSE2_MIN_LEN ? charset_vectors(vectors, set) : 0U;
+    const uint32_t flip = member ? 0U : 0xFFFFU;
+    while (amount != 0U && len >= 16U)
+    {
+        len -= 16U;
+        const __m128i block = _mm_loadu_si128((const __m128i*) (bytes + len));
+        const uint32_t mask = members16(block, vectors, amount) ^ flip;
+        if (mask != 0U)
+        {
+            return len + xtr_msb32(mask);
+        }
+    }
+#endif
+    while (len > 0U)
+    {
+        len--;
+        if (xtr_charset_contains(set, bytes[len]) == member)
+        {
+            return len;
+        }
+    }
+    return XTR_NOT_FOUND;
+}
+
+XTR_API size_t
+xtr_find_first_of(const xtr_t* const xtr, const xtr_charset_t* const set)
+{
+    if (xtr == NULL || set == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const size_t index = xtr_charset_scan(set, xtr->buffer, xtr->used, true);
+    return index == xtr->used ? XTR_NOT_FOUND : index;
+}
+
+XTR_API size_t
+xtr_find_first_not_of(const xtr_t* const xtr, const xtr_charset_t* const set)
+{
+    if (xtr == NULL || set == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const size_t index = xtr_charset_scan(set, xtr->buffer, xtr->used, false);
+    return index == xtr->used ? XTR_NOT_FOUND : index;
+}
+
+XTR_API size_t
+xtr_find_last_of(const xtr_t* const xtr, const xtr_charset_t* const set)
+{
+    if (xtr == NULL || set == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return charset_scan_reverse(set, xtr->buffer, xtr->used, true);
+}
+
+XTR_API size_t
+xtr_find_last_not_of(const xtr_t* const xtr, const xtr_charset_t* const set)
+{
+    if (xtr == NULL || set == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return charset_scan_reverse(set, xtr->buffer, xtr->used, false);
+}
+
+XTR_API size_t
+xtr_span(const xtr_t* const xtr, const xtr_charset_t* const set)
+{
+    if (xtr == NULL || set == NULL)
+    {
+        return 0U;
+    }
+    return xtr_charset_scan(set, xtr->buffer, xtr->used, false);
+}
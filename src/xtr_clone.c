@@ -41,6 +41,60 @@ xtr_clone(const xtr_t* const xtr)
     return xtr_from_bytes(xtr->buffer, xtr->used);
 }
 
+XTR_API xtr_t*
+xtr_share(xtr_t* const xtr)
+{
+    if (xtr == NULL)
+    {
+        return NULL;
+    }
+    xtr_refs_add(xtr, 1U);
+    return xtr;
+}
+
+XTR_API void
+xtr_release(xtr_t** const pxtr)
+{
+    xtr_free(pxtr);
+}
+
+XTR_API bool
+xtr_is_shared(const xtr_t* const xtr)
+{
+    return xtr != NULL && xtr_refs_load(xtr) > 1U;
+}
+
+XTR_API size_t
+xtr_references(const xtr_t* const xtr)
+{
+    if (xtr == NULL)
+    {
+        return 0U;
+    }
+    return xtr_refs_load(xtr);
+}
+
+XTR_API xtr_t*
+xtr_unshare(xtr_t** const pxtr)
+{
+    if (pxtr == NULL || *pxtr == NULL)
+    {
+        return NULL;
+    }
+    if (!xtr_is_shared(*pxtr))
+    {
+        return *pxtr;
+    }
+    xtr_t* const copy = xtr_from_bytes_capac((*pxtr)->buffer, (*pxtr)->used, xtr_capacity(*pxtr));
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    xtr_release(pxtr);
+    *pxtr = copy;
+    return copy;
+}
+
 XTR_API xtr_t*
 xtr_expanded(const xtr_t* xtr, size_t at_least)
 {
@@ -54,10 +108,14 @@ xtr_expanded(const xtr_t* xtr, size_t at_least)
 XTR_API xtr_t*
 xtr_expand(xtr_t** pxtr, size_t at_least)
 {
-    if (pxtr == NULL)
+    if (pxtr == NULL || *pxtr == NULL)
     {
         return NULL;
     }
+    if (!xtr_is_shared(*pxtr))
+    {
+        return xtr_reallocate(pxtr, XTR_MAX(at_least, (*pxtr)->used));
+    }
     xtr_t* const clone = xtr_from_bytes_capac((*pxtr)->buffer, (*pxtr)->used, at_least);
     if (clone == NULL)
     {
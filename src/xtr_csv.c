@@ -0,0 +1,347 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/** @internal Bytes classified at once into 64-bit masks. */
+#define CSV_BLOCK_LEN 64U
+
+/** @internal Bit-masks of the structural characters in a block, bit i for byte i. */
+typedef struct
+{
+    uint64_t quotes;
+    uint64_t separators;
+    uint64_t newlines;
+} csv_masks_t;
+
+XTR_API xtr_csv_t*
+xtr_csv_new(const uint8_t separator, const uint8_t quote)
+{
+    if (separator == quote || separator == '\n' || separator == '\r' || quote == '\n' ||
+        quote == '\r')
+    {
+        return NULL;
+    }
+    xtr_csv_t* const csv = XTR_CALLOC(1U, sizeof(xtr_csv_t));
+    if (csv == NULL)
+    {
+        return NULL;
+    }
+    csv->separator = separator;
+    csv->quote = quote;
+    return csv;
+}
+
+XTR_API void
+xtr_csv_free(xtr_csv_t** const pcsv)
+{
+    if (pcsv == NULL || *pcsv == NULL)
+    {
+        return;
+    }
+    XTR_FREE((*pcsv)->field_ends);
+    XTR_FREE((*pcsv)->record_ends);
+    XTR_FREE(*pcsv);
+    *pcsv = NULL;
+}
+
+/** @internal Classifies the 64 bytes of a block. */
+XTR_INLINE static void
+csv_classify(csv_masks_t* const masks, const xtr_csv_t* const csv, const uint8_t* const block)
+{
+#if defined(XTR_AVX2)
+    const __m256i quote = _mm256_set1_epi8((char) csv->quote);
+    const __m256i separator = _mm256_set1_epi8((char) csv->separator);
+    const __m256i newline = _mm256_set1_epi8('\n');
+    masks->quotes = 0U;
+    masks->separators = 0U;
+    masks->newlines = 0U;
+    for (unsigned int i = 0U; i < CSV_BLOCK_LEN; i += 32U)
+    {
+        const __m256i bytes = _mm256_loadu_si256((const __m256i*) (const void*) &block[i]);
+        masks->quotes |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+                             _mm256_cmpeq_epi8(bytes, quote))
+                         << i;
+        masks->separators |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+                                 _mm256_cmpeq_epi8(bytes, separator))
+                             << i;
+        masks->newlines |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+                               _mm256_cmpeq_epi8(bytes, newline))
+                           << i;
+    }
+#elif defined(XTR_SSE2)
+    const __m128i quote = _mm_set1_epi8((char) csv->quote);
+    const __m128i separator = _mm_set1_epi8((char) csv->separator);
+    const __m128i newline = _mm_set1_epi8('\n');
+    masks->quotes = 0U;
+    masks->separators = 0U;
+    masks->newlines = 0U;
+    for (unsigned int i = 0U; i < CSV_BLOCK_LEN; i += 16U)
+    {
+        const __m128i bytes = _mm_loadu_si128((const __m128i*) (const void*) &block[i]);
+        masks->quotes |= (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote))
+                         << i;
+        masks->separators |=
+            (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, separator)) << i;
+        masks->newlines |= (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline))
+                           << i;
+    }
+#else
+    masks->quotes = 0U;
+    masks->separators = 0U;
+    masks->newlines = 0U;
+    for (unsigned int i = 0U; i < CSV_BLOCK_LEN; i++)
+    {
+        masks->quotes |= (uint64_t) (block[i] == csv->quote) << i;
+        masks->separators |= (uint64_t) (block[i] == csv->separator) << i;
+        masks->newlines |= (uint64_t) (block[i] == '\n') << i;
+    }
+#endif
+}
+
+/**
+ * @internal
+ * Bit i of the result is the xor of the bits 0 to i of the mask: set from
+ * each odd quote (opening) to the following even one (closing), excluded.
+ * Doubled quotes escaping a quote within a quoted field toggle it twice,
+ * thus need no special handling.
+ */
+XTR_INLINE static uint64_t
+csv_prefix_xor(uint64_t mask)
+{
+#if defined(XTR_PCLMUL)
+    // Carry-less multiplication by all ones: the xor of all shifted copies
+    const __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, (long long) mask),
+                                                 _mm_set1_epi8(-1), 0);
+    return (uint64_t) _mm_cvtsi128_si64(product);
+#else
+    mask ^= mask << 1U;
+    mask ^= mask << 2U;
+    mask ^= mask << 4U;
+    mask ^= mask << 8U;
+    mask ^= mask << 16U;
+    mask ^= mask << 32U;
+    return mask;
+#endif
+}
+
+/** @internal Grows an array of indices to at least the given capacity. */
+static bool
+csv_reserve(size_t** const array, size_t* const capacity, const size_t needed)
+{
+    if (needed <= *capacity)
+    {
+        return true;
+    }
+    const size_t larger = XTR_MAX(needed, *capacity * 2U);
+    size_t* const grown = XTR_REALLOC(*array, larger * sizeof(size_t));
+    if (grown == NULL)
+    {
+        return false;
+    }
+    *array = grown;
+    *capacity = larger;
+    return true;
+}
+
+XTR_API bool
+xtr_csv_parse(xtr_csv_t* const csv, const xtr_t* const text)
+{
+    if (csv == NULL)
+    {
+        return false;
+    }
+    csv->text = NULL;
+    csv->len = 0U;
+    csv->fields = 0U;
+    csv->records = 0U;
+    if (text == NULL)
+    {
+        return false;
+    }
+    uint64_t inside = 0U;  // All ones when a block ends within quotes
+    for (size_t base = 0U; base < text->used; base += CSV_BLOCK_LEN)
+    {
+        // At most one field and one record per byte in a block, plus the last
+        if (!csv_reserve(&csv->field_ends, &csv->fields_capacity,
+                         csv->fields + CSV_BLOCK_LEN + 1U) ||
+            !csv_reserve(&csv->record_ends, &csv->records_capacity,
+                         csv->records + CSV_BLOCK_LEN + 1U))
+        {
+            csv->fields = 0U;
+            csv->records = 0U;
+            return false;
+        }
+        csv_masks_t masks;
+        if (text->used - base >= CSV_BLOCK_LEN)
+        {
+            csv_classify(&masks, csv, &text->buffer[base]);
+        }
+        else
+        {
+            // Last partial block, ignoring what follows the text
+            uint8_t tail[CSV_BLOCK_LEN] = {0};
+            memcpy(tail, &text->buffer[base], text->used - base);
+            csv_classify(&masks, csv, tail);
+            const uint64_t valid = (UINT64_C(1) << (text->used - base)) - 1U;
+            masks.quotes &= valid;
+            masks.separators &= valid;
+            masks.newlines &= valid;
+        }
+        const uint64_t quoted = csv_prefix_xor(masks.quotes) ^ inside;
+        inside = (uint64_t) 0U - (quoted >> 63U);
+        uint64_t structurals = (masks.separators | masks.newlines) & ~quoted;
+        const uint64_t newlines = masks.newlines & ~quoted;
+        while (structurals != 0U)
+        {
+            const unsigned int i = xtr_ctz64(structurals);
+            csv->field_ends[csv->fields++] = base + i;
+            if ((newlines >> i) & 1U)
+            {
+                csv->record_ends[csv->records++] = csv->fields;
+            }
+            structurals &= structurals - 1U;
+        }
+    }
+    if (inside != 0U)
+    {
+        // Quoted field never closed
+        csv->fields = 0U;
+        csv->records = 0U;
+        return false;
+    }
+    if (text->used > 0U && text->buffer[text->used - 1U] != '\n')
+    {
+        // Last record without a trailing newline
+        csv->field_ends[csv->fields++] = text->used;
+        csv->record_ends[csv->records++] = csv->fields;
+    }
+    csv->text = text->buffer;
+    csv->len = text->used;
+    return true;
+}
+
+XTR_API size_t
+xtr_csv_records(const xtr_csv_t* const csv)
+{
+    return csv == NULL ? 0U : csv->records;
+}
+
+XTR_API size_t
+xtr_csv_fields(const xtr_csv_t* const csv, const size_t record)
+{
+    if (csv == NULL || record >= csv->records)
+    {
+        return 0U;
+    }
+    return csv->record_ends[record] - (record == 0U ? 0U : csv->record_ends[record - 1U]);
+}
+
+/**
+ * @internal
+ * Locates a field in the text, without the carriage return of a CRLF line
+ * ending and without the quotes around a quoted field.
+ *
+ * @return whether the field is quoted, thus may contain doubled quotes
+ */
+static bool
+csv_locate(const xtr_csv_t* const csv, const size_t index, size_t* const start, size_t* const end)
+{
+    *start = index == 0U ? 0U : csv->field_ends[index - 1U] + 1U;
+    *end = csv->field_ends[index];
+    if (*end < csv->len && csv->text[*end] == '\n' && *end > *start &&
+        csv->text[*end - 1U] == '\r')
+    {
+        (*end)--;
+    }
+    if (*end - *start >= 2U && csv->text[*start] == csv->quote &&
+        csv->text[*end - 1U] == csv->quote)
+    {
+        (*start)++;
+        (*end)--;
+        return true;
+    }
+    return false;
+}
+
+XTR_API bool
+xtr_csv_field(xtr_view_t* const view,
+              const xtr_csv_t* const csv,
+              const size_t record,
+              const size_t field)
+{
+    if (view == NULL)
+    {
+        return false;
+    }
+    if (field >= xtr_csv_fields(csv, record))
+    {
+        xtr_view_from_bytes(view, NULL, 0U);
+        return false;
+    }
+    const size_t index = (record == 0U ? 0U : csv->record_ends[record - 1U]) + field;
+    size_t start;
+    size_t end;
+    csv_locate(csv, index, &start, &end);
+    xtr_view_from_bytes(view, &csv->text[start], end - start);
+    return true;
+}
+
+XTR_API xtr_t*
+xtr_csv_field_unescaped(const xtr_csv_t* const csv, const size_t record, const size_t field)
+{
+    if (field >= xtr_csv_fields(csv, record))
+    {
+        return NULL;
+    }
+    const size_t index = (record == 0U ? 0U : csv->record_ends[record - 1U]) + field;
+    size_t start;
+    size_t end;
+    const bool quoted = csv_locate(csv, index, &start, &end);
+    xtr_t* const unescaped = xtr_new(end - start);
+    if (unescaped == NULL)
+    {
+        return NULL;
+    }
+    size_t used = 0U;
+    for (size_t i = start; i < end; i++)
+    {
+        unescaped->buffer[used++] = csv->text[i];
+        // Doubled quote within a quoted field: keep one
+        if (quoted && csv->text[i] == csv->quote && i + 1U < end &&
+            csv->text[i + 1U] == csv->quote)
+        {
+            i++;
+        }
+    }
+    set_used_and_terminator(unescaped, used);
+    return unescaped;
+}
@@ -31,188 +31,395 @@
 
 #include "xtr_internal.h"
 
-XTR_API void
+XTR_API bool
 xtr_clear(xtr_t* const xtr)
 {
-    if (xtr != NULL)
+    if (xtr == NULL || xtr_is_shared(xtr))
     {
+        return false;
+    }
 #if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
-        zero_out(xtr->buffer, xtr->capacity);
+    zero_out(xtr->buffer, xtr->capacity);
 #endif
-        set_used_and_terminator(xtr, 0U);
-    }
+    set_used_and_terminator(xtr, 0U);
+    xtr_drop_head_room(xtr);  // Nothing to move when empty
+    return true;
 }
 
-XTR_API void
-xtr_truncate_head(xtr_t* const xtr, const size_t amount_to_truncate)
+XTR_API bool
+xtr_clear_cow(xtr_t** const pxtr)
 {
-    if (xtr == NULL)
+    if (pxtr == NULL || *pxtr == NULL)
     {
-        return;
+        return false;
     }
-    const size_t to_truncate = XTR_MIN(amount_to_truncate, xtr->used);
-    const size_t new_len = xtr->used - to_truncate;
-    memmove_zero_out(xtr->buffer, xtr->buffer + to_truncate, new_len);
-    set_used_and_terminator(xtr, new_len);
+    if (!xtr_is_shared(*pxtr))
+    {
+        return xtr_clear(*pxtr);
+    }
+    xtr_t* const empty = xtr_new(xtr_capacity(*pxtr));
+    if (empty == NULL)
+    {
+        return false;
+    }
+    xtr_release(pxtr);
+    *pxtr = empty;
+    return true;
 }
 
-XTR_API void
-xtr_truncate_tail(xtr_t* const xtr, const size_t amount_to_truncate)
+/**
+ * @internal
+ * Removes the first `len` bytes by moving the content start after them,
+ * without moving the rest of the content.
+ */
+static void
+consume_head(xtr_t* const xtr, const size_t len)
 {
-    if (xtr == NULL)
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+    zero_out(xtr->buffer, len);
+#endif
+    xtr->buffer += len;
+    xtr->capacity -= len;
+    xtr->used -= len;
+    if (xtr->used == 0U)
     {
-        return;
+        xtr_drop_head_room(xtr);  // Free to do without content to move
     }
-    const size_t to_truncate = XTR_MIN(amount_to_truncate, xtr->used);
-    const size_t new_len = xtr->used - to_truncate;
+}
+
+/**
+ * @internal
+ * Removes the last `len` bytes, `len` being at most the length.
+ */
+static void
+consume_tail(xtr_t* const xtr, const size_t len)
+{
+    const size_t new_len = xtr->used - len;
 #if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
-    zero_out(&xtr->buffer[new_len], amount_to_truncate);
+    zero_out(&xtr->buffer[new_len], len);
 #endif
     set_used_and_terminator(xtr, new_len);
 }
 
+/**
+ * @internal
+ * Keeps only the `len` bytes starting at `start`, in-place.
+ */
+static void
+keep_range(xtr_t* const xtr, const size_t start, const size_t len)
+{
+    consume_tail(xtr, xtr->used - start - len);
+    consume_head(xtr, start);
+}
+
+/**
+ * @internal
+ * Keeps only the `len` bytes starting at `start` of the pointed xtring.
+ *
+ * A private xtring is shortened in-place. A shared one is left to its other
+ * owners: the caller's reference is replaced by a copy of the kept bytes.
+ * @return false in case of malloc failure, leaving `*pxtr` untouched.
+ */
+static bool
+keep_cow(xtr_t** const pxtr, const size_t start, const size_t len)
+{
+    xtr_t* const xtr = *pxtr;
+    if (!xtr_is_shared(xtr))
+    {
+        keep_range(xtr, start, len);
+        return true;
+    }
+    xtr_t* const kept = xtr_from_bytes(&xtr->buffer[start], len);
+    if (kept == NULL)
+    {
+        return false;
+    }
+    xtr_release(pxtr);
+    *pxtr = kept;
+    return true;
+}
+
+XTR_API bool
+xtr_truncate_head(xtr_t* const xtr, const size_t amount_to_truncate)
+{
+    if (xtr == NULL || xtr_is_shared(xtr))
+    {
+        return false;
+    }
+    consume_head(xtr, XTR_MIN(amount_to_truncate, xtr->used));
+    return true;
+}
+
+XTR_API bool
+xtr_truncate_head_cow(xtr_t** const pxtr, const size_t amount_to_truncate)
+{
+    if (pxtr == NULL || *pxtr == NULL)
+    {
+        return false;
+    }
+    const size_t to_truncate = XTR_MIN(amount_to_truncate, (*pxtr)->used);
+    return keep_cow(pxtr, to_truncate, (*pxtr)->used - to_truncate);
+}
+
+XTR_API bool
+xtr_truncate_tail(xtr_t* const xtr, const size_t amount_to_truncate)
+{
+    if (xtr == NULL || xtr_is_shared(xtr))
+    {
+        return false;
+    }
+    consume_tail(xtr, XTR_MIN(amount_to_truncate, xtr->used));
+    return true;
+}
+
+XTR_API bool
+xtr_truncate_tail_cow(xtr_t** const pxtr, const size_t amount_to_truncate)
+{
+    if (pxtr == NULL || *pxtr == NULL)
+    {
+        return false;
+    }
+    const size_t to_truncate = XTR_MIN(amount_to_truncate, (*pxtr)->used);
+    return keep_cow(pxtr, 0U, (*pxtr)->used - to_truncate);
+}
+
 XTR_API xtr_t*
 xtr_pop_tail(xtr_t* const xtr, const size_t amount_to_pop)
 {
-    if (xtr == NULL)
+    if (xtr == NULL || xtr_is_shared(xtr))
     {
         return NULL;
     }
     const size_t poppable = XTR_MIN(amount_to_pop, xtr->used);
-    const size_t new_len = xtr->used - poppable;
-    xtr_t* const popped = xtr_from_bytes(&xtr->buffer[new_len], poppable);
+    xtr_t* const popped = xtr_from_bytes(&xtr->buffer[xtr->used - poppable], poppable);
     if (popped == NULL)
     {
         return NULL;
     }
-#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
-    zero_out(&xtr->buffer[new_len], poppable);
-#endif
-    set_used_and_terminator(xtr, new_len);
+    consume_tail(xtr, poppable);
+    return popped;
+}
+
+XTR_API xtr_t*
+xtr_pop_tail_cow(xtr_t** const pxtr, const size_t amount_to_pop)
+{
+    if (pxtr == NULL || *pxtr == NULL)
+    {
+        return NULL;
+    }
+    const size_t poppable = XTR_MIN(amount_to_pop, (*pxtr)->used);
+    const size_t new_len = (*pxtr)->used - poppable;
+    xtr_t* popped = xtr_from_bytes(&(*pxtr)->buffer[new_len], poppable);
+    if (popped == NULL)
+    {
+        return NULL;
+    }
+    if (!keep_cow(pxtr, 0U, new_len))
+    {
+        xtr_free(&popped);
+    }
     return popped;
 }
 
 XTR_API xtr_t*
 xtr_pop_head(xtr_t* const xtr, const size_t amount_to_pop)
 {
-    if (xtr == NULL)
+    if (xtr == NULL || xtr_is_shared(xtr))
     {
         return NULL;
     }
     const size_t poppable = XTR_MIN(amount_to_pop, xtr->used);
-    const size_t new_len = xtr->used - poppable;
     xtr_t* const popped = xtr_from_bytes(xtr->buffer, poppable);
     if (popped == NULL)
     {
         return NULL;
     }
-    memmove_zero_out(xtr->buffer, xtr->buffer + poppable, new_len);
-    set_used_and_terminator(xtr, new_len);
+    consume_head(xtr, poppable);
     return popped;
 }
 
-XTR_API void
-xtr_trim_tail(xtr_t* xtr, const char* chars)
+XTR_API xtr_t*
+xtr_pop_head_cow(xtr_t** const pxtr, const size_t amount_to_pop)
 {
-    if (xtr_is_empty(xtr))
+    if (pxtr == NULL || *pxtr == NULL)
     {
-        return;
+        return NULL;
     }
-    size_t last = xtr->used - 1U;  // Shifting index of last character, moving towards 0.
-    // Stop when non-space found or when `last` loops around (`0--`)
-    // thus the entire buffer was already explored.
-    if (chars == NULL || *chars == TERMINATOR)
+    const size_t poppable = XTR_MIN(amount_to_pop, (*pxtr)->used);
+    xtr_t* popped = xtr_from_bytes((*pxtr)->buffer, poppable);
+    if (popped == NULL)
     {
-        // No characters to trim given: trimming whitespace.
-        while (last < xtr->used && isspace(xtr->buffer[last]))
-        {
-            last--;
-        }
+        return NULL;
     }
-    else
+    if (!keep_cow(pxtr, poppable, (*pxtr)->used - poppable))
     {
-        while (last < xtr->used && strchr(chars, xtr->buffer[last]))
-        {
-            last--;
-        }
+        xtr_free(&popped);
     }
-#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
-    zero_out(&xtr->buffer[last], (xtr->used - 1U) - last);
-#endif
-    set_used_and_terminator(xtr, last);
+    return popped;
 }
 
-XTR_API void
-xtr_trim_head(xtr_t* xtr, const char* chars)
+/**
+ * @internal
+ * Range of the xtring remaining after trimming `chars` (or, if NULL or
+ * empty, the whitespace) from its head and/or tail.
+ */
+static void
+trim_range(const xtr_t* const xtr, const char* const chars, const bool head,
+           const bool tail, size_t* const start, size_t* const len)
 {
-    if (xtr_is_empty(xtr))
+    xtr_charset_t set;
+    xtr_charset_init(&set, (chars == NULL || *chars == TERMINATOR) ? NULL : chars);
+    size_t end = xtr->used;
+    if (tail)
     {
-        return;
+        const size_t last_kept = xtr_find_last_not_of(xtr, &set);
+        end = last_kept == XTR_NOT_FOUND ? 0U : last_kept + 1U;
     }
-    size_t first = 0U;  // Shifting index of first character, moving towards end.
-    // Stop when non-space found or when `first` hits string end,
-    // thus the entire buffer was already explored.
-    if (chars == NULL || *chars == TERMINATOR)
+    *start = head ? XTR_MIN(xtr_span(xtr, &set), end) : 0U;
+    *len = end - *start;
+}
+
+/** @internal Trims in-place, unless shared. */
+static bool
+trim_in_place(xtr_t* const xtr, const char* const chars, const bool head, const bool tail)
+{
+    if (xtr == NULL || xtr_is_shared(xtr))
     {
-        // No characters to trim given: trimming whitespace.
-        while (first < xtr->used && isspace(xtr->buffer[first]))
-        {
-            first++;
-        }
+        return false;
     }
-    else
+    size_t start;
+    size_t len;
+    trim_range(xtr, chars, head, tail, &start, &len);
+    keep_range(xtr, start, len);
+    return true;
+}
+
+/** @internal Trims in-place or, if shared, into a copy. */
+static bool
+trim_cow(xtr_t** const pxtr, const char* const chars, const bool head, const bool tail)
+{
+    if (pxtr == NULL || *pxtr == NULL)
     {
-        while (first < xtr->used && strchr(chars, xtr->buffer[first]))
-        {
-            first++;
-        }
+        return false;
     }
-    memmove_zero_out(xtr->buffer, &xtr->buffer[first], xtr->used - first);
-    set_used_and_terminator(xtr, xtr->used - first);
+    size_t start;
+    size_t len;
+    trim_range(*pxtr, chars, head, tail, &start, &len);
+    return keep_cow(pxtr, start, len);
 }
 
-XTR_API void
-xtr_trim(xtr_t* xtr, const char* chars)
+XTR_API bool
+xtr_trim_tail(xtr_t* const xtr, const char* const chars)
 {
-    xtr_trim_tail(xtr, chars);
-    xtr_trim_head(xtr, chars);
+    return trim_in_place(xtr, chars, false, true);
+}
+
+XTR_API bool
+xtr_trim_tail_cow(xtr_t** const pxtr, const char* const chars)
+{
+    return trim_cow(pxtr, chars, false, true);
+}
+
+XTR_API bool
+xtr_trim_head(xtr_t* const xtr, const char* const chars)
+{
+    return trim_in_place(xtr, chars, true, false);
+}
+
+XTR_API bool
+xtr_trim_head_cow(xtr_t** const pxtr, const char* const chars)
+{
+    return trim_cow(pxtr, chars, true, false);
+}
+
+XTR_API bool
+xtr_trim(xtr_t* const xtr, const char* const chars)
+{
+    return trim_in_place(xtr, chars, true, true);
+}
+
+XTR_API bool
+xtr_trim_cow(xtr_t** const pxtr, const char* const chars)
+{
+    return trim_cow(pxtr, chars, true, true);
+}
+
+/** @internal Whether the xtring ends with the C-string `suffix`. */
+static bool
+has_suffix(const xtr_t* const xtr, const char* const suffix, size_t* const suffix_len)
+{
+    *suffix_len = strlen(suffix);
+    return *suffix_len <= xtr->used &&
+           memcmp(&xtr->buffer[xtr->used - *suffix_len], suffix, *suffix_len) == 0;
+}
+
+/** @internal Whether the xtring starts with the C-string `prefix`. */
+static bool
+has_prefix(const xtr_t* const xtr, const char* const prefix, size_t* const prefix_len)
+{
+    *prefix_len = strlen(prefix);
+    return *prefix_len <= xtr->used && memcmp(xtr->buffer, prefix, *prefix_len) == 0;
 }
 
 // TODO binary version? not char* but void*?
-XTR_API void
-xtr_truncate_suffix(xtr_t* xtr, const char* suffix)
+XTR_API bool
+xtr_truncate_suffix(xtr_t* const xtr, const char* const suffix)
 {
-    if (xtr_is_empty(xtr) || suffix == NULL)
+    if (xtr == NULL || xtr_is_shared(xtr))
     {
-        return;
+        return false;
     }
-    const size_t suffix_len = strlen(suffix);
-    if (suffix_len > xtr->used)
+    size_t suffix_len;
+    if (suffix != NULL && has_suffix(xtr, suffix, &suffix_len))
     {
-        return;
+        consume_tail(xtr, suffix_len);
     }
-    if (memcmp(&xtr->buffer[xtr->used - suffix_len], suffix, suffix_len) == 0)
+    return true;
+}
+
+XTR_API bool
+xtr_truncate_suffix_cow(xtr_t** const pxtr, const char* const suffix)
+{
+    if (pxtr == NULL || *pxtr == NULL)
     {
-        xtr_truncate_tail(xtr, suffix_len);
+        return false;
     }
+    size_t suffix_len;
+    if (suffix != NULL && has_suffix(*pxtr, suffix, &suffix_len))
+    {
+        return keep_cow(pxtr, 0U, (*pxtr)->used - suffix_len);
+    }
+    return true;
 }
 
-XTR_API void
-xtr_truncate_prefix(xtr_t* xtr, const char* prefix)
+XTR_API bool
+xtr_truncate_prefix(xtr_t* const xtr, const char* const prefix)
 {
-    if (xtr_is_empty(xtr) || prefix == NULL)
+    if (xtr == NULL || xtr_is_shared(xtr))
+    {
+        return false;
+    }
+    size_t prefix_len;
+    if (prefix != NULL && has_prefix(xtr, prefix, &prefix_len))
     {
-        return;
+        consume_head(xtr, prefix_len);
     }
-    const size_t prefix_len = strlen(prefix);
-    if (prefix_len > xtr->used)
+    return true;
+}
+
+XTR_API bool
+xtr_truncate_prefix_cow(xtr_t** const pxtr, const char* const prefix)
+{
+    if (pxtr == NULL || *pxtr == NULL)
     {
-        return;
+        return false;
     }
-    if (memcmp(xtr->buffer, prefix, prefix_len) == 0)
+    size_t prefix_len;
+    if (prefix != NULL && has_prefix(*pxtr, prefix, &prefix_len))
     {
-        xtr_truncate_head(xtr, prefix_len);
+        return keep_cow(pxtr, prefix_len, (*pxtr)->used - prefix_len);
     }
+    return true;
 }
 
 XTR_API xtr_t*
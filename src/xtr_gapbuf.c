@@ -0,0 +1,250 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/*
+ * The text before the cursor is the xtring's content, thus `xtr->used` is the
+ * cursor, and the text after the cursor ends at `xtr->capacity`. Both count
+ * from `xtr->buffer`, after the head room left by e.g. xtr_truncate_head():
+ *
+ *         [capacity][used][refs][buffer][head room][before..........after\0]
+ *                                                  ^buffer    ^used      ^gap_end
+ *
+ * The content is not null-terminated while editing, as the terminator would
+ * overwrite the first byte after the cursor when the gap is empty.
+ */
+
+/** @internal Capacity of a gap buffer growing from an empty xtring. */
+#define GAPBUF_MIN_CAPACITY 64U
+
+static size_t
+gapbuf_after_len(const xtr_gapbuf_t* const gapbuf)
+{
+    return gapbuf->xtr->capacity - gapbuf->gap_end;
+}
+
+/**
+ * @internal
+ * Moves the text into a new allocation with a gap of at least `gap_len`
+ * bytes, doubling the capacity at least, for amortised O(1) insertions.
+ */
+static bool
+gapbuf_grow(xtr_gapbuf_t* const gapbuf, const size_t gap_len)
+{
+    xtr_t* old = gapbuf->xtr;
+    const size_t after_len = gapbuf_after_len(gapbuf);
+    const size_t text_len = old->used + after_len;
+    const size_t needed = text_len + gap_len;
+    if (needed < text_len)
+    {
+        return false;  // Size overflow
+    }
+    size_t capacity = XTR_MAX(old->capacity, GAPBUF_MIN_CAPACITY / 2U) * 2U;
+    if (capacity < needed || capacity < old->capacity)
+    {
+        capacity = needed;
+    }
+    xtr_t* const grown = xtr_alloc(0U, capacity);
+    if (grown == NULL)
+    {
+        return false;
+    }
+    memcpy(grown->buffer, old->buffer, old->used);
+    memcpy(&grown->buffer[capacity - after_len], &old->buffer[gapbuf->gap_end], after_len);
+    grown->used = old->used;
+    gapbuf->xtr = grown;
+    gapbuf->gap_end = capacity - after_len;
+    xtr_free(&old);
+    return true;
+}
+
+XTR_API bool
+xtr_gapbuf_init(xtr_gapbuf_t* const gapbuf, xtr_t** const pxtr)
+{
+    if (gapbuf == NULL || xtr_unshare(pxtr) == NULL)
+    {
+        return false;
+    }
+    gapbuf->xtr = *pxtr;
+    gapbuf->gap_end = gapbuf->xtr->capacity;
+    *pxtr = NULL;
+    return true;
+}
+
+XTR_API void
+xtr_gapbuf_free(xtr_gapbuf_t* const gapbuf)
+{
+    if (gapbuf != NULL)
+    {
+        xtr_free(&gapbuf->xtr);
+    }
+}
+
+XTR_API xtr_t*
+xtr_gapbuf_to_xtr(xtr_gapbuf_t* const gapbuf)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        return NULL;
+    }
+    xtr_t* const xtr = gapbuf->xtr;
+    const size_t after_len = gapbuf_after_len(gapbuf);
+    memmove_zero_out(&xtr->buffer[xtr->used], &xtr->buffer[gapbuf->gap_end], after_len);
+    set_used_and_terminator(xtr, xtr->used + after_len);
+    gapbuf->xtr = NULL;
+    return xtr;
+}
+
+XTR_API size_t
+xtr_gapbuf_length(const xtr_gapbuf_t* const gapbuf)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        return 0U;
+    }
+    return gapbuf->xtr->used + gapbuf_after_len(gapbuf);
+}
+
+XTR_API size_t
+xtr_gapbuf_cursor(const xtr_gapbuf_t* const gapbuf)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        return 0U;
+    }
+    return gapbuf->xtr->used;
+}
+
+XTR_API bool
+xtr_gapbuf_move(xtr_gapbuf_t* const gapbuf, const size_t position)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL || position > xtr_gapbuf_length(gapbuf))
+    {
+        return false;
+    }
+    xtr_t* const xtr = gapbuf->xtr;
+    if (position < xtr->used)
+    {
+        // Bytes between the new and the old cursor jump after the gap
+        const size_t distance = xtr->used - position;
+        gapbuf->gap_end -= distance;
+        memmove_zero_out(&xtr->buffer[gapbuf->gap_end], &xtr->buffer[position], distance);
+        xtr->used = position;
+    }
+    else
+    {
+        // Bytes between the old and the new cursor jump before the gap
+        const size_t distance = position - xtr->used;
+        memmove_zero_out(&xtr->buffer[xtr->used], &xtr->buffer[gapbuf->gap_end], distance);
+        gapbuf->gap_end += distance;
+        xtr->used = position;
+    }
+    return true;
+}
+
+XTR_API bool
+xtr_gapbuf_insert(xtr_gapbuf_t* const gapbuf, const xtr_view_t text)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL || text.bytes == NULL)
+    {
+        return false;
+    }
+    if (gapbuf->gap_end - gapbuf->xtr->used < text.length && !gapbuf_grow(gapbuf, text.length))
+    {
+        return false;
+    }
+    memcpy(&gapbuf->xtr->buffer[gapbuf->xtr->used], text.bytes, text.length);
+    gapbuf->xtr->used += text.length;
+    return true;
+}
+
+XTR_API size_t
+xtr_gapbuf_delete(xtr_gapbuf_t* const gapbuf, const size_t len)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        return 0U;
+    }
+    const size_t deleted = XTR_MIN(len, gapbuf_after_len(gapbuf));
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+    zero_out(&gapbuf->xtr->buffer[gapbuf->gap_end], deleted);
+#endif
+    gapbuf->gap_end += deleted;
+    return deleted;
+}
+
+XTR_API size_t
+xtr_gapbuf_backspace(xtr_gapbuf_t* const gapbuf, const size_t len)
+{
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        return 0U;
+    }
+    const size_t deleted = XTR_MIN(len, gapbuf->xtr->used);
+    gapbuf->xtr->used -= deleted;
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+    zero_out(&gapbuf->xtr->buffer[gapbuf->xtr->used], deleted);
+#endif
+    return deleted;
+}
+
+XTR_API bool
+xtr_gapbuf_before(xtr_view_t* const view, const xtr_gapbuf_t* const gapbuf)
+{
+    if (view == NULL)
+    {
+        return false;
+    }
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        xtr_view_from_bytes(view, NULL, 0U);
+        return false;
+    }
+    xtr_view_from_bytes(view, gapbuf->xtr->buffer, gapbuf->xtr->used);
+    return true;
+}
+
+XTR_API bool
+xtr_gapbuf_after(xtr_view_t* const view, const xtr_gapbuf_t* const gapbuf)
+{
+    if (view == NULL)
+    {
+        return false;
+    }
+    if (gapbuf == NULL || gapbuf->xtr == NULL)
+    {
+        xtr_view_from_bytes(view, NULL, 0U);
+        return false;
+    }
+    xtr_view_from_bytes(view, &gapbuf->xtr->buffer[gapbuf->gap_end], gapbuf_after_len(gapbuf));
+    return true;
+}
@@ -48,7 +48,7 @@ xtr_capacity(const xtr_t* const xtr)
     {
         return 0U;
     }
-    return xtr->capacity;
+    return xtr_head_room(xtr) + xtr->capacity;
 }
 
 XTR_API XTR_INLINE size_t
@@ -58,7 +58,7 @@ xtr_available(const xtr_t* const xtr)
     {
         return 0U;
     }
-    return xtr->capacity - xtr->used;
+    return xtr_head_room(xtr) + xtr->capacity - xtr->used;
 }
 
 XTR_API const char*
@@ -119,12 +119,24 @@ xtr_to_hex(const xtr_t* const bin, const bool upper, const char* const separator
     {
         return NULL;
     }
+    xtr_view_t view;
+    xtr_view(&view, bin);
+    return xtr_view_to_hex(view, upper, separator);
+}
+
+XTR_API xtr_t*
+xtr_view_to_hex(const xtr_view_t bin, const bool upper, const char* const separator)
+{
+    if (bin.bytes == NULL)
+    {
+        return NULL;
+    }
     size_t sep_len = 0U;
     if (separator != NULL)
     {
         sep_len = strlen(separator);
     }
-    xtr_t* hex = xtr_new(bin->used * (2U + sep_len));
+    xtr_t* hex = xtr_new(bin.length * (2U + sep_len));
     if (hex == NULL)
     {
         return NULL;
@@ -139,17 +151,17 @@ xtr_to_hex(const xtr_t* const bin, const bool upper, const char* const separator
         hexchars = HEXCHARS_LOWER;
     }
     size_t hex_index = 0U;
-    for (size_t bin_index = 0U; bin_index < bin->used; bin_index++)
+    for (size_t bin_index = 0U; bin_index < bin.length; bin_index++)
     {
         // Encode a byte to two hex characters
-        hex->buffer[hex_index++] = hexchars[bin->buffer[bin_index] >> 4U];
-        hex->buffer[hex_index++] = hexchars[bin->buffer[bin_index] & 0x0FU];
+        hex->buffer[hex_index++] = hexchars[bin.bytes[bin_index] >> 4U];
+        hex->buffer[hex_index++] = hexchars[bin.bytes[bin_index] & 0x0FU];
         if (separator != NULL)
         {
             memcpy(&hex->buffer[hex_index], separator, sep_len);
             hex_index += sep_len;
         }
     }
-    set_used_and_terminator(hex, bin->used * (2U + sep_len));
+    set_used_and_terminator(hex, bin.length * (2U + sep_len));
     return hex;
 }
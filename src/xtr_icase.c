@@ -0,0 +1,398 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+#if defined(XTR_AVX2)
+/**
+ * @internal
+ * Lowercases the ASCII letters of 32 bytes at once.
+ *
+ * Shifts the 'A'..'Z' range to the lowest signed values, so a single signed
+ * comparison detects the uppercase letters, to which 0x20 is added.
+ */
+XTR_INLINE static __m256i
+fold32(const __m256i block)
+{
+    const __m256i shifted = _mm256_add_epi8(block, _mm256_set1_epi8((char) (0x80 - 'A')));
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (-128 + 26)), shifted);
+    return _mm256_or_si256(block, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+#if defined(XTR_SSE2)
+/**
+ * @internal
+ * Lowercases the ASCII letters of 16 bytes at once, as fold32().
+ */
+XTR_INLINE static __m128i
+fold16(const __m128i block)
+{
+    const __m128i shifted = _mm_add_epi8(block, _mm_set1_epi8((char) (0x80 - 'A')));
+    const __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char) (-128 + 26)));
+    return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+size_t
+xtr_icase_mismatch(const uint8_t* const a, const uint8_t* const b, const size_t len)
+{
+    size_t i = 0U;
+#if defined(XTR_AVX2)
+    for (; i + 32U <= len; i += 32U)
+    {
+        const __m256i block_a = fold32(_mm256_loadu_si256((const __m256i*) (a + i)));
+        const __m256i block_b = fold32(_mm256_loadu_si256((const __m256i*) (b + i)));
+        const uint32_t differing =
+            ~(uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block_a, block_b));
+        if (differing != 0U)
+        {
+            return i + xtr_ctz32(differing);
+        }
+    }
+#endif
+#if defined(XTR_SSE2)
+    for (; i + 16U <= len; i += 16U)
+    {
+        const __m128i block_a = fold16(_mm_loadu_si128((const __m128i*) (a + i)));
+        const __m128i block_b = fold16(_mm_loadu_si128((const __m128i*) (b + i)));
+        const uint32_t differing =
+            ~(uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block_a, block_b)) & 0xFFFFU;
+        if (differing != 0U)
+        {
+            return i + xtr_ctz32(differing);
+        }
+    }
+#endif
+    for (; i < len; i++)
+    {
+        if (xtr_ascii_lower(a[i]) != xtr_ascii_lower(b[i]))
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * @internal
+ * Case-insensitive search of a single byte.
+ */
+static const uint8_t*
+icase_byte_search(const uint8_t* const haystack, const size_t haystack_len, const uint8_t byte)
+{
+    const uint8_t lower = xtr_ascii_lower(byte);
+    if ((uint8_t) ((byte | 0x20U) - 'a') >= 26U)
+    {
+        return memchr(haystack, byte, haystack_len);  // Not a letter
+    }
+    size_t i = 0U;
+#if defined(XTR_AVX2)
+    const __m256i wanted32 = _mm256_set1_epi8((char) lower);
+    for (; i + 32U <= haystack_len; i += 32U)
+    {
+        const __m256i block = fold32(_mm256_loadu_si256((const __m256i*) (haystack + i)));
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, wanted32));
+        if (mask != 0U)
+        {
+            return haystack + i + xtr_ctz32(mask);
+        }
+    }
+#elif defined(XTR_SSE2)
+    const __m128i wanted16 = _mm_set1_epi8((char) lower);
+    for (; i + 16U <= haystack_len; i += 16U)
+    {
+        const __m128i block = fold16(_mm_loadu_si128((const __m128i*) (haystack + i)));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, wanted16));
+        if (mask != 0U)
+        {
+            return haystack + i + xtr_ctz32(mask);
+        }
+    }
+#endif
+    for (; i < haystack_len; i++)
+    {
+        if (xtr_ascii_lower(haystack[i]) == lower)
+        {
+            return &haystack[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * Case-insensitive variant of xtr_twoway_search(), without the memchr()
+ * skip of the rarest byte, which cannot match both cases at once.
+ */
+static const uint8_t*
+icase_twoway_search(const xtr_twoway_t* const twoway,
+                    const uint8_t* const haystack,
+                    const size_t haystack_len,
+                    const uint8_t* const needle,
+                    const size_t needle_len)
+{
+    const size_t suffix = twoway->suffix;
+    const size_t period = twoway->period;
+    const size_t last_start = haystack_len - needle_len;
+    size_t memory = 0U;
+    size_t j = 0U;  // Candidate position of the needle in the haystack
+    size_t i;       // Position in the needle being compared
+    while (j <= last_start)
+    {
+        i = XTR_MAX(suffix, memory);
+        // Scan for matches in the right half
+        while (i < needle_len && xtr_ascii_lower(needle[i]) == xtr_ascii_lower(haystack[i + j]))
+        {
+            i++;
+        }
+        if (i >= needle_len)
+        {
+            // Scan for matches in the left half
+            i = suffix - 1U;
+            while (memory < i + 1U &&
+                   xtr_ascii_lower(needle[i]) == xtr_ascii_lower(haystack[i + j]))
+            {
+                i--;
+            }
+            if (i + 1U < memory + 1U)
+            {
+                return &haystack[j];
+            }
+            j += period;
+            // Only periodic needles remember the matched repetitions
+            memory = twoway->periodic ? needle_len - period : 0U;
+        }
+        else
+        {
+            j += i - suffix + 1U;
+            memory = 0U;
+        }
+    }
+    return NULL;
+}
+
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+/**
+ * @internal
+ * Case-insensitive variant of the SIMD first/last-byte filter of
+ * xtr_memmem(), folding the case of the haystack blocks before comparing.
+ *
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 2
+ * @param [out] resume first haystack position not scanned yet, when not found
+ * @return pointer to the first needle occurrence in the scanned section or NULL
+ */
+static const uint8_t*
+icase_simd_filtered_search(const uint8_t* const haystack,
+                           const size_t haystack_len,
+                           const uint8_t* const needle,
+                           const size_t needle_len,
+                           size_t* const resume)
+{
+    const size_t positions = haystack_len - needle_len + 1U;
+    const uint8_t* const last_byte = haystack + needle_len - 1U;
+    const char first = (char) xtr_ascii_lower(needle[0]);
+    const char last = (char) xtr_ascii_lower(needle[needle_len - 1U]);
+    size_t verified = 0U;
+    size_t i = 0U;
+    #if defined(XTR_AVX2)
+    const __m256i first32 = _mm256_set1_epi8(first);
+    const __m256i last32 = _mm256_set1_epi8(last);
+    const size_t step = 32U;
+    #else
+    const __m128i first16 = _mm_set1_epi8(first);
+    const __m128i last16 = _mm_set1_epi8(last);
+    const size_t step = 16U;
+    #endif
+    for (; i + step <= positions; i += step)
+    {
+    #if defined(XTR_AVX2)
+        const __m256i block_first = fold32(_mm256_loadu_si256((const __m256i*) (haystack + i)));
+        const __m256i block_last = fold32(_mm256_loadu_si256((const __m256i*) (last_byte + i)));
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first32), _mm256_cmpeq_epi8(block_last, last32)));
+    #else
+        const __m128i block_first = fold16(_mm_loadu_si128((const __m128i*) (haystack + i)));
+        const __m128i block_last = fold16(_mm_loadu_si128((const __m128i*) (last_byte + i)));
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block_first, first16), _mm_cmpeq_epi8(block_last, last16)));
+    #endif
+        while (mask != 0U)
+        {
+            const uint8_t* const candidate = haystack + i + xtr_ctz32(mask);
+            if (xtr_icase_mismatch(candidate + 1U, needle + 1U, needle_len - 2U) ==
+                needle_len - 2U)
+            {
+                return candidate;
+            }
+            verified += needle_len;
+            mask &= mask - 1U;  // Clear lowest set bit
+        }
+        if (verified > i * XTR_SIMD_VERIFY_FACTOR + XTR_SIMD_VERIFY_ALLOWANCE)
+        {
+            i += step;
+            break;
+        }
+    }
+    *resume = i;
+    return NULL;
+}
+#endif
+
+/**
+ * @internal
+ * Case-insensitive counterpart of xtr_memmem_prepared(), without the
+ * input validation.
+ */
+static const uint8_t*
+icase_search(const uint8_t* const haystack,
+             const size_t haystack_len,
+             const uint8_t* const needle,
+             const size_t needle_len)
+{
+    if (needle_len == 1U)
+    {
+        return icase_byte_search(haystack, haystack_len, needle[0]);
+    }
+    size_t resume = 0U;
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+    const uint8_t* const found =
+        icase_simd_filtered_search(haystack, haystack_len, needle, needle_len, &resume);
+    if (found != NULL || resume + needle_len > haystack_len)
+    {
+        return found;
+    }
+#endif
+    // Tail shorter than a vector, too many false positives or no SIMD:
+    // the Two-Way search is linear in the worst case
+    xtr_twoway_t twoway;
+    xtr_twoway_prepare_icase(&twoway, needle, needle_len);
+    return icase_twoway_search(&twoway, haystack + resume, haystack_len - resume, needle,
+                               needle_len);
+}
+
+XTR_API size_t
+xtr_find_icase(const xtr_t* const haystack, const xtr_t* const needle)
+{
+    if (xtr_is_empty(haystack) || xtr_is_empty(needle) || needle->used > haystack->used)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const uint8_t* const location =
+        icase_search(haystack->buffer, haystack->used, needle->buffer, needle->used);
+    if (location == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return (size_t) (location - haystack->buffer);
+}
+
+XTR_API int
+xtr_cmp_icase(const xtr_t* const a, const xtr_t* const b)
+{
+    if (a == b)
+    {
+        return 0;
+    }
+    if (a == NULL)
+    {
+        return -1;
+    }
+    if (b == NULL)
+    {
+        return +1;
+    }
+    const size_t minlen = XTR_MIN(a->used, b->used);
+    const size_t mismatch = xtr_icase_mismatch(a->buffer, b->buffer, minlen);
+    if (mismatch < minlen)
+    {
+        // Content differs
+        return xtr_ascii_lower(a->buffer[mismatch]) < xtr_ascii_lower(b->buffer[mismatch])
+                   ? -3
+                   : +3;
+    }
+    // Equal part of the content until the end of the shortest xtring
+    if (a->used < b->used)
+    {
+        return -2;
+    }
+    else if (a->used > b->used)
+    {
+        return +2;
+    }
+    return 0;
+}
+
+XTR_API bool
+xtr_is_equal_icase(const xtr_t* const a, const xtr_t* const b)
+{
+    if (a == b)
+    {
+        return true;
+    }
+    if (a == NULL || b == NULL || a->used != b->used)
+    {
+        return false;
+    }
+    return xtr_icase_mismatch(a->buffer, b->buffer, a->used) == a->used;
+}
+
+XTR_API bool
+xtr_startswith_icase(const xtr_t* const xtr, const xtr_t* const prefix)
+{
+    if (xtr == prefix)
+    {
+        return true;
+    }
+    if (xtr == NULL || prefix == NULL || xtr->used < prefix->used)
+    {
+        return false;
+    }
+    return xtr_icase_mismatch(xtr->buffer, prefix->buffer, prefix->used) == prefix->used;
+}
+
+XTR_API bool
+xtr_endswith_icase(const xtr_t* const xtr, const xtr_t* const suffix)
+{
+    if (xtr == suffix)
+    {
+        return true;
+    }
+    if (xtr == NULL || suffix == NULL || xtr->used < suffix->used)
+    {
+        return false;
+    }
+    return xtr_icase_mismatch(&xtr->buffer[xtr->used - suffix->used], suffix->buffer,
+                              suffix->used) == suffix->used;
+}
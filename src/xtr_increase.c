@@ -34,75 +34,225 @@
 XTR_API size_t
 xtr_push_tail(xtr_t* const xtr, const xtr_t* const extension)
 {
-    if (xtr == NULL || extension == NULL || xtr_capacity(xtr) < extension->used)
+    if (xtr == NULL || extension == NULL || xtr_available(xtr) < extension->used ||
+        xtr_is_shared(xtr))
     {
         return 0U;
     }
-    memcpy(&xtr->buffer[xtr->used], extension->buffer, extension->used);
-    set_used_and_terminator(xtr, xtr->used + extension->used);
-    return extension->used;
+    const size_t len = extension->used;  // Changes when pushing onto itself
+    if (xtr->capacity - xtr->used < len)
+    {
+        xtr_drop_head_room(xtr);
+    }
+    memcpy(&xtr->buffer[xtr->used], extension->buffer, len);
+    set_used_and_terminator(xtr, xtr->used + len);
+    return len;
 }
 
 XTR_API size_t
 xtr_push_head(xtr_t* const xtr, const xtr_t* const extension)
 {
-    if (xtr == NULL || extension == NULL || xtr_capacity(xtr) < extension->used)
+    if (xtr == NULL || extension == NULL || xtr_available(xtr) < extension->used ||
+        xtr_is_shared(xtr))
     {
         return 0U;
     }
-    memmove(&xtr->buffer[extension->used], xtr->buffer, xtr->used);
-    memcpy(xtr->buffer, extension->buffer, extension->used);
-    set_used_and_terminator(xtr, xtr->used + extension->used);
-    return extension->used;
+    const size_t len = extension->used;  // Changes when pushing onto itself
+    const size_t head_room = xtr_head_room(xtr);
+    if (head_room < len)
+    {
+        // Recenter: the content moves once, leaving half the free space as
+        // head room for the next pushes
+        const size_t free_space = head_room + xtr->capacity - xtr->used;
+        const size_t new_head_room = len + (free_space - len) / 2U;
+        uint8_t* const new_buffer = &xtr->storage[new_head_room];
+        memmove(new_buffer, xtr->buffer, xtr->used);
+        xtr->capacity = xtr->capacity + head_room - new_head_room;
+        xtr->buffer = new_buffer;
+        set_used_and_terminator(xtr, xtr->used);
+    }
+    // Read after recentering, as the extension may be the xtring itself
+    const uint8_t* const source = extension->buffer;
+    xtr->buffer -= len;
+    xtr->capacity += len;
+    memcpy(xtr->buffer, source, len);
+    set_used_and_terminator(xtr, xtr->used + len);
+    return len;
 }
 
-XTR_API xtr_t*
-xtr_extend_tail(xtr_t** const pxtr, const xtr_t* const extension)
+/**
+ * @internal
+ * Whether the extension fits into the xtring, after copying it if shared.
+ */
+static bool
+push_cow_fits(xtr_t** const pxtr, const xtr_t* const extension)
 {
-    // TODO copy pointers locally for reentrancy
-    if (pxtr == NULL || *pxtr == NULL || extension == NULL)
+    // Checked before the copy, which has the same capacity
+    return pxtr != NULL && *pxtr != NULL && extension != NULL &&
+           xtr_available(*pxtr) >= extension->used && xtr_unshare(pxtr) != NULL;
+}
+
+XTR_API size_t
+xtr_push_tail_cow(xtr_t** const pxtr, const xtr_t* const extension)
+{
+    if (!push_cow_fits(pxtr, extension))
     {
-        return NULL;
+        return 0U;
     }
-    if (xtr_capacity(*pxtr) >= extension->used)
+    return xtr_push_tail(*pxtr, extension);
+}
+
+XTR_API size_t
+xtr_push_head_cow(xtr_t** const pxtr, const xtr_t* const extension)
+{
+    if (!push_cow_fits(pxtr, extension))
     {
-        xtr_push_tail(*pxtr, extension);
+        return 0U;
     }
-    else
+    return xtr_push_head(*pxtr, extension);
+}
+
+/** @internal Policy of xtr_extend_head() and xtr_extend_tail(), see xtr_set_growth(). */
+static xtr_growth_t growth_policy = {200U, 0U, 16U};
+
+XTR_API void
+xtr_growth(xtr_growth_t* const growth)
+{
+    if (growth != NULL)
+    {
+        *growth = growth_policy;
+    }
+}
+
+XTR_API void
+xtr_set_growth(const xtr_growth_t growth)
+{
+    growth_policy = growth;
+}
+
+/**
+ * @internal
+ * Capacity to allocate for `needed` bytes according to the growth policy.
+ * Falls back to less spare room rather than overflowing.
+ */
+static size_t
+grown_capacity(const size_t needed, const xtr_growth_t* const growth)
+{
+    size_t slack = 0U;
+    if (growth->factor_percent > 100U)
+    {
+        // Clamped to 100x, so the split product below cannot overflow
+        const size_t extra_percent = XTR_MIN(growth->factor_percent, 10000U) - 100U;
+        const size_t hundreds = needed / 100U;
+        slack = hundreds > (SIZE_MAX - 10000U) / extra_percent
+                    ? SIZE_MAX
+                    : hundreds * extra_percent + needed % 100U * extra_percent / 100U;
+    }
+    if (growth->max_slack != 0U)
+    {
+        slack = XTR_MIN(slack, growth->max_slack);
+    }
+    size_t capacity = needed + XTR_MIN(slack, SIZE_MAX - needed);
+    if (sizeof_struct_xtr(capacity) == SIZE_OVERFLOW)
+    {
+        return needed;
+    }
+    if (growth->size_class > 1U)
     {
-        xtr_t* const new = xtr_concat(*pxtr, extension);
-        if (new == NULL)
+        const size_t size = sizeof_struct_xtr(capacity);
+        const size_t size_class = growth->size_class;
+        const size_t padding = (size_class - size % size_class) % size_class;
+        if (size + padding >= size)
         {
-            return NULL;
+            capacity += padding;
         }
-        xtr_free(pxtr);
-        *pxtr = new;
     }
-    return *pxtr;
+    return capacity;
+}
+
+/**
+ * @internal
+ * Replaces `*pxtr` with a copy of it extended by `extension`, with the
+ * spare room of the growth policy at the side being extended.
+ */
+static xtr_t*
+extend_grown(xtr_t** const pxtr, const xtr_t* const extension,
+             const xtr_growth_t* const growth, const bool at_head)
+{
+    const xtr_t* const old = *pxtr;
+    const size_t needed = old->used + extension->used;
+    if (needed < old->used)
+    {
+        return NULL;
+    }  // Size overflow
+    const size_t capacity = grown_capacity(needed, growth == NULL ? &growth_policy : growth);
+    xtr_t* const new = xtr_alloc(needed, capacity);
+    if (new == NULL)
+    {
+        return NULL;
+    }
+    if (at_head)
+    {
+        // Spare room before the content, for the next prepends
+        new->buffer += capacity - needed;
+        new->capacity = needed;
+        memcpy(new->buffer, extension->buffer, extension->used);
+        memcpy(&new->buffer[extension->used], old->buffer, old->used);
+    }
+    else
+    {
+        memcpy(new->buffer, old->buffer, old->used);
+        memcpy(&new->buffer[old->used], extension->buffer, extension->used);
+    }
+    set_used_and_terminator(new, needed);
+    xtr_free(pxtr);
+    *pxtr = new;
+    return new;
 }
 
 XTR_API xtr_t*
-xtr_extend_head(xtr_t** const pxtr, const xtr_t* const extension)
+xtr_extend_tail_growth(xtr_t** const pxtr, const xtr_t* const extension,
+                       const xtr_growth_t* const growth)
 {
+    // TODO copy pointers locally for reentrancy
     if (pxtr == NULL || *pxtr == NULL || extension == NULL)
     {
         return NULL;
     }
-    if (xtr_capacity(*pxtr) >= extension->used)
+    if (xtr_available(*pxtr) >= extension->used && !xtr_is_shared(*pxtr))
     {
-        xtr_push_head(*pxtr, extension);
+        xtr_push_tail(*pxtr, extension);
+        return *pxtr;
     }
-    else
+    return extend_grown(pxtr, extension, growth, false);
+}
+
+XTR_API xtr_t*
+xtr_extend_head_growth(xtr_t** const pxtr, const xtr_t* const extension,
+                       const xtr_growth_t* const growth)
+{
+    if (pxtr == NULL || *pxtr == NULL || extension == NULL)
     {
-        xtr_t* const new = xtr_concat(extension, *pxtr);
-        if (new == NULL)
-        {
-            return NULL;
-        }
-        xtr_free(pxtr);
-        *pxtr = new;
+        return NULL;
+    }
+    if (xtr_available(*pxtr) >= extension->used && !xtr_is_shared(*pxtr))
+    {
+        xtr_push_head(*pxtr, extension);
+        return *pxtr;
     }
-    return *pxtr;
+    return extend_grown(pxtr, extension, growth, true);
+}
+
+XTR_API xtr_t*
+xtr_extend_tail(xtr_t** const pxtr, const xtr_t* const extension)
+{
+    return xtr_extend_tail_growth(pxtr, extension, NULL);
+}
+
+XTR_API xtr_t*
+xtr_extend_head(xtr_t** const pxtr, const xtr_t* const extension)
+{
+    return xtr_extend_head_growth(pxtr, extension, NULL);
 }
 
 XTR_API xtr_t*
@@ -0,0 +1,643 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+/** @internal Unused slot of the suffix array while sorting. */
+#define SAIS_EMPTY UINT32_MAX
+
+/**
+ * @internal
+ * Text being sorted by sais(): the bytes widened to 32 bits at the top level,
+ * names of the LMS substrings of the upper level in the recursion.
+ */
+typedef struct
+{
+    const uint32_t* chars;
+    size_t len;
+    /** Alphabet size: values are in `[0, alphabet)`. */
+    size_t alphabet;
+    /** Whether each suffix is S-type, including the empty suffix `len`. */
+    uint8_t* s_type;
+    /** Start or end of the bucket of each value. */
+    uint32_t* buckets;
+} sais_text_t;
+
+XTR_INLINE static size_t
+sais_char(const sais_text_t* const t, const size_t i)
+{
+    return t->chars[i];
+}
+
+XTR_INLINE static bool
+sais_is_s(const sais_text_t* const t, const size_t i)
+{
+    return t->s_type[i] != 0U;
+}
+
+/** @internal Leftmost S-type: S-type suffix right after an L-type one. */
+XTR_INLINE static bool
+sais_is_lms(const sais_text_t* const t, const size_t i)
+{
+    return i > 0U && sais_is_s(t, i) && !sais_is_s(t, i - 1U);
+}
+
+/** @internal Computes the first index (or the one after the last) of each bucket. */
+static void
+sais_buckets(const sais_text_t* const t, const bool ends)
+{
+    memset(t->buckets, 0, t->alphabet * sizeof(uint32_t));
+    for (size_t i = 0U; i < t->len; i++)
+    {
+        t->buckets[sais_char(t, i)]++;
+    }
+    uint32_t sum = 0U;
+    for (size_t c = 0U; c < t->alphabet; c++)
+    {
+        sum += t->buckets[c];
+        t->buckets[c] = ends ? sum : sum - t->buckets[c];
+    }
+}
+
+/**
+ * @internal
+ * Sorts the L-type suffixes, then the S-type ones, from the LMS suffixes
+ * placed at the ends of their buckets.
+ */
+static void
+sais_induce(const sais_text_t* const t, uint32_t* const sa)
+{
+    sais_buckets(t, false);
+    // The empty suffix, virtually first, induces the last one
+    sa[t->buckets[sais_char(t, t->len - 1U)]++] = (uint32_t) (t->len - 1U);
+    for (size_t i = 0U; i < t->len; i++)
+    {
+        if (sa[i] != SAIS_EMPTY && sa[i] > 0U && !sais_is_s(t, sa[i] - 1U))
+        {
+            const uint32_t j = sa[i] - 1U;
+            sa[t->buckets[sais_char(t, j)]++] = j;
+        }
+    }
+    sais_buckets(t, true);
+    for (size_t i = t->len; i > 0U; i--)
+    {
+        if (sa[i - 1U] != SAIS_EMPTY && sa[i - 1U] > 0U && sais_is_s(t, sa[i - 1U] - 1U))
+        {
+            const uint32_t j = sa[i - 1U] - 1U;
+            sa[--t->buckets[sais_char(t, j)]] = j;
+        }
+    }
+}
+
+/** @internal Checks whether the LMS substrings at two different indices are equal. */
+static bool
+sais_lms_equal(const sais_text_t* const t, const size_t a, const size_t b)
+{
+    for (size_t d = 0U;; d++)
+    {
+        // The empty suffix is unique
+        if (a + d == t->len || b + d == t->len || sais_char(t, a + d) != sais_char(t, b + d) ||
+            sais_is_s(t, a + d) != sais_is_s(t, b + d))
+        {
+            return false;
+        }
+        if (d > 0U && sais_is_lms(t, a + d))
+        {
+            return true;  // Both end here, as the previous types are equal
+        }
+    }
+}
+
+static bool
+sais(sais_text_t* t, uint32_t* sa);
+
+/**
+ * @internal
+ * Sorts the LMS suffixes, placing them at the ends of their buckets in
+ * sorted order: sorts the LMS substrings by induction, names them by rank
+ * and, if the names are not unique, recursively sorts the text of names.
+ */
+static bool
+sais_sort_lms(const sais_text_t* const t, uint32_t* const sa)
+{
+    const size_t n = t->len;
+    memset(sa, 0xFF, n * sizeof(uint32_t));
+    sais_buckets(t, true);
+    for (size_t i = 1U; i < n; i++)
+    {
+        if (sais_is_lms(t, i))
+        {
+            sa[--t->buckets[sais_char(t, i)]] = (uint32_t) i;
+        }
+    }
+    sais_induce(t, sa);
+    size_t lms_amount = 0U;
+    for (size_t i = 0U; i < n; i++)
+    {
+        if (sais_is_lms(t, sa[i]))
+        {
+            sa[lms_amount++] = sa[i];
+        }
+    }
+    // Names stored in the upper half by index: LMS indices are 2+ apart
+    memset(&sa[lms_amount], 0xFF, (n - lms_amount) * sizeof(uint32_t));
+    uint32_t names = 0U;
+    for (size_t i = 0U; i < lms_amount; i++)
+    {
+        if (i == 0U || !sais_lms_equal(t, sa[i], sa[i - 1U]))
+        {
+            names++;
+        }
+        sa[lms_amount + sa[i] / 2U] = names - 1U;
+    }
+    uint32_t* const reduced = &sa[n - lms_amount];
+    for (size_t i = n, j = n; i > lms_amount; i--)
+    {
+        if (sa[i - 1U] != SAIS_EMPTY)
+        {
+            sa[--j] = sa[i - 1U];
+        }
+    }
+    // Order of the LMS suffixes, as indices in `reduced`
+    if (names < lms_amount)
+    {
+        sais_text_t names_text = {reduced, lms_amount, names, NULL, NULL};
+        if (!sais(&names_text, sa))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        for (size_t i = 0U; i < lms_amount; i++)
+        {
+            sa[reduced[i]] = (uint32_t) i;
+        }
+    }
+    // From indices in `reduced` to text indices
+    for (size_t i = 1U, j = 0U; i < n; i++)
+    {
+        if (sais_is_lms(t, i))
+        {
+            reduced[j++] = (uint32_t) i;
+        }
+    }
+    for (size_t i = 0U; i < lms_amount; i++)
+    {
+        sa[i] = reduced[sa[i]];
+    }
+    memset(&sa[lms_amount], 0xFF, (n - lms_amount) * sizeof(uint32_t));
+    sais_buckets(t, true);
+    for (size_t i = lms_amount; i > 0U; i--)
+    {
+        const uint32_t j = sa[i - 1U];
+        sa[i - 1U] = SAIS_EMPTY;
+        sa[--t->buckets[sais_char(t, j)]] = j;
+    }
+    return true;
+}
+
+/**
+ * @internal
+ * Builds the suffix array of a text in linear time with the SA-IS algorithm
+ * by Nong, Zhang and Chan, with a virtual smallest empty suffix at the end.
+ *
+ * @param [in] t text to sort, its types and buckets allocated here
+ * @param [out] sa `t->len` entries, also used as working memory
+ * @return false in case of malloc failure
+ */
+static bool
+sais(sais_text_t* const t, uint32_t* const sa)
+{
+    const size_t n = t->len;
+    if (n <= 1U)
+    {
+        if (n == 1U)
+        {
+            sa[0] = 0U;
+        }
+        return true;
+    }
+    t->s_type = XTR_MALLOC(n + 1U);
+    t->buckets = XTR_MALLOC(t->alphabet * sizeof(uint32_t));
+    const bool success = t->s_type != NULL && t->buckets != NULL;
+    if (success)
+    {
+        t->s_type[n] = 1U;
+        t->s_type[n - 1U] = 0U;
+        for (size_t i = n - 1U; i > 0U; i--)
+        {
+            const size_t current = sais_char(t, i - 1U);
+            const size_t next = sais_char(t, i);
+            t->s_type[i - 1U] = current < next || (current == next && t->s_type[i] != 0U);
+        }
+    }
+    if (success && sais_sort_lms(t, sa))
+    {
+        sais_induce(t, sa);
+        XTR_FREE(t->s_type);
+        XTR_FREE(t->buckets);
+        return true;
+    }
+    XTR_FREE(t->s_type);
+    XTR_FREE(t->buckets);
+    return false;
+}
+
+/**
+ * @internal
+ * Computes the LCP array from the suffix array in linear time, through the
+ * permuted LCP array indexed by text position (Kärkkäinen, Manzini, Puglisi).
+ *
+ * @return false in case of malloc failure
+ */
+static bool
+index_build_lcp(const uint8_t* const text,
+                const size_t len,
+                const uint32_t* const suffixes,
+                uint32_t* const lcp)
+{
+    if (len == 0U)
+    {
+        return true;
+    }
+    // Suffix preceding each one in the array, then turned into the LCP with it
+    uint32_t* const plcp = XTR_MALLOC(len * sizeof(uint32_t));
+    if (plcp == NULL)
+    {
+        return false;
+    }
+    plcp[suffixes[0]] = SAIS_EMPTY;
+    for (size_t i = 1U; i < len; i++)
+    {
+        plcp[suffixes[i]] = suffixes[i - 1U];
+    }
+    // The LCP of suffix i+1 is at least the one of suffix i minus 1
+    size_t common = 0U;
+    for (size_t i = 0U; i < len; i++)
+    {
+        if (plcp[i] == SAIS_EMPTY)
+        {
+            plcp[i] = 0U;
+            common = 0U;
+            continue;
+        }
+        const size_t previous = plcp[i];
+        while (i + common < len && previous + common < len &&
+               text[i + common] == text[previous + common])
+        {
+            common++;
+        }
+        plcp[i] = (uint32_t) common;
+        common -= common > 0U ? 1U : 0U;
+    }
+    for (size_t i = 0U; i < len; i++)
+    {
+        lcp[i] = plcp[suffixes[i]];
+    }
+    XTR_FREE(plcp);
+    return true;
+}
+
+/** @internal Offset of the suffix array in the serialised block of a text. */
+static size_t
+index_suffixes_offset(const size_t len)
+{
+    return XTR_INDEX_HEADER_LEN + (len + 3U) / 4U * 4U;
+}
+
+/** @internal Points the index arrays into its block. */
+static void
+index_point_arrays(xtr_index_t* const index)
+{
+    index->text = &index->block[XTR_INDEX_HEADER_LEN];
+    const size_t offset = index_suffixes_offset(index->len);
+    index->suffixes = (const uint32_t*) (const void*) &index->block[offset];
+    index->lcp = index->suffixes + index->len;
+}
+
+XTR_API xtr_index_t*
+xtr_index_new(const xtr_t* const text)
+{
+    // Suffix indices and the empty marker must fit 32 bits
+    if (text == NULL || text->used >= UINT32_MAX ||
+        text->used > (SIZE_MAX - XTR_INDEX_HEADER_LEN - 3U) / 9U)
+    {
+        return NULL;
+    }
+    xtr_index_t* const index = XTR_MALLOC(sizeof(xtr_index_t));
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    const size_t offset = index_suffixes_offset(text->used);
+    uint8_t* const block = XTR_CALLOC(offset + 2U * text->used * sizeof(uint32_t), 1U);
+    if (block == NULL)
+    {
+        XTR_FREE(index);
+        return NULL;
+    }
+    const uint32_t version = XTR_INDEX_VERSION;
+    const uint32_t byte_order = XTR_INDEX_BYTE_ORDER;
+    const uint64_t len = text->used;
+    memcpy(block, XTR_INDEX_MAGIC, 8U);
+    memcpy(&block[8], &version, sizeof(version));
+    memcpy(&block[12], &byte_order, sizeof(byte_order));
+    memcpy(&block[16], &len, sizeof(len));
+    memcpy(&block[XTR_INDEX_HEADER_LEN], text->buffer, text->used);
+    uint32_t* const suffixes = (uint32_t*) (void*) &block[offset];
+    uint32_t* const lcp = suffixes + text->used;
+    // The LCP array holds the text widened to 32 bits until sorted
+    for (size_t i = 0U; i < text->used; i++)
+    {
+        lcp[i] = text->buffer[i];
+    }
+    sais_text_t sorted = {lcp, text->used, UINT8_MAX + 1U, NULL, NULL};
+    if (!sais(&sorted, suffixes) || !index_build_lcp(text->buffer, text->used, suffixes, lcp))
+    {
+        XTR_FREE(block);
+        XTR_FREE(index);
+        return NULL;
+    }
+    index->len = text->used;
+    index->block = block;
+    index->size = offset + 2U * text->used * sizeof(uint32_t);
+    index->owned = true;
+    index_point_arrays(index);
+    return index;
+}
+
+XTR_API xtr_index_t*
+xtr_index_from_bytes(const uint8_t* const bytes, const size_t size)
+{
+    if (bytes == NULL || size < XTR_INDEX_HEADER_LEN || (uintptr_t) bytes % sizeof(uint32_t) != 0U)
+    {
+        return NULL;
+    }
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t len;
+    memcpy(&version, &bytes[8], sizeof(version));
+    memcpy(&byte_order, &bytes[12], sizeof(byte_order));
+    memcpy(&len, &bytes[16], sizeof(len));
+    if (memcmp(bytes, XTR_INDEX_MAGIC, 8U) != 0 || version != XTR_INDEX_VERSION ||
+        byte_order != XTR_INDEX_BYTE_ORDER || len >= UINT32_MAX ||
+        len > (SIZE_MAX - XTR_INDEX_HEADER_LEN - 3U) / 9U ||
+        size != index_suffixes_offset((size_t) len) + 2U * (size_t) len * sizeof(uint32_t))
+    {
+        return NULL;
+    }
+    xtr_index_t* const index = XTR_MALLOC(sizeof(xtr_index_t));
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    index->len = (size_t) len;
+    index->block = bytes;
+    index->size = size;
+    index->owned = false;
+    index_point_arrays(index);
+    return index;
+}
+
+XTR_API void
+xtr_index_free(xtr_index_t** const pindex)
+{
+    if (pindex != NULL && *pindex != NULL)
+    {
+        xtr_index_t* const index = *pindex;
+        if (index->owned)
+        {
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+            zero_out((void*) index->block, index->size);
+#endif
+            XTR_FREE((void*) index->block);
+        }
+        XTR_FREE(index);
+        *pindex = NULL;  // Clear outside reference to avoid use-after-free
+    }
+}
+
+XTR_API const uint8_t*
+xtr_index_bytes(const xtr_index_t* const index, size_t* const size)
+{
+    if (size != NULL)
+    {
+        *size = index == NULL ? 0U : index->size;
+    }
+    return index == NULL ? NULL : index->block;
+}
+
+/**
+ * @internal
+ * Binary search of the range of suffixes starting with the needle.
+ *
+ * Skips the bytes the needle has in common with both the suffixes bounding
+ * the range searched so far, as all the suffixes in between share them.
+ *
+ * @param [in] upper false to find the first suffix starting with the needle
+ *             or greater, true for the first greater one not starting with it
+ * @return index in the suffix array
+ */
+static size_t
+index_bound(const xtr_index_t* const index,
+            const uint8_t* const needle,
+            const size_t needle_len,
+            const bool upper)
+{
+    size_t low = 0U;
+    size_t high = index->len;
+    size_t low_common = 0U;
+    size_t high_common = 0U;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2U;
+        const size_t start = index->suffixes[middle];
+        // Corrupted serialised arrays are read as empty suffixes
+        const size_t suffix_len = start < index->len ? index->len - start : 0U;
+        const uint8_t* const suffix = &index->text[start < index->len ? start : 0U];
+        size_t common = XTR_MIN(low_common, high_common);
+        const size_t limit = XTR_MIN(needle_len, suffix_len);
+        while (common < limit && suffix[common] == needle[common])
+        {
+            common++;
+        }
+        bool before;
+        if (common == needle_len)
+        {
+            before = upper;  // Starts with the needle
+        }
+        else
+        {
+            // Corrupted arrays may skip past the suffix's end: never read it
+            before = common >= suffix_len || suffix[common] < needle[common];
+        }
+        if (before)
+        {
+            low = middle + 1U;
+            low_common = common;
+        }
+        else
+        {
+            high = middle;
+            high_common = common;
+        }
+    }
+    return low;
+}
+
+/**
+ * @internal
+ * Finds the range of the suffix array of the suffixes starting with the needle.
+ *
+ * @return amount of suffixes in the range starting at `first`,
+ *         #XTR_NOT_FOUND in case of NULL pointers or empty needle.
+ */
+static size_t
+index_range(const xtr_index_t* const index, const xtr_t* const needle, size_t* const first)
+{
+    *first = 0U;
+    if (index == NULL || xtr_is_empty(needle))
+    {
+        return XTR_NOT_FOUND;
+    }
+    *first = index_bound(index, needle->buffer, needle->used, false);
+    return index_bound(index, needle->buffer, needle->used, true) - *first;
+}
+
+XTR_API bool
+xtr_index_contains(const xtr_index_t* const index, const xtr_t* const needle)
+{
+    size_t first;
+    const size_t amount = index_range(index, needle, &first);
+    return amount != XTR_NOT_FOUND && amount > 0U;
+}
+
+XTR_API size_t
+xtr_index_occurrences(const xtr_index_t* const index, const xtr_t* const needle)
+{
+    size_t first;
+    return index_range(index, needle, &first);
+}
+
+XTR_API size_t
+xtr_index_find(const xtr_index_t* const index, const xtr_t* const needle)
+{
+    size_t first;
+    const size_t amount = index_range(index, needle, &first);
+    if (amount == XTR_NOT_FOUND)
+    {
+        return XTR_NOT_FOUND;
+    }
+    size_t lowest = XTR_NOT_FOUND;
+    for (size_t i = first; i < first + amount; i++)
+    {
+        // Skips positions of corrupted serialised arrays
+        if (index->suffixes[i] < index->len)
+        {
+            lowest = XTR_MIN(lowest, (size_t) index->suffixes[i]);
+        }
+    }
+    return lowest;
+}
+
+static int
+index_compare_positions(const void* const a, const void* const b)
+{
+    const size_t first = *(const size_t*) a;
+    const size_t second = *(const size_t*) b;
+    return (first > second) - (first < second);
+}
+
+XTR_API size_t*
+xtr_index_find_all(size_t* const amount, const xtr_index_t* const index, const xtr_t* const needle)
+{
+    if (amount == NULL)
+    {
+        return NULL;
+    }
+    size_t first;
+    *amount = 0U;
+    const size_t found = index_range(index, needle, &first);
+    if (found == XTR_NOT_FOUND || found > SIZE_MAX / sizeof(size_t))
+    {
+        return NULL;
+    }
+    size_t* const indices = XTR_MALLOC(XTR_MAX(found, 1U) * sizeof(size_t));
+    if (indices == NULL)
+    {
+        return NULL;
+    }
+    size_t valid = 0U;
+    for (size_t i = 0U; i < found; i++)
+    {
+        // Skips positions of corrupted serialised arrays
+        if (index->suffixes[first + i] < index->len)
+        {
+            indices[valid++] = index->suffixes[first + i];
+        }
+    }
+    qsort(indices, valid, sizeof(size_t), index_compare_positions);
+    *amount = valid;
+    return indices;
+}
+
+XTR_API size_t
+xtr_index_longest_repeat(const xtr_index_t* const index, size_t* const length)
+{
+    if (length != NULL)
+    {
+        *length = 0U;
+    }
+    if (index == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    size_t longest = 0U;
+    size_t start = XTR_NOT_FOUND;
+    for (size_t i = 1U; i < index->len; i++)
+    {
+        const size_t suffix = index->suffixes[i];
+        // Bounded against corrupted serialised arrays
+        if (index->lcp[i] > longest && suffix < index->len && index->lcp[i] <= index->len - suffix)
+        {
+            longest = index->lcp[i];
+            start = suffix;
+        }
+    }
+    if (length != NULL)
+    {
+        *length = longest;
+    }
+    return start;
+}
@@ -45,6 +45,28 @@ extern "C"
 #define XTR_MAX(a, b)  ((a) >= (b) ? (a) : (b))
 #define SIZE_OVERFLOW  0U
 
+#if defined(XTR_SIMD) && XTR_SIMD
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define XTR_SSE2 1
+        #include <emmintrin.h>
+    #endif
+    #if defined(__SSSE3__) || defined(__AVX2__)
+        #define XTR_SSSE3 1
+        #include <tmmintrin.h>
+    #endif
+    #if defined(__AVX2__)
+        #define XTR_AVX2 1
+        #include <immintrin.h>
+    #endif
+    #if defined(__PCLMUL__)
+        #define XTR_PCLMUL 1
+        #include <wmmintrin.h>
+    #endif
+#endif
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wpadded"
 /**
@@ -63,31 +85,47 @@ extern "C"
  * memory management (other than freeing the xtrings after use), or
  * keeping track of the data length and buffer sizes.
  *
- *                                +-- content always null-terminated
- *                                |
- *                                |          +-- buffer always null-terminated
- *                                |          |
- *                                v          v
+ * The reference count is 1 for a freshly allocated xtring and is increased
+ * by xtr_share(). While it is above 1, the xtring is read-only.
+ *
+ * The content starts at `buffer`, which points into the allocated `storage`.
+ * Removing bytes from the head just advances it, leaving head room before
+ * the content, which pushes to the head reuse. Pushes to the tail move the
+ * content back to the storage start only when the tail has too little room.
  *
- *         [capacity][used][abcde\0.........\0]
+ *                                                +-- content always null-terminated
+ *                                                |
+ *                                                |          +-- buffer always null-terminated
+ *                                                |          |
+ *                                                v          v
  *
- *                          \___/            used (5, excl. null terminator)
- *                               \_________/ available free space (11)
- *                          \______________/ capacity (16, excl. null term.)
+ *         [capacity][used][refs][buffer][...abcde\0.........\0]
+ *                                        ^  ^buffer
+ *                                        storage
+ *
+ *                                        \_/                 head room (3)
+ *                                           \___/            used (5, excl. null terminator)
+ *                                                \_________/ free space after content (11)
+ *                                           \______________/ capacity (16, excl. null term.)
  *
  */
 struct xtr
 {
-    /** Total bytes for content in buffer (used + free), before terminator. */
+    /** Total bytes for content from `buffer` on (used + free), before terminator. */
     size_t capacity;
     /** Occupied bytes with content in buffer out of the capacity. */
     size_t used;
-    /** Buffer with the actual data. Buffer size = `capacity+1`, where the +1
+    /** Amount of owners of this xtring, accessed atomically. */
+    size_t refs;
+    /** Start of the content, within `storage`: `storage + head room`.
+     * Buffer size = `capacity+1`, where the +1
      * is for a null-terminator at the buffer's end to protect against string
      * reads out of bounds. The content is also always null-terminated,
-     * thus the nulls are at `buffer[used]` and at `buffer[capacity]`.
+     * thus the nulls are at `buffer[used]` and at `buffer[capacity]`. */
+    uint8_t* buffer;
+    /** Allocated space for head room, content, free space and terminator.
      * C99 flexible array member <https://en.wikipedia.org/wiki/Flexible_array_member> */
-    uint8_t buffer[1U];
+    uint8_t storage[1U];
 };
 #pragma clang diagnostic pop
 
@@ -159,15 +197,215 @@ zero_out(void* data, size_t len);  // todo rename to xtr_zero_out
 void
 memmove_zero_out(void* dst, void* src, size_t len);
 
+/**
+ * @internal
+ * Bytes before the content, freed by removing bytes from the head.
+ *
+ * @param [in] xtr xtring, not NULL
+ * @return distance of the content start from the storage start
+ */
+XTR_INLINE static size_t
+xtr_head_room(const xtr_t* const xtr)
+{
+    return (size_t) (xtr->buffer - xtr->storage);
+}
+
+/**
+ * @internal
+ * Moves the content to the storage start, turning the head room into
+ * free space at the tail. O(1) for an empty xtring or without head room.
+ *
+ * @param [in, out] xtr xtring to compact, not NULL
+ */
+void
+xtr_drop_head_room(xtr_t* xtr);
+
+/**
+ * @internal
+ * Changes the capacity of an unshared xtring, keeping its content.
+ *
+ * Uses XTR_REALLOC, which may grow or shrink the allocation without copying.
+ * With XTR_CLEAR_HEAP the content is copied to a new allocation instead
+ * and the old one is wiped, as realloc may move the block without clearing it.
+ *
+ * @param [in, out] pxtr xtring to reallocate, not NULL, not shared.
+ *        Replaced by the reallocated xtring on success.
+ * @param [in] capacity new capacity, at least the content length.
+ * @return the reallocated xtring or NULL in case of malloc failure, size overflow or
+ *         a capacity shorter than the content. `*pxtr` stays valid on failure.
+ */
+xtr_t*
+xtr_reallocate(xtr_t** pxtr, size_t capacity);
+
+/**
+ * @internal
+ * Index of the least significant set bit (count trailing zeros).
+ *
+ * @param [in] mask bit-mask, must be non-zero
+ * @return index of the lowest set bit, 0 to 31
+ */
+XTR_INLINE static unsigned int
+xtr_ctz32(const uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned int) index;
+#else
+    unsigned int index = 0U;
+    while (((mask >> index) & 1U) == 0U)
+    {
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @internal
+ * Index of the least significant set bit of a 64-bit mask, as xtr_ctz32().
+ */
+XTR_INLINE static unsigned int
+xtr_ctz64(const uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_ctzll(mask);
+#else
+    const uint32_t low = (uint32_t) mask;
+    return low != 0U ? xtr_ctz32(low) : 32U + xtr_ctz32((uint32_t) (mask >> 32U));
+#endif
+}
+
+/**
+ * @internal
+ * Amount of set bits in a 64-bit mask.
+ */
+XTR_INLINE static unsigned int
+xtr_popcount64(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_popcountll(mask);
+#else
+    unsigned int count = 0U;
+    for (; mask != 0U; mask &= mask - 1U)
+    {
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @internal
+ * Index of the most significant set bit (31 minus count leading zeros).
+ *
+ * @param [in] mask bit-mask, must be non-zero
+ * @return index of the highest set bit, 0 to 31
+ */
+XTR_INLINE static unsigned int
+xtr_msb32(const uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 31U - (unsigned int) __builtin_clz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (unsigned int) index;
+#else
+    unsigned int index = 31U;
+    while (((mask >> index) & 1U) == 0U)
+    {
+        index--;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @internal
+ * Atomically adds `delta` to the reference count of the xtring.
+ *
+ * Without compiler support for atomics, the update is a plain read-modify-write
+ * and sharing xtrings across threads is not safe.
+ *
+ * @param [in, out] xtr xtring with the counter, not NULL
+ * @param [in] delta amount to add, `SIZE_MAX` to subtract one
+ * @return the reference count after the update
+ */
+XTR_INLINE static size_t
+xtr_refs_add(xtr_t* const xtr, const size_t delta)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_add_fetch(&xtr->refs, delta, __ATOMIC_ACQ_REL);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    return (size_t) _InterlockedExchangeAdd64((volatile __int64*) &xtr->refs, (__int64) delta)
+           + delta;
+#elif defined(_MSC_VER)
+    return (size_t) _InterlockedExchangeAdd((volatile long*) &xtr->refs, (long) delta) + delta;
+#else
+    xtr->refs += delta;
+    return xtr->refs;
+#endif
+}
+
+/**
+ * @internal
+ * Current reference count of the xtring, loaded atomically.
+ *
+ * @param [in] xtr xtring with the counter, not NULL
+ * @return amount of owners, at least 1
+ */
+XTR_INLINE static size_t
+xtr_refs_load(const xtr_t* const xtr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(&xtr->refs, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    return *(const volatile size_t*) &xtr->refs;
+#else
+    return xtr->refs;
+#endif
+}
+
+/**
+ * @internal
+ * Lowercase variant of an ASCII uppercase letter, any other byte unchanged.
+ */
+XTR_INLINE static uint8_t
+xtr_ascii_lower(const uint8_t byte)
+{
+    return (uint8_t) ((uint8_t) (byte - 'A') < 26U ? byte | 0x20U : byte);
+}
+
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+    /**
+     * @internal
+     * Maximum amount of needle bytes the SIMD filter may verify per scanned
+     * haystack byte, before giving up on the filter. Plus a constant allowance,
+     * so a few early false positives on short haystacks do not trigger it.
+     * Keeps the worst case linear, as the Two-Way search takes over when the
+     * first/last byte filter lets through too many false positives.
+     */
+    #define XTR_SIMD_VERIFY_FACTOR    4U
+    #define XTR_SIMD_VERIFY_ALLOWANCE 256U
+#endif
+
 /**
  * @internal
  * Searches a multi-byte pattern in a larger binary array.
  *
  * This is a custom implementation of the memmem() function, which is part of the
- * GNU libc, but not of the standard libc. This is a naive implementation of the
- * substring search algorithm but still tries to add a few optimisations, like
- * avoiding scanning any haystack byte twice. It should be performant-enough
- * for small to medium-sized arrays.
+ * GNU libc, but not of the standard libc. Single-byte needles are searched
+ * with memchr(). When SSE2 or AVX2 are available, longer needles are first
+ * searched by comparing the needle's first and last byte against 16 or 32
+ * haystack positions at once, verifying only the candidates where both match.
+ * Otherwise, or when too many candidates turn out to be false positives,
+ * the search continues with the Two-Way algorithm by Crochemore and Perrin,
+ * which guarantees O(haystack_len + needle_len) time with O(1) additional
+ * memory, regardless of the content: adversarial inputs such as `aaa...ab`
+ * needles in `aaa...a` haystacks do not cause quadratic runtimes.
  *
  * @param haystack larger array to search in
  * @param haystack_len amount of bytes of the haystack array
@@ -182,6 +420,564 @@ memmove_zero_out(void* dst, void* src, size_t len);
 const void*
 xtr_memmem(const void* haystack, size_t haystack_len, const void* needle, size_t needle_len);
 
+/**
+ * @internal
+ * Precomputed properties of a needle, as required by the Two-Way search.
+ */
+typedef struct
+{
+    /** Critical position: index of the start of the needle's right half. */
+    size_t suffix;
+    /** Shift after a mismatch in the left half: the period of the needle
+     * if periodic, otherwise the maximal safe shift. */
+    size_t period;
+    /** Index of the needle byte expected to appear the least in the haystack. */
+    size_t rare;
+    /** Whether the entire needle is periodic, so partial matches are remembered. */
+    bool periodic;
+} xtr_twoway_t;
+
+/**
+ * @internal
+ * Computes the critical factorisation of the needle and the other properties
+ * the Two-Way search requires, so they can be reused across many searches.
+ *
+ * @param [out] twoway precomputed properties of the needle
+ * @param [in] needle pattern to analyse
+ * @param [in] needle_len amount of bytes in the needle, at least 1
+ */
+void
+xtr_twoway_prepare(xtr_twoway_t* twoway, const uint8_t* needle, size_t needle_len);
+
+/**
+ * @internal
+ * Two-Way substring search by Crochemore and Perrin.
+ *
+ * Guarantees O(haystack_len + needle_len) comparisons in the worst case and
+ * O(1) additional memory. The right half of the needle is matched
+ * left-to-right first, then the left half right-to-left. Whenever no
+ * partial match is remembered, positions where the needle's rarest byte
+ * does not match are skipped with memchr(), which makes the search
+ * on typical data about as fast as a plain memchr() scan.
+ *
+ * @param [in] twoway properties of the needle from xtr_twoway_prepare()
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 1
+ * @return pointer to the first needle occurrence in the haystack or NULL
+ */
+const uint8_t*
+xtr_twoway_search(const xtr_twoway_t* twoway,
+                  const uint8_t* haystack,
+                  size_t haystack_len,
+                  const uint8_t* needle,
+                  size_t needle_len);
+
+/**
+ * @internal
+ * Same as xtr_twoway_prepare(), but for case-insensitive searches: the
+ * needle is factorised as if lowercased. The `rare` field is not used.
+ *
+ * @param [out] twoway precomputed properties of the needle
+ * @param [in] needle pattern to analyse
+ * @param [in] needle_len amount of bytes in the needle, at least 1
+ */
+void
+xtr_twoway_prepare_icase(xtr_twoway_t* twoway, const uint8_t* needle, size_t needle_len);
+
+/**
+ * @internal
+ * Finds the first position where two arrays differ, ignoring the case of
+ * the ASCII letters. Folds the case of 16 (SSE2) or 32 (AVX2) bytes per step
+ * when available.
+ *
+ * @param [in] a first array
+ * @param [in] b second array
+ * @param [in] len amount of bytes to compare in both arrays
+ * @return index of the first differing byte, `len` if none
+ */
+size_t
+xtr_icase_mismatch(const uint8_t* a, const uint8_t* b, size_t len);
+
+/**
+ * @internal
+ * Core of xtr_memmem() without the input validation, optionally reusing the
+ * Two-Way properties of the needle computed in advance.
+ *
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 1
+ * @param [in] twoway properties of the needle from xtr_twoway_prepare() or
+ *             NULL to compute them only when needed
+ * @return pointer to the first needle occurrence in the haystack or NULL
+ */
+const uint8_t*
+xtr_memmem_prepared(const uint8_t* haystack,
+                    size_t haystack_len,
+                    const uint8_t* needle,
+                    size_t needle_len,
+                    const xtr_twoway_t* twoway);
+
+/**
+ * @internal
+ * Searches a byte in an array from its end backwards, like the GNU
+ * memrchr() extension, which is not part of the standard libc.
+ * Scans 16 (SSE2) or 32 (AVX2) bytes per step when available.
+ *
+ * @param [in] haystack array to search in
+ * @param [in] haystack_len amount of bytes in the haystack
+ * @param [in] byte value to search for
+ * @return pointer to the last occurrence of the byte or NULL
+ */
+const uint8_t*
+xtr_memrchr(const uint8_t* haystack, size_t haystack_len, uint8_t byte);
+
+/**
+ * @internal
+ * Searches the last occurrence of a multi-byte pattern in a larger binary
+ * array: the reverse-direction counterpart of xtr_memmem().
+ *
+ * Scans from the end of the haystack backwards, so the runtime is
+ * proportional to the distance of the occurrence from the end. Uses the
+ * same strategies as xtr_memmem() in mirrored direction: xtr_memrchr() for
+ * single-byte needles, the SIMD first/last-byte filter and the Two-Way
+ * algorithm on the reversed needle, keeping the worst case linear.
+ *
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 1
+ * @return pointer to the last needle occurrence in the haystack or NULL
+ */
+const uint8_t*
+xtr_memrmem(const uint8_t* haystack,
+            size_t haystack_len,
+            const uint8_t* needle,
+            size_t needle_len);
+
+/** @internal Index of the byte's row in the bitmap of an #xtr_charset_t. */
+#define XTR_CHARSET_ROW(byte) ((size_t) (((byte) >> 7U) << 4U) | ((byte) & 0x0FU))
+/** @internal Bit of the byte within its row in the bitmap of an #xtr_charset_t. */
+#define XTR_CHARSET_BIT(byte) ((uint8_t) (1U << (((byte) >> 4U) & 7U)))
+
+/**
+ * @internal
+ * Scans an array for the first byte which is (or is not) in the set.
+ *
+ * @param [in] set of bytes
+ * @param [in] bytes array to scan
+ * @param [in] len amount of bytes in the array
+ * @param [in] member true to find the first byte in the set, false for the
+ *             first byte not in the set
+ * @return index of the found byte, `len` if none
+ */
+size_t
+xtr_charset_scan(const xtr_charset_t* set, const uint8_t* bytes, size_t len, bool member);
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Compiled search pattern: a copy of the needle with all the search
+ * preprocessing already done, allocated as a single block.
+ */
+struct xtr_pattern
+{
+    /** Two-Way properties of the needle, for a linear worst case. */
+    xtr_twoway_t twoway;
+#if !defined(XTR_SSE2) && !defined(XTR_AVX2)
+    /** Horspool bad-character table: shift of the needle for each possible
+     * haystack byte aligned with the needle's last byte. Filled only for
+     * needles longer than #XTR_PATTERN_LONG_NEEDLE. */
+    size_t shift[UINT8_MAX + 1U];
+#endif
+    /** Amount of bytes in the needle, at least 1. */
+    size_t len;
+    /** Copy of the needle, null-terminated. C99 flexible array member. */
+    uint8_t needle[1U];
+};
+#pragma clang diagnostic pop
+
+#if !defined(XTR_SSE2) && !defined(XTR_AVX2)
+    /**
+     * @internal
+     * Without SIMD, needles longer than this are searched with the Two-Way
+     * algorithm combined with a Horspool shift table, which skips up to the
+     * whole needle length per step. Shorter needles, and any needle when
+     * the SIMD filter is available (which is faster even for long needles on
+     * typical text), use the same dispatch as xtr_memmem().
+     */
+    #define XTR_PATTERN_LONG_NEEDLE 16U
+#endif
+
+/**
+ * @internal
+ * Searches the compiled pattern in a binary array.
+ *
+ * @param [in] pattern compiled needle, not NULL
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack
+ * @return pointer to the first needle occurrence in the haystack or NULL,
+ *         also when the needle does not fit in the haystack
+ */
+const uint8_t*
+xtr_pattern_search(const xtr_pattern_t* pattern, const uint8_t* haystack, size_t haystack_len);
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Incremental search of a compiled pattern in a stream of chunks.
+ *
+ * Positions are absolute offsets in the stream. The window holds the
+ * carry-over (the last bytes of the previous chunks where an occurrence
+ * may still start, at most `needle_len - 1`) followed by as many bytes
+ * of the current chunk, so occurrences straddling the two are found
+ * without concatenating the chunks.
+ */
+struct xtr_stream_search
+{
+    /** Compiled needle, borrowed. */
+    const xtr_pattern_t* pattern;
+    /** Chunk being searched, borrowed, or NULL when none is fed. */
+    const xtr_t* chunk;
+    /** Stream offset of the chunk's first byte (amount of previous bytes). */
+    size_t chunk_offset;
+    /** Stream offset where the next occurrence may start. */
+    size_t resume;
+    /** Amount of carried-over bytes at the start of the window. */
+    size_t carry_len;
+    /** Amount of bytes in the window: carry-over and start of the chunk. */
+    size_t window_len;
+    /** Buffer of `2 * (needle_len - 1)` bytes, allocated after the struct. */
+    uint8_t* window;
+};
+#pragma clang diagnostic pop
+
+/** @internal Marker for a missing Aho-Corasick state link. */
+#define XTR_AC_NO_STATE UINT32_MAX
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Compiled Aho-Corasick automaton for many needles at once, allocated as a
+ * single block: the struct is followed by the arrays it points to.
+ *
+ * The automaton is a complete DFA over byte classes, so scanning costs
+ * exactly two table lookups per haystack byte regardless of the amount of
+ * needles: `next = transitions[state + classes[byte]]`.
+ * Transitions store pre-multiplied row offsets (state index times `stride`)
+ * to avoid a multiplication in the scanning loop. The states reporting any
+ * needle are numbered last, so `state >= match_offset` is the only check
+ * per byte.
+ */
+struct xtr_multipattern
+{
+    /** Amount of needles, including the empty ones. */
+    size_t amount;
+    /** Length of the longest needle. */
+    size_t max_len;
+    /** Amount of automaton states, including the root (state 0). */
+    size_t states;
+    /** Amount of byte classes, row length of the transition table. */
+    size_t stride;
+    /** Row offset of the first state reporting any needle. */
+    size_t match_offset;
+    /** Length of each needle, indexed by needle ID. */
+    size_t* needle_lens;
+    /** `states * stride` row offsets of the target states. */
+    uint32_t* transitions;
+    /** Per state, index in `outputs` of the first needle ending exactly in
+     * that state. `states + 1` long, so `outputs_start[s+1]` is the end. */
+    uint32_t* outputs_start;
+    /** Per state, the nearest state along the failure links which has
+     * needles ending exactly there, or #XTR_AC_NO_STATE. */
+    uint32_t* dict_links;
+    /** Needle IDs grouped by the state they end in. */
+    uint32_t* outputs;
+    /** Byte class of each byte value: bytes not appearing in any needle
+     * share the same class. */
+    uint8_t classes[UINT8_MAX + 1U];
+};
+#pragma clang diagnostic pop
+
+/** @internal Longest literal prefix of a regex searched with xtr_memmem(). */
+#define XTR_RE_MAX_PREFIX 32U
+/** @internal Flag of the DFA transitions to states needing checks while
+ * searching: matching states, start states skipping to the literal prefix. */
+#define XTR_RE_SPECIAL UINT32_C(0x80000000)
+/** @internal Marker for a DFA transition not computed yet. */
+#define XTR_RE_UNKNOWN UINT32_MAX
+/** @internal Marker for the DFA state without threads, which never matches. */
+#define XTR_RE_DEAD    (UINT32_MAX - 1U)
+
+/** @internal Instructions of a compiled regular expression program. */
+typedef enum
+{
+    /** Consumes a byte in the set and continues at `next`. */
+    XTR_RE_BYTES = 0,
+    /** Continues both at `next`, with higher priority, and at `alt`. */
+    XTR_RE_SPLIT,
+    /** Continues at `next`. */
+    XTR_RE_JUMP,
+    /** Reports a match. */
+    XTR_RE_MATCH,
+} xtr_re_op_t;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/** @internal Instruction of a compiled regular expression program (NFA). */
+typedef struct
+{
+    /** Bytes consumed by #XTR_RE_BYTES. */
+    xtr_charset_t set;
+    xtr_re_op_t op;
+    uint32_t next;
+    uint32_t alt;
+} xtr_re_inst_t;
+
+/**
+ * @internal
+ * Lazily built DFA simulating a regular expression program, with a cache of
+ * bounded size, allocated as a single block at compilation.
+ *
+ * Each DFA state is the list of program instructions (consuming bytes or
+ * matching) the NFA threads are at. States and transitions are computed on
+ * first use while searching; when the cache is full it is flushed, keeping
+ * the memory bounded while each haystack byte still costs at most one
+ * state computation, linear in the program length.
+ */
+typedef struct
+{
+    /** Program simulated by the DFA, borrowed from the regex. */
+    const xtr_re_inst_t* program;
+    /** Program instruction the threads start at. */
+    uint32_t entry;
+    /** Leftmost-first matching: threads of lower priority than a matching
+     * one are dropped. Otherwise, all threads are kept as a sorted set. */
+    bool leftmost_first;
+    /** Skipping to the literal prefix of the regex in the start state. */
+    bool accelerated;
+    /** Transition value of the state of the threads at `entry`. */
+    uint32_t start;
+    /** Row offset of the start state, without flags. */
+    uint32_t start_offset;
+    /** Amount of cached states. */
+    uint32_t states;
+    /** Most states fitting the cache. */
+    uint32_t max_states;
+    /** Amount of used entries of `lists`. */
+    size_t lists_used;
+    /** Most entries fitting `lists`. */
+    size_t lists_capacity;
+    /** Amount of slots of `table`, a power of 2. */
+    size_t table_len;
+    /** `max_states * stride` transitions: row offset of the target state
+     * (state index times `stride`), optionally flagged with #XTR_RE_SPECIAL,
+     * or #XTR_RE_UNKNOWN or #XTR_RE_DEAD. */
+    uint32_t* transitions;
+    /** Per state, index in `lists` of its instructions, `max_states + 1` long. */
+    uint32_t* lists_start;
+    /** Instructions of all states, concatenated. */
+    uint32_t* lists;
+    /** Hash table of the states by instruction list, storing state index + 1. */
+    uint32_t* table;
+    /** Per state, whether it has a matching thread. */
+    uint8_t* matching;
+} xtr_re_dfa_t;
+
+/**
+ * @internal
+ * Compiled regular expression: the program in both directions and the
+ * DFAs simulating them.
+ *
+ * A search runs the leftmost-first forward DFA to find where the match
+ * ends, then the reversed program backwards from there to find the
+ * leftmost start: two linear passes over the haystack at most.
+ */
+struct xtr_regex
+{
+    /** Amount of byte classes, row length of the DFA transition tables. */
+    size_t stride;
+    /** Amount of instructions of `forward`. */
+    size_t forward_len;
+    /** Amount of bytes of `prefix`. */
+    size_t prefix_len;
+    /** Program of the expression, followed by a lazy loop over any byte
+     * to search at every position. */
+    xtr_re_inst_t* forward;
+    /** Program of the expression reversed, matching the mirrored strings. */
+    xtr_re_inst_t* reverse;
+    /** Scratch space of the DFA state computations: depth-first stack,
+     * visit marks and instruction list. */
+    uint32_t* stack;
+    uint32_t* marks;
+    uint32_t* list;
+    /** Visit mark of the current state computation. */
+    uint32_t generation;
+    /** Whether the expression starts with `^` and ends with `$`. */
+    bool anchored_start;
+    bool anchored_end;
+    /** Bytes every match starts with, searched with xtr_memmem() to skip
+     * the haystack sections where no match can start. */
+    uint8_t prefix[XTR_RE_MAX_PREFIX];
+    /** Byte class of each byte value: bytes equally treated by the whole
+     * program share the same class. */
+    uint8_t classes[UINT8_MAX + 1U];
+    /** One byte value of each class. */
+    uint8_t class_bytes[UINT8_MAX + 1U];
+    /** Leftmost-first search of the match end. */
+    xtr_re_dfa_t search;
+    /** Anchored search of the match start, running `reverse` backwards. */
+    xtr_re_dfa_t backward;
+    /** Anchored match of the entire haystack. */
+    xtr_re_dfa_t full;
+};
+#pragma clang diagnostic pop
+
+/** @internal Identifier at the start of the serialised indices. */
+#define XTR_INDEX_MAGIC "xtrindex"
+/** @internal Version of the layout of the serialised indices. */
+#define XTR_INDEX_VERSION 1U
+/** @internal Stored in the serialised indices to detect the byte order. */
+#define XTR_INDEX_BYTE_ORDER UINT32_C(0x01020304)
+/** @internal Bytes of the header of the serialised indices. */
+#define XTR_INDEX_HEADER_LEN 24U
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Suffix array index of a text.
+ *
+ * All arrays live in a single serialisable block of `size` bytes, in host
+ * byte order:
+ *
+ *     [magic (8)][version (4)][byte order (4)][text length (8)]
+ *     [text, zero-padded to a multiple of 4][suffix array][LCP array]
+ *
+ * with one `uint32_t` per text byte in each array.
+ */
+struct xtr_index
+{
+    /** Amount of bytes of the text. */
+    size_t len;
+    const uint8_t* text;
+    /** Starting indices of the suffixes of the text in lexicographic order. */
+    const uint32_t* suffixes;
+    /** Length of the longest common prefix of each suffix in `suffixes`
+     * with the previous one, 0 for the first. */
+    const uint32_t* lcp;
+    /** The serialised block the arrays point into. */
+    const uint8_t* block;
+    size_t size;
+    /** Whether the block was allocated by the index, rather than provided. */
+    bool owned;
+};
+#pragma clang diagnostic pop
+
+/**
+ * @internal
+ * Compiled CSV dialect and the fields found by the last parsing.
+ *
+ * Fields are stored by their end only: each ends at a separator or a
+ * newline, or at the end of the text, and the next one starts right after.
+ * The arrays are kept across parsings, growing only when a text has more
+ * fields or records than any previous one.
+ */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+struct xtr_csv
+{
+    uint8_t separator;
+    uint8_t quote;
+    /** Text of the last parsing, borrowed. */
+    const uint8_t* text;
+    size_t len;
+    /** Index in the text of the byte after each field. */
+    size_t* field_ends;
+    size_t fields;
+    size_t fields_capacity;
+    /** Amount of fields up to the end of each record. */
+    size_t* record_ends;
+    size_t records;
+    size_t records_capacity;
+};
+#pragma clang diagnostic pop
+
+/** @internal Lines per block of an #xtr_line_index_t, one per bit of a 64-bit word. */
+#define XTR_LINE_BLOCK_LEN 64U
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Starts of up to #XTR_LINE_BLOCK_LEN consecutive lines: the first one
+ * plus the distance of each from it, bit-packed with the same width.
+ * Packing 64 values of `width` bits takes exactly `width` words.
+ */
+typedef struct
+{
+    /** Start of the first line of the block. */
+    size_t base;
+    /** Index of the first word of the block's packed distances. */
+    size_t word;
+    /** Bits per packed distance, enough for the largest one. */
+    unsigned int width;
+} xtr_line_block_t;
+
+struct xtr_line_index
+{
+    /** Text of the lines, borrowed. */
+    const uint8_t* text;
+    size_t len;
+    size_t lines;
+    xtr_line_block_t* blocks;
+    uint64_t* words;
+    size_t words_used;
+    size_t words_capacity;
+};
+#pragma clang diagnostic pop
+
+/**
+ * @internal
+ * Spare nodes an #xtr_rope_t keeps for reuse, beyond which freed ones are
+ * returned to the heap.
+ */
+#define XTR_ROPE_SPARES_MAX 64U
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Node of an #xtr_rope_t, AVL-balanced on the height.
+ *
+ * A leaf has no children and owns a non-empty slice of an xtring.
+ * An internal node always has both children and a NULL slice.
+ */
+typedef struct xtr_rope_node
+{
+    struct xtr_rope_node* left;
+    struct xtr_rope_node* right;
+    xtr_slice_t leaf;
+    /** Bytes in the subtree. */
+    size_t length;
+    /** 0 for leaves, 1 + the height of the taller child otherwise. */
+    size_t height;
+} xtr_rope_node_t;
+
+struct xtr_rope
+{
+    xtr_rope_node_t* root;
+    /** Free nodes, linked through their `left` pointer. */
+    xtr_rope_node_t* spare;
+    size_t spares;
+};
+#pragma clang diagnostic pop
+
 #ifdef __cplusplus
 }
 #endif
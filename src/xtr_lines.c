@@ -0,0 +1,377 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/** @internal Bytes scanned at once for newlines, one per bit of a 64-bit mask. */
+#define LINES_SCAN_LEN 64U
+
+/**
+ * @internal
+ * Finds the newlines in the bytes from an index, up to 64 of them.
+ *
+ * @return bit-mask with bit i set if the byte at `start + i` is a newline
+ */
+static uint64_t
+lines_newlines(const uint8_t* const text, const size_t len, const size_t start)
+{
+    const size_t amount = XTR_MIN(len - start, LINES_SCAN_LEN);
+    const uint8_t* block = &text[start];
+    uint8_t tail[LINES_SCAN_LEN];
+    if (amount < LINES_SCAN_LEN)
+    {
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, block, amount);
+        block = tail;
+    }
+    uint64_t newlines = 0U;
+#if defined(XTR_AVX2)
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (unsigned int i = 0U; i < LINES_SCAN_LEN; i += 32U)
+    {
+        const __m256i bytes = _mm256_loadu_si256((const __m256i*) (const void*) &block[i]);
+        newlines |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline))
+                    << i;
+    }
+#elif defined(XTR_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (unsigned int i = 0U; i < LINES_SCAN_LEN; i += 16U)
+    {
+        const __m128i bytes = _mm_loadu_si128((const __m128i*) (const void*) &block[i]);
+        newlines |= (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)) << i;
+    }
+#else
+    for (unsigned int i = 0U; i < LINES_SCAN_LEN; i++)
+    {
+        newlines |= (uint64_t) (block[i] == '\n') << i;
+    }
+#endif
+    return newlines;
+}
+
+/**
+ * @internal
+ * View of a line from its start to its end, excluding a CR before its LF.
+ * A CR ending the last line without a newline is part of the line.
+ */
+static void
+lines_view(xtr_view_t* const line,
+           const uint8_t* const text,
+           const size_t start,
+           size_t end,
+           const bool has_newline)
+{
+    if (has_newline && end > start && text[end - 1U] == '\r')
+    {
+        end--;
+    }
+    xtr_view_from_bytes(line, &text[start], end - start);
+}
+
+XTR_API void
+xtr_line_iter_init(xtr_line_iter_t* const iter, const xtr_t* const xtr)
+{
+    if (iter == NULL)
+    {
+        return;
+    }
+    iter->xtr = xtr;
+    iter->line_start = xtr_is_empty(xtr) ? SIZE_MAX : 0U;
+    iter->scanned = 0U;
+    iter->newlines = xtr_is_empty(xtr) ? 0U : lines_newlines(xtr->buffer, xtr->used, 0U);
+}
+
+XTR_API bool
+xtr_line_next(xtr_line_iter_t* const iter, xtr_view_t* const line)
+{
+    if (iter == NULL || line == NULL || iter->line_start == SIZE_MAX)
+    {
+        return false;
+    }
+    const xtr_t* const xtr = iter->xtr;
+    while (iter->newlines == 0U)
+    {
+        iter->scanned += LINES_SCAN_LEN;
+        if (iter->scanned >= xtr->used)
+        {
+            // Last line, without a newline
+            lines_view(line, xtr->buffer, iter->line_start, xtr->used, false);
+            iter->line_start = SIZE_MAX;
+            return true;
+        }
+        iter->newlines = lines_newlines(xtr->buffer, xtr->used, iter->scanned);
+    }
+    const size_t newline = iter->scanned + xtr_ctz64(iter->newlines);
+    iter->newlines &= iter->newlines - 1U;
+    lines_view(line, xtr->buffer, iter->line_start, newline, true);
+    // A trailing newline does not start another line
+    iter->line_start = newline + 1U == xtr->used ? SIZE_MAX : newline + 1U;
+    return true;
+}
+
+/** @internal Bits needed to represent a value, 0 for 0. */
+static unsigned int
+lines_width(const size_t value)
+{
+    unsigned int width = 0U;
+    while (width < 64U && (value >> width) != 0U)
+    {
+        width++;
+    }
+    return width;
+}
+
+/**
+ * @internal
+ * Packs the starts of the lines of a block, appending the block.
+ *
+ * @return false in case of malloc failure
+ */
+static bool
+lines_pack(xtr_line_index_t* const index, const size_t* const starts, const size_t amount)
+{
+    xtr_line_block_t* const block = &index->blocks[index->lines / XTR_LINE_BLOCK_LEN];
+    block->base = starts[0];
+    block->width = lines_width(starts[amount - 1U] - starts[0]);
+    block->word = index->words_used;
+    if (block->width == 0U)
+    {
+        // A single line in the block: its start is the base, nothing to pack
+        index->lines += amount;
+        return true;
+    }
+    if (index->words_used + block->width > index->words_capacity)
+    {
+        const size_t capacity = XTR_MAX(index->words_capacity * 2U, XTR_LINE_BLOCK_LEN);
+        uint64_t* const larger = XTR_REALLOC(index->words, capacity * sizeof(uint64_t));
+        if (larger == NULL)
+        {
+            return false;
+        }
+        index->words = larger;
+        index->words_capacity = capacity;
+    }
+    uint64_t* const words = &index->words[block->word];
+    memset(words, 0, block->width * sizeof(uint64_t));
+    for (size_t i = 0U; i < amount; i++)
+    {
+        const uint64_t distance = starts[i] - starts[0];
+        const size_t bit = i * block->width;
+        words[bit / 64U] |= distance << (bit % 64U);
+        if (bit % 64U + block->width > 64U)
+        {
+            words[bit / 64U + 1U] |= distance >> (64U - bit % 64U);
+        }
+    }
+    index->words_used += block->width;
+    index->lines += amount;
+    return true;
+}
+
+/** @internal Start of a line, unpacked from its block. */
+static size_t
+lines_start(const xtr_line_index_t* const index, const size_t line)
+{
+    const xtr_line_block_t* const block = &index->blocks[line / XTR_LINE_BLOCK_LEN];
+    if (block->width == 0U)
+    {
+        return block->base;
+    }
+    const uint64_t* const words = &index->words[block->word];
+    const size_t bit = line % XTR_LINE_BLOCK_LEN * block->width;
+    uint64_t distance = words[bit / 64U] >> (bit % 64U);
+    if (bit % 64U + block->width > 64U)
+    {
+        distance |= words[bit / 64U + 1U] << (64U - bit % 64U);
+    }
+    if (block->width < 64U)
+    {
+        distance &= (UINT64_C(1) << block->width) - 1U;
+    }
+    return block->base + (size_t) distance;
+}
+
+XTR_API xtr_line_index_t*
+xtr_line_index_new(const xtr_t* const text)
+{
+    if (text == NULL)
+    {
+        return NULL;
+    }
+    xtr_line_index_t* index = XTR_CALLOC(1U, sizeof(xtr_line_index_t));
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    index->text = text->buffer;
+    index->len = text->used;
+    // One block per 64 newlines, plus the first line's
+    size_t newlines = 0U;
+    for (size_t scanned = 0U; scanned < text->used; scanned += LINES_SCAN_LEN)
+    {
+        newlines += (size_t) xtr_popcount64(lines_newlines(text->buffer, text->used, scanned));
+    }
+    const size_t blocks = newlines / XTR_LINE_BLOCK_LEN + 1U;
+    index->blocks = XTR_MALLOC(blocks * sizeof(xtr_line_block_t));
+    if (index->blocks == NULL)
+    {
+        xtr_line_index_free(&index);
+        return NULL;
+    }
+    size_t starts[XTR_LINE_BLOCK_LEN];
+    size_t amount = 0U;
+    if (text->used > 0U)
+    {
+        starts[amount++] = 0U;
+    }
+    for (size_t scanned = 0U; scanned < text->used; scanned += LINES_SCAN_LEN)
+    {
+        uint64_t mask = lines_newlines(text->buffer, text->used, scanned);
+        while (mask != 0U)
+        {
+            const size_t start = scanned + xtr_ctz64(mask) + 1U;
+            mask &= mask - 1U;
+            if (start == text->used)
+            {
+                break;  // A trailing newline does not start another line
+            }
+            if (amount == XTR_LINE_BLOCK_LEN)
+            {
+                if (!lines_pack(index, starts, amount))
+                {
+                    xtr_line_index_free(&index);
+                    return NULL;
+                }
+                amount = 0U;
+            }
+            starts[amount++] = start;
+        }
+    }
+    if (amount > 0U && !lines_pack(index, starts, amount))
+    {
+        xtr_line_index_free(&index);
+        return NULL;
+    }
+    return index;
+}
+
+XTR_API void
+xtr_line_index_free(xtr_line_index_t** const pindex)
+{
+    if (pindex == NULL || *pindex == NULL)
+    {
+        return;
+    }
+    XTR_FREE((*pindex)->blocks);
+    XTR_FREE((*pindex)->words);
+    XTR_FREE(*pindex);
+    *pindex = NULL;
+}
+
+XTR_API size_t
+xtr_line_index_lines(const xtr_line_index_t* const index)
+{
+    return index == NULL ? 0U : index->lines;
+}
+
+XTR_API size_t
+xtr_line_index_offset(const xtr_line_index_t* const index, const size_t line)
+{
+    if (index == NULL || line >= index->lines)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return lines_start(index, line);
+}
+
+XTR_API size_t
+xtr_line_index_line_at(const xtr_line_index_t* const index, const size_t offset)
+{
+    if (index == NULL || offset >= index->len)
+    {
+        return XTR_NOT_FOUND;
+    }
+    // Last block starting at or before the offset, the first one starts at 0
+    size_t low = 0U;
+    size_t high = (index->lines - 1U) / XTR_LINE_BLOCK_LEN;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low + 1U) / 2U;
+        if (index->blocks[middle].base <= offset)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1U;
+        }
+    }
+    // Then the last line of the block starting at or before it
+    size_t first = low * XTR_LINE_BLOCK_LEN;
+    size_t last = XTR_MIN(first + XTR_LINE_BLOCK_LEN, index->lines) - 1U;
+    while (first < last)
+    {
+        const size_t middle = first + (last - first + 1U) / 2U;
+        if (lines_start(index, middle) <= offset)
+        {
+            first = middle;
+        }
+        else
+        {
+            last = middle - 1U;
+        }
+    }
+    return first;
+}
+
+XTR_API bool
+xtr_line_index_line(xtr_view_t* const view, const xtr_line_index_t* const index, const size_t line)
+{
+    if (view == NULL)
+    {
+        return false;
+    }
+    if (index == NULL || line >= index->lines)
+    {
+        xtr_view_from_bytes(view, NULL, 0U);
+        return false;
+    }
+    const size_t start = lines_start(index, line);
+    size_t end = line + 1U < index->lines ? lines_start(index, line + 1U) - 1U : index->len;
+    bool has_newline = line + 1U < index->lines;
+    if (!has_newline && end > start && index->text[end - 1U] == '\n')
+    {
+        end--;
+        has_newline = true;
+    }
+    lines_view(view, index->text, start, end, has_newline);
+    return true;
+}
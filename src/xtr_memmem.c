@@ -0,0 +1,905 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/**
+ * @internal
+ * Needles up to this length are searched with a memchr() on the first byte,
+ * followed by a memcmp() of the rest. The worst case is still linear,
+ * bounded by `haystack_len * XTR_MEMMEM_SHORT_NEEDLE` byte comparisons.
+ */
+#define XTR_MEMMEM_SHORT_NEEDLE 3U
+
+/** @internal Flag of twoway_critical_factorisation(): read the needle backwards. */
+#define TWOWAY_REVERSED 1U
+/** @internal Flag of twoway_critical_factorisation(): ignore the ASCII case. */
+#define TWOWAY_ICASE    2U
+
+/**
+ * @internal
+ * Byte of the needle at index `i`, counting from the end and lowercased
+ * according to the `TWOWAY_` flags.
+ */
+XTR_INLINE static uint8_t
+needle_at(const uint8_t* const needle,
+          const size_t needle_len,
+          const size_t i,
+          const unsigned int flags)
+{
+    const uint8_t byte = (flags & TWOWAY_REVERSED) ? needle[needle_len - 1U - i] : needle[i];
+    return (flags & TWOWAY_ICASE) ? xtr_ascii_lower(byte) : byte;
+}
+
+/**
+ * @internal
+ * Computes the critical factorisation of the needle, as required by the
+ * Two-Way algorithm by Crochemore and Perrin.
+ *
+ * The needle is split into `needle[0..suffix)` and `needle[suffix..len)`,
+ * choosing the split point with the maximal suffix of the needle according
+ * to both the lexicographic order and the reversed one.
+ *
+ * @param [in] needle pattern to factorise
+ * @param [in] needle_len amount of bytes in the pattern, at least 1
+ * @param [out] period period of the right half of the needle
+ * @param [in] flags `TWOWAY_REVERSED` to factorise the needle read backwards,
+ *             `TWOWAY_ICASE` to factorise it lowercased
+ * @return index of the start of the right half of the needle (critical position)
+ */
+static size_t
+twoway_critical_factorisation(const uint8_t* const needle,
+                              const size_t needle_len,
+                              size_t* const period,
+                              const unsigned int flags)
+{
+    if (needle_len < 3U)
+    {
+        *period = 1U;
+        return needle_len - 1U;
+    }
+    // Maximal suffix according to the lexicographic order.
+    // Indices start at SIZE_MAX as in the original paper, where they are -1,
+    // relying on the defined unsigned wrap-around to 0 when incremented.
+    size_t max_suffix = SIZE_MAX;
+    size_t j = 0U;
+    size_t k = 1U;
+    size_t p = 1U;
+    while (j + k < needle_len)
+    {
+        const uint8_t a = needle_at(needle, needle_len, j + k, flags);
+        const uint8_t b = needle_at(needle, needle_len, max_suffix + k, flags);
+        if (a < b)
+        {
+            // Suffix is smaller, period is the entire prefix so far
+            j += k;
+            k = 1U;
+            p = j - max_suffix;
+        }
+        else if (a == b)
+        {
+            // Advance through the repetition of the current period
+            if (k != p)
+            {
+                k++;
+            }
+            else
+            {
+                j += p;
+                k = 1U;
+            }
+        }
+        else
+        {
+            // Suffix is larger, start over from the current location
+            max_suffix = j++;
+            k = 1U;
+            p = 1U;
+        }
+    }
+    *period = p;
+    // Maximal suffix according to the reversed lexicographic order
+    size_t max_suffix_rev = SIZE_MAX;
+    j = 0U;
+    k = 1U;
+    p = 1U;
+    while (j + k < needle_len)
+    {
+        const uint8_t a = needle_at(needle, needle_len, j + k, flags);
+        const uint8_t b = needle_at(needle, needle_len, max_suffix_rev + k, flags);
+        if (b < a)
+        {
+            j += k;
+            k = 1U;
+            p = j - max_suffix_rev;
+        }
+        else if (a == b)
+        {
+            if (k != p)
+            {
+                k++;
+            }
+            else
+            {
+                j += p;
+                k = 1U;
+            }
+        }
+        else
+        {
+            max_suffix_rev = j++;
+            k = 1U;
+            p = 1U;
+        }
+    }
+    // The critical position is the larger of the two maximal suffixes
+    if (max_suffix_rev + 1U < max_suffix + 1U)
+    {
+        return max_suffix + 1U;
+    }
+    *period = p;
+    return max_suffix_rev + 1U;
+}
+
+/**
+ * @internal
+ * Heuristic estimate of how common a byte is in typical text and binary data:
+ * whitespace and zeros are very common, then the most frequent English
+ * letters, then any other lowercase letter or digit, then anything else.
+ *
+ * @param [in] byte value to rate
+ * @return 0 for rare bytes up to 3 for very common ones
+ */
+static unsigned int
+byte_commonness(const uint8_t byte)
+{
+    static const char FREQUENT_LETTERS[] = "etaoinshr";
+    if (byte == 0U || byte == 0xFFU || isspace(byte))
+    {
+        return 3U;
+    }
+    if (memchr(FREQUENT_LETTERS, byte, sizeof(FREQUENT_LETTERS) - 1U) != NULL)
+    {
+        return 2U;
+    }
+    if (islower(byte) || isdigit(byte))
+    {
+        return 1U;
+    }
+    return 0U;
+}
+
+/**
+ * @internal
+ * Index of the needle byte which is expected to appear the least in the
+ * haystack, used to skip non-matching positions with memchr().
+ *
+ * @param [in] needle pattern to inspect
+ * @param [in] needle_len amount of bytes in the pattern, at least 1
+ * @return index of the rarest needle byte, the last one on ties
+ */
+static size_t
+rare_byte_index(const uint8_t* const needle, const size_t needle_len)
+{
+    size_t rarest = needle_len - 1U;
+    unsigned int rarest_commonness = byte_commonness(needle[rarest]);
+    for (size_t i = needle_len - 1U; i-- > 0U && rarest_commonness > 0U;)
+    {
+        const unsigned int commonness = byte_commonness(needle[i]);
+        if (commonness < rarest_commonness)
+        {
+            rarest = i;
+            rarest_commonness = commonness;
+        }
+    }
+    return rarest;
+}
+
+void
+xtr_twoway_prepare(xtr_twoway_t* const twoway,
+                   const uint8_t* const needle,
+                   const size_t needle_len)
+{
+    twoway->suffix = twoway_critical_factorisation(needle, needle_len, &twoway->period, 0U);
+    twoway->rare = rare_byte_index(needle, needle_len);
+    twoway->periodic = memcmp(needle, needle + twoway->period, twoway->suffix) == 0;
+    if (!twoway->periodic)
+    {
+        // Any mismatch in the left half results in a maximal shift
+        twoway->period = XTR_MAX(twoway->suffix, needle_len - twoway->suffix) + 1U;
+    }
+}
+
+void
+xtr_twoway_prepare_icase(xtr_twoway_t* const twoway,
+                         const uint8_t* const needle,
+                         const size_t needle_len)
+{
+    twoway->suffix =
+        twoway_critical_factorisation(needle, needle_len, &twoway->period, TWOWAY_ICASE);
+    twoway->rare = 0U;  // No memchr() skip for case-insensitive searches
+    twoway->periodic =
+        xtr_icase_mismatch(needle, needle + twoway->period, twoway->suffix) == twoway->suffix;
+    if (!twoway->periodic)
+    {
+        twoway->period = XTR_MAX(twoway->suffix, needle_len - twoway->suffix) + 1U;
+    }
+}
+
+const uint8_t*
+xtr_twoway_search(const xtr_twoway_t* const twoway,
+                  const uint8_t* const haystack,
+                  const size_t haystack_len,
+                  const uint8_t* const needle,
+                  const size_t needle_len)
+{
+    const size_t suffix = twoway->suffix;
+    const size_t period = twoway->period;
+    const size_t rare = twoway->rare;
+    const size_t last_start = haystack_len - needle_len;
+    size_t j = 0U;  // Candidate position of the needle in the haystack
+    size_t i;       // Position in the needle being compared
+    if (twoway->periodic)
+    {
+        // Entire needle is periodic: a mismatch in the left half can only
+        // shift by the period, so remember how much of the right half
+        // is already known to match, to avoid rescanning it.
+        size_t memory = 0U;
+        while (j <= last_start)
+        {
+            if (memory == 0U && needle[rare] != haystack[j + rare])
+            {
+                // Skip all positions where the rarest byte does not match
+                const uint8_t* const next =
+                    memchr(&haystack[j + rare + 1U], needle[rare], last_start - j);
+                if (next == NULL)
+                {
+                    return NULL;
+                }
+                j = (size_t) (next - haystack) - rare;
+            }
+            i = XTR_MAX(suffix, memory);
+            // Scan for matches in the right half
+            while (i < needle_len && needle[i] == haystack[i + j])
+            {
+                i++;
+            }
+            if (i >= needle_len)
+            {
+                // Scan for matches in the left half
+                i = suffix - 1U;
+                while (memory < i + 1U && needle[i] == haystack[i + j])
+                {
+                    i--;
+                }
+                if (i + 1U < memory + 1U)
+                {
+                    return &haystack[j];
+                }
+                // No match, remember how many repetitions of the period
+                // on the right half were scanned
+                j += period;
+                memory = needle_len - period;
+            }
+            else
+            {
+                j += i - suffix + 1U;
+                memory = 0U;
+            }
+        }
+    }
+    else
+    {
+        // The two halves of the needle are distinct: no memory is required
+        // and any mismatch in the left half results in a maximal shift.
+        while (j <= last_start)
+        {
+            if (needle[rare] != haystack[j + rare])
+            {
+                const uint8_t* const next =
+                    memchr(&haystack[j + rare + 1U], needle[rare], last_start - j);
+                if (next == NULL)
+                {
+                    return NULL;
+                }
+                j = (size_t) (next - haystack) - rare;
+            }
+            i = suffix;
+            // Scan for matches in the right half
+            while (i < needle_len && needle[i] == haystack[i + j])
+            {
+                i++;
+            }
+            if (i >= needle_len)
+            {
+                // Scan for matches in the left half
+                i = suffix - 1U;
+                while (i != SIZE_MAX && needle[i] == haystack[i + j])
+                {
+                    i--;
+                }
+                if (i == SIZE_MAX)
+                {
+                    return &haystack[j];
+                }
+                j += period;
+            }
+            else
+            {
+                j += i - suffix + 1U;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * Searches a short needle with memchr() on its first byte and memcmp() on
+ * the rest, which is the fastest approach for needles that fit into a
+ * handful of comparisons.
+ */
+static const uint8_t*
+short_needle_search(const uint8_t* haystack,
+                    const size_t haystack_len,
+                    const uint8_t* const needle,
+                    const size_t needle_len)
+{
+    // Last possible address where the needle could still start.
+    // If not found until this point, the rest of the haystack is too short to fit a needle.
+    const uint8_t* const haystack_last = haystack + haystack_len - needle_len;
+    while (haystack <= haystack_last)
+    {
+        haystack = memchr(haystack, needle[0], (size_t) (haystack_last - haystack) + 1U);
+        if (haystack == NULL)
+        {
+            return NULL;
+        }
+        if (memcmp(haystack + 1U, needle + 1U, needle_len - 1U) == 0)
+        {
+            return haystack;
+        }
+        haystack++;
+    }
+    return NULL;
+}
+
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+
+/**
+ * @internal
+ * Checks a bit-mask of candidate positions, where both the first and last
+ * needle bytes match, with a memcmp() of the needle's body.
+ *
+ * @param [in] candidate haystack position of bit 0 of the mask
+ * @param [in] mask candidate positions, one per bit
+ * @param [in] needle pattern, its first and last bytes already matched
+ * @param [in] needle_len amount of bytes in the needle, at least 2
+ * @param [in,out] verified counter of compared bytes
+ * @return the position of the first matching candidate or NULL
+ */
+XTR_INLINE static const uint8_t*
+simd_verify_candidates(const uint8_t* const candidate,
+                       uint32_t mask,
+                       const uint8_t* const needle,
+                       const size_t needle_len,
+                       size_t* const verified)
+{
+    while (mask != 0U)
+    {
+        const unsigned int offset = xtr_ctz32(mask);
+        if (memcmp(candidate + offset + 1U, needle + 1U, needle_len - 2U) == 0)
+        {
+            return candidate + offset;
+        }
+        *verified += needle_len;
+        mask &= mask - 1U;  // Clear lowest set bit
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * SIMD substring search filtering the candidate positions by the first and
+ * last byte of the needle, 16 (SSE2) or 32 (AVX2) positions per step.
+ *
+ * Stops early either when the remaining positions are fewer than a full
+ * vector or when the verification effort exceeds the linear budget.
+ *
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 2
+ * @param [out] resume first haystack position not scanned yet, when not found
+ * @return pointer to the first needle occurrence in the scanned section or NULL
+ */
+static const uint8_t*
+simd_filtered_search(const uint8_t* const haystack,
+                     const size_t haystack_len,
+                     const uint8_t* const needle,
+                     const size_t needle_len,
+                     size_t* const resume)
+{
+    // Amount of possible needle starting positions
+    const size_t positions = haystack_len - needle_len + 1U;
+    const uint8_t* const last_byte = haystack + needle_len - 1U;
+    size_t verified = 0U;
+    size_t i = 0U;
+    #if defined(XTR_AVX2)
+    const __m256i first32 = _mm256_set1_epi8((char) needle[0]);
+    const __m256i last32 = _mm256_set1_epi8((char) needle[needle_len - 1U]);
+    for (; i + 32U <= positions; i += 32U)
+    {
+        const __m256i block_first = _mm256_loadu_si256((const __m256i*) (haystack + i));
+        const __m256i block_last = _mm256_loadu_si256((const __m256i*) (last_byte + i));
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first32), _mm256_cmpeq_epi8(block_last, last32)));
+        const uint8_t* const found =
+            simd_verify_candidates(haystack + i, mask, needle, needle_len, &verified);
+        if (found != NULL)
+        {
+            return found;
+        }
+        if (verified > i * XTR_SIMD_VERIFY_FACTOR + XTR_SIMD_VERIFY_ALLOWANCE)
+        {
+            i += 32U;
+            break;
+        }
+    }
+    #else
+    const __m128i first16 = _mm_set1_epi8((char) needle[0]);
+    const __m128i last16 = _mm_set1_epi8((char) needle[needle_len - 1U]);
+    for (; i + 16U <= positions; i += 16U)
+    {
+        const __m128i block_first = _mm_loadu_si128((const __m128i*) (haystack + i));
+        const __m128i block_last = _mm_loadu_si128((const __m128i*) (last_byte + i));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block_first, first16), _mm_cmpeq_epi8(block_last, last16)));
+        const uint8_t* const found =
+            simd_verify_candidates(haystack + i, mask, needle, needle_len, &verified);
+        if (found != NULL)
+        {
+            return found;
+        }
+        if (verified > i * XTR_SIMD_VERIFY_FACTOR + XTR_SIMD_VERIFY_ALLOWANCE)
+        {
+            i += 16U;
+            break;
+        }
+    }
+    #endif
+    *resume = i;
+    return NULL;
+}
+
+#endif
+
+/**
+ * @internal
+ * Scalar search, choosing the best algorithm for the needle length.
+ */
+static const uint8_t*
+scalar_search(const uint8_t* const haystack,
+              const size_t haystack_len,
+              const uint8_t* const needle,
+              const size_t needle_len,
+              const xtr_twoway_t* const twoway)
+{
+    if (needle_len <= XTR_MEMMEM_SHORT_NEEDLE)
+    {
+        return short_needle_search(haystack, haystack_len, needle, needle_len);
+    }
+    if (twoway != NULL)
+    {
+        return xtr_twoway_search(twoway, haystack, haystack_len, needle, needle_len);
+    }
+    xtr_twoway_t prepared;
+    xtr_twoway_prepare(&prepared, needle, needle_len);
+    return xtr_twoway_search(&prepared, haystack, haystack_len, needle, needle_len);
+}
+
+const uint8_t*
+xtr_memmem_prepared(const uint8_t* const haystack,
+                    const size_t haystack_len,
+                    const uint8_t* const needle,
+                    const size_t needle_len,
+                    const xtr_twoway_t* const twoway)
+{
+    if (needle_len == 1U)
+    {
+        return memchr(haystack, needle[0], haystack_len);
+    }
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+    size_t resume = 0U;
+    const uint8_t* const found =
+        simd_filtered_search(haystack, haystack_len, needle, needle_len, &resume);
+    if (found != NULL || resume + needle_len > haystack_len)
+    {
+        return found;
+    }
+    // Tail shorter than a vector, or too many false positives: finish with
+    // the scalar search, which is linear in the worst case.
+    return scalar_search(haystack + resume, haystack_len - resume, needle, needle_len, twoway);
+#else
+    return scalar_search(haystack, haystack_len, needle, needle_len, twoway);
+#endif
+}
+
+const void*
+xtr_memmem(const void* const haystack,
+           const size_t haystack_len,
+           const void* const needle,
+           const size_t needle_len)
+{
+    if (haystack == NULL || needle == NULL || haystack_len == 0U || needle_len == 0U ||
+        haystack_len < needle_len)
+    {
+        return NULL;
+    }
+    if (haystack == needle)
+    {
+        return haystack;
+    }
+    // The Two-Way factorisation is computed only if the scalar search needs it
+    return xtr_memmem_prepared(haystack, haystack_len, needle, needle_len, NULL);
+}
+
+// ------------------- Reverse search ------------------------------------
+
+const uint8_t*
+xtr_memrchr(const uint8_t* const haystack, size_t haystack_len, const uint8_t byte)
+{
+#if defined(XTR_AVX2)
+    const __m256i wanted32 = _mm256_set1_epi8((char) byte);
+    while (haystack_len >= 32U)
+    {
+        haystack_len -= 32U;
+        const __m256i block = _mm256_loadu_si256((const __m256i*) (haystack + haystack_len));
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, wanted32));
+        if (mask != 0U)
+        {
+            return haystack + haystack_len + xtr_msb32(mask);
+        }
+    }
+#elif defined(XTR_SSE2)
+    const __m128i wanted16 = _mm_set1_epi8((char) byte);
+    while (haystack_len >= 16U)
+    {
+        haystack_len -= 16U;
+        const __m128i block = _mm_loadu_si128((const __m128i*) (haystack + haystack_len));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, wanted16));
+        if (mask != 0U)
+        {
+            return haystack + haystack_len + xtr_msb32(mask);
+        }
+    }
+#else
+    // Word-at-a-time: detects whether any of the 8 bytes equals the wanted one
+    const uint64_t ones = 0x0101010101010101U;
+    const uint64_t highs = 0x8080808080808080U;
+    const uint64_t wanted = ones * byte;
+    while (haystack_len >= sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, haystack + haystack_len - sizeof(uint64_t), sizeof(word));
+        word ^= wanted;
+        if (((word - ones) & ~word & highs) != 0U)
+        {
+            break;  // Found within these bytes, pinpointed below
+        }
+        haystack_len -= sizeof(uint64_t);
+    }
+#endif
+    while (haystack_len > 0U)
+    {
+        haystack_len--;
+        if (haystack[haystack_len] == byte)
+        {
+            return &haystack[haystack_len];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * Computes the Two-Way properties of the needle read backwards, for
+ * twoway_search_reverse().
+ */
+static void
+twoway_prepare_reverse(xtr_twoway_t* const twoway,
+                       const uint8_t* const needle,
+                       const size_t needle_len)
+{
+    twoway->suffix =
+        twoway_critical_factorisation(needle, needle_len, &twoway->period, TWOWAY_REVERSED);
+    twoway->rare = needle_len - 1U - rare_byte_index(needle, needle_len);
+    // The reversed needle's first `suffix` bytes are the needle's last ones
+    const size_t tail = needle_len - twoway->suffix;
+    twoway->periodic =
+        memcmp(needle + tail, needle + tail - twoway->period, twoway->suffix) == 0;
+    if (!twoway->periodic)
+    {
+        twoway->period = XTR_MAX(twoway->suffix, needle_len - twoway->suffix) + 1U;
+    }
+}
+
+/**
+ * @internal
+ * Two-Way search of the reversed needle in the reversed haystack, finding
+ * the last occurrence in linear time.
+ *
+ * Mirrors xtr_twoway_search(), where index `x` of the reversed arrays
+ * is index `len - 1 - x` of the original ones.
+ *
+ * @param [in] twoway properties of the needle from twoway_prepare_reverse()
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 1
+ * @return pointer to the last needle occurrence in the haystack or NULL
+ */
+static const uint8_t*
+twoway_search_reverse(const xtr_twoway_t* const twoway,
+                      const uint8_t* const haystack,
+                      const size_t haystack_len,
+                      const uint8_t* const needle,
+                      const size_t needle_len)
+{
+    const uint8_t* const haystack_end = haystack + haystack_len - 1U;
+    const uint8_t* const needle_end = needle + needle_len - 1U;
+    const size_t suffix = twoway->suffix;
+    const size_t period = twoway->period;
+    const size_t rare = twoway->rare;
+    const uint8_t rare_byte = *(needle_end - rare);
+    const size_t last_start = haystack_len - needle_len;
+    size_t memory = 0U;
+    size_t j = 0U;  // Candidate position of the reversed needle in the reversed haystack
+    size_t i;       // Position in the reversed needle being compared
+    while (j <= last_start)
+    {
+        if (memory == 0U && rare_byte != *(haystack_end - (j + rare)))
+        {
+            // Skip all positions where the rarest byte does not match
+            const uint8_t* const previous =
+                xtr_memrchr(haystack + needle_len - 1U - rare, last_start - j, rare_byte);
+            if (previous == NULL)
+            {
+                return NULL;
+            }
+            j = (size_t) (haystack_end - previous) - rare;
+        }
+        i = XTR_MAX(suffix, memory);
+        // Scan for matches in the right half
+        while (i < needle_len && *(needle_end - i) == *(haystack_end - (i + j)))
+        {
+            i++;
+        }
+        if (i >= needle_len)
+        {
+            // Scan for matches in the left half
+            i = suffix - 1U;
+            while (memory < i + 1U && *(needle_end - i) == *(haystack_end - (i + j)))
+            {
+                i--;
+            }
+            if (i + 1U < memory + 1U)
+            {
+                return haystack_end - (j + needle_len - 1U);
+            }
+            j += period;
+            // Only periodic needles remember the matched repetitions
+            memory = twoway->periodic ? needle_len - period : 0U;
+        }
+        else
+        {
+            j += i - suffix + 1U;
+            memory = 0U;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * Mirror of short_needle_search(): xtr_memrchr() on the first needle byte,
+ * memcmp() on the rest.
+ */
+static const uint8_t*
+short_needle_search_reverse(const uint8_t* const haystack,
+                            const size_t haystack_len,
+                            const uint8_t* const needle,
+                            const size_t needle_len)
+{
+    // Possible starting positions still to check, all before this one
+    size_t candidates = haystack_len - needle_len + 1U;
+    while (candidates > 0U)
+    {
+        const uint8_t* const candidate = xtr_memrchr(haystack, candidates, needle[0]);
+        if (candidate == NULL)
+        {
+            return NULL;
+        }
+        if (memcmp(candidate + 1U, needle + 1U, needle_len - 1U) == 0)
+        {
+            return candidate;
+        }
+        candidates = (size_t) (candidate - haystack);
+    }
+    return NULL;
+}
+
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+
+/**
+ * @internal
+ * Mirror of simd_verify_candidates(), checking the highest candidate
+ * positions first.
+ */
+XTR_INLINE static const uint8_t*
+simd_verify_candidates_reverse(const uint8_t* const candidate,
+                               uint32_t mask,
+                               const uint8_t* const needle,
+                               const size_t needle_len,
+                               size_t* const verified)
+{
+    while (mask != 0U)
+    {
+        const unsigned int offset = xtr_msb32(mask);
+        if (memcmp(candidate + offset + 1U, needle + 1U, needle_len - 2U) == 0)
+        {
+            return candidate + offset;
+        }
+        *verified += needle_len;
+        mask &= ~(1U << offset);  // Clear highest set bit
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * Mirror of simd_filtered_search(), scanning the candidate positions from
+ * the last one backwards.
+ *
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least `needle_len`
+ * @param [in] needle smaller array to search for
+ * @param [in] needle_len amount of bytes in the needle, at least 2
+ * @param [out] remaining amount of starting positions, from the haystack
+ *              start, not scanned yet, when not found
+ * @return pointer to the last needle occurrence in the scanned section or NULL
+ */
+static const uint8_t*
+simd_filtered_search_reverse(const uint8_t* const haystack,
+                             const size_t haystack_len,
+                             const uint8_t* const needle,
+                             const size_t needle_len,
+                             size_t* const remaining)
+{
+    size_t positions = haystack_len - needle_len + 1U;
+    const uint8_t* const last_byte = haystack + needle_len - 1U;
+    size_t verified = 0U;
+    size_t scanned = 0U;
+    #if defined(XTR_AVX2)
+    const __m256i first32 = _mm256_set1_epi8((char) needle[0]);
+    const __m256i last32 = _mm256_set1_epi8((char) needle[needle_len - 1U]);
+    while (positions >= 32U)
+    {
+        positions -= 32U;
+        const __m256i block_first = _mm256_loadu_si256((const __m256i*) (haystack + positions));
+        const __m256i block_last = _mm256_loadu_si256((const __m256i*) (last_byte + positions));
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first32), _mm256_cmpeq_epi8(block_last, last32)));
+        const uint8_t* const found = simd_verify_candidates_reverse(
+            haystack + positions, mask, needle, needle_len, &verified);
+        if (found != NULL)
+        {
+            return found;
+        }
+        scanned += 32U;
+        if (verified > scanned * XTR_SIMD_VERIFY_FACTOR + XTR_SIMD_VERIFY_ALLOWANCE)
+        {
+            break;
+        }
+    }
+    #else
+    const __m128i first16 = _mm_set1_epi8((char) needle[0]);
+    const __m128i last16 = _mm_set1_epi8((char) needle[needle_len - 1U]);
+    while (positions >= 16U)
+    {
+        positions -= 16U;
+        const __m128i block_first = _mm_loadu_si128((const __m128i*) (haystack + positions));
+        const __m128i block_last = _mm_loadu_si128((const __m128i*) (last_byte + positions));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block_first, first16), _mm_cmpeq_epi8(block_last, last16)));
+        const uint8_t* const found = simd_verify_candidates_reverse(
+            haystack + positions, mask, needle, needle_len, &verified);
+        if (found != NULL)
+        {
+            return found;
+        }
+        scanned += 16U;
+        if (verified > scanned * XTR_SIMD_VERIFY_FACTOR + XTR_SIMD_VERIFY_ALLOWANCE)
+        {
+            break;
+        }
+    }
+    #endif
+    *remaining = positions;
+    return NULL;
+}
+
+#endif
+
+/**
+ * @internal
+ * Mirror of scalar_search().
+ */
+static const uint8_t*
+scalar_search_reverse(const uint8_t* const haystack,
+                      const size_t haystack_len,
+                      const uint8_t* const needle,
+                      const size_t needle_len)
+{
+    if (needle_len <= XTR_MEMMEM_SHORT_NEEDLE)
+    {
+        return short_needle_search_reverse(haystack, haystack_len, needle, needle_len);
+    }
+    xtr_twoway_t twoway;
+    twoway_prepare_reverse(&twoway, needle, needle_len);
+    return twoway_search_reverse(&twoway, haystack, haystack_len, needle, needle_len);
+}
+
+const uint8_t*
+xtr_memrmem(const uint8_t* const haystack,
+            const size_t haystack_len,
+            const uint8_t* const needle,
+            const size_t needle_len)
+{
+    if (needle_len == 1U)
+    {
+        return xtr_memrchr(haystack, haystack_len, needle[0]);
+    }
+#if defined(XTR_SSE2) || defined(XTR_AVX2)
+    size_t remaining = 0U;
+    const uint8_t* const found =
+        simd_filtered_search_reverse(haystack, haystack_len, needle, needle_len, &remaining);
+    if (found != NULL || remaining == 0U)
+    {
+        return found;
+    }
+    // Head shorter than a vector, or too many false positives: finish with
+    // the scalar search on the positions not scanned yet.
+    return scalar_search_reverse(haystack, remaining + needle_len - 1U, needle, needle_len);
+#else
+    return scalar_search_reverse(haystack, haystack_len, needle, needle_len);
+#endif
+}
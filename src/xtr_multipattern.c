@@ -0,0 +1,546 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+/**
+ * @internal
+ * Called for each needle occurrence found by the automaton, in order of
+ * the occurrence's end.
+ *
+ * @param [in,out] context state of the caller
+ * @param [in] needle_id index of the found needle
+ * @param [in] start index of the first byte of the occurrence in the haystack
+ * @param [in] end index after the last byte of the occurrence in the haystack
+ * @return the haystack index where the scan should stop. Returning the
+ *         haystack length continues the scan until the end.
+ */
+typedef size_t (*ac_handler_t)(void* context, size_t needle_id, size_t start, size_t end);
+
+/**
+ * @internal
+ * Single pass over the haystack with the automaton, reporting every
+ * occurrence of every needle to the handler.
+ *
+ * The hot loop is one class lookup and one transition lookup per haystack
+ * byte; a single comparison with the first matching state avoids touching
+ * the output tables for states not reporting any needle.
+ */
+static void
+ac_scan(const xtr_multipattern_t* const patterns,
+        const uint8_t* const haystack,
+        const size_t haystack_len,
+        const ac_handler_t handler,
+        void* const context)
+{
+    const uint32_t* const transitions = patterns->transitions;
+    const uint8_t* const classes = patterns->classes;
+    const size_t match_offset = patterns->match_offset;
+    size_t end = haystack_len;
+    uint32_t state = 0U;  // Root
+    for (size_t i = 0U; i < end; i++)
+    {
+        state = transitions[state + classes[haystack[i]]];
+        if (state < match_offset)
+        {
+            continue;
+        }
+        size_t output_state = state / patterns->stride;
+        if (patterns->outputs_start[output_state] == patterns->outputs_start[output_state + 1U])
+        {
+            output_state = patterns->dict_links[output_state];
+        }
+        // Walk all needles ending here, from the longest to the shortest
+        while (output_state != XTR_AC_NO_STATE)
+        {
+            for (size_t k = patterns->outputs_start[output_state];
+                 k < patterns->outputs_start[output_state + 1U]; k++)
+            {
+                const size_t needle_id = patterns->outputs[k];
+                const size_t start = i + 1U - patterns->needle_lens[needle_id];
+                const size_t stop = handler(context, needle_id, start, i + 1U);
+                end = XTR_MIN(end, stop);
+                if (end <= i)
+                {
+                    return;
+                }
+            }
+            output_state = patterns->dict_links[output_state];
+        }
+    }
+}
+
+/**
+ * @internal
+ * Assigns a class to each byte value appearing in the needles, in
+ * increasing order starting from 0. All other byte values share the last
+ * class, as they can never be part of a match. The transition table has
+ * one column per class rather than per byte value, which makes it much
+ * smaller for typical needles.
+ *
+ * @return amount of classes
+ */
+static size_t
+ac_byte_classes(uint8_t classes[UINT8_MAX + 1U],
+                const xtr_t* const* const needles,
+                const size_t amount)
+{
+    bool used[UINT8_MAX + 1U] = {false};
+    for (size_t id = 0U; id < amount; id++)
+    {
+        for (size_t i = 0U; i < xtr_length(needles[id]); i++)
+        {
+            used[needles[id]->buffer[i]] = true;
+        }
+    }
+    size_t amount_of_classes = 0U;
+    for (size_t byte = 0U; byte <= UINT8_MAX; byte++)
+    {
+        if (used[byte])
+        {
+            classes[byte] = (uint8_t) amount_of_classes++;
+        }
+    }
+    if (amount_of_classes > UINT8_MAX)
+    {
+        return amount_of_classes;  // All byte values used, no shared class
+    }
+    for (size_t byte = 0U; byte <= UINT8_MAX; byte++)
+    {
+        if (!used[byte])
+        {
+            classes[byte] = (uint8_t) amount_of_classes;
+        }
+    }
+    return amount_of_classes + 1U;
+}
+
+/**
+ * @internal
+ * Computes the failure and dictionary-suffix links with a breadth-first
+ * visit of the trie, completing every missing trie transition so that the
+ * automaton is a DFA with exactly one lookup per haystack byte.
+ *
+ * @param [in,out] transitions trie with 0 for missing transitions, as no
+ *        state but the root is a child of the root. Complete DFA on return.
+ * @param [in] states amount of states in the trie
+ * @param [in] stride amount of byte classes, row length of `transitions`
+ * @param [in] outputs_start per state index of the first own needle in the outputs
+ * @param [out] dict_links per state link to the nearest suffix state with needles
+ * @param [out] fail per state failure link, scratch space
+ * @param [out] queue scratch space for the visit, `states` long
+ */
+static void
+ac_link(uint32_t* const transitions,
+        const size_t states,
+        const size_t stride,
+        const uint32_t* const outputs_start,
+        uint32_t* const dict_links,
+        uint32_t* const fail,
+        uint32_t* const queue)
+{
+    size_t head = 0U;
+    size_t tail = 0U;
+    fail[0] = 0U;
+    dict_links[0] = XTR_AC_NO_STATE;
+    for (size_t c = 0U; c < stride; c++)
+    {
+        const uint32_t child = transitions[c];
+        if (child != 0U)
+        {
+            fail[child] = 0U;
+            dict_links[child] = XTR_AC_NO_STATE;  // Root never has needles
+            queue[tail++] = child;
+        }
+    }
+    while (head < tail)
+    {
+        const uint32_t state = queue[head++];
+        uint32_t* const row = &transitions[state * stride];
+        const uint32_t* const fail_row = &transitions[fail[state] * stride];
+        for (size_t c = 0U; c < stride; c++)
+        {
+            if (row[c] == 0U)
+            {
+                // Missing in the trie: continue from the longest proper suffix
+                row[c] = fail_row[c];
+                continue;
+            }
+            const uint32_t child = row[c];
+            const uint32_t child_fail = fail_row[c];
+            fail[child] = child_fail;
+            dict_links[child] = outputs_start[child_fail] != outputs_start[child_fail + 1U]
+                                    ? child_fail
+                                    : dict_links[child_fail];
+            queue[tail++] = child;
+        }
+    }
+    XTR_ASSERT(tail == states - 1U);
+    (void) states;
+}
+
+XTR_API xtr_multipattern_t*
+xtr_multipattern_new(const xtr_t* const* const needles, const size_t amount)
+{
+    if (needles == NULL || amount == 0U || amount >= XTR_AC_NO_STATE)
+    {
+        return NULL;
+    }
+    size_t total_len = 0U;
+    for (size_t id = 0U; id < amount; id++)
+    {
+        total_len += xtr_length(needles[id]);
+        if (total_len >= XTR_AC_NO_STATE)
+        {
+            return NULL;  // Too many states to index
+        }
+    }
+    uint8_t classes[UINT8_MAX + 1U];
+    const size_t stride = ac_byte_classes(classes, needles, amount);
+    const size_t max_states = total_len + 1U;  // Root + one per needle byte at most
+    if (max_states > (XTR_AC_NO_STATE - 1U) / stride)
+    {
+        return NULL;  // Row offsets would not fit in 32 bits
+    }
+    // Scratch space for the construction, freed at the end
+    uint32_t* const trie = XTR_CALLOC(max_states * stride, sizeof(uint32_t));
+    uint32_t* const terminals = XTR_MALLOC(amount * sizeof(uint32_t));
+    uint32_t* const outputs_start = XTR_CALLOC(max_states + 1U, sizeof(uint32_t));
+    uint32_t* const dict_links = XTR_MALLOC(max_states * sizeof(uint32_t));
+    uint32_t* const fail = XTR_MALLOC(max_states * sizeof(uint32_t));
+    uint32_t* const queue = XTR_MALLOC(max_states * sizeof(uint32_t));
+    xtr_multipattern_t* patterns = NULL;
+    if (trie == NULL || terminals == NULL || outputs_start == NULL || dict_links == NULL ||
+        fail == NULL || queue == NULL)
+    {
+        goto cleanup;
+    }
+    // Trie of all needles
+    size_t states = 1U;
+    size_t max_len = 0U;
+    for (size_t id = 0U; id < amount; id++)
+    {
+        const size_t len = xtr_length(needles[id]);
+        if (len == 0U)
+        {
+            terminals[id] = XTR_AC_NO_STATE;  // Empty needles never match
+            continue;
+        }
+        max_len = XTR_MAX(max_len, len);
+        uint32_t state = 0U;
+        for (size_t i = 0U; i < len; i++)
+        {
+            uint32_t* const transition = &trie[state * stride + classes[needles[id]->buffer[i]]];
+            if (*transition == 0U)
+            {
+                *transition = (uint32_t) states++;
+            }
+            state = *transition;
+        }
+        terminals[id] = state;
+        outputs_start[state + 1U]++;
+    }
+    // Prefix sums: needles ending in state s are at outputs[outputs_start[s]..outputs_start[s+1])
+    for (size_t s = 0U; s < states; s++)
+    {
+        outputs_start[s + 1U] += outputs_start[s];
+    }
+    ac_link(trie, states, stride, outputs_start, dict_links, fail, queue);
+    // Final layout in a single allocation, all arrays sized exactly
+    const size_t amount_of_outputs = outputs_start[states];
+    const size_t to_allocate = sizeof(xtr_multipattern_t) + amount * sizeof(size_t) +
+                               (states * stride + states + 1U + states + amount_of_outputs) *
+                                   sizeof(uint32_t);
+    patterns = XTR_MALLOC(to_allocate);
+    if (patterns == NULL)
+    {
+        goto cleanup;
+    }
+    patterns->amount = amount;
+    patterns->max_len = max_len;
+    patterns->states = states;
+    patterns->stride = stride;
+    memcpy(patterns->classes, classes, sizeof(classes));
+    // size_t array first, for the alignment of the following ones
+    patterns->needle_lens = (size_t*) (patterns + 1);
+    patterns->transitions = (uint32_t*) (patterns->needle_lens + amount);
+    patterns->outputs_start = patterns->transitions + states * stride;
+    patterns->dict_links = patterns->outputs_start + states + 1U;
+    patterns->outputs = patterns->dict_links + states;
+    for (size_t id = 0U; id < amount; id++)
+    {
+        patterns->needle_lens[id] = xtr_length(needles[id]);
+    }
+    // Renumber the states, reusing the failure links as map from the trie
+    // numbering: states reporting any needle last, so a single comparison
+    // in the scanning loop tells whether the current state reports needles.
+    uint32_t* const renumbered = fail;
+    uint32_t renumbered_states = 0U;
+    for (bool matching_pass = false; renumbered_states < states; matching_pass = true)
+    {
+        if (matching_pass)
+        {
+            patterns->match_offset = renumbered_states * stride;
+        }
+        for (size_t state = 0U; state < states; state++)
+        {
+            const bool matching = outputs_start[state] != outputs_start[state + 1U] ||
+                                  dict_links[state] != XTR_AC_NO_STATE;
+            if (matching == matching_pass)
+            {
+                renumbered[state] = renumbered_states++;
+            }
+        }
+    }
+    XTR_ASSERT(renumbered[0] == 0U);  // Root never reports needles
+    memset(patterns->outputs_start, 0, (states + 1U) * sizeof(uint32_t));
+    for (size_t state = 0U; state < states; state++)
+    {
+        // Pre-multiplied row offsets of the target states
+        const size_t row = renumbered[state] * stride;
+        for (size_t c = 0U; c < stride; c++)
+        {
+            const uint32_t target = trie[state * stride + c];
+            patterns->transitions[row + c] = (uint32_t) (renumbered[target] * stride);
+        }
+        patterns->dict_links[renumbered[state]] =
+            dict_links[state] == XTR_AC_NO_STATE ? XTR_AC_NO_STATE : renumbered[dict_links[state]];
+        patterns->outputs_start[renumbered[state] + 1U] =
+            outputs_start[state + 1U] - outputs_start[state];
+    }
+    for (size_t state = 0U; state < states; state++)
+    {
+        patterns->outputs_start[state + 1U] += patterns->outputs_start[state];
+    }
+    // Needle IDs grouped by terminal state, reusing the queue as fill counters
+    memcpy(queue, patterns->outputs_start, states * sizeof(uint32_t));
+    for (size_t id = 0U; id < amount; id++)
+    {
+        if (terminals[id] != XTR_AC_NO_STATE)
+        {
+            patterns->outputs[queue[renumbered[terminals[id]]]++] = (uint32_t) id;
+        }
+    }
+cleanup:
+    XTR_FREE(trie);
+    XTR_FREE(terminals);
+    XTR_FREE(outputs_start);
+    XTR_FREE(dict_links);
+    XTR_FREE(fail);
+    XTR_FREE(queue);
+    return patterns;
+}
+
+XTR_API void
+xtr_multipattern_free(xtr_multipattern_t** const ppatterns)
+{
+    if (ppatterns != NULL && *ppatterns != NULL)
+    {
+        XTR_FREE(*ppatterns);
+        *ppatterns = NULL;  // Clear outside reference to avoid use-after-free
+    }
+}
+
+/** @internal State of xtr_find_any() while scanning. */
+typedef struct
+{
+    size_t max_len;
+    size_t start;
+    size_t len;
+    size_t needle_id;
+} ac_first_t;
+
+/**
+ * @internal
+ * Keeps the leftmost occurrence, the longest on ties. Stops the scan once no
+ * needle can start before the kept one anymore.
+ */
+static size_t
+ac_first_handler(void* const context, const size_t needle_id, const size_t start, const size_t end)
+{
+    ac_first_t* const first = context;
+    const size_t len = end - start;
+    if (first->start == XTR_NOT_FOUND || start < first->start ||
+        (start == first->start && len > first->len))
+    {
+        first->start = start;
+        first->len = len;
+        first->needle_id = needle_id;
+    }
+    return first->start + first->max_len;
+}
+
+XTR_API size_t
+xtr_find_any(const xtr_t* const haystack,
+             const xtr_multipattern_t* const patterns,
+             size_t* const needle_id)
+{
+    if (needle_id != NULL)
+    {
+        *needle_id = XTR_NOT_FOUND;
+    }
+    if (xtr_is_empty(haystack) || patterns == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    ac_first_t first = {patterns->max_len, XTR_NOT_FOUND, 0U, XTR_NOT_FOUND};
+    ac_scan(patterns, haystack->buffer, haystack->used, ac_first_handler, &first);
+    if (needle_id != NULL)
+    {
+        *needle_id = first.needle_id;
+    }
+    return first.start;
+}
+
+/** @internal State of xtr_find_all_any() while scanning. */
+typedef struct
+{
+    xtr_match_t* matches;
+    size_t amount;
+    size_t capacity;
+    size_t haystack_len;
+} ac_all_t;
+
+/**
+ * @internal
+ * Appends each occurrence to the growing array. Stops the scan when
+ * running out of memory, freeing the array.
+ */
+static size_t
+ac_all_handler(void* const context, const size_t needle_id, const size_t start, const size_t end)
+{
+    ac_all_t* const all = context;
+    (void) end;
+    if (all->amount == all->capacity)
+    {
+        const size_t capacity = all->capacity * 2U;
+        xtr_match_t* const larger = capacity > SIZE_MAX / sizeof(xtr_match_t)
+                                        ? NULL
+                                        : XTR_REALLOC(all->matches, capacity * sizeof(xtr_match_t));
+        if (larger == NULL)
+        {
+            XTR_FREE(all->matches);
+            all->matches = NULL;
+            return 0U;
+        }
+        all->matches = larger;
+        all->capacity = capacity;
+    }
+    all->matches[all->amount].index = start;
+    all->matches[all->amount].needle_id = needle_id;
+    all->amount++;
+    return all->haystack_len;
+}
+
+XTR_API xtr_match_t*
+xtr_find_all_any(size_t* const amount,
+                 const xtr_t* const haystack,
+                 const xtr_multipattern_t* const patterns)
+{
+    if (amount == NULL)
+    {
+        return NULL;
+    }
+    *amount = 0U;
+    if (haystack == NULL || patterns == NULL)
+    {
+        return NULL;
+    }
+    ac_all_t all = {NULL, 0U, 16U, haystack->used};
+    all.matches = XTR_MALLOC(all.capacity * sizeof(xtr_match_t));
+    if (all.matches == NULL)
+    {
+        return NULL;
+    }
+    ac_scan(patterns, haystack->buffer, haystack->used, ac_all_handler, &all);
+    if (all.matches != NULL)
+    {
+        *amount = all.amount;
+    }
+    return all.matches;
+}
+
+/** @internal State of xtr_count_each() while scanning. */
+typedef struct
+{
+    size_t* counts;
+    size_t* resume;
+    size_t total;
+    size_t haystack_len;
+} ac_count_t;
+
+/**
+ * @internal
+ * Counts the occurrence unless overlapping with the previous counted
+ * occurrence of the same needle.
+ */
+static size_t
+ac_count_handler(void* const context, const size_t needle_id, const size_t start, const size_t end)
+{
+    ac_count_t* const count = context;
+    if (start >= count->resume[needle_id])
+    {
+        count->counts[needle_id]++;
+        count->resume[needle_id] = end;
+        count->total++;
+    }
+    return count->haystack_len;
+}
+
+XTR_API size_t
+xtr_count_each(size_t* const counts,
+               const xtr_t* const haystack,
+               const xtr_multipattern_t* const patterns)
+{
+    if (counts == NULL || haystack == NULL || patterns == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    // Per needle, first haystack index where its next occurrence may start
+    size_t* const resume = XTR_CALLOC(patterns->amount, sizeof(size_t));
+    if (resume == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    memset(counts, 0, patterns->amount * sizeof(size_t));
+    ac_count_t count = {counts, resume, 0U, haystack->used};
+    ac_scan(patterns, haystack->buffer, haystack->used, ac_count_handler, &count);
+    XTR_FREE(resume);
+    return count.total;
+}
+
+XTR_API size_t
+xtr_multipattern_amount(const xtr_multipattern_t* const patterns)
+{
+    return patterns == NULL ? 0U : patterns->amount;
+}
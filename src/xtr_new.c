@@ -52,6 +52,8 @@ xtr_alloc(const size_t used, const size_t capacity)
     {
         return NULL;
     }
+    new->refs = 1U;
+    new->buffer = new->storage;
     set_capacity_and_terminator(new, capacity);
     set_used_and_terminator(new, 0U);
     return new;
@@ -74,8 +76,13 @@ xtr_free(xtr_t** const pxtr)
 {
     if (pxtr != NULL && *pxtr != NULL)
     {
+        if (xtr_refs_load(*pxtr) > 1U && xtr_refs_add(*pxtr, SIZE_MAX) > 0U)
+        {
+            *pxtr = NULL;  // Other owners still use it
+            return;
+        }
 #if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
-        zero_out((*pxtr)->buffer, (*pxtr)->capacity);
+        zero_out((*pxtr)->storage, xtr_capacity(*pxtr));
 #endif
         XTR_FREE(*pxtr);
         *pxtr = NULL;  // Clear outside reference to avoid use-after-free
@@ -0,0 +1,505 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+#if defined(XTR_THREADS) && XTR_THREADS
+    #if XTR_OS == 'W'
+        #include <windows.h>
+    #else
+        #include <pthread.h>
+        #include <unistd.h>
+    #endif
+#endif
+
+/**
+ * @internal
+ * When counting, amount of occurrence positions each thread records from
+ * the start of its range, to resynchronise the non-overlapping occurrences
+ * with the ones of the previous range.
+ */
+#define XTR_PARALLEL_RESYNC_POSITIONS 64U
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/**
+ * @internal
+ * Section of the haystack searched by one thread.
+ *
+ * Occurrences starting at positions in `[start, end)` are found, so the
+ * searched bytes extend by `needle_len - 1` into the following range.
+ * Occurrences do not overlap, assuming that no previous occurrence
+ * ends after `start`: the merge fixes up the cases where it does.
+ */
+typedef struct
+{
+    const xtr_pattern_t* pattern;
+    const uint8_t* haystack;
+    size_t haystack_len;
+    /** First position in the range, inclusive. */
+    size_t start;
+    /** Last position in the range, exclusive. */
+    size_t end;
+    /** Amount of found occurrences. */
+    size_t count;
+    /** End of the last found occurrence, `start` if none. */
+    size_t last_end;
+    /** First `recorded` positions of the found occurrences. */
+    size_t* positions;
+    size_t recorded;
+    /** Maximum amount of positions to record. */
+    size_t capacity;
+    /** Whether `positions` is reallocated to record all occurrences. */
+    bool growable;
+    /** Set on malloc failure. */
+    bool failed;
+    /** Fixed buffer for the positions, when not growable. */
+    size_t prefix[XTR_PARALLEL_RESYNC_POSITIONS];
+} range_search_t;
+#pragma clang diagnostic pop
+
+/**
+ * @internal
+ * Records the non-overlapping occurrences in the range.
+ */
+static void
+search_range(range_search_t* const range)
+{
+    const size_t needle_len = range->pattern->len;
+    const size_t window_end = XTR_MIN(range->end + needle_len - 1U, range->haystack_len);
+    size_t progress = range->start;
+    range->last_end = range->start;
+    while (progress < range->end)
+    {
+        const uint8_t* const occurrence = xtr_pattern_search(
+            range->pattern, &range->haystack[progress], window_end - progress);
+        if (occurrence == NULL)
+        {
+            break;
+        }
+        const size_t position = (size_t) (occurrence - range->haystack);
+        if (range->recorded == range->capacity && range->growable)
+        {
+            const size_t capacity = range->capacity * 2U;
+            size_t* const larger = capacity > SIZE_MAX / sizeof(size_t)
+                                       ? NULL
+                                       : XTR_REALLOC(range->positions, capacity * sizeof(size_t));
+            if (larger == NULL)
+            {
+                range->failed = true;
+                return;
+            }
+            range->positions = larger;
+            range->capacity = capacity;
+        }
+        if (range->recorded < range->capacity)
+        {
+            range->positions[range->recorded++] = position;
+        }
+        range->count++;
+        progress = position + needle_len;
+        range->last_end = progress;
+    }
+}
+
+/**
+ * @internal
+ * Prepares the range structure.
+ *
+ * @return false in case of malloc failure
+ */
+static bool
+init_range(range_search_t* const range,
+           const xtr_pattern_t* const pattern,
+           const xtr_t* const haystack,
+           const size_t start,
+           const size_t end,
+           const bool record_all)
+{
+    range->pattern = pattern;
+    range->haystack = haystack->buffer;
+    range->haystack_len = haystack->used;
+    range->start = start;
+    range->end = end;
+    range->count = 0U;
+    range->last_end = start;
+    range->recorded = 0U;
+    range->growable = record_all;
+    range->failed = false;
+    if (record_all)
+    {
+        range->capacity = 16U;
+        range->positions = XTR_MALLOC(range->capacity * sizeof(size_t));
+        return range->positions != NULL;
+    }
+    range->capacity = XTR_PARALLEL_RESYNC_POSITIONS;
+    range->positions = range->prefix;
+    return true;
+}
+
+#if defined(XTR_THREADS) && XTR_THREADS
+
+    #if XTR_OS == 'W'
+typedef HANDLE thread_t;
+
+static DWORD WINAPI
+search_range_thread(LPVOID range)
+{
+    search_range(range);
+    return 0;
+}
+
+static bool
+thread_start(thread_t* const thread, range_search_t* const range)
+{
+    *thread = CreateThread(NULL, 0, search_range_thread, range, 0, NULL);
+    return *thread != NULL;
+}
+
+static void
+thread_join(const thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static size_t
+hardware_threads(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
+    #else
+typedef pthread_t thread_t;
+
+static void*
+search_range_thread(void* const range)
+{
+    search_range(range);
+    return NULL;
+}
+
+static bool
+thread_start(thread_t* const thread, range_search_t* const range)
+{
+    return pthread_create(thread, NULL, search_range_thread, range) == 0;
+}
+
+static void
+thread_join(const thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static size_t
+hardware_threads(void)
+{
+    const long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (size_t) online : 1U;
+}
+    #endif
+
+/**
+ * @internal
+ * Searches all ranges, the first one in the calling thread, the others in
+ * new threads. A range whose thread cannot be started is searched in the
+ * calling thread instead.
+ */
+static void
+search_ranges(range_search_t* const ranges, const size_t amount)
+{
+    if (amount == 1U)
+    {
+        search_range(&ranges[0]);
+        return;
+    }
+    thread_t* const threads = XTR_MALLOC(amount * sizeof(thread_t));
+    bool* const started = XTR_CALLOC(amount, sizeof(bool));
+    if (threads != NULL && started != NULL)
+    {
+        for (size_t i = 1U; i < amount; i++)
+        {
+            started[i] = thread_start(&threads[i], &ranges[i]);
+        }
+    }
+    search_range(&ranges[0]);
+    for (size_t i = 1U; i < amount; i++)
+    {
+        if (started != NULL && started[i])
+        {
+            thread_join(threads[i]);
+        }
+        else
+        {
+            search_range(&ranges[i]);
+        }
+    }
+    XTR_FREE(threads);
+    XTR_FREE(started);
+}
+#else
+static size_t
+hardware_threads(void)
+{
+    return 1U;
+}
+
+static void
+search_ranges(range_search_t* const ranges, const size_t amount)
+{
+    for (size_t i = 0U; i < amount; i++)
+    {
+        search_range(&ranges[i]);
+    }
+}
+#endif
+
+/**
+ * @internal
+ * Amount of ranges to split the haystack into, 1 for a serial search.
+ */
+static size_t
+amount_of_ranges(const size_t haystack_len, const size_t threads)
+{
+    const size_t wanted = threads == 0U ? hardware_threads() : threads;
+    const size_t max_ranges = XTR_MAX(haystack_len / XTR_PARALLEL_MIN_LEN, 1U);
+    return XTR_MIN(wanted, max_ranges);
+}
+
+/**
+ * @internal
+ * Merges the occurrences of the ranges, in order, so the result is the
+ * same as the one of a serial search.
+ *
+ * The occurrence found last in a range may end after the start of the next
+ * range, which was searched assuming no such overlap. In that case the next
+ * range is searched again from that end, until reaching an occurrence also
+ * found by its thread: from there on, the two chains of non-overlapping
+ * occurrences coincide. Only periodic needles like "aa" may require
+ * searching a large part of the range again.
+ *
+ * @param [in] ranges searched ranges
+ * @param [in] amount of ranges
+ * @param [out] positions array where to write the positions of all
+ *              occurrences, or NULL when only counting
+ * @return amount of occurrences
+ */
+static size_t
+merge_ranges(const range_search_t* const ranges, const size_t amount, size_t* const positions)
+{
+    size_t total = 0U;
+    size_t resume = 0U;  // End of the last accepted occurrence
+    for (size_t r = 0U; r < amount; r++)
+    {
+        const range_search_t* const range = &ranges[r];
+        const size_t needle_len = range->pattern->len;
+        const size_t window_end = XTR_MIN(range->end + needle_len - 1U, range->haystack_len);
+        size_t first = 0U;  // First occurrence found by the thread to accept
+        while (resume > range->start)
+        {
+            const uint8_t* const occurrence =
+                resume >= range->end ? NULL
+                                     : xtr_pattern_search(range->pattern,
+                                                          &range->haystack[resume],
+                                                          window_end - resume);
+            if (occurrence == NULL)
+            {
+                first = range->count;
+                break;
+            }
+            const size_t position = (size_t) (occurrence - range->haystack);
+            while (first < range->recorded && range->positions[first] < position)
+            {
+                first++;
+            }
+            if (first < range->recorded && range->positions[first] == position)
+            {
+                break;  // Converged with the occurrences found by the thread
+            }
+            if (first == range->recorded && range->recorded < range->count)
+            {
+                // Beyond the recorded positions: count the rest serially
+                range_search_t rest = *range;
+                rest.start = position;
+                rest.count = 0U;
+                rest.recorded = 0U;
+                rest.capacity = 0U;
+                rest.growable = false;
+                search_range(&rest);
+                total += rest.count;
+                resume = rest.last_end;
+                first = range->count;
+                break;
+            }
+            if (positions != NULL)
+            {
+                positions[total] = position;
+            }
+            total++;
+            resume = position + needle_len;
+        }
+        if (first < range->count)
+        {
+            if (positions != NULL)
+            {
+                memcpy(&positions[total], &range->positions[first],
+                       (range->recorded - first) * sizeof(size_t));
+            }
+            total += range->count - first;
+            resume = range->last_end;
+        }
+    }
+    return total;
+}
+
+/**
+ * @internal
+ * Splits the haystack into ranges, searches them and merges the results.
+ *
+ * @param [out] amount of occurrences
+ * @param [out] pall positions of the occurrences, to free after usage.
+ *              NULL to only count them.
+ * @param [in] haystack to search in
+ * @param [in] needle to search for
+ * @param [in] threads amount of threads, 0 for one per processor
+ * @return false in case of malloc failure
+ */
+static bool
+parallel_search(size_t* const amount,
+                size_t** const pall,
+                const xtr_t* const haystack,
+                const xtr_t* const needle,
+                const size_t threads)
+{
+    const bool record_all = pall != NULL;
+    size_t* positions = NULL;
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    if (pattern == NULL)
+    {
+        return false;
+    }
+    const size_t ranges_amount = amount_of_ranges(haystack->used, threads);
+    range_search_t* const ranges = XTR_MALLOC(ranges_amount * sizeof(range_search_t));
+    size_t initialised = 0U;
+    bool failed = ranges == NULL;
+    const size_t range_len = haystack->used / ranges_amount;
+    for (; !failed && initialised < ranges_amount; initialised++)
+    {
+        const size_t start = initialised * range_len;
+        const size_t end =
+            initialised + 1U == ranges_amount ? haystack->used : start + range_len;
+        failed = !init_range(&ranges[initialised], pattern, haystack, start, end, record_all);
+    }
+    if (!failed)
+    {
+        search_ranges(ranges, ranges_amount);
+        size_t upper_bound = 0U;
+        for (size_t i = 0U; i < ranges_amount; i++)
+        {
+            failed |= ranges[i].failed;
+            upper_bound += ranges[i].count;
+        }
+        // Resynchronised ranges never contain more occurrences than found
+        // by their threads, as those start from an earlier position.
+        if (!failed && record_all)
+        {
+            positions = XTR_MALLOC(XTR_MAX(upper_bound, 1U) * sizeof(size_t));
+            failed = positions == NULL;
+        }
+        if (!failed)
+        {
+            *amount = merge_ranges(ranges, ranges_amount, positions);
+        }
+    }
+    for (size_t i = 0U; record_all && i < initialised; i++)
+    {
+        XTR_FREE(ranges[i].positions);
+    }
+    XTR_FREE(ranges);
+    xtr_pattern_free(&pattern);
+    if (failed)
+    {
+        XTR_FREE(positions);
+        return false;
+    }
+    if (record_all)
+    {
+        *pall = positions;
+    }
+    return true;
+}
+
+XTR_API size_t
+xtr_occurrences_parallel(const xtr_t* const haystack,
+                         const xtr_t* const needle,
+                         const size_t threads)
+{
+    size_t amount = 0U;
+    if (haystack == NULL || needle == NULL || needle->used == 0U)
+    {
+        return XTR_NOT_FOUND;
+    }
+    if (needle->used > haystack->used)
+    {
+        return 0U;
+    }
+    if (!parallel_search(&amount, NULL, haystack, needle, threads))
+    {
+        return XTR_NOT_FOUND;
+    }
+    return amount;
+}
+
+XTR_API size_t*
+xtr_find_all_parallel(size_t* const amount,
+                      const xtr_t* const haystack,
+                      const xtr_t* const needle,
+                      const size_t threads)
+{
+    if (amount == NULL || haystack == NULL || needle == NULL || needle->used == 0U)
+    {
+        return NULL;
+    }
+    *amount = 0U;
+    if (needle->used > haystack->used)
+    {
+        return XTR_CALLOC(1U, sizeof(size_t));
+    }
+    size_t* positions = NULL;
+    if (!parallel_search(amount, &positions, haystack, needle, threads))
+    {
+        return NULL;
+    }
+    return positions;
+}
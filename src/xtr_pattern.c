@@ -0,0 +1,274 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+#include <stddef.h>
+
+XTR_API xtr_pattern_t*
+xtr_pattern_new(const xtr_t* const needle)
+{
+    if (xtr_is_empty(needle))
+    {
+        return NULL;
+    }
+    const size_t header = offsetof(struct xtr_pattern, needle);
+    const size_t to_allocate = header + needle->used + TERMINATOR_LEN;
+    if (to_allocate <= needle->used)
+    {
+        return NULL;  // Integer overflow
+    }
+    xtr_pattern_t* const pattern = XTR_MALLOC(to_allocate);
+    if (pattern == NULL)
+    {
+        return NULL;
+    }
+    pattern->len = needle->used;
+    memcpy(pattern->needle, needle->buffer, needle->used);
+    pattern->needle[needle->used] = TERMINATOR;
+    xtr_twoway_prepare(&pattern->twoway, pattern->needle, pattern->len);
+#if !defined(XTR_SSE2) && !defined(XTR_AVX2)
+    if (pattern->len > XTR_PATTERN_LONG_NEEDLE)
+    {
+        for (size_t i = 0U; i <= UINT8_MAX; i++)
+        {
+            pattern->shift[i] = pattern->len;
+        }
+        for (size_t i = 0U; i < pattern->len; i++)
+        {
+            pattern->shift[pattern->needle[i]] = pattern->len - i - 1U;
+        }
+    }
+#endif
+    return pattern;
+}
+
+XTR_API void
+xtr_pattern_free(xtr_pattern_t** const ppattern)
+{
+    if (ppattern != NULL && *ppattern != NULL)
+    {
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+        zero_out((*ppattern)->needle, (*ppattern)->len);
+#endif
+        XTR_FREE(*ppattern);
+        *ppattern = NULL;  // Clear outside reference to avoid use-after-free
+    }
+}
+
+#if !defined(XTR_SSE2) && !defined(XTR_AVX2)
+
+/**
+ * @internal
+ * Two-Way search combined with the Horspool bad-character shift, for long
+ * needles.
+ *
+ * The haystack byte aligned with the needle's last byte is checked first:
+ * unless it matches, the needle is shifted according to the table, often by
+ * its whole length, without inspecting the bytes in between. Otherwise the
+ * Two-Way comparisons follow, keeping the worst case linear.
+ *
+ * @param [in] pattern compiled long needle, with the shift table filled
+ * @param [in] haystack larger array to search in
+ * @param [in] haystack_len amount of bytes in the haystack, at least the needle length
+ * @return pointer to the first needle occurrence in the haystack or NULL
+ */
+static const uint8_t*
+twoway_shift_search(const xtr_pattern_t* const pattern,
+                    const uint8_t* const haystack,
+                    const size_t haystack_len)
+{
+    const uint8_t* const needle = pattern->needle;
+    const size_t needle_len = pattern->len;
+    const size_t suffix = pattern->twoway.suffix;
+    const size_t period = pattern->twoway.period;
+    const size_t last_start = haystack_len - needle_len;
+    size_t j = 0U;  // Candidate position of the needle in the haystack
+    size_t i;       // Position in the needle being compared
+    if (pattern->twoway.periodic)
+    {
+        size_t memory = 0U;
+        while (j <= last_start)
+        {
+            size_t shift = pattern->shift[haystack[j + needle_len - 1U]];
+            if (shift > 0U)
+            {
+                if (memory != 0U && shift < period)
+                {
+                    // The needle is periodic, but the last period has a byte
+                    // out of place: no match possible until after the mismatch
+                    shift = needle_len - period;
+                }
+                memory = 0U;
+                j += shift;
+                continue;
+            }
+            // Scan for matches in the right half, the last byte already matched
+            i = XTR_MAX(suffix, memory);
+            while (i < needle_len - 1U && needle[i] == haystack[i + j])
+            {
+                i++;
+            }
+            if (i >= needle_len - 1U)
+            {
+                // Scan for matches in the left half
+                i = suffix - 1U;
+                while (memory < i + 1U && needle[i] == haystack[i + j])
+                {
+                    i--;
+                }
+                if (i + 1U < memory + 1U)
+                {
+                    return &haystack[j];
+                }
+                j += period;
+                memory = needle_len - period;
+            }
+            else
+            {
+                j += i - suffix + 1U;
+                memory = 0U;
+            }
+        }
+    }
+    else
+    {
+        while (j <= last_start)
+        {
+            const size_t shift = pattern->shift[haystack[j + needle_len - 1U]];
+            if (shift > 0U)
+            {
+                j += shift;
+                continue;
+            }
+            i = suffix;
+            while (i < needle_len - 1U && needle[i] == haystack[i + j])
+            {
+                i++;
+            }
+            if (i >= needle_len - 1U)
+            {
+                i = suffix - 1U;
+                while (i != SIZE_MAX && needle[i] == haystack[i + j])
+                {
+                    i--;
+                }
+                if (i == SIZE_MAX)
+                {
+                    return &haystack[j];
+                }
+                j += period;
+            }
+            else
+            {
+                j += i - suffix + 1U;
+            }
+        }
+    }
+    return NULL;
+}
+
+#endif
+
+const uint8_t*
+xtr_pattern_search(const xtr_pattern_t* const pattern,
+                   const uint8_t* const haystack,
+                   const size_t haystack_len)
+{
+    if (haystack_len < pattern->len)
+    {
+        return NULL;
+    }
+#if !defined(XTR_SSE2) && !defined(XTR_AVX2)
+    if (pattern->len > XTR_PATTERN_LONG_NEEDLE)
+    {
+        return twoway_shift_search(pattern, haystack, haystack_len);
+    }
+#endif
+    return xtr_memmem_prepared(haystack, haystack_len, pattern->needle, pattern->len,
+                               &pattern->twoway);
+}
+
+XTR_API size_t
+xtr_pattern_find(const xtr_t* const haystack, const xtr_pattern_t* const pattern)
+{
+    return xtr_pattern_find_from(haystack, pattern, 0U);
+}
+
+XTR_API size_t
+xtr_pattern_find_from(const xtr_t* const haystack,
+                      const xtr_pattern_t* const pattern,
+                      const size_t start)
+{
+    if (xtr_is_empty(haystack) || pattern == NULL || start >= haystack->used)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const uint8_t* const location =
+        xtr_pattern_search(pattern, haystack->buffer + start, haystack->used - start);
+    if (location == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return (size_t) (location - haystack->buffer);
+}
+
+XTR_API size_t
+xtr_pattern_count(const xtr_t* const haystack, const xtr_pattern_t* const pattern)
+{
+    if (haystack == NULL || pattern == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    size_t count = 0U;
+    size_t progress = 0U;
+    while (true)
+    {
+        // Non-overlapping occurrences: resume the search after the needle's end
+        const uint8_t* const occurrence = xtr_pattern_search(
+            pattern, &haystack->buffer[progress], haystack->used - progress);
+        if (occurrence == NULL)
+        {
+            break;
+        }
+        count++;
+        progress = (size_t) (occurrence - haystack->buffer) + pattern->len;
+    }
+    return count;
+}
+
+XTR_API bool
+xtr_pattern_contains(const xtr_t* const haystack, const xtr_pattern_t* const pattern)
+{
+    return xtr_pattern_find(haystack, pattern) != XTR_NOT_FOUND;
+}
@@ -0,0 +1,1503 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+/** @internal Most repetitions of a bounded repetition such as `{n,m}`. */
+#define RE_MAX_REPEAT 1000U
+/** @internal Most instructions of a compiled program, also most parsed nodes. */
+#define RE_MAX_INSTS (16U * 1024U)
+/** @internal Most nodes visited while compiling, bounding empty repetitions. */
+#define RE_MAX_WORK (8U * RE_MAX_INSTS)
+/** @internal Most nested groups, bounding the recursion depth. */
+#define RE_MAX_DEPTH 200U
+/** @internal Maximum of a repetition without upper bound. */
+#define RE_INFINITE UINT32_MAX
+/** @internal Missing node or instruction. */
+#define RE_NONE UINT32_MAX
+
+// ------------------- Parsing ------------------------------------------------
+
+/** @internal Kinds of nodes of the syntax tree. */
+typedef enum
+{
+    /** Any byte of a set. */
+    RE_NODE_BYTES = 0,
+    /** All children in sequence, matching the empty string if none. */
+    RE_NODE_CONCAT,
+    /** Any of the children. */
+    RE_NODE_ALTERNATE,
+    /** The child repeated `min` to `max` times. */
+    RE_NODE_REPEAT,
+} re_kind_t;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wpadded"
+/** @internal Node of the syntax tree, linked to the others by index. */
+typedef struct
+{
+    xtr_charset_t set;
+    re_kind_t kind;
+    /** First and last child, the only child of repetitions. */
+    uint32_t first;
+    uint32_t last;
+    /** Next and previous sibling. */
+    uint32_t next;
+    uint32_t prev;
+    uint32_t min;
+    uint32_t max;
+    bool greedy;
+} re_node_t;
+
+/** @internal State of the recursive descent parser. */
+typedef struct
+{
+    const char* pattern;
+    /** Index of the next byte to parse. */
+    size_t pos;
+    /** Index after the last byte to parse, excluding a final `$` anchor. */
+    size_t end;
+    re_node_t* nodes;
+    size_t amount;
+    size_t capacity;
+    /** Amount of groups open at `pos`. */
+    size_t depth;
+} re_parser_t;
+#pragma clang diagnostic pop
+
+static void
+re_set_add_range(xtr_charset_t* const set, const unsigned int low, const unsigned int high)
+{
+    for (unsigned int byte = low; byte <= high; byte++)
+    {
+        set->bitmap[XTR_CHARSET_ROW(byte)] |= XTR_CHARSET_BIT(byte);
+    }
+}
+
+static void
+re_set_negate(xtr_charset_t* const set)
+{
+    for (size_t i = 0U; i < sizeof(set->bitmap); i++)
+    {
+        set->bitmap[i] = (uint8_t) ~set->bitmap[i];
+    }
+}
+
+/**
+ * @internal
+ * Checks whether the set has exactly one member.
+ *
+ * @param [in] set to check
+ * @param [out] byte the only member, if any
+ * @return true if the set has exactly one member
+ */
+static bool
+re_set_single(const xtr_charset_t* const set, uint8_t* const byte)
+{
+    size_t members = 0U;
+    for (unsigned int candidate = 0U; candidate <= UINT8_MAX; candidate++)
+    {
+        if (xtr_charset_contains(set, (uint8_t) candidate))
+        {
+            *byte = (uint8_t) candidate;
+            members++;
+        }
+    }
+    return members == 1U;
+}
+
+static bool
+re_is_alnum(const unsigned int c)
+{
+    return (c >= '0' && c <= '9') || ((c | 0x20U) >= 'a' && (c | 0x20U) <= 'z');
+}
+
+static unsigned int
+re_hex_digit(const unsigned int c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if ((c | 0x20U) >= 'a' && (c | 0x20U) <= 'f')
+    {
+        return (c | 0x20U) - 'a' + 10U;
+    }
+    return 16U;  // Invalid
+}
+
+/** @internal Appends a node to the tree, returning its index or #RE_NONE. */
+static uint32_t
+re_node(re_parser_t* const parser, const re_kind_t kind)
+{
+    if (parser->amount == parser->capacity)
+    {
+        if (parser->capacity >= RE_MAX_INSTS)
+        {
+            return RE_NONE;
+        }
+        const size_t capacity = parser->capacity == 0U ? 64U : parser->capacity * 2U;
+        re_node_t* const larger = XTR_REALLOC(parser->nodes, capacity * sizeof(re_node_t));
+        if (larger == NULL)
+        {
+            return RE_NONE;
+        }
+        parser->nodes = larger;
+        parser->capacity = capacity;
+    }
+    re_node_t* const node = &parser->nodes[parser->amount];
+    memset(node, 0, sizeof(*node));
+    node->kind = kind;
+    node->first = RE_NONE;
+    node->last = RE_NONE;
+    node->next = RE_NONE;
+    node->prev = RE_NONE;
+    return (uint32_t) parser->amount++;
+}
+
+static void
+re_append_child(re_parser_t* const parser, const uint32_t parent, const uint32_t child)
+{
+    re_node_t* const nodes = parser->nodes;
+    nodes[child].prev = nodes[parent].last;
+    if (nodes[parent].last == RE_NONE)
+    {
+        nodes[parent].first = child;
+    }
+    else
+    {
+        nodes[nodes[parent].last].next = child;
+    }
+    nodes[parent].last = child;
+}
+
+/**
+ * @internal
+ * Parses the escape sequence after a backslash.
+ *
+ * @param [in,out] parser positioned after the backslash
+ * @param [out] set bytes matched by the sequence
+ * @param [out] byte the matched byte for single-byte sequences, -1 for
+ *              classes such as `\d`
+ * @return false on invalid syntax
+ */
+static bool
+re_parse_escape(re_parser_t* const parser, xtr_charset_t* const set, int* const byte)
+{
+    if (parser->pos == parser->end)
+    {
+        return false;
+    }
+    const unsigned int c = (uint8_t) parser->pattern[parser->pos++];
+    memset(set, 0, sizeof(*set));
+    *byte = -1;
+    switch (c)
+    {
+        case 'd':
+        case 'D':
+            re_set_add_range(set, '0', '9');
+            break;
+        case 'w':
+        case 'W':
+            re_set_add_range(set, '0', '9');
+            re_set_add_range(set, 'A', 'Z');
+            re_set_add_range(set, 'a', 'z');
+            re_set_add_range(set, '_', '_');
+            break;
+        case 's':
+        case 'S':
+            re_set_add_range(set, '\t', '\r');
+            re_set_add_range(set, ' ', ' ');
+            break;
+        case 't':
+            *byte = '\t';
+            break;
+        case 'n':
+            *byte = '\n';
+            break;
+        case 'r':
+            *byte = '\r';
+            break;
+        case 'f':
+            *byte = '\f';
+            break;
+        case 'v':
+            *byte = '\v';
+            break;
+        case 'x':
+        {
+            if (parser->end - parser->pos < 2U)
+            {
+                return false;
+            }
+            const unsigned int high = re_hex_digit((uint8_t) parser->pattern[parser->pos]);
+            const unsigned int low = re_hex_digit((uint8_t) parser->pattern[parser->pos + 1U]);
+            if (high > 15U || low > 15U)
+            {
+                return false;
+            }
+            parser->pos += 2U;
+            *byte = (int) (high << 4U | low);
+            break;
+        }
+        default:
+            if (re_is_alnum(c))
+            {
+                return false;  // Unknown escape, reserved
+            }
+            *byte = (int) c;
+            break;
+    }
+    if (c == 'D' || c == 'W' || c == 'S')
+    {
+        re_set_negate(set);
+    }
+    if (*byte >= 0)
+    {
+        re_set_add_range(set, (unsigned int) *byte, (unsigned int) *byte);
+    }
+    return true;
+}
+
+/** @internal Parses a class after its opening `[`. */
+static uint32_t
+re_parse_class(re_parser_t* const parser)
+{
+    xtr_charset_t set;
+    memset(&set, 0, sizeof(set));
+    const bool negated = parser->pos < parser->end && parser->pattern[parser->pos] == '^';
+    parser->pos += negated ? 1U : 0U;
+    for (bool first = true;; first = false)
+    {
+        if (parser->pos == parser->end)
+        {
+            return RE_NONE;  // Unterminated
+        }
+        int low = (uint8_t) parser->pattern[parser->pos++];
+        if (low == ']' && !first)
+        {
+            break;
+        }
+        xtr_charset_t escaped;
+        if (low == '\\')
+        {
+            if (!re_parse_escape(parser, &escaped, &low))
+            {
+                return RE_NONE;
+            }
+            if (low < 0)
+            {
+                for (size_t i = 0U; i < sizeof(set.bitmap); i++)
+                {
+                    set.bitmap[i] |= escaped.bitmap[i];
+                }
+                continue;
+            }
+        }
+        int high = low;
+        if (parser->end - parser->pos >= 2U && parser->pattern[parser->pos] == '-' &&
+            parser->pattern[parser->pos + 1U] != ']')
+        {
+            parser->pos++;
+            high = (uint8_t) parser->pattern[parser->pos++];
+            if (high == '\\' && (!re_parse_escape(parser, &escaped, &high) || high < 0))
+            {
+                return RE_NONE;  // Classes cannot be range ends
+            }
+            if (high < low)
+            {
+                return RE_NONE;
+            }
+        }
+        re_set_add_range(&set, (unsigned int) low, (unsigned int) high);
+    }
+    if (negated)
+    {
+        re_set_negate(&set);
+    }
+    const uint32_t node = re_node(parser, RE_NODE_BYTES);
+    if (node != RE_NONE)
+    {
+        parser->nodes[node].set = set;
+    }
+    return node;
+}
+
+static uint32_t
+re_parse_alternation(re_parser_t* parser);
+
+/** @internal Parses a single byte, class or group. */
+static uint32_t
+re_parse_atom(re_parser_t* const parser)
+{
+    const unsigned int c = (uint8_t) parser->pattern[parser->pos++];
+    xtr_charset_t set;
+    memset(&set, 0, sizeof(set));
+    int byte;
+    switch (c)
+    {
+        case '(':
+        {
+            if (++parser->depth > RE_MAX_DEPTH)
+            {
+                return RE_NONE;
+            }
+            if (parser->end - parser->pos >= 2U && parser->pattern[parser->pos] == '?' &&
+                parser->pattern[parser->pos + 1U] == ':')
+            {
+                parser->pos += 2U;
+            }
+            const uint32_t group = re_parse_alternation(parser);
+            if (group == RE_NONE || parser->pos == parser->end ||
+                parser->pattern[parser->pos] != ')')
+            {
+                return RE_NONE;
+            }
+            parser->pos++;
+            parser->depth--;
+            return group;
+        }
+        case '[':
+            return re_parse_class(parser);
+        case '.':
+            re_set_add_range(&set, 0U, UINT8_MAX);
+            set.bitmap[XTR_CHARSET_ROW('\n')] &= (uint8_t) ~XTR_CHARSET_BIT('\n');
+            break;
+        case '\\':
+            if (!re_parse_escape(parser, &set, &byte))
+            {
+                return RE_NONE;
+            }
+            break;
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case '^':
+        case '$':
+            return RE_NONE;  // Nothing to repeat or anchor not at the edges
+        default:
+            re_set_add_range(&set, c, c);
+            break;
+    }
+    const uint32_t node = re_node(parser, RE_NODE_BYTES);
+    if (node != RE_NONE)
+    {
+        parser->nodes[node].set = set;
+    }
+    return node;
+}
+
+/** @internal Parses a decimal repetition count, false if missing or too large. */
+static bool
+re_parse_count(re_parser_t* const parser, uint32_t* const count)
+{
+    const size_t start = parser->pos;
+    *count = 0U;
+    while (parser->pos < parser->end && parser->pattern[parser->pos] >= '0' &&
+           parser->pattern[parser->pos] <= '9')
+    {
+        if (*count <= RE_MAX_REPEAT)
+        {
+            *count = *count * 10U + (uint32_t) (parser->pattern[parser->pos] - '0');
+        }
+        parser->pos++;
+    }
+    return parser->pos != start && *count <= RE_MAX_REPEAT;
+}
+
+static bool
+re_is_quantifier(const re_parser_t* const parser)
+{
+    if (parser->pos == parser->end)
+    {
+        return false;
+    }
+    const char c = parser->pattern[parser->pos];
+    return c == '*' || c == '+' || c == '?' || c == '{';
+}
+
+/** @internal Parses an atom followed by an optional quantifier. */
+static uint32_t
+re_parse_repetition(re_parser_t* const parser)
+{
+    const uint32_t atom = re_parse_atom(parser);
+    if (atom == RE_NONE || !re_is_quantifier(parser))
+    {
+        return atom;
+    }
+    uint32_t min = 0U;
+    uint32_t max = RE_INFINITE;
+    switch (parser->pattern[parser->pos++])
+    {
+        case '+':
+            min = 1U;
+            break;
+        case '?':
+            max = 1U;
+            break;
+        case '{':
+            if (!re_parse_count(parser, &min) || parser->pos == parser->end)
+            {
+                return RE_NONE;
+            }
+            if (parser->pattern[parser->pos] == ',')
+            {
+                parser->pos++;
+                if (parser->pos < parser->end && parser->pattern[parser->pos] != '}' &&
+                    (!re_parse_count(parser, &max) || max < min))
+                {
+                    return RE_NONE;
+                }
+            }
+            else
+            {
+                max = min;
+            }
+            if (parser->pos == parser->end || parser->pattern[parser->pos] != '}')
+            {
+                return RE_NONE;
+            }
+            parser->pos++;
+            break;
+        default:  // '*'
+            break;
+    }
+    const bool greedy = parser->pos == parser->end || parser->pattern[parser->pos] != '?';
+    parser->pos += greedy ? 0U : 1U;
+    if (re_is_quantifier(parser))
+    {
+        return RE_NONE;  // Nested quantifiers need a group
+    }
+    const uint32_t repeat = re_node(parser, RE_NODE_REPEAT);
+    if (repeat != RE_NONE)
+    {
+        parser->nodes[repeat].first = atom;
+        parser->nodes[repeat].last = atom;
+        parser->nodes[repeat].min = min;
+        parser->nodes[repeat].max = max;
+        parser->nodes[repeat].greedy = greedy;
+    }
+    return repeat;
+}
+
+/** @internal Parses a sequence of repetitions, up to a `|` or `)`. */
+static uint32_t
+re_parse_concatenation(re_parser_t* const parser)
+{
+    const uint32_t concat = re_node(parser, RE_NODE_CONCAT);
+    while (concat != RE_NONE && parser->pos < parser->end && parser->pattern[parser->pos] != '|' &&
+           parser->pattern[parser->pos] != ')')
+    {
+        const uint32_t item = re_parse_repetition(parser);
+        if (item == RE_NONE)
+        {
+            return RE_NONE;
+        }
+        re_append_child(parser, concat, item);
+    }
+    return concat;
+}
+
+/** @internal Parses sequences separated by `|`, up to a `)` or the end. */
+static uint32_t
+re_parse_alternation(re_parser_t* const parser)
+{
+    const uint32_t first = re_parse_concatenation(parser);
+    if (first == RE_NONE || parser->pos == parser->end || parser->pattern[parser->pos] != '|')
+    {
+        return first;
+    }
+    const uint32_t alternate = re_node(parser, RE_NODE_ALTERNATE);
+    if (alternate == RE_NONE)
+    {
+        return RE_NONE;
+    }
+    re_append_child(parser, alternate, first);
+    while (parser->pos < parser->end && parser->pattern[parser->pos] == '|')
+    {
+        parser->pos++;
+        const uint32_t branch = re_parse_concatenation(parser);
+        if (branch == RE_NONE)
+        {
+            return RE_NONE;
+        }
+        re_append_child(parser, alternate, branch);
+    }
+    return alternate;
+}
+
+/**
+ * @internal
+ * Collects the literal bytes every match of the node starts with.
+ *
+ * @return true if the whole node is literal, so the collection may continue
+ *         with the following nodes
+ */
+static bool
+re_literal_prefix(const re_node_t* const nodes,
+                  const uint32_t node,
+                  uint8_t* const prefix,
+                  size_t* const len)
+{
+    uint8_t byte;
+    switch (nodes[node].kind)
+    {
+        case RE_NODE_BYTES:
+            if (*len == XTR_RE_MAX_PREFIX || !re_set_single(&nodes[node].set, &byte))
+            {
+                return false;
+            }
+            prefix[(*len)++] = byte;
+            return true;
+        case RE_NODE_CONCAT:
+            for (uint32_t child = nodes[node].first; child != RE_NONE; child = nodes[child].next)
+            {
+                if (!re_literal_prefix(nodes, child, prefix, len))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case RE_NODE_REPEAT:
+            if (nodes[node].min > 0U)
+            {
+                (void) re_literal_prefix(nodes, nodes[node].first, prefix, len);
+            }
+            return false;
+        case RE_NODE_ALTERNATE:
+        default:
+            return false;
+    }
+}
+
+// ------------------- Compilation ------------------------------------------------
+
+/** @internal State of the program emission from the syntax tree. */
+typedef struct
+{
+    const re_node_t* nodes;
+    xtr_re_inst_t* insts;
+    size_t len;
+    size_t capacity;
+    /** Amount of nodes emitted, also repeatedly. */
+    size_t work;
+    /** Whether concatenations are emitted in reverse order. */
+    bool reversed;
+} re_emitter_t;
+
+/** @internal Appends an instruction, returning its index or #RE_NONE. */
+static uint32_t
+re_emit_inst(re_emitter_t* const emitter,
+             const xtr_re_op_t op,
+             const xtr_charset_t* const set,
+             const uint32_t next,
+             const uint32_t alt)
+{
+    if (emitter->len == emitter->capacity)
+    {
+        if (emitter->capacity >= RE_MAX_INSTS)
+        {
+            return RE_NONE;
+        }
+        const size_t capacity = emitter->capacity == 0U ? 64U : emitter->capacity * 2U;
+        xtr_re_inst_t* const larger =
+            XTR_REALLOC(emitter->insts, capacity * sizeof(xtr_re_inst_t));
+        if (larger == NULL)
+        {
+            return RE_NONE;
+        }
+        emitter->insts = larger;
+        emitter->capacity = capacity;
+    }
+    xtr_re_inst_t* const inst = &emitter->insts[emitter->len];
+    if (set != NULL)
+    {
+        inst->set = *set;
+    }
+    else
+    {
+        memset(&inst->set, 0, sizeof(inst->set));
+    }
+    inst->op = op;
+    inst->next = next;
+    inst->alt = alt;
+    return (uint32_t) emitter->len++;
+}
+
+/**
+ * @internal
+ * Points all instructions in a chain to the end of the program.
+ * The chain is linked through the `next` or `alt` field to be patched.
+ */
+static void
+re_patch(re_emitter_t* const emitter, uint32_t chain, const bool through_alt)
+{
+    while (chain != RE_NONE)
+    {
+        uint32_t* const field =
+            through_alt ? &emitter->insts[chain].alt : &emitter->insts[chain].next;
+        chain = *field;
+        *field = (uint32_t) emitter->len;
+    }
+}
+
+/**
+ * @internal
+ * Emits the instructions of a node, falling through to the instruction
+ * after them (Thompson's construction).
+ */
+static bool
+re_emit(re_emitter_t* const emitter, const uint32_t node)
+{
+    if (++emitter->work > RE_MAX_WORK)
+    {
+        return false;
+    }
+    const re_node_t* const nodes = emitter->nodes;
+    const uint32_t child = nodes[node].first;
+    const bool greedy = nodes[node].greedy;
+    switch (nodes[node].kind)
+    {
+        case RE_NODE_BYTES:
+            return re_emit_inst(emitter, XTR_RE_BYTES, &nodes[node].set,
+                                (uint32_t) emitter->len + 1U, RE_NONE) != RE_NONE;
+        case RE_NODE_CONCAT:
+            for (uint32_t item = emitter->reversed ? nodes[node].last : child; item != RE_NONE;
+                 item = emitter->reversed ? nodes[item].prev : nodes[item].next)
+            {
+                if (!re_emit(emitter, item))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case RE_NODE_ALTERNATE:
+        {
+            uint32_t jumps = RE_NONE;
+            for (uint32_t branch = child; branch != RE_NONE; branch = nodes[branch].next)
+            {
+                const bool last = nodes[branch].next == RE_NONE;
+                const uint32_t split =
+                    last ? RE_NONE
+                         : re_emit_inst(emitter, XTR_RE_SPLIT, NULL, (uint32_t) emitter->len + 1U,
+                                        RE_NONE);
+                if ((!last && split == RE_NONE) || !re_emit(emitter, branch))
+                {
+                    return false;
+                }
+                if (!last)
+                {
+                    jumps = re_emit_inst(emitter, XTR_RE_JUMP, NULL, jumps, RE_NONE);
+                    if (jumps == RE_NONE)
+                    {
+                        return false;
+                    }
+                    emitter->insts[split].alt = (uint32_t) emitter->len;
+                }
+            }
+            re_patch(emitter, jumps, false);
+            return true;
+        }
+        case RE_NODE_REPEAT:
+        default:
+        {
+            uint32_t start = (uint32_t) emitter->len;
+            for (uint32_t i = 0U; i < nodes[node].min; i++)
+            {
+                start = (uint32_t) emitter->len;
+                if (!re_emit(emitter, child))
+                {
+                    return false;
+                }
+            }
+            if (nodes[node].max == RE_INFINITE)
+            {
+                const uint32_t split = (uint32_t) emitter->len;
+                if (nodes[node].min == 0U)
+                {
+                    // Loop entering the child: split, child, jump back
+                    if (re_emit_inst(emitter, XTR_RE_SPLIT, NULL, RE_NONE, RE_NONE) == RE_NONE ||
+                        !re_emit(emitter, child) ||
+                        re_emit_inst(emitter, XTR_RE_JUMP, NULL, split, RE_NONE) == RE_NONE)
+                    {
+                        return false;
+                    }
+                    start = split + 1U;
+                }
+                else if (re_emit_inst(emitter, XTR_RE_SPLIT, NULL, RE_NONE, RE_NONE) == RE_NONE)
+                {
+                    return false;
+                }
+                // Repeating the last copy of the child or leaving the loop
+                const uint32_t leave = nodes[node].min == 0U ? (uint32_t) emitter->len : split + 1U;
+                emitter->insts[split].next = greedy ? start : leave;
+                emitter->insts[split].alt = greedy ? leave : start;
+                return true;
+            }
+            // Optional copies, nested: after skipping one, all the following are skipped
+            uint32_t skips = RE_NONE;
+            for (uint32_t i = nodes[node].min; i < nodes[node].max; i++)
+            {
+                const uint32_t enter = (uint32_t) emitter->len + 1U;
+                skips = re_emit_inst(emitter, XTR_RE_SPLIT, NULL, greedy ? enter : skips,
+                                     greedy ? skips : enter);
+                if (skips == RE_NONE || !re_emit(emitter, child))
+                {
+                    return false;
+                }
+            }
+            re_patch(emitter, skips, greedy);
+            return true;
+        }
+    }
+}
+
+/**
+ * @internal
+ * Groups the byte values treated equally by all instructions of the
+ * program, refining the grouping by each set in turn. The DFA transition
+ * tables have one column per class rather than per byte value.
+ *
+ * @return amount of classes
+ */
+static size_t
+re_byte_classes(uint8_t classes[UINT8_MAX + 1U],
+                uint8_t class_bytes[UINT8_MAX + 1U],
+                const xtr_re_inst_t* const program,
+                const size_t len)
+{
+    memset(classes, 0, UINT8_MAX + 1U);
+    size_t amount = 1U;
+    for (size_t pc = 0U; pc < len; pc++)
+    {
+        if (program[pc].op != XTR_RE_BYTES)
+        {
+            continue;
+        }
+        // New class of each (old class, membership) pair
+        uint16_t refined[2U][UINT8_MAX + 1U];
+        memset(refined, 0xFF, sizeof(refined));
+        amount = 0U;
+        for (unsigned int byte = 0U; byte <= UINT8_MAX; byte++)
+        {
+            const bool member = xtr_charset_contains(&program[pc].set, (uint8_t) byte);
+            uint16_t* const class_id = &refined[member][classes[byte]];
+            if (*class_id == UINT16_MAX)
+            {
+                *class_id = (uint16_t) amount++;
+            }
+            classes[byte] = (uint8_t) *class_id;
+        }
+    }
+    for (unsigned int byte = 0U; byte <= UINT8_MAX; byte++)
+    {
+        class_bytes[classes[byte]] = (uint8_t) byte;
+    }
+    return amount;
+}
+
+// ------------------- Lazy DFA ------------------------------------------------
+
+/** @internal Starts a new visit of the program, with fresh visit marks. */
+static void
+re_next_generation(xtr_regex_t* const regex)
+{
+    if (++regex->generation == 0U)
+    {
+        memset(regex->marks, 0, regex->forward_len * sizeof(uint32_t));
+        regex->generation = 1U;
+    }
+}
+
+/**
+ * @internal
+ * Appends to the instruction list the byte-consuming and matching
+ * instructions reachable from `pc` without consuming bytes, in priority
+ * order (depth-first, preferred branches first), skipping those already
+ * visited in this generation.
+ *
+ * @return new length of the list
+ */
+static size_t
+re_closure(xtr_regex_t* const regex,
+           const xtr_re_inst_t* const program,
+           const uint32_t pc,
+           size_t len)
+{
+    uint32_t* const stack = regex->stack;
+    size_t top = 0U;
+    stack[top++] = pc;
+    while (top > 0U)
+    {
+        const uint32_t current = stack[--top];
+        if (regex->marks[current] == regex->generation)
+        {
+            continue;
+        }
+        regex->marks[current] = regex->generation;
+        switch (program[current].op)
+        {
+            case XTR_RE_SPLIT:
+                stack[top++] = program[current].alt;
+                stack[top++] = program[current].next;
+                break;
+            case XTR_RE_JUMP:
+                stack[top++] = program[current].next;
+                break;
+            case XTR_RE_BYTES:
+            case XTR_RE_MATCH:
+            default:
+                regex->list[len++] = current;
+                break;
+        }
+    }
+    return len;
+}
+
+static int
+re_compare_pc(const void* const a, const void* const b)
+{
+    const uint32_t pc_a = *(const uint32_t*) a;
+    const uint32_t pc_b = *(const uint32_t*) b;
+    return (pc_a > pc_b) - (pc_a < pc_b);
+}
+
+/**
+ * @internal
+ * Brings the instruction list into the canonical form of its DFA state:
+ * for leftmost-first matching the threads after the first matching one are
+ * dropped, as they could only report less preferred matches; otherwise the
+ * order does not matter, so the list is sorted.
+ *
+ * @return new length of the list
+ */
+static size_t
+re_canonical(const xtr_regex_t* const regex, const xtr_re_dfa_t* const dfa, size_t len)
+{
+    if (!dfa->leftmost_first)
+    {
+        qsort(regex->list, len, sizeof(uint32_t), re_compare_pc);
+        return len;
+    }
+    for (size_t i = 0U; i < len; i++)
+    {
+        if (dfa->program[regex->list[i]].op == XTR_RE_MATCH)
+        {
+            return i + 1U;
+        }
+    }
+    return len;
+}
+
+static uint32_t
+re_hash(const uint32_t* const list, const size_t len)
+{
+    uint32_t hash = 2166136261U;  // FNV-1a
+    for (size_t i = 0U; i < len; i++)
+    {
+        hash = (hash ^ list[i]) * 16777619U;
+    }
+    return hash;
+}
+
+/** @internal Empties the cache of states. */
+static void
+re_dfa_flush(xtr_re_dfa_t* const dfa)
+{
+    dfa->states = 0U;
+    dfa->lists_used = 0U;
+    dfa->lists_start[0] = 0U;
+    memset(dfa->table, 0, dfa->table_len * sizeof(uint32_t));
+}
+
+static void
+re_dfa_start(xtr_regex_t* regex, xtr_re_dfa_t* dfa);
+
+/**
+ * @internal
+ * Finds the DFA state of the threads in the instruction list of the regex,
+ * adding it to the cache if new. When the cache is full, it is flushed
+ * first, invalidating all previous states.
+ *
+ * @param [in,out] regex holding the instruction list, canonical
+ * @param [in,out] dfa cache to search the state in
+ * @param [in] len length of the instruction list
+ * @param [out] flushed set to true when the cache was flushed
+ * @return index of the state, #XTR_RE_DEAD for an empty list
+ */
+static uint32_t
+re_dfa_state(xtr_regex_t* const regex,
+             xtr_re_dfa_t* const dfa,
+             const size_t len,
+             bool* const flushed)
+{
+    if (len == 0U)
+    {
+        return XTR_RE_DEAD;
+    }
+    const size_t mask = dfa->table_len - 1U;
+    size_t slot = re_hash(regex->list, len) & mask;
+    for (; dfa->table[slot] != 0U; slot = (slot + 1U) & mask)
+    {
+        const uint32_t state = dfa->table[slot] - 1U;
+        const uint32_t* const list = &dfa->lists[dfa->lists_start[state]];
+        if (dfa->lists_start[state + 1U] - dfa->lists_start[state] == len &&
+            memcmp(list, regex->list, len * sizeof(uint32_t)) == 0)
+        {
+            return state;
+        }
+    }
+    if (dfa->states == dfa->max_states || dfa->lists_capacity - dfa->lists_used < len)
+    {
+        re_dfa_flush(dfa);
+        *flushed = true;
+        slot = re_hash(regex->list, len) & mask;
+    }
+    const uint32_t state = dfa->states++;
+    memcpy(&dfa->lists[dfa->lists_used], regex->list, len * sizeof(uint32_t));
+    dfa->lists_used += len;
+    dfa->lists_start[state + 1U] = (uint32_t) dfa->lists_used;
+    bool matching = false;
+    for (size_t i = 0U; i < len; i++)
+    {
+        matching = matching || dfa->program[regex->list[i]].op == XTR_RE_MATCH;
+    }
+    dfa->matching[state] = matching;
+    memset(&dfa->transitions[state * regex->stride], 0xFF, regex->stride * sizeof(uint32_t));
+    dfa->table[slot] = state + 1U;
+    if (*flushed && state == 0U)
+    {
+        re_dfa_start(regex, dfa);
+    }
+    return state;
+}
+
+/**
+ * @internal
+ * Transition value of a state: its row offset, flagged with
+ * #XTR_RE_SPECIAL if it is matching or the start state of a search
+ * skipping to the literal prefix.
+ */
+static uint32_t
+re_dfa_encode(const xtr_regex_t* const regex, const xtr_re_dfa_t* const dfa, const uint32_t state)
+{
+    if (state == XTR_RE_DEAD)
+    {
+        return XTR_RE_DEAD;
+    }
+    const uint32_t offset = (uint32_t) (state * regex->stride);
+    const bool special =
+        dfa->matching[state] || (dfa->accelerated && offset == dfa->start_offset);
+    return special ? offset | XTR_RE_SPECIAL : offset;
+}
+
+/** @internal Finds or adds the start state, with the threads at the entry. */
+static void
+re_dfa_start(xtr_regex_t* const regex, xtr_re_dfa_t* const dfa)
+{
+    re_next_generation(regex);
+    size_t len = re_closure(regex, dfa->program, dfa->entry, 0U);
+    len = re_canonical(regex, dfa, len);
+    bool flushed = false;
+    const uint32_t state = re_dfa_state(regex, dfa, len, &flushed);
+    dfa->start_offset = (uint32_t) (state * regex->stride);
+    dfa->start = re_dfa_encode(regex, dfa, state);
+}
+
+/**
+ * @internal
+ * Computes the transition of a state for a byte class, caching it.
+ *
+ * @param [in,out] regex compiled regular expression
+ * @param [in,out] dfa automaton of the regex
+ * @param [in] offset row offset of the state, without flags
+ * @param [in] class_id byte class of the transition
+ * @return transition value of the target state, #XTR_RE_DEAD if all threads die
+ */
+static uint32_t
+re_dfa_step(xtr_regex_t* const regex,
+            xtr_re_dfa_t* const dfa,
+            const uint32_t offset,
+            const size_t class_id)
+{
+    const uint32_t state = (uint32_t) (offset / regex->stride);
+    const uint8_t byte = regex->class_bytes[class_id];
+    re_next_generation(regex);
+    size_t len = 0U;
+    for (uint32_t i = dfa->lists_start[state]; i < dfa->lists_start[state + 1U]; i++)
+    {
+        const xtr_re_inst_t* const inst = &dfa->program[dfa->lists[i]];
+        if (inst->op == XTR_RE_BYTES && xtr_charset_contains(&inst->set, byte))
+        {
+            len = re_closure(regex, dfa->program, inst->next, len);
+        }
+    }
+    len = re_canonical(regex, dfa, len);
+    bool flushed = false;
+    const uint32_t target = re_dfa_encode(regex, dfa, re_dfa_state(regex, dfa, len, &flushed));
+    if (!flushed)
+    {
+        dfa->transitions[offset + class_id] = target;
+    }
+    return target;
+}
+
+/**
+ * @internal
+ * Allocates the cache of a DFA within #XTR_REGEX_CACHE_SIZE bytes, large
+ * enough for at least a few states of any size, and adds its start state.
+ */
+static bool
+re_dfa_init(xtr_regex_t* const regex,
+            xtr_re_dfa_t* const dfa,
+            const xtr_re_inst_t* const program,
+            const uint32_t entry,
+            const bool leftmost_first)
+{
+    dfa->program = program;
+    dfa->entry = entry;
+    dfa->leftmost_first = leftmost_first;
+    dfa->accelerated = leftmost_first && regex->prefix_len != 0U;
+    const size_t half = XTR_REGEX_CACHE_SIZE / 2U;
+    // Transitions, start of the list, 2 hash table slots, matching flag
+    const size_t state_size = (regex->stride + 3U) * sizeof(uint32_t) + 1U;
+    // Row offsets must fit below the flag
+    const size_t max_states = XTR_MIN(half / state_size, (XTR_RE_SPECIAL - 1U) / regex->stride);
+    dfa->max_states = (uint32_t) XTR_MAX(max_states, 4U);
+    dfa->lists_capacity = XTR_MAX(half / sizeof(uint32_t), 2U * regex->forward_len);
+    dfa->table_len = 1U;
+    while (dfa->table_len < 2U * dfa->max_states)
+    {
+        dfa->table_len *= 2U;
+    }
+    const size_t words = dfa->max_states * regex->stride + dfa->max_states + 1U +
+                         dfa->lists_capacity + dfa->table_len;
+    dfa->transitions = XTR_MALLOC(words * sizeof(uint32_t) + dfa->max_states);
+    if (dfa->transitions == NULL)
+    {
+        return false;
+    }
+    dfa->lists_start = dfa->transitions + dfa->max_states * regex->stride;
+    dfa->lists = dfa->lists_start + dfa->max_states + 1U;
+    dfa->table = dfa->lists + dfa->lists_capacity;
+    dfa->matching = (uint8_t*) (dfa->table + dfa->table_len);
+    re_dfa_flush(dfa);
+    re_dfa_start(regex, dfa);
+    return true;
+}
+
+// ------------------- Searching ------------------------------------------------
+
+/*
+ * The search loops run a tight inner loop over the transitions to plain
+ * states, one table lookup and one comparison per byte, leaving it only for
+ * flagged, dead or not yet computed transitions.
+ */
+
+/**
+ * @internal
+ * Runs the leftmost-first DFA from an index until all threads die,
+ * skipping to the occurrences of the literal prefix whenever no thread is
+ * in progress.
+ *
+ * @return index after the preferred match starting at the lowest index,
+ *         #XTR_NOT_FOUND if none
+ */
+static size_t
+re_search_end(xtr_regex_t* const regex, const uint8_t* const text, const size_t len, size_t i)
+{
+    xtr_re_dfa_t* const dfa = &regex->search;
+    const uint8_t* const classes = regex->classes;
+    const uint32_t* const transitions = dfa->transitions;
+    uint32_t current = dfa->start;
+    size_t end = XTR_NOT_FOUND;
+    while (true)
+    {
+        if ((current & XTR_RE_SPECIAL) != 0U)
+        {
+            current &= ~XTR_RE_SPECIAL;
+            if (dfa->accelerated && current == dfa->start_offset)
+            {
+                const uint8_t* const found =
+                    xtr_memmem(&text[i], len - i, regex->prefix, regex->prefix_len);
+                if (found == NULL)
+                {
+                    break;
+                }
+                i = (size_t) (found - text);
+            }
+            if (dfa->matching[current / regex->stride])
+            {
+                end = i;
+            }
+        }
+        uint32_t next = 0U;
+        for (; i < len; i++)
+        {
+            next = transitions[current + classes[text[i]]];
+            if (next >= XTR_RE_SPECIAL)
+            {
+                break;
+            }
+            current = next;
+        }
+        if (i == len)
+        {
+            break;
+        }
+        if (next == XTR_RE_UNKNOWN)
+        {
+            next = re_dfa_step(regex, dfa, current, classes[text[i]]);
+        }
+        if (next == XTR_RE_DEAD)
+        {
+            break;
+        }
+        current = next;
+        i++;
+    }
+    return end;
+}
+
+/**
+ * @internal
+ * Runs the reversed program backwards from the end of a match down to an
+ * index, until all threads die.
+ *
+ * @return lowest index where a match ending at `i` starts, not lower than
+ *         `from`, #XTR_NOT_FOUND if none
+ */
+static size_t
+re_search_start(xtr_regex_t* const regex, const uint8_t* const text, size_t i, const size_t from)
+{
+    xtr_re_dfa_t* const dfa = &regex->backward;
+    const uint8_t* const classes = regex->classes;
+    const uint32_t* const transitions = dfa->transitions;
+    uint32_t current = dfa->start;
+    size_t start = XTR_NOT_FOUND;
+    while (true)
+    {
+        if ((current & XTR_RE_SPECIAL) != 0U)
+        {
+            current &= ~XTR_RE_SPECIAL;
+            start = dfa->matching[current / regex->stride] ? i : start;
+        }
+        uint32_t next = 0U;
+        for (; i > from; i--)
+        {
+            next = transitions[current + classes[text[i - 1U]]];
+            if (next >= XTR_RE_SPECIAL)
+            {
+                break;
+            }
+            current = next;
+        }
+        if (i == from)
+        {
+            break;
+        }
+        if (next == XTR_RE_UNKNOWN)
+        {
+            next = re_dfa_step(regex, dfa, current, classes[text[i - 1U]]);
+        }
+        if (next == XTR_RE_DEAD)
+        {
+            break;
+        }
+        current = next;
+        i--;
+    }
+    return start;
+}
+
+/** @internal Checks whether the entire array matches. */
+static bool
+re_full_match(xtr_regex_t* const regex, const uint8_t* const text, const size_t len)
+{
+    xtr_re_dfa_t* const dfa = &regex->full;
+    uint32_t current = dfa->start & ~XTR_RE_SPECIAL;
+    for (size_t i = 0U; i < len; i++)
+    {
+        const size_t class_id = regex->classes[text[i]];
+        uint32_t next = dfa->transitions[current + class_id];
+        if (next == XTR_RE_UNKNOWN)
+        {
+            next = re_dfa_step(regex, dfa, current, class_id);
+        }
+        if (next == XTR_RE_DEAD)
+        {
+            return false;
+        }
+        current = next & ~XTR_RE_SPECIAL;
+    }
+    return dfa->matching[current / regex->stride];
+}
+
+/**
+ * @internal
+ * Searches for the first match starting at or after `from`.
+ *
+ * @param [out] length amount of bytes of the match, 0 if none
+ * @return index of the match, #XTR_NOT_FOUND if none
+ */
+static size_t
+re_find(xtr_regex_t* const regex,
+        const uint8_t* const text,
+        const size_t len,
+        const size_t from,
+        size_t* const length)
+{
+    size_t start = XTR_NOT_FOUND;
+    size_t end = len;
+    if (regex->anchored_start && from != 0U)
+    {
+        // `^` matches only at the start of the haystack
+    }
+    else if (regex->anchored_start && regex->anchored_end)
+    {
+        start = re_full_match(regex, text, len) ? 0U : XTR_NOT_FOUND;
+    }
+    else if (regex->anchored_end)
+    {
+        // All matches end at the end: only the start is unknown
+        start = re_search_start(regex, text, len, from);
+    }
+    else
+    {
+        end = re_search_end(regex, text, len, from);
+        if (end != XTR_NOT_FOUND)
+        {
+            start = regex->anchored_start ? 0U : re_search_start(regex, text, end, from);
+            XTR_ASSERT(start != XTR_NOT_FOUND);
+        }
+    }
+    *length = start == XTR_NOT_FOUND ? 0U : end - start;
+    return start;
+}
+
+// ------------------- API ------------------------------------------------
+
+/** @internal Compiles the parsed syntax tree into the programs and their DFAs. */
+static xtr_regex_t*
+re_compile(const re_node_t* const nodes,
+           const uint32_t root,
+           const bool anchored_start,
+           const bool anchored_end)
+{
+    xtr_regex_t* regex = XTR_CALLOC(1U, sizeof(xtr_regex_t));
+    if (regex == NULL)
+    {
+        return NULL;
+    }
+    regex->anchored_start = anchored_start;
+    regex->anchored_end = anchored_end;
+    re_emitter_t forward = {nodes, NULL, 0U, 0U, 0U, false};
+    re_emitter_t reverse = {nodes, NULL, 0U, 0U, 0U, true};
+    bool ok = re_emit(&forward, root) &&
+              re_emit_inst(&forward, XTR_RE_MATCH, NULL, RE_NONE, RE_NONE) != RE_NONE &&
+              re_emit(&reverse, root) &&
+              re_emit_inst(&reverse, XTR_RE_MATCH, NULL, RE_NONE, RE_NONE) != RE_NONE;
+    // Lazy loop over any byte before the expression, to search at every index
+    const uint32_t loop = (uint32_t) forward.len;
+    xtr_charset_t any;
+    memset(&any, 0xFF, sizeof(any));
+    ok = ok && re_emit_inst(&forward, XTR_RE_SPLIT, NULL, 0U, loop + 1U) != RE_NONE &&
+         re_emit_inst(&forward, XTR_RE_BYTES, &any, loop, RE_NONE) != RE_NONE;
+    regex->forward = forward.insts;
+    regex->reverse = reverse.insts;
+    regex->forward_len = forward.len;
+    if (ok)
+    {
+        regex->stride =
+            re_byte_classes(regex->classes, regex->class_bytes, regex->forward, forward.len);
+        if (!anchored_start)
+        {
+            (void) re_literal_prefix(nodes, root, regex->prefix, &regex->prefix_len);
+        }
+        // Scratch space: stack, visit marks, instruction list
+        regex->stack = XTR_CALLOC(4U * forward.len + 1U, sizeof(uint32_t));
+        ok = regex->stack != NULL;
+    }
+    if (ok)
+    {
+        regex->marks = regex->stack + 2U * forward.len + 1U;
+        regex->list = regex->marks + forward.len;
+        ok = re_dfa_init(regex, &regex->full, regex->forward, 0U, false);
+        ok = ok && (anchored_end || re_dfa_init(regex, &regex->search, regex->forward,
+                                                anchored_start ? 0U : loop, true));
+        ok = ok && (anchored_start ||
+                    re_dfa_init(regex, &regex->backward, regex->reverse, 0U, false));
+    }
+    if (!ok)
+    {
+        xtr_regex_free(&regex);
+    }
+    return regex;
+}
+
+XTR_API xtr_regex_t*
+xtr_regex_new(const char* const pattern)
+{
+    if (pattern == NULL)
+    {
+        return NULL;
+    }
+    re_parser_t parser = {pattern, 0U, strlen(pattern), NULL, 0U, 0U, 0U};
+    const bool anchored_start = parser.end > 0U && pattern[0] == '^';
+    parser.pos = anchored_start ? 1U : 0U;
+    bool anchored_end = false;
+    if (parser.end > parser.pos && pattern[parser.end - 1U] == '$')
+    {
+        // Not anchoring if escaped by an odd amount of backslashes
+        size_t backslashes = 0U;
+        while (parser.end - backslashes - 1U > parser.pos &&
+               pattern[parser.end - backslashes - 2U] == '\\')
+        {
+            backslashes++;
+        }
+        anchored_end = backslashes % 2U == 0U;
+        parser.end -= anchored_end ? 1U : 0U;
+    }
+    const uint32_t root = re_parse_alternation(&parser);
+    xtr_regex_t* regex = NULL;
+    if (root != RE_NONE && parser.pos == parser.end &&
+        !((anchored_start || anchored_end) && parser.nodes[root].kind == RE_NODE_ALTERNATE))
+    {
+        regex = re_compile(parser.nodes, root, anchored_start, anchored_end);
+    }
+    XTR_FREE(parser.nodes);
+    return regex;
+}
+
+XTR_API void
+xtr_regex_free(xtr_regex_t** const pregex)
+{
+    if (pregex != NULL && *pregex != NULL)
+    {
+        xtr_regex_t* const regex = *pregex;
+        XTR_FREE(regex->search.transitions);
+        XTR_FREE(regex->backward.transitions);
+        XTR_FREE(regex->full.transitions);
+        XTR_FREE(regex->stack);
+        XTR_FREE(regex->forward);
+        XTR_FREE(regex->reverse);
+        XTR_FREE(regex);
+        *pregex = NULL;  // Clear outside reference to avoid use-after-free
+    }
+}
+
+XTR_API bool
+xtr_regex_match(const xtr_t* const xtr, xtr_regex_t* const regex)
+{
+    if (xtr == NULL || regex == NULL)
+    {
+        return false;
+    }
+    return re_full_match(regex, xtr->buffer, xtr->used);
+}
+
+XTR_API size_t
+xtr_regex_find_from(const xtr_t* const haystack,
+                    xtr_regex_t* const regex,
+                    const size_t start,
+                    size_t* const length)
+{
+    size_t match_len = 0U;
+    size_t index = XTR_NOT_FOUND;
+    if (haystack != NULL && regex != NULL && start <= haystack->used)
+    {
+        index = re_find(regex, haystack->buffer, haystack->used, start, &match_len);
+    }
+    if (length != NULL)
+    {
+        *length = match_len;
+    }
+    return index;
+}
+
+XTR_API size_t
+xtr_regex_find(const xtr_t* const haystack, xtr_regex_t* const regex, size_t* const length)
+{
+    return xtr_regex_find_from(haystack, regex, 0U, length);
+}
+
+XTR_API xtr_region_t*
+xtr_regex_find_all(size_t* const amount, const xtr_t* const haystack, xtr_regex_t* const regex)
+{
+    if (amount == NULL)
+    {
+        return NULL;
+    }
+    *amount = 0U;
+    if (haystack == NULL || regex == NULL)
+    {
+        return NULL;
+    }
+    size_t capacity = 16U;
+    xtr_region_t* regions = XTR_MALLOC(capacity * sizeof(xtr_region_t));
+    size_t found = 0U;
+    for (size_t from = 0U; regions != NULL && from <= haystack->used;)
+    {
+        size_t length;
+        const size_t index = re_find(regex, haystack->buffer, haystack->used, from, &length);
+        if (index == XTR_NOT_FOUND)
+        {
+            break;
+        }
+        if (found == capacity)
+        {
+            capacity *= 2U;
+            xtr_region_t* const larger =
+                capacity > SIZE_MAX / sizeof(xtr_region_t)
+                    ? NULL
+                    : XTR_REALLOC(regions, capacity * sizeof(xtr_region_t));
+            if (larger == NULL)
+            {
+                XTR_FREE(regions);
+                return NULL;
+            }
+            regions = larger;
+        }
+        regions[found].index = index;
+        regions[found].length = length;
+        found++;
+        // Empty matches would be found again at the same index
+        from = index + length + (length == 0U ? 1U : 0U);
+    }
+    if (regions != NULL)
+    {
+        *amount = found;
+    }
+    return regions;
+}
@@ -58,7 +58,12 @@ xtr_resize(xtr_t* const xtr, const size_t new_capacity)
     {
         return NULL;
     }
-    if (new_capacity < xtr->used)
+    if (new_capacity < xtr->used && xtr_is_shared(xtr))
+    {
+        // Other owners still read the content: shorten a copy instead
+        return xtr_truncated(xtr, new_capacity);
+    }
+    else if (new_capacity < xtr->used)
     {
         // Clear bytes at the end, but keep same allocation buffer
 #if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
@@ -81,6 +86,15 @@ xtr_resize_free(xtr_t** const pxtr, const size_t new_length)
     {
         return NULL;
     }
+    if (*pxtr != NULL && new_length >= (*pxtr)->used && !xtr_is_shared(*pxtr))
+    {
+        xtr_t* const resized = xtr_reallocate(pxtr, new_length);
+        if (resized != NULL)
+        {
+            *pxtr = NULL;  // Consumed, as when copying
+        }
+        return resized;
+    }
     xtr_t* const resized = xtr_resize(*pxtr, new_length);
     if (resized != *pxtr)
     {
@@ -111,11 +125,40 @@ xtr_compress_free(xtr_t** const pxtr)  // TODO rename to compact?
     {
         return NULL;
     }
-    xtr_t* const compressed = xtr_clone(*pxtr);
-    if (compressed == NULL)
+    xtr_t* compressed;
+    if (xtr_is_shared(*pxtr))
     {
-        return NULL;
+        compressed = xtr_from_bytes((*pxtr)->buffer, (*pxtr)->used);
+        if (compressed == NULL)
+        {
+            return NULL;
+        }
+        xtr_free(pxtr);
+        return compressed;
+    }
+    compressed = xtr_reallocate(pxtr, (*pxtr)->used);
+    if (compressed != NULL)
+    {
+        *pxtr = NULL;  // Consumed, as when copying
     }
-    xtr_free(pxtr);
     return compressed;
 }
+
+XTR_API xtr_t*
+xtr_reserve(xtr_t** const pxtr, const size_t additional)
+{
+    if (pxtr == NULL || *pxtr == NULL)
+    {
+        return NULL;
+    }
+    if (xtr_available(*pxtr) >= additional && !xtr_is_shared(*pxtr))
+    {
+        return *pxtr;
+    }
+    const size_t needed = (*pxtr)->used + additional;
+    if (needed < additional)
+    {
+        return NULL;
+    }  // Size overflow
+    return xtr_expand(pxtr, needed);
+}
@@ -51,13 +51,13 @@ xtr_reversed(const xtr_t* const xtr)
     return reversed;
 }
 
-XTR_API void
+XTR_API bool
 xtr_reverse(xtr_t* const xtr)
 {
-    if (xtr == NULL)
+    if (xtr == NULL || xtr_is_shared(xtr))
     {
-        return;
-    }  // TODO errcodes
+        return false;
+    }
     uint8_t temp;
     for (size_t head = 0U, tail = xtr->used - 1U; head < tail; head++, tail--)
     {
@@ -65,4 +65,11 @@ xtr_reverse(xtr_t* const xtr)
         xtr->buffer[head] = xtr->buffer[tail];
         xtr->buffer[tail] = temp;
     }
+    return true;
+}
+
+XTR_API bool
+xtr_reverse_cow(xtr_t** const pxtr)
+{
+    return xtr_unshare(pxtr) != NULL && xtr_reverse(*pxtr);
 }
@@ -0,0 +1,537 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/** @internal Adjacent pieces up to this total length are stored as one leaf. */
+#define ROPE_MERGE_LEN 256U
+/** @internal Spare nodes reserved before an operation, more than any one needs. */
+#define ROPE_RESERVE 8U
+
+static bool
+is_leaf(const xtr_rope_node_t* const node)
+{
+    return node->left == NULL;
+}
+
+/**
+ * @internal
+ * Ensures at least `amount` spare nodes, so the following operation never
+ * fails midway with a half-modified tree.
+ */
+static bool
+rope_reserve(xtr_rope_t* const rope, const size_t amount)
+{
+    while (rope->spares < amount)
+    {
+        xtr_rope_node_t* const node = XTR_MALLOC(sizeof(xtr_rope_node_t));
+        if (node == NULL)
+        {
+            return false;
+        }
+        node->left = rope->spare;
+        rope->spare = node;
+        rope->spares++;
+    }
+    return true;
+}
+
+/** @internal Takes a spare node, one must have been reserved. */
+static xtr_rope_node_t*
+node_take(xtr_rope_t* const rope)
+{
+    xtr_rope_node_t* const node = rope->spare;
+    rope->spare = node->left;
+    rope->spares--;
+    return node;
+}
+
+/** @internal Returns a node no longer in the tree, owning no slice, to the spares. */
+static void
+node_give(xtr_rope_t* const rope, xtr_rope_node_t* const node)
+{
+    if (rope->spares < XTR_ROPE_SPARES_MAX)
+    {
+        node->left = rope->spare;
+        rope->spare = node;
+        rope->spares++;
+    }
+    else
+    {
+        XTR_FREE(node);
+    }
+}
+
+/** @internal Frees a subtree, releasing the slices of its leaves. */
+static void
+nodes_free(xtr_rope_node_t* const node)
+{
+    if (node != NULL)
+    {
+        nodes_free(node->left);
+        nodes_free(node->right);
+        xtr_slice_free(&node->leaf);
+        XTR_FREE(node);
+    }
+}
+
+/** @internal Recomputes length and height of an internal node from its children. */
+static void
+node_update(xtr_rope_node_t* const node)
+{
+    node->length = node->left->length + node->right->length;
+    node->height = 1U + XTR_MAX(node->left->height, node->right->height);
+}
+
+static xtr_rope_node_t*
+rotate_left(xtr_rope_node_t* const node)
+{
+    xtr_rope_node_t* const top = node->right;
+    node->right = top->left;
+    node_update(node);
+    top->left = node;
+    node_update(top);
+    return top;
+}
+
+static xtr_rope_node_t*
+rotate_right(xtr_rope_node_t* const node)
+{
+    xtr_rope_node_t* const top = node->left;
+    node->left = top->right;
+    node_update(node);
+    top->right = node;
+    node_update(top);
+    return top;
+}
+
+/**
+ * @internal
+ * Restores the AVL balance of an internal node whose children differ in
+ * height by at most 2, with a single or double rotation.
+ */
+static xtr_rope_node_t*
+rebalance(xtr_rope_node_t* const node)
+{
+    node_update(node);
+    if (node->left->height > node->right->height + 1U)
+    {
+        if (node->left->right->height > node->left->left->height)
+        {
+            node->left = rotate_left(node->left);
+        }
+        return rotate_right(node);
+    }
+    if (node->right->height > node->left->height + 1U)
+    {
+        if (node->right->left->height > node->right->right->height)
+        {
+            node->right = rotate_right(node->right);
+        }
+        return rotate_left(node);
+    }
+    return node;
+}
+
+/**
+ * @internal
+ * Moves the bytes of leaf `right` to the end of leaf `left`, if short enough.
+ *
+ * Appends in-place when `left` is the only user of its xtring and the slice
+ * ends at its content's end, otherwise copies both into a new xtring.
+ * @return true if merged and `right` returned to the spares, false if the
+ *         leaves are too long or in case of malloc failure.
+ */
+static bool
+leaf_merge(xtr_rope_t* const rope, xtr_rope_node_t* const left, xtr_rope_node_t* const right)
+{
+    const size_t merged_len = left->length + right->length;
+    if (merged_len > ROPE_MERGE_LEN)
+    {
+        return false;
+    }
+    xtr_t* const owner = left->leaf.parent;
+    if (!xtr_is_shared(owner) && owner->capacity - owner->used >= right->length &&
+        left->leaf.view.bytes + left->length == owner->buffer + owner->used)
+    {
+        memcpy(&owner->buffer[owner->used], right->leaf.view.bytes, right->length);
+        set_used_and_terminator(owner, owner->used + right->length);
+        left->leaf.view.length = merged_len;
+    }
+    else
+    {
+        xtr_t* merged = xtr_new(ROPE_MERGE_LEN);
+        if (merged == NULL)
+        {
+            return false;
+        }
+        memcpy(merged->buffer, left->leaf.view.bytes, left->length);
+        memcpy(&merged->buffer[left->length], right->leaf.view.bytes, right->length);
+        set_used_and_terminator(merged, merged_len);
+        xtr_slice_free(&left->leaf);
+        xtr_slice_shared(&left->leaf, merged, 0U, merged_len);
+        xtr_free(&merged);  // The slice is the only owner now
+    }
+    left->length = merged_len;
+    xtr_slice_free(&right->leaf);
+    node_give(rope, right);
+    return true;
+}
+
+/**
+ * @internal
+ * Concatenates two balanced subtrees into one, in O(height difference).
+ *
+ * Descends the taller tree's spine to a subtree of about the height of the
+ * other one, joins them there under a new node and rebalances on the way up.
+ * A short leaf descends down to the adjacent leaf instead, to be merged with it.
+ * Uses at most one spare node.
+ */
+static xtr_rope_node_t*
+rope_join(xtr_rope_t* const rope, xtr_rope_node_t* const left, xtr_rope_node_t* const right)
+{
+    if (left == NULL)
+    {
+        return right;
+    }
+    if (right == NULL)
+    {
+        return left;
+    }
+    if (is_leaf(left) && is_leaf(right) && leaf_merge(rope, left, right))
+    {
+        return left;
+    }
+    if (left->height > right->height + 1U ||
+        (is_leaf(right) && !is_leaf(left) && right->length <= ROPE_MERGE_LEN))
+    {
+        left->right = rope_join(rope, left->right, right);
+        return rebalance(left);
+    }
+    if (right->height > left->height + 1U ||
+        (is_leaf(left) && !is_leaf(right) && left->length <= ROPE_MERGE_LEN))
+    {
+        right->left = rope_join(rope, left, right->left);
+        return rebalance(right);
+    }
+    xtr_rope_node_t* const node = node_take(rope);
+    node->left = left;
+    node->right = right;
+    xtr_slice_sub(&node->leaf, NULL, 0U, 0U);
+    node_update(node);
+    return node;
+}
+
+/**
+ * @internal
+ * Splits a subtree into the bytes before `offset` and the ones from `offset` on.
+ *
+ * A leaf is cut into two slices of the same xtring, without copies.
+ * Every internal node on the path is returned to the spares before the
+ * join that may need one, so the split uses at most one spare node.
+ */
+static void
+rope_split(xtr_rope_t* const rope,
+           xtr_rope_node_t* const node,
+           const size_t offset,
+           xtr_rope_node_t** const left,
+           xtr_rope_node_t** const right)
+{
+    if (node == NULL || offset == 0U)
+    {
+        *left = NULL;
+        *right = node;
+    }
+    else if (offset >= node->length)
+    {
+        *left = node;
+        *right = NULL;
+    }
+    else if (is_leaf(node))
+    {
+        xtr_rope_node_t* const tail = node_take(rope);
+        tail->left = NULL;
+        tail->right = NULL;
+        tail->height = 0U;
+        xtr_slice_sub(&tail->leaf, &node->leaf, offset, SIZE_MAX);
+        tail->length = tail->leaf.view.length;
+        xtr_slice_t head;
+        xtr_slice_sub(&head, &node->leaf, 0U, offset);
+        xtr_slice_free(&node->leaf);
+        node->leaf = head;
+        node->length = offset;
+        *left = node;
+        *right = tail;
+    }
+    else
+    {
+        xtr_rope_node_t* const children_left = node->left;
+        xtr_rope_node_t* const children_right = node->right;
+        xtr_rope_node_t* middle;
+        node_give(rope, node);
+        if (offset <= children_left->length)
+        {
+            rope_split(rope, children_left, offset, left, &middle);
+            *right = rope_join(rope, middle, children_right);
+        }
+        else
+        {
+            rope_split(rope, children_right, offset - children_left->length, &middle, right);
+            *left = rope_join(rope, children_left, middle);
+        }
+    }
+}
+
+XTR_API xtr_rope_t*
+xtr_rope_new(void)
+{
+    xtr_rope_t* const rope = XTR_MALLOC(sizeof(xtr_rope_t));
+    if (rope == NULL)
+    {
+        return NULL;
+    }
+    rope->root = NULL;
+    rope->spare = NULL;
+    rope->spares = 0U;
+    return rope;
+}
+
+XTR_API void
+xtr_rope_free(xtr_rope_t** const prope)
+{
+    if (prope == NULL || *prope == NULL)
+    {
+        return;
+    }
+    nodes_free((*prope)->root);
+    while ((*prope)->spare != NULL)
+    {
+        xtr_rope_node_t* const spare = (*prope)->spare;
+        (*prope)->spare = spare->left;
+        XTR_FREE(spare);
+    }
+    XTR_FREE(*prope);
+    *prope = NULL;
+}
+
+XTR_API size_t
+xtr_rope_length(const xtr_rope_t* const rope)
+{
+    if (rope == NULL || rope->root == NULL)
+    {
+        return 0U;
+    }
+    return rope->root->length;
+}
+
+/**
+ * @internal
+ * Inserts a leaf slicing the whole non-empty `piece`, which gains an owner.
+ * The nodes must be reserved already.
+ */
+static void
+rope_insert_leaf(xtr_rope_t* const rope, const size_t offset, xtr_t* const piece)
+{
+    xtr_rope_node_t* const leaf = node_take(rope);
+    leaf->left = NULL;
+    leaf->right = NULL;
+    leaf->height = 0U;
+    xtr_slice_shared(&leaf->leaf, piece, 0U, SIZE_MAX);
+    leaf->length = piece->used;
+    xtr_rope_node_t* before;
+    xtr_rope_node_t* after;
+    rope_split(rope, rope->root, offset, &before, &after);
+    rope->root = rope_join(rope, rope_join(rope, before, leaf), after);
+}
+
+XTR_API bool
+xtr_rope_insert(xtr_rope_t* const rope, const size_t offset, const xtr_t* const text)
+{
+    if (rope == NULL || text == NULL || offset > xtr_rope_length(rope))
+    {
+        return false;
+    }
+    if (text->used == 0U)
+    {
+        return true;  // Leaves are never empty
+    }
+    if (!rope_reserve(rope, ROPE_RESERVE))
+    {
+        return false;
+    }
+    // Short pieces get room for the following ones to be merged in-place
+    xtr_t* piece = text->used < ROPE_MERGE_LEN
+                       ? xtr_from_bytes_capac(text->buffer, text->used, ROPE_MERGE_LEN)
+                       : xtr_clone(text);
+    if (piece == NULL)
+    {
+        return false;
+    }
+    rope_insert_leaf(rope, offset, piece);
+    xtr_free(&piece);  // The leaf is the only owner now
+    return true;
+}
+
+XTR_API bool
+xtr_rope_insert_shared(xtr_rope_t* const rope, const size_t offset, xtr_t* const text)
+{
+    if (rope == NULL || text == NULL || offset > xtr_rope_length(rope))
+    {
+        return false;
+    }
+    if (text->used == 0U)
+    {
+        return true;  // Leaves are never empty
+    }
+    if (!rope_reserve(rope, ROPE_RESERVE))
+    {
+        return false;
+    }
+    rope_insert_leaf(rope, offset, text);
+    return true;
+}
+
+XTR_API bool
+xtr_rope_delete(xtr_rope_t* const rope, const size_t offset, const size_t len)
+{
+    if (rope == NULL || offset > xtr_rope_length(rope))
+    {
+        return false;
+    }
+    if (!rope_reserve(rope, ROPE_RESERVE))
+    {
+        return false;
+    }
+    xtr_rope_node_t* before;
+    xtr_rope_node_t* rest;
+    xtr_rope_node_t* deleted;
+    xtr_rope_node_t* after;
+    rope_split(rope, rope->root, offset, &before, &rest);
+    rope_split(rope, rest, len, &deleted, &after);
+    nodes_free(deleted);
+    rope->root = rope_join(rope, before, after);
+    return true;
+}
+
+XTR_API bool
+xtr_rope_concat(xtr_rope_t* const rope, xtr_rope_t** const pother)
+{
+    if (rope == NULL || pother == NULL || *pother == NULL || *pother == rope)
+    {
+        return false;
+    }
+    if (!rope_reserve(rope, ROPE_RESERVE))
+    {
+        return false;
+    }
+    rope->root = rope_join(rope, rope->root, (*pother)->root);
+    (*pother)->root = NULL;
+    xtr_rope_free(pother);
+    return true;
+}
+
+XTR_API xtr_rope_t*
+xtr_rope_split(xtr_rope_t* const rope, const size_t offset)
+{
+    if (rope == NULL || offset > xtr_rope_length(rope) || !rope_reserve(rope, ROPE_RESERVE))
+    {
+        return NULL;
+    }
+    xtr_rope_t* const tail = xtr_rope_new();
+    if (tail == NULL)
+    {
+        return NULL;
+    }
+    rope_split(rope, rope->root, offset, &rope->root, &tail->root);
+    return tail;
+}
+
+XTR_API xtr_t*
+xtr_rope_flatten(const xtr_rope_t* const rope)
+{
+    if (rope == NULL)
+    {
+        return NULL;
+    }
+    const size_t len = xtr_rope_length(rope);
+    xtr_t* const flat = xtr_new(len);
+    if (flat == NULL)
+    {
+        return NULL;
+    }
+    xtr_rope_iter_t iter;
+    xtr_view_t piece;
+    size_t offset = 0U;
+    xtr_rope_iter_init(&iter, rope, 0U);
+    while (xtr_rope_next(&iter, &piece))
+    {
+        memcpy(&flat->buffer[offset], piece.bytes, piece.length);
+        offset += piece.length;
+    }
+    set_used_and_terminator(flat, len);
+    return flat;
+}
+
+XTR_API void
+xtr_rope_iter_init(xtr_rope_iter_t* const iter, const xtr_rope_t* const rope, const size_t offset)
+{
+    if (iter != NULL)
+    {
+        iter->rope = rope;
+        iter->offset = offset;
+    }
+}
+
+XTR_API bool
+xtr_rope_next(xtr_rope_iter_t* const iter, xtr_view_t* const piece)
+{
+    if (iter == NULL || piece == NULL || iter->offset >= xtr_rope_length(iter->rope))
+    {
+        return false;
+    }
+    const xtr_rope_node_t* node = iter->rope->root;
+    size_t offset = iter->offset;
+    while (!is_leaf(node))
+    {
+        if (offset < node->left->length)
+        {
+            node = node->left;
+        }
+        else
+        {
+            offset -= node->left->length;
+            node = node->right;
+        }
+    }
+    xtr_view_sub(piece, node->leaf.view, offset, SIZE_MAX);
+    iter->offset += piece->length;
+    return true;
+}
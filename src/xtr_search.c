@@ -35,13 +35,13 @@
 XTR_API size_t
 xtr_find(const xtr_t* const haystack, const xtr_t* const needle)
 {
-    return xtr_find_within(haystack, needle, 0U, haystack->used);
+    return xtr_find_within(haystack, needle, 0U, xtr_length(haystack));
 }
 
 XTR_API size_t
 xtr_find_from(const xtr_t* const haystack, const xtr_t* const needle, const size_t start)
 {
-    return xtr_find_within(haystack, needle, start, haystack->used);
+    return xtr_find_within(haystack, needle, start, xtr_length(haystack));
 }
 
 XTR_API size_t
@@ -50,8 +50,8 @@ xtr_find_within(const xtr_t* const haystack,
                 const size_t start,
                 const size_t end)
 {
-    if (xtr_is_empty(haystack) || xtr_is_empty(needle) || start >= haystack->used ||
-        end >= haystack->used)
+    if (xtr_is_empty(haystack) || xtr_is_empty(needle) || start >= end ||
+        end > haystack->used)
     {
         return XTR_NOT_FOUND;
     }
@@ -64,25 +64,56 @@ xtr_find_within(const xtr_t* const haystack,
     return (size_t) (location - haystack->buffer);
 }
 
+XTR_API size_t
+xtr_rfind(const xtr_t* const haystack, const xtr_t* const needle)
+{
+    return xtr_rfind_within(haystack, needle, 0U, xtr_length(haystack));
+}
+
+XTR_API size_t
+xtr_rfind_within(const xtr_t* const haystack,
+                 const xtr_t* const needle,
+                 const size_t start,
+                 const size_t end)
+{
+    if (xtr_is_empty(haystack) || xtr_is_empty(needle) || start >= end ||
+        end > haystack->used || end - start < needle->used)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const uint8_t* const location =
+        xtr_memrmem(haystack->buffer + start, end - start, needle->buffer, needle->used);
+    if (location == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return (size_t) (location - haystack->buffer);
+}
+
 XTR_API bool
 xtr_contains(const xtr_t* const haystack, const xtr_t* const needle)
 {
-    return xtr_find_within(haystack, needle, 0U, haystack->used) != XTR_NOT_FOUND;
+    return xtr_find_within(haystack, needle, 0U, xtr_length(haystack)) != XTR_NOT_FOUND;
 }
 
 XTR_API size_t
 xtr_occurrences(const xtr_t* const haystack, const xtr_t* const needle)
 {
-    if (xtr_is_empty(haystack) || xtr_is_empty(needle) || needle->used > haystack->used)
+    if (haystack == NULL || xtr_is_empty(needle))
     {
         return XTR_NOT_FOUND;
-    }  // TODO return 0 instead?
+    }
+    // Factorise the needle once, not again for every occurrence
+    xtr_twoway_t twoway;
+    xtr_twoway_prepare(&twoway, needle->buffer, needle->used);
     size_t count = 0U;
-    const uint8_t* occurrence = haystack->buffer;
-    size_t remaining_len = haystack->used - needle->used;
-    while (true)
+    size_t progress = 0U;
+    while (haystack->used - progress >= needle->used)
     {
-        occurrence = xtr_memmem(occurrence, remaining_len, needle->buffer, needle->used);
+        // Non-overlapping occurrences: resume the search after the needle's end
+        const uint8_t* const occurrence =
+            xtr_memmem_prepared(&haystack->buffer[progress], haystack->used - progress,
+                                needle->buffer, needle->used, &twoway);
         if (occurrence == NULL)
         {
             break;
@@ -90,59 +121,122 @@ xtr_occurrences(const xtr_t* const haystack, const xtr_t* const needle)
         XTR_ASSERT(occurrence >= haystack->buffer);
         XTR_ASSERT(occurrence < haystack->buffer + haystack->used);
         count++;
-        remaining_len -= (size_t) (occurrence - haystack->buffer) + needle->used;
-        occurrence += needle->used;
+        progress = (size_t) (occurrence - haystack->buffer) + needle->used;
     }
     return count;
 }
 
-XTR_API const size_t*
-xtr_find_all(const xtr_t* const haystack, const xtr_t* const needle)
+_Static_assert(sizeof(xtr_twoway_t) <= sizeof(((xtr_cursor_t*) NULL)->twoway),
+               "Cursor too small for the Two-Way search state.");
+
+XTR_API void
+xtr_cursor_init(xtr_cursor_t* const cursor, const xtr_t* const haystack, const xtr_t* const needle)
+{
+    if (cursor == NULL)
+    {
+        return;
+    }
+    cursor->haystack = haystack;
+    cursor->needle = needle;
+    cursor->pattern = NULL;
+    cursor->position = 0U;
+    if (haystack == NULL || xtr_is_empty(needle))
+    {
+        cursor->haystack = NULL;  // Yields no occurrences
+        return;
+    }
+    xtr_twoway_t twoway;
+    xtr_twoway_prepare(&twoway, needle->buffer, needle->used);
+    memcpy(cursor->twoway, &twoway, sizeof(twoway));
+}
+
+XTR_API void
+xtr_cursor_init_pattern(xtr_cursor_t* const cursor,
+                        const xtr_t* const haystack,
+                        const xtr_pattern_t* const pattern)
+{
+    if (cursor == NULL)
+    {
+        return;
+    }
+    cursor->haystack = pattern == NULL ? NULL : haystack;
+    cursor->needle = NULL;
+    cursor->pattern = pattern;
+    cursor->position = 0U;
+}
+
+XTR_API size_t
+xtr_find_next(xtr_cursor_t* const cursor)
+{
+    if (cursor == NULL || cursor->haystack == NULL || cursor->position > cursor->haystack->used)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const xtr_t* const haystack = cursor->haystack;
+    const uint8_t* const start = &haystack->buffer[cursor->position];
+    const size_t remaining = haystack->used - cursor->position;
+    const uint8_t* occurrence;
+    size_t needle_len;
+    if (cursor->pattern != NULL)
+    {
+        needle_len = cursor->pattern->len;
+        occurrence = xtr_pattern_search(cursor->pattern, start, remaining);
+    }
+    else
+    {
+        needle_len = cursor->needle->used;
+        xtr_twoway_t twoway;
+        memcpy(&twoway, cursor->twoway, sizeof(twoway));
+        occurrence = remaining < needle_len ? NULL
+                                            : xtr_memmem_prepared(start, remaining,
+                                                                  cursor->needle->buffer,
+                                                                  needle_len, &twoway);
+    }
+    if (occurrence == NULL)
+    {
+        cursor->position = SIZE_MAX;  // Exhausted, also for the next calls
+        return XTR_NOT_FOUND;
+    }
+    const size_t index = (size_t) (occurrence - haystack->buffer);
+    // Non-overlapping occurrences: resume the search after the needle's end
+    cursor->position = index + needle_len;
+    return index;
+}
+
+XTR_API size_t*
+xtr_find_all(size_t* const amount, const xtr_t* const haystack, const xtr_t* const needle)
 {
-    if (haystack == NULL || needle == NULL || haystack->used > needle->used)
+    if (amount == NULL || haystack == NULL || xtr_is_empty(needle))
     {
         return NULL;
     }
-    size_t max_matches =
-        8U;  // 1 for amount of occurrence_indices , then 7 needle occurrence_indices = 8 chunks
-    size_t* occurrence_indices = malloc(max_matches * sizeof(size_t));
-    if (occurrence_indices == NULL)
+    *amount = 0U;
+    size_t capacity = 8U;
+    size_t* indices = XTR_MALLOC(capacity * sizeof(size_t));
+    if (indices == NULL)
     {
         return NULL;
     }
-    // First element in returned array contains amount of elements **after** the first element.
-    occurrence_indices[0] = 0U;
-    const size_t last_useful_index = haystack->used - needle->used + 1U;
-    size_t progress = 0U;
-    size_t match;
-    while (true)
+    xtr_cursor_t cursor;
+    xtr_cursor_init(&cursor, haystack, needle);
+    size_t found = 0U;
+    for (size_t index = xtr_find_next(&cursor); index != XTR_NOT_FOUND;
+         index = xtr_find_next(&cursor))
     {
-        match = xtr_find_within(haystack, needle, progress, last_useful_index);
-        if (match == XTR_NOT_FOUND)
-        {
-            break;
-        }
-        occurrence_indices[occurrence_indices[0]++] = match;
-        progress = match + needle->used;
-        if (occurrence_indices[0] > max_matches)  // Resizing array of results
+        if (found == capacity)
         {
-            max_matches *= 2U;
-            size_t* const larger_needles = realloc(occurrence_indices, max_matches);
-            if (larger_needles == NULL)
+            // Occurrences do not overlap: capacity cannot exceed the haystack length
+            capacity *= 2U;
+            size_t* const larger = XTR_REALLOC(indices, capacity * sizeof(size_t));
+            if (larger == NULL)
             {
-                goto rollback;
+                XTR_FREE(indices);
+                return NULL;
             }
-            memset(occurrence_indices, 0, max_matches * sizeof(size_t));
-            free(occurrence_indices);
-            occurrence_indices = larger_needles;
+            indices = larger;
         }
+        indices[found++] = index;
     }
-    return occurrence_indices;
-rollback:
-{
-    memset(occurrence_indices, 0, max_matches * sizeof(size_t));
-    free(occurrence_indices);
-    occurrence_indices = NULL;
-    return NULL;
-}
+    *amount = found;
+    return indices;
 }
@@ -0,0 +1,186 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+/**
+ * @internal
+ * Stores into `slice` the section `view` of the content of `parent`, taking
+ * a reference to the parent. A NULL slice if the view is NULL.
+ */
+static bool
+slice_of(xtr_slice_t* const slice, xtr_t* const parent, const xtr_view_t view)
+{
+    if (slice == NULL)
+    {
+        return false;
+    }
+    slice->view = view;
+    slice->parent = view.bytes == NULL ? NULL : xtr_share(parent);
+    return slice->parent != NULL;
+}
+
+XTR_API bool
+xtr_slice_shared(xtr_slice_t* const slice, xtr_t* const parent, const size_t start,
+                 const size_t len)
+{
+    xtr_view_t view;
+    xtr_view_range(&view, parent, start, len);
+    return slice_of(slice, parent, view);
+}
+
+XTR_API bool
+xtr_slice_sub(xtr_slice_t* const sub, const xtr_slice_t* const slice, const size_t start,
+              const size_t len)
+{
+    xtr_view_t view;
+    if (slice == NULL)
+    {
+        xtr_view_from_bytes(&view, NULL, 0U);
+        return slice_of(sub, NULL, view);
+    }
+    xtr_view_sub(&view, slice->view, start, len);
+    return slice_of(sub, slice->parent, view);
+}
+
+XTR_API void
+xtr_slice_free(xtr_slice_t* const slice)
+{
+    if (slice != NULL)
+    {
+        xtr_release(&slice->parent);
+        xtr_view_from_bytes(&slice->view, NULL, 0U);
+    }
+}
+
+XTR_API bool
+xtr_slice_pop_head(xtr_slice_t* const popped, xtr_slice_t* const slice, const size_t len)
+{
+    if (!xtr_slice_sub(popped, slice, 0U, len))
+    {
+        return false;
+    }
+    xtr_view_sub(&slice->view, slice->view, popped->view.length, SIZE_MAX);
+    return true;
+}
+
+XTR_API bool
+xtr_slice_pop_tail(xtr_slice_t* const popped, xtr_slice_t* const slice, const size_t len)
+{
+    const size_t kept =
+        slice == NULL ? 0U : slice->view.length - XTR_MIN(len, slice->view.length);
+    if (!xtr_slice_sub(popped, slice, kept, SIZE_MAX))
+    {
+        return false;
+    }
+    slice->view.length = kept;
+    return true;
+}
+
+XTR_API xtr_slice_t*
+xtr_split_slices(size_t* const amount_of_chunks, xtr_t* const xtr, const xtr_t* const separator)
+{
+    if (amount_of_chunks == NULL)
+    {
+        return NULL;
+    }
+    const size_t amount = xtr_split_views_into(NULL, 0U, xtr, separator);
+    if (amount == XTR_NOT_FOUND)
+    {
+        return NULL;
+    }
+    xtr_slice_t* const slices = XTR_MALLOC(amount * sizeof(xtr_slice_t));
+    if (slices == NULL)
+    {
+        return NULL;
+    }
+    // One atomic update for all the slices rather than one each
+    xtr_refs_add(xtr, amount);
+    xtr_split_iter_t iter;
+    xtr_split_iter_init(&iter, xtr, separator);
+    for (size_t i = 0U; xtr_split_next(&iter, &slices[i].view); i++)
+    {
+        slices[i].parent = xtr;
+    }
+    *amount_of_chunks = amount;
+    return slices;
+}
+
+XTR_API void
+xtr_slices_free(xtr_slice_t** const pslices, const size_t amount)
+{
+    if (pslices == NULL || *pslices == NULL)
+    {
+        return;
+    }
+    xtr_slice_t* const slices = *pslices;
+    for (size_t i = 0U; i < amount;)
+    {
+        // Runs of slices of the same parent, as from xtr_split_slices(), are
+        // released with one atomic update, but the last reference
+        size_t run = 1U;
+        while (i + run < amount && slices[i + run].parent == slices[i].parent)
+        {
+            run++;
+        }
+        if (slices[i].parent != NULL && run > 1U)
+        {
+            xtr_refs_add(slices[i].parent, 0U - (run - 1U));
+        }
+        xtr_release(&slices[i].parent);
+        i += run;
+    }
+    XTR_FREE(*pslices);
+    *pslices = NULL;
+}
+
+XTR_API bool
+xtr_slice_compact(xtr_slice_t* const slice)
+{
+    if (slice == NULL || slice->parent == NULL)
+    {
+        return false;
+    }
+    if (slice->view.bytes == slice->parent->buffer &&
+        slice->view.length == xtr_capacity(slice->parent))
+    {
+        return true;
+    }
+    xtr_t* const copy = xtr_from_view(slice->view);
+    if (copy == NULL)
+    {
+        return false;
+    }
+    xtr_release(&slice->parent);
+    slice->parent = copy;
+    xtr_view(&slice->view, copy);
+    return true;
+}
@@ -34,128 +34,317 @@
 XTR_API xtr_t**
 xtr_split(size_t* const amount_of_chunks, const xtr_t* const haystack, const xtr_t* const needle)
 {
-    if (amount_of_chunks == NULL)
-    {
-        return NULL;
-    }
-    const size_t* occurrence_indices = xtr_find_all(haystack, needle);
-    if (occurrence_indices == NULL)
+    if (amount_of_chunks == NULL || haystack == NULL || xtr_is_empty(needle))
     {
         return NULL;
     }
-    size_t chunk_idx = 0U;
-    xtr_t** chunks = calloc((occurrence_indices[0] + 1U), sizeof(size_t));
+    size_t capacity = 8U;
+    size_t amount = 0U;
+    xtr_t** chunks = XTR_MALLOC(capacity * sizeof(xtr_t*));
     if (chunks == NULL)
     {
-        goto rollback;
+        return NULL;
     }
-    if (occurrence_indices[0] == 0U)
+    xtr_cursor_t cursor;
+    xtr_cursor_init(&cursor, haystack, needle);
+    size_t chunk_start = 0U;
+    while (true)
     {
-        chunks[chunk_idx] = xtr_clone(haystack);
-        if (chunks[chunk_idx] == NULL)
+        const size_t occurrence = xtr_find_next(&cursor);
+        // Chunk up to the next separator or, after the last one, to the end
+        const size_t chunk_end = occurrence == XTR_NOT_FOUND ? haystack->used : occurrence;
+        if (amount == capacity)
         {
-            goto rollback;
+            // At most haystack_len + 1 chunks: no overflow
+            capacity *= 2U;
+            xtr_t** const larger = XTR_REALLOC(chunks, capacity * sizeof(xtr_t*));
+            if (larger == NULL)
+            {
+                goto rollback;
+            }
+            chunks = larger;
         }
-        chunk_idx++;
-    }
-    else
-    {
-        // First chunk, from start to first needle occurrence
-        chunks[chunk_idx] = xtr_from_bytes(&haystack->buffer[0], occurrence_indices[1]);
-        if (chunks[chunk_idx] == NULL)
+        chunks[amount] = xtr_from_bytes(&haystack->buffer[chunk_start], chunk_end - chunk_start);
+        if (chunks[amount] == NULL)
         {
             goto rollback;
         }
-        chunk_idx++;
-        // Middle chunks, between occurrence_indices
-        for (size_t i = 1U; i <= occurrence_indices[0] - 1U; i++)
+        amount++;
+        if (occurrence == XTR_NOT_FOUND)
         {
-            const size_t chunk_start = occurrence_indices[i] + needle->used;
-            const size_t chunk_len = occurrence_indices[i + 1U] - chunk_start;
-            chunks[chunk_idx] = xtr_from_bytes(&haystack->buffer[chunk_start], chunk_len);
-            if (chunks[chunk_idx] == NULL)
+            break;
+        }
+        chunk_start = occurrence + needle->used;
+    }
+    *amount_of_chunks = amount;
+    return chunks;
+rollback:
+{
+    while (amount > 0U)
+    {
+        xtr_free(&chunks[--amount]);
+    }
+    XTR_FREE(chunks);
+    return NULL;
+}
+}
+
+XTR_API xtr_t**
+xtr_split_any(size_t* const amount_of_chunks,
+              const xtr_t* const xtr,
+              const xtr_charset_t* const separators)
+{
+    if (amount_of_chunks == NULL || xtr == NULL || separators == NULL)
+    {
+        return NULL;
+    }
+    size_t capacity = 8U;
+    size_t amount = 0U;
+    xtr_t** chunks = XTR_MALLOC(capacity * sizeof(xtr_t*));
+    if (chunks == NULL)
+    {
+        return NULL;
+    }
+    size_t chunk_start = 0U;
+    while (true)
+    {
+        // Chunk up to the next separator or, after the last one, to the end
+        const size_t chunk_len = xtr_charset_scan(separators, &xtr->buffer[chunk_start],
+                                                  xtr->used - chunk_start, true);
+        if (amount == capacity)
+        {
+            // At most xtr_len + 1 chunks: no overflow
+            capacity *= 2U;
+            xtr_t** const larger = XTR_REALLOC(chunks, capacity * sizeof(xtr_t*));
+            if (larger == NULL)
             {
                 goto rollback;
             }
-            chunk_idx++;
+            chunks = larger;
         }
-        // Last chunk, from last match to end
-        const size_t chunk_start = occurrence_indices[occurrence_indices[0]] + needle->used;
-        const size_t chunk_len = haystack->used - chunk_start;
-        chunks[chunk_idx] = xtr_from_bytes(&haystack->buffer[chunk_start], chunk_len);
-        if (chunks[chunk_idx] == NULL)
+        chunks[amount] = xtr_from_bytes(&xtr->buffer[chunk_start], chunk_len);
+        if (chunks[amount] == NULL)
         {
             goto rollback;
         }
-        chunk_idx++;
+        amount++;
+        chunk_start += chunk_len;
+        if (chunk_start == xtr->used)
+        {
+            break;
+        }
+        chunk_start++;  // Skip the separator
     }
-    free((void*) (uint64_t) occurrence_indices);
-    occurrence_indices = NULL;
-    *amount_of_chunks = chunk_idx;
+    *amount_of_chunks = amount;
     return chunks;
 rollback:
 {
-    free((void*) (uint64_t) occurrence_indices);
-    occurrence_indices = NULL;
-    if (chunks != NULL)
+    while (amount > 0U)
     {
-        while (chunk_idx)
-        {
-            xtr_free(&chunks[chunk_idx--]);
-        }
-        free(chunks);
-        chunks = NULL;
+        xtr_free(&chunks[--amount]);
     }
+    XTR_FREE(chunks);
     return NULL;
 }
 }
 
 XTR_API xtr_t**
-xtr_split_every(size_t* const parts, const xtr_t* const xtr, const size_t chunk_len)
+xtr_split_every(size_t* const amount_of_chunks, const xtr_t* const xtr, const size_t chunk_len)
 {
     if (xtr_is_empty(xtr) || chunk_len == 0U)
     {
         return NULL;
     }
-    const size_t amount_of_chunks = (xtr->used + chunk_len - 1U) / chunk_len;
-    if (amount_of_chunks * chunk_len < xtr->used)
-    {
-        return NULL;
-    }  // Size overflow
-    xtr_t** const chunks = malloc(amount_of_chunks * sizeof(xtr_t*));
+    const size_t amount = xtr->used / chunk_len + (xtr->used % chunk_len != 0U);
+    xtr_t** const chunks = XTR_MALLOC(amount * sizeof(xtr_t*));
     if (chunks == NULL)
     {
         return NULL;
     }
-    xtr_t* chunk;
-    size_t chunk_idx;
-    for (chunk_idx = 0U; chunk_idx < amount_of_chunks - 1U; chunk_idx++)
+    xtr_split_iter_t iter;
+    xtr_split_iter_init_every(&iter, xtr, chunk_len);
+    xtr_view_t chunk;
+    for (size_t i = 0U; xtr_split_next(&iter, &chunk); i++)
     {
-        chunk = xtr_from_bytes(&xtr->buffer[chunk_idx * chunk_len], chunk_len);
-        if (chunk == NULL)
+        chunks[i] = xtr_from_view(chunk);
+        if (chunks[i] == NULL)
         {
-            goto rollback;
+            while (i > 0U)
+            {
+                xtr_free(&chunks[--i]);
+            }
+            XTR_FREE(chunks);
+            return NULL;
         }
     }
-    // Last chunk, may be shorter
-    const size_t remaining_len = XTR_MIN(chunk_len, xtr->used - chunk_idx * chunk_len);
-    chunk = xtr_from_bytes(&xtr->buffer[xtr->used - chunk_len], remaining_len);
-    if (chunk == NULL)
+    if (amount_of_chunks != NULL)
     {
-        goto rollback;
+        *amount_of_chunks = amount;
     }
-    if (parts != NULL)
+    return chunks;
+}
+
+XTR_API void
+xtr_split_iter_init(xtr_split_iter_t* const iter,
+                    const xtr_t* const xtr,
+                    const xtr_t* const separator)
+{
+    if (iter == NULL)
     {
-        *parts = amount_of_chunks;
+        return;
     }
-    return chunks;
-rollback:
+    xtr_cursor_init(&iter->cursor, xtr, separator);
+    iter->xtr = xtr;
+    iter->chunk_len = 0U;
+    iter->chunk_start = xtr == NULL || xtr_is_empty(separator) ? SIZE_MAX : 0U;
+}
+
+XTR_API void
+xtr_split_iter_init_every(xtr_split_iter_t* const iter,
+                          const xtr_t* const xtr,
+                          const size_t chunk_len)
 {
-    while (chunk_idx)
+    if (iter == NULL)
     {
-        xtr_free(&chunks[chunk_idx--]);
+        return;
     }
-    free(chunks);
-    return NULL;
+    xtr_cursor_init(&iter->cursor, NULL, NULL);
+    iter->xtr = xtr;
+    iter->chunk_len = chunk_len;
+    iter->chunk_start = xtr_is_empty(xtr) || chunk_len == 0U ? SIZE_MAX : 0U;
 }
+
+XTR_API bool
+xtr_split_next(xtr_split_iter_t* const iter, xtr_view_t* const chunk)
+{
+    if (iter == NULL || chunk == NULL || iter->chunk_start == SIZE_MAX)
+    {
+        return false;
+    }
+    const size_t start = iter->chunk_start;
+    size_t end;
+    if (iter->chunk_len != 0U)
+    {
+        end = start + XTR_MIN(iter->chunk_len, iter->xtr->used - start);
+        iter->chunk_start = end == iter->xtr->used ? SIZE_MAX : end;
+    }
+    else
+    {
+        // Chunk up to the next separator or, after the last one, to the end
+        const size_t occurrence = xtr_find_next(&iter->cursor);
+        end = occurrence == XTR_NOT_FOUND ? iter->xtr->used : occurrence;
+        iter->chunk_start =
+            occurrence == XTR_NOT_FOUND ? SIZE_MAX : occurrence + iter->cursor.needle->used;
+    }
+    xtr_view_range(chunk, iter->xtr, start, end - start);
+    return true;
+}
+
+XTR_API size_t
+xtr_split_views_into(xtr_view_t* const chunks,
+                     const size_t max_chunks,
+                     const xtr_t* const xtr,
+                     const xtr_t* const separator)
+{
+    if ((chunks == NULL && max_chunks > 0U) || xtr == NULL || xtr_is_empty(separator))
+    {
+        return XTR_NOT_FOUND;
+    }
+    xtr_split_iter_t iter;
+    xtr_split_iter_init(&iter, xtr, separator);
+    size_t amount = 0U;
+    xtr_view_t chunk;
+    while (xtr_split_next(&iter, &chunk))
+    {
+        if (amount < max_chunks)
+        {
+            chunks[amount] = chunk;
+        }
+        amount++;
+    }
+    return amount;
+}
+
+XTR_API xtr_view_t*
+xtr_split_views(size_t* const amount_of_chunks,
+                const xtr_t* const xtr,
+                const xtr_t* const separator)
+{
+    if (amount_of_chunks == NULL)
+    {
+        return NULL;
+    }
+    // Counting first costs a search, much cheaper than growing the array
+    const size_t amount = xtr_split_views_into(NULL, 0U, xtr, separator);
+    if (amount == XTR_NOT_FOUND)
+    {
+        return NULL;
+    }
+    xtr_view_t* const chunks = XTR_MALLOC(amount * sizeof(xtr_view_t));
+    if (chunks == NULL)
+    {
+        return NULL;
+    }
+    xtr_split_views_into(chunks, amount, xtr, separator);
+    *amount_of_chunks = amount;
+    return chunks;
+}
+
+/** @internal Size rounded up to keep what follows it aligned as an xtring. */
+static size_t
+split_packed_aligned(const size_t size)
+{
+    return (size + sizeof(size_t) - 1U) / sizeof(size_t) * sizeof(size_t);
+}
+
+XTR_API xtr_t**
+xtr_split_packed(size_t* const amount_of_chunks,
+                 const xtr_t* const xtr,
+                 const xtr_t* const separator)
+{
+    if (amount_of_chunks == NULL)
+    {
+        return NULL;
+    }
+    const size_t amount = xtr_split_views_into(NULL, 0U, xtr, separator);
+    if (amount == XTR_NOT_FOUND)
+    {
+        return NULL;
+    }
+    // Pointer table, then the chunks: each at most with the padded header
+    // and terminator of an empty xtring, padding and its share of the bytes
+    const size_t per_chunk = split_packed_aligned(sizeof_struct_xtr(0U)) + sizeof(size_t);
+    if (amount > (SIZE_MAX - xtr->used - sizeof(size_t)) / (sizeof(xtr_t*) + per_chunk))
+    {
+        return NULL;
+    }  // Size overflow
+    const size_t table_size = split_packed_aligned(amount * sizeof(xtr_t*));
+    const size_t size = table_size + amount * per_chunk + xtr->used;
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+    uint8_t* const block = XTR_CALLOC(size, 1U);
+#else
+    uint8_t* const block = XTR_MALLOC(size);
+#endif
+    if (block == NULL)
+    {
+        return NULL;
+    }
+    xtr_t** const chunks = (xtr_t**) (void*) block;
+    size_t offset = table_size;
+    xtr_split_iter_t iter;
+    xtr_split_iter_init(&iter, xtr, separator);
+    xtr_view_t view;
+    for (size_t i = 0U; xtr_split_next(&iter, &view); i++)
+    {
+        xtr_t* const chunk = (xtr_t*) (void*) &block[offset];
+        chunk->refs = 1U;
+        chunk->buffer = chunk->storage;
+        set_capacity_and_terminator(chunk, view.length);
+        memcpy(chunk->buffer, view.bytes, view.length);
+        set_used_and_terminator(chunk, view.length);
+        chunks[i] = chunk;
+        offset += split_packed_aligned(sizeof_struct_xtr(view.length));
+    }
+    *amount_of_chunks = amount;
+    return chunks;
 }
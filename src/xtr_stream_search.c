@@ -0,0 +1,178 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtr.h"
+#include "xtr_internal.h"
+
+XTR_API xtr_stream_search_t*
+xtr_stream_search_new(const xtr_pattern_t* const pattern)
+{
+    if (pattern == NULL)
+    {
+        return NULL;
+    }
+    // Room for the carry-over and as many bytes of the next chunk
+    const size_t window_capacity = XTR_MAX(2U * (pattern->len - 1U), 1U);
+    if (window_capacity > SIZE_MAX - sizeof(xtr_stream_search_t))
+    {
+        return NULL;  // Integer overflow
+    }
+    xtr_stream_search_t* const search =
+        XTR_MALLOC(sizeof(xtr_stream_search_t) + window_capacity);
+    if (search == NULL)
+    {
+        return NULL;
+    }
+    search->pattern = pattern;
+    search->window = (uint8_t*) (search + 1);
+    xtr_stream_search_reset(search);
+    return search;
+}
+
+XTR_API void
+xtr_stream_search_free(xtr_stream_search_t** const psearch)
+{
+    if (psearch != NULL && *psearch != NULL)
+    {
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+        zero_out((*psearch)->window, (*psearch)->window_len);
+#endif
+        XTR_FREE(*psearch);
+        *psearch = NULL;  // Clear outside reference to avoid use-after-free
+    }
+}
+
+XTR_API void
+xtr_stream_search_reset(xtr_stream_search_t* const search)
+{
+    if (search != NULL)
+    {
+        search->chunk = NULL;
+        search->chunk_offset = 0U;
+        search->resume = 0U;
+        search->carry_len = 0U;
+        search->window_len = 0U;
+    }
+}
+
+/**
+ * @internal
+ * Marks the current chunk as completely searched, keeping as carry-over
+ * only its last bytes where an occurrence could still start, at most
+ * `needle_len - 1`, together with the ones still carried over from the
+ * previous chunks if the current chunk is shorter than that.
+ */
+static void
+finish_chunk(xtr_stream_search_t* const search)
+{
+    const size_t chunk_len = search->chunk->used;
+    const size_t stream_len = search->chunk_offset + chunk_len;
+    const size_t keep_from =
+        XTR_MAX(search->resume, stream_len - XTR_MIN(stream_len, search->pattern->len - 1U));
+    const size_t carry_len = stream_len - keep_from;
+    if (carry_len <= chunk_len)
+    {
+        memcpy(search->window, &search->chunk->buffer[chunk_len - carry_len], carry_len);
+    }
+    else
+    {
+        // Chunk shorter than the carry-over: the whole chunk is in the window,
+        // right after the previous carry-over
+        const size_t window_start = search->chunk_offset - search->carry_len;
+        memmove(search->window, &search->window[keep_from - window_start], carry_len);
+    }
+    search->chunk = NULL;
+    search->chunk_offset = stream_len;
+    search->resume = keep_from;
+    search->carry_len = carry_len;
+    search->window_len = carry_len;
+}
+
+XTR_API void
+xtr_stream_search_feed(xtr_stream_search_t* const search, const xtr_t* const chunk)
+{
+    if (search == NULL || chunk == NULL)
+    {
+        return;
+    }
+    if (search->chunk != NULL)
+    {
+        finish_chunk(search);
+    }
+    search->chunk = chunk;
+    // Append the start of the chunk to the carry-over, to find the
+    // occurrences straddling the two without copying the entire chunk
+    const size_t stitched = XTR_MIN(search->pattern->len - 1U, chunk->used);
+    memcpy(&search->window[search->carry_len], chunk->buffer, stitched);
+    search->window_len = search->carry_len + stitched;
+}
+
+XTR_API size_t
+xtr_stream_search_next(xtr_stream_search_t* const search)
+{
+    if (search == NULL || search->chunk == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const size_t needle_len = search->pattern->len;
+    if (search->resume < search->chunk_offset)
+    {
+        // Occurrences starting in the carry-over, ending in the chunk
+        const size_t window_start = search->chunk_offset - search->carry_len;
+        const size_t from = search->resume - window_start;
+        const uint8_t* const occurrence = xtr_pattern_search(
+            search->pattern, &search->window[from], search->window_len - from);
+        if (occurrence != NULL && occurrence < &search->window[search->carry_len])
+        {
+            const size_t position = window_start + (size_t) (occurrence - search->window);
+            search->resume = position + needle_len;
+            return position;
+        }
+        // Skip the positions ruled out by the window. When the chunk is
+        // shorter than the carry-over, the last ones may still match later.
+        const size_t window_end = window_start + search->window_len;
+        search->resume = XTR_MAX(search->resume, window_end - XTR_MIN(search->window_len,
+                                                                      needle_len - 1U));
+    }
+    // Occurrences entirely in the chunk
+    const size_t from = XTR_MAX(search->resume, search->chunk_offset) - search->chunk_offset;
+    const uint8_t* const occurrence = xtr_pattern_search(
+        search->pattern, &search->chunk->buffer[from], search->chunk->used - from);
+    if (occurrence == NULL)
+    {
+        finish_chunk(search);
+        return XTR_NOT_FOUND;
+    }
+    const size_t position = search->chunk_offset + (size_t) (occurrence - search->chunk->buffer);
+    search->resume = position + needle_len;
+    return position;
+}
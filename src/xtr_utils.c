@@ -58,10 +58,13 @@ set_capacity_and_terminator(xtr_t* xtr, size_t capacity)
     xtr->buffer[xtr->capacity] = TERMINATOR;
 }
 
+_Static_assert(offsetof(struct xtr, storage) == XTR_HEADER_SIZE,
+               "XTR_HEADER_SIZE does not match the xtr_t layout.");
+
 XTR_INLINE size_t
 sizeof_struct_xtr(size_t capacity)
 {
-    const size_t size = sizeof(size_t) * 2U + capacity + TERMINATOR_LEN;
+    const size_t size = offsetof(struct xtr, storage) + capacity + TERMINATOR_LEN;
     if (size <= capacity)
     {
         return SIZE_OVERFLOW;
@@ -97,7 +100,7 @@ memmove_zero_out(void* const dst, void* const src, const size_t len)
         //    000000000
         memmove(d, s, len);
         // Can cast signed ptrdiff to unsigned size_t because s < d
-        zero_out(d, (size_t) (d - s));
+        zero_out(s, (size_t) (d - s));
     }
     else if (d < s && s < d + len)
     {
@@ -121,68 +124,49 @@ memmove_zero_out(void* const dst, void* const src, const size_t len)
     }
 }
 
-const void*
-xtr_memmem(const void* haystack_vp,
-           const size_t haystack_len,
-           const void* const needle_vp,
-           const size_t needle_len)
+void
+xtr_drop_head_room(xtr_t* const xtr)
 {
-    // TODO consider boyer-moore search
-    if (haystack_vp == NULL || needle_vp == NULL || haystack_len == 0U || needle_len == 0U ||
-        haystack_len < needle_len)
+    const size_t head_room = xtr_head_room(xtr);
+    if (head_room == 0U)
     {
-        return NULL;
+        return;
     }
-    if (haystack_vp == needle_vp)
+    memmove_zero_out(xtr->storage, xtr->buffer, xtr->used);
+    xtr->buffer = xtr->storage;
+    set_capacity_and_terminator(xtr, xtr->capacity + head_room);
+    set_used_and_terminator(xtr, xtr->used);
+}
+
+xtr_t*
+xtr_reallocate(xtr_t** const pxtr, const size_t capacity)
+{
+    const size_t to_allocate = sizeof_struct_xtr(capacity);
+    if (to_allocate == SIZE_OVERFLOW || capacity < (*pxtr)->used)
     {
-        return haystack_vp;
+        return NULL;
     }
-    const uint8_t* haystack = (const uint8_t*) haystack_vp;
-    // haystack_end = last possible address where the needle could still be.
-    // If not found until this point, the rest of the haystack is too short to fit a needle.
-    const uint8_t* const haystack_end = haystack + haystack_len - needle_len;
-    const uint8_t* haystack_search = haystack;
-    const uint8_t* const needle = (const uint8_t*) needle_vp;
-    const uint8_t* const needle_end = needle + haystack_len;
-    const uint8_t* needle_search = needle;
-    if (needle_len == 1U)
+#if (defined(XTR_CLEAR_HEAP) && XTR_CLEAR_HEAP)
+    // The allocator may move the block without clearing the old one:
+    // copy to a new allocation and wipe the old one when freeing it instead
+    xtr_t* const new = xtr_alloc((*pxtr)->used, capacity);
+    if (new == NULL)
     {
-        return memchr(haystack, needle[0], haystack_len);
+        return NULL;
     }
-    while (true)
+    memcpy(new->buffer, (*pxtr)->buffer, (*pxtr)->used);
+    set_used_and_terminator(new, (*pxtr)->used);
+    xtr_free(pxtr);
+#else
+    xtr_drop_head_room(*pxtr);
+    xtr_t* const new = XTR_REALLOC(*pxtr, to_allocate);
+    if (new == NULL)
     {
-        haystack_search =
-            memchr(haystack_search, needle[0], (size_t) (haystack_end - haystack_search));
-        if (haystack_search == NULL)
-        {
-            return NULL;
-        }
-        // First byte is matching
-        haystack_search++;
-        needle_search = &needle[1];
-        // Match the rest of the needle body against the haystack
-        while (haystack_search < haystack_end)
-        {
-            if (*haystack_search == *needle_search)
-            {
-                // Another byte matching
-                haystack_search++;
-                needle_search++;
-                if (needle_search == needle_end)
-                {
-                    // Full match found
-                    return haystack_search - needle_len;
-                }
-            }
-            else
-            {
-                // Mismatch. Resume haystack seach for first needle byte
-                // starting from where the needle-body matching stopped.
-                break;
-            }
-        }
+        return NULL;
     }
-    // TODO if the search reaches index haystack->used-needle->used+1U, then the rest does not
-    //  contain a needle anyhow
-    return NULL;
+    new->buffer = new->storage;  // Points into the old block if moved
+    set_capacity_and_terminator(new, capacity);
+#endif
+    *pxtr = new;
+    return new;
 }
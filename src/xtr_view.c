@@ -0,0 +1,269 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtr_internal.h"
+
+XTR_API bool
+xtr_view(xtr_view_t* const view, const xtr_t* const xtr)
+{
+    return xtr_view_range(view, xtr, 0U, xtr_length(xtr));
+}
+
+XTR_API bool
+xtr_view_range(xtr_view_t* const view, const xtr_t* const xtr, const size_t start,
+               const size_t len)
+{
+    if (xtr == NULL)
+    {
+        return xtr_view_from_bytes(view, NULL, 0U);
+    }
+    xtr_view_t whole;
+    xtr_view_from_bytes(&whole, xtr->buffer, xtr->used);
+    return xtr_view_sub(view, whole, start, len);
+}
+
+XTR_API bool
+xtr_view_from_bytes(xtr_view_t* const view, const uint8_t* const bytes, const size_t len)
+{
+    if (view == NULL)
+    {
+        return false;
+    }
+    view->bytes = bytes;
+    view->length = bytes == NULL ? 0U : len;
+    return bytes != NULL;
+}
+
+XTR_API bool
+xtr_view_from_str(xtr_view_t* const view, const char* const str)
+{
+    return xtr_view_from_bytes(view, (const uint8_t*) str, str == NULL ? 0U : strlen(str));
+}
+
+XTR_API bool
+xtr_view_sub(xtr_view_t* const sub, const xtr_view_t view, const size_t start, const size_t len)
+{
+    if (view.bytes == NULL || start > view.length)
+    {
+        return xtr_view_from_bytes(sub, NULL, 0U);
+    }
+    return xtr_view_from_bytes(sub, &view.bytes[start], XTR_MIN(len, view.length - start));
+}
+
+XTR_API xtr_t*
+xtr_from_view(const xtr_view_t view)
+{
+    if (view.bytes == NULL)
+    {
+        return NULL;
+    }
+    return xtr_from_bytes(view.bytes, view.length);
+}
+
+XTR_API bool
+xtr_view_is_empty(const xtr_view_t view)
+{
+    return view.length == 0U;
+}
+
+/** @internal True if every byte of a non-empty view satisfies the `<ctype.h>` classifier. */
+static bool
+view_all(const xtr_view_t view, int (*const is_class)(int))
+{
+    if (view.length == 0U)
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < view.length; i++)
+    {
+        if (!is_class(view.bytes[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+XTR_API bool
+xtr_view_is_zeros(const xtr_view_t view)
+{
+    if (view.length == 0U)
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < view.length; i++)
+    {
+        if (view.bytes[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+XTR_API bool
+xtr_view_is_spaces(const xtr_view_t view)
+{
+    return view_all(view, isspace);
+}
+
+XTR_API bool
+xtr_view_is_alpha(const xtr_view_t view)
+{
+    return view_all(view, isalpha);
+}
+
+XTR_API bool
+xtr_view_is_alphanum(const xtr_view_t view)
+{
+    return view_all(view, isalnum);
+}
+
+XTR_API bool
+xtr_view_is_digits(const xtr_view_t view)
+{
+    return view_all(view, isdigit);
+}
+
+XTR_API bool
+xtr_view_is_upper(const xtr_view_t view)
+{
+    return view_all(view, isupper);
+}
+
+XTR_API bool
+xtr_view_is_lower(const xtr_view_t view)
+{
+    return view_all(view, islower);
+}
+
+XTR_API bool
+xtr_view_is_printable(const xtr_view_t view)
+{
+    return view_all(view, isprint);
+}
+
+XTR_API int
+xtr_view_cmp(const xtr_view_t a, const xtr_view_t b)
+{
+    if (a.bytes == b.bytes && a.length == b.length)
+    {
+        return 0;
+    }
+    if (a.bytes == NULL)
+    {
+        return -1;
+    }
+    if (b.bytes == NULL)
+    {
+        return +1;
+    }
+    const int comparison = memcmp(a.bytes, b.bytes, XTR_MIN(a.length, b.length));
+    if (comparison != 0)
+    {
+        return comparison * 3;
+    }
+    if (a.length < b.length)
+    {
+        return -2;
+    }
+    else if (a.length > b.length)
+    {
+        return +2;
+    }
+    return 0;
+}
+
+XTR_API bool
+xtr_view_is_equal(const xtr_view_t a, const xtr_view_t b)
+{
+    if (a.bytes == NULL || b.bytes == NULL)
+    {
+        return a.bytes == b.bytes;
+    }
+    return a.length == b.length && memcmp(a.bytes, b.bytes, a.length) == 0;
+}
+
+XTR_API bool
+xtr_view_startswith(const xtr_view_t view, const xtr_view_t prefix)
+{
+    if (view.bytes == NULL || prefix.bytes == NULL)
+    {
+        return view.bytes == prefix.bytes;
+    }
+    return view.length >= prefix.length && memcmp(view.bytes, prefix.bytes, prefix.length) == 0;
+}
+
+XTR_API bool
+xtr_view_endswith(const xtr_view_t view, const xtr_view_t suffix)
+{
+    if (view.bytes == NULL || suffix.bytes == NULL)
+    {
+        return view.bytes == suffix.bytes;
+    }
+    return view.length >= suffix.length &&
+           memcmp(&view.bytes[view.length - suffix.length], suffix.bytes, suffix.length) == 0;
+}
+
+XTR_API size_t
+xtr_view_find(const xtr_view_t haystack, const xtr_view_t needle)
+{
+    const uint8_t* const location =
+        xtr_memmem(haystack.bytes, haystack.length, needle.bytes, needle.length);
+    if (location == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return (size_t) (location - haystack.bytes);
+}
+
+XTR_API size_t
+xtr_view_rfind(const xtr_view_t haystack, const xtr_view_t needle)
+{
+    if (haystack.bytes == NULL || needle.bytes == NULL || needle.length == 0U ||
+        haystack.length < needle.length)
+    {
+        return XTR_NOT_FOUND;
+    }
+    const uint8_t* const location =
+        xtr_memrmem(haystack.bytes, haystack.length, needle.bytes, needle.length);
+    if (location == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    return (size_t) (location - haystack.bytes);
+}
+
+XTR_API bool
+xtr_view_contains(const xtr_view_t haystack, const xtr_view_t needle)
+{
+    return xtr_view_find(haystack, needle) != XTR_NOT_FOUND;
+}
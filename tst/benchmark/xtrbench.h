@@ -0,0 +1,83 @@
+/**
+ * @file
+ * Benchmarks run by the xtrbench_main/main().
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef XTRBENCH_H
+#define XTRBENCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "xtr.h"
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Runs `statement` in a loop `iterations` times and prints the elapsed
+ * CPU time and the throughput over `bytes_per_iteration`.
+ */
+#define XTRBENCH_RUN(name, iterations, bytes_per_iteration, statement)                     \
+    do                                                                                     \
+    {                                                                                      \
+        const clock_t xtrbench_start = clock();                                            \
+        for (size_t xtrbench_i = 0U; xtrbench_i < (iterations); xtrbench_i++)              \
+        {                                                                                  \
+            statement;                                                                     \
+        }                                                                                  \
+        const double xtrbench_seconds =                                                    \
+            (double) (clock() - xtrbench_start) / (double) CLOCKS_PER_SEC;                 \
+        const double xtrbench_mib =                                                        \
+            (double) (bytes_per_iteration) * (double) (iterations) / (1024.0 * 1024.0);    \
+        printf("%-48s %10.3f ms %10.1f MiB/s\n",                                           \
+               (name),                                                                     \
+               xtrbench_seconds * 1000.0,                                                  \
+               xtrbench_seconds > 0.0 ? xtrbench_mib / xtrbench_seconds : 0.0);            \
+    } while (0)
+
+/**
+ * Sink for benchmark results, preventing the compiler from optimising
+ * the benchmarked calls away.
+ */
+extern volatile size_t xtrbench_sink;
+
+void
+xtrbench_find(void);
+
+void
+xtrbench_edit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XTRBENCH_H */
@@ -0,0 +1,319 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrbench.h"
+
+#include <string.h>
+
+#define PAYLOAD_LEN (1024U * 1024U)
+
+static void
+bench_share(const xtr_t* const payload, const size_t consumers, const size_t iterations)
+{
+    xtr_t* fanout[64];
+    const size_t amount = consumers < 64U ? consumers : 64U;
+    XTRBENCH_RUN("fan-out, deep clones (xtr_clone)", iterations, amount * xtr_length(payload), {
+        for (size_t c = 0U; c < amount; c++)
+        {
+            fanout[c] = xtr_clone(payload);
+        }
+        for (size_t c = 0U; c < amount; c++)
+        {
+            xtrbench_sink += xtr_length(fanout[c]);
+            xtr_free(&fanout[c]);
+        }
+    });
+    xtr_t* shared = xtr_clone(payload);
+    XTRBENCH_RUN("fan-out, shared clones (xtr_share)", iterations, amount * xtr_length(shared), {
+        for (size_t c = 0U; c < amount; c++)
+        {
+            fanout[c] = xtr_share(shared);
+        }
+        for (size_t c = 0U; c < amount; c++)
+        {
+            xtrbench_sink += xtr_length(fanout[c]);
+            xtr_release(&fanout[c]);
+        }
+    });
+    xtr_free(&shared);
+}
+
+static void
+bench_rope(const size_t pieces, const size_t iterations)
+{
+    // Document assembled by inserting 1 KiB pieces at the front
+    xtr_t* piece = xtr_from_str_repeat("0123456789abcdef", 64U);
+    const size_t bytes = pieces * xtr_length(piece);
+    XTRBENCH_RUN("insert at start, contiguous (xtr_concat)", iterations, bytes, {
+        xtr_t* document = xtr_new_empty();
+        for (size_t p = 0U; p < pieces; p++)
+        {
+            xtr_t* const longer = xtr_concat(piece, document);
+            xtr_free(&document);
+            document = longer;
+        }
+        xtrbench_sink += xtr_length(document);
+        xtr_free(&document);
+    });
+    XTRBENCH_RUN("insert at start, rope (xtr_rope_insert)", iterations, bytes, {
+        xtr_rope_t* rope = xtr_rope_new();
+        for (size_t p = 0U; p < pieces; p++)
+        {
+            xtr_rope_insert(rope, 0U, piece);
+        }
+        xtr_t* document = xtr_rope_flatten(rope);
+        xtrbench_sink += xtr_length(document);
+        xtr_free(&document);
+        xtr_rope_free(&rope);
+    });
+    XTRBENCH_RUN("insert at start, rope (xtr_rope_insert_shared)", iterations, bytes, {
+        xtr_rope_t* rope = xtr_rope_new();
+        for (size_t p = 0U; p < pieces; p++)
+        {
+            xtr_rope_insert_shared(rope, 0U, piece);
+        }
+        xtr_t* document = xtr_rope_flatten(rope);
+        xtrbench_sink += xtr_length(document);
+        xtr_free(&document);
+        xtr_rope_free(&rope);
+    });
+    XTRBENCH_RUN("insert in middle, rope (xtr_rope_insert)", iterations, bytes, {
+        xtr_rope_t* rope = xtr_rope_new();
+        for (size_t p = 0U; p < pieces; p++)
+        {
+            xtr_rope_insert(rope, xtr_rope_length(rope) / 2U + p % 7U, piece);
+        }
+        xtr_t* document = xtr_rope_flatten(rope);
+        xtrbench_sink += xtr_length(document);
+        xtr_free(&document);
+        xtr_rope_free(&rope);
+    });
+    // Typing: single bytes inserted one after the other in the middle
+    xtr_t* byte = xtr_from_str("x");
+    xtr_rope_t* text = xtr_rope_new();
+    for (size_t p = 0U; p < pieces; p++)
+    {
+        xtr_rope_insert(text, 0U, piece);
+    }
+    const size_t keystrokes = 100000U;
+    XTRBENCH_RUN("insert 1 byte in middle, rope (xtr_rope_insert)", iterations, keystrokes, {
+        const size_t at = xtr_rope_length(text) / 2U;
+        for (size_t k = 0U; k < keystrokes; k++)
+        {
+            xtr_rope_insert(text, at + k, byte);
+        }
+        xtr_rope_delete(text, at, keystrokes);
+    });
+    xtr_rope_free(&text);
+    xtr_free(&byte);
+    xtr_free(&piece);
+}
+
+static void
+bench_gapbuf(const size_t text_len, const size_t edits, const size_t iterations)
+{
+    // Template filling: short inserts and deletes near a cursor drifting forward
+    xtr_t* byte = xtr_from_str("x");
+    xtr_view_t byte_view;
+    xtr_view_t word;
+    xtr_view(&byte_view, byte);
+    xtr_view_from_str(&word, "{{name}}");
+    XTRBENCH_RUN("edits near cursor, gap buffer (xtr_gapbuf_insert)", iterations, edits, {
+        xtr_t* text = xtr_from_byte_repeat('-', text_len);
+        xtr_gapbuf_t gapbuf;
+        xtr_gapbuf_init(&gapbuf, &text);
+        for (size_t e = 0U; e < edits; e++)
+        {
+            xtr_gapbuf_move(&gapbuf, (e * 37U) % text_len);
+            xtr_gapbuf_insert(&gapbuf, word);
+            xtr_gapbuf_backspace(&gapbuf, 8U);
+            xtr_gapbuf_insert(&gapbuf, byte_view);
+            xtr_gapbuf_delete(&gapbuf, 1U);
+        }
+        text = xtr_gapbuf_to_xtr(&gapbuf);
+        xtrbench_sink += xtr_length(text);
+        xtr_free(&text);
+    });
+    XTRBENCH_RUN("edits near cursor, rope (xtr_rope_insert)", iterations, edits, {
+        xtr_t* text = xtr_from_byte_repeat('-', text_len);
+        xtr_t* placeholder = xtr_from_view(word);
+        xtr_rope_t* rope = xtr_rope_new();
+        xtr_rope_insert(rope, 0U, text);
+        for (size_t e = 0U; e < edits; e++)
+        {
+            const size_t at = (e * 37U) % text_len;
+            xtr_rope_insert(rope, at, placeholder);
+            xtr_rope_delete(rope, at, 8U);
+            xtr_rope_insert(rope, at, byte);
+            xtr_rope_delete(rope, at + 1U, 1U);
+        }
+        xtr_t* flat = xtr_rope_flatten(rope);
+        xtrbench_sink += xtr_length(flat);
+        xtr_free(&flat);
+        xtr_rope_free(&rope);
+        xtr_free(&placeholder);
+        xtr_free(&text);
+    });
+    xtr_free(&byte);
+}
+
+static void
+bench_head_room(const size_t len, const size_t record_len, const size_t iterations)
+{
+    // Protocol parser: consume short records from the front of a receive buffer
+    xtr_t* received = xtr_from_byte_repeat('r', len);
+    xtr_t* header = xtr_from_byte_repeat('h', record_len);
+    XTRBENCH_RUN("consume records from front (xtr_truncate_head)", iterations, len, {
+        xtr_t* buffer = xtr_clone(received);
+        while (xtr_length(buffer) >= record_len)
+        {
+            xtrbench_sink += xtr_bytes(buffer)[0];
+            xtr_truncate_head(buffer, record_len);
+        }
+        xtr_free(&buffer);
+    });
+    XTRBENCH_RUN("consume records from front (memmove per record)", iterations, len, {
+        xtr_t* buffer = xtr_clone(received);
+        uint8_t* const bytes = (uint8_t*) xtr_cstring(buffer);
+        for (size_t left = len; left >= record_len; left -= record_len)
+        {
+            xtrbench_sink += bytes[0];
+            memmove(bytes, &bytes[record_len], left - record_len);
+        }
+        xtr_free(&buffer);
+    });
+    XTRBENCH_RUN("replace record headers in place (xtr_push_head)", iterations, len, {
+        xtr_t* buffer = xtr_clone(received);
+        while (xtr_length(buffer) >= record_len)
+        {
+            xtr_truncate_head(buffer, record_len);
+            xtr_push_head(buffer, header);
+            xtrbench_sink += xtr_bytes(buffer)[0];
+            xtr_truncate_head(buffer, record_len);
+        }
+        xtr_free(&buffer);
+    });
+    xtr_free(&header);
+    xtr_free(&received);
+}
+
+static void
+bench_growth(const size_t appends, const size_t iterations)
+{
+    // Building a string from many short appends
+    xtr_t* piece = xtr_from_str("0123456789abcdef");
+    const size_t bytes = appends * xtr_length(piece);
+    const xtr_growth_t exact = {100U, 0U, 0U};
+    XTRBENCH_RUN("short appends, exact growth (xtr_extend_tail_growth)", iterations, bytes, {
+        xtr_t* built = xtr_new_empty();
+        for (size_t a = 0U; a < appends; a++)
+        {
+            xtr_extend_tail_growth(&built, piece, &exact);
+        }
+        xtrbench_sink += xtr_length(built);
+        xtr_free(&built);
+    });
+    XTRBENCH_RUN("short appends, default growth (xtr_extend_tail)", iterations, bytes, {
+        xtr_t* built = xtr_new_empty();
+        for (size_t a = 0U; a < appends; a++)
+        {
+            xtr_extend_tail(&built, piece);
+        }
+        xtrbench_sink += xtr_length(built);
+        xtr_free(&built);
+    });
+    XTRBENCH_RUN("short appends, reserved (xtr_reserve)", iterations, bytes, {
+        xtr_t* built = xtr_new_empty();
+        xtr_reserve(&built, bytes);
+        for (size_t a = 0U; a < appends; a++)
+        {
+            xtr_extend_tail(&built, piece);
+        }
+        xtrbench_sink += xtr_length(built);
+        xtr_free(&built);
+    });
+    xtr_free(&piece);
+}
+
+static void
+bench_realloc(const size_t len, const size_t iterations)
+{
+    // Growing a large buffer step by step, then trimming its spare room
+    char name[80];
+    snprintf(name, sizeof(name), "grow %zu MiB to %zu MiB (xtr_expand)", len >> 20U, len >> 16U);
+    XTRBENCH_RUN(name, iterations, len, {
+        xtr_t* buffer = xtr_from_byte_repeat('b', len);
+        for (size_t capacity = 2U * len; capacity <= 16U * len; capacity *= 2U)
+        {
+            xtr_expand(&buffer, capacity);
+        }
+        xtrbench_sink += xtr_capacity(buffer);
+        xtr_free(&buffer);
+    });
+    snprintf(name, sizeof(name), "grow %zu MiB to %zu MiB (copy and free)", len >> 20U, len >> 16U);
+    XTRBENCH_RUN(name, iterations, len, {
+        xtr_t* buffer = xtr_from_byte_repeat('b', len);
+        for (size_t capacity = 2U * len; capacity <= 16U * len; capacity *= 2U)
+        {
+            xtr_t* copy = xtr_expanded(buffer, capacity);
+            xtr_free(&buffer);
+            buffer = copy;
+        }
+        xtrbench_sink += xtr_capacity(buffer);
+        xtr_free(&buffer);
+    });
+    XTRBENCH_RUN("trim spare room (xtr_compress_free)", iterations, len, {
+        xtr_t* buffer = xtr_from_byte_repeat_capac('b', len, 2U * len);
+        xtr_t* compressed = xtr_compress_free(&buffer);
+        xtrbench_sink += xtr_capacity(compressed);
+        xtr_free(&compressed);
+    });
+    XTRBENCH_RUN("trim spare room (copy and free)", iterations, len, {
+        xtr_t* buffer = xtr_from_byte_repeat_capac('b', len, 2U * len);
+        xtr_t* compressed = xtr_expanded(buffer, len);
+        xtr_free(&buffer);
+        xtrbench_sink += xtr_capacity(compressed);
+        xtr_free(&compressed);
+    });
+}
+
+void
+xtrbench_edit(void)
+{
+    xtr_t* payload = xtr_from_byte_repeat('p', PAYLOAD_LEN);
+    bench_share(payload, 64U, 20U);
+    xtr_free(&payload);
+    bench_rope(2000U, 3U);
+    bench_gapbuf(65536U, 100000U, 10U);
+    bench_head_room(1U << 20U, 16U, 2U);
+    bench_growth(20000U, 3U);
+    bench_realloc(4U << 20U, 5U);
+}
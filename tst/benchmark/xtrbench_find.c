@@ -0,0 +1,752 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrbench.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#define HAYSTACK_LEN (1024U * 1024U)
+
+/**
+ * Previous substring search approach, kept as baseline: memchr() on the
+ * first needle byte, then comparing the rest of the needle byte by byte.
+ */
+static const uint8_t*
+memchr_naive_search(const uint8_t* const haystack,
+                    const size_t haystack_len,
+                    const uint8_t* const needle,
+                    const size_t needle_len)
+{
+    const uint8_t* const last = haystack + haystack_len - needle_len;
+    const uint8_t* candidate = haystack;
+    while (candidate <= last)
+    {
+        candidate = memchr(candidate, needle[0], (size_t) (last - candidate) + 1U);
+        if (candidate == NULL)
+        {
+            return NULL;
+        }
+        size_t i = 1U;
+        while (i < needle_len && candidate[i] == needle[i])
+        {
+            i++;
+        }
+        if (i == needle_len)
+        {
+            return candidate;
+        }
+        candidate++;
+    }
+    return NULL;
+}
+
+/** Log-like text: pseudo-random lowercase words separated by spaces. */
+static xtr_t*
+text_haystack(void)
+{
+    uint8_t* const bytes = malloc(HAYSTACK_LEN);
+    if (bytes == NULL)
+    {
+        return NULL;
+    }
+    uint32_t state = 0x12345678U;
+    for (size_t i = 0U; i < HAYSTACK_LEN; i++)
+    {
+        state = state * 1103515245U + 12345U;
+        const uint8_t value = (uint8_t) ((state >> 16U) % 32U);
+        bytes[i] = value < 26U ? (uint8_t) ('a' + value) : (uint8_t) ' ';
+    }
+    xtr_t* const haystack = xtr_from_bytes(bytes, HAYSTACK_LEN);
+    free(bytes);
+    return haystack;
+}
+
+static void
+bench_needle(const xtr_t* const haystack, const size_t needle_len, const size_t iterations)
+{
+    // Needle taken from the haystack's end, so the entire haystack is scanned
+    const uint8_t* const bytes = xtr_bytes(haystack);
+    const size_t len = xtr_length(haystack);
+    xtr_t* needle = xtr_from_bytes(&bytes[len - needle_len], needle_len);
+    char name[64];
+    snprintf(name, sizeof(name), "find, text, %zu-byte needle (baseline)", needle_len);
+    XTRBENCH_RUN(name,
+                 iterations,
+                 len,
+                 xtrbench_sink += (size_t) memchr_naive_search(
+                     bytes, len, xtr_bytes(needle), needle_len));
+    snprintf(name, sizeof(name), "find, text, %zu-byte needle (xtr_find)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_find(haystack, needle));
+    snprintf(name, sizeof(name), "occurrences, text, %zu-byte needle", needle_len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_occurrences(haystack, needle));
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    snprintf(name, sizeof(name), "find, text, %zu-byte needle (xtr_pattern_find)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_pattern_find(haystack, pattern));
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+}
+
+static void
+bench_many_haystacks(const xtr_t* const text, const size_t needle_len, const size_t iterations)
+{
+    // Same needle searched in many short xtrings: preprocessing dominates
+    const size_t haystack_len = 128U;
+    const size_t amount = xtr_length(text) / haystack_len;
+    xtr_t** haystacks = malloc(amount * sizeof(xtr_t*));
+    if (haystacks == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0U; i < amount; i++)
+    {
+        haystacks[i] = xtr_from_bytes(&xtr_bytes(text)[i * haystack_len], haystack_len);
+    }
+    xtr_t* needle = xtr_from_byte_repeat('Z', needle_len);
+    char name[64];
+    snprintf(name, sizeof(name), "find, %zu x 128 B, %zu-byte needle (xtr_find)", amount,
+             needle_len);
+    XTRBENCH_RUN(name, iterations, xtr_length(text), for (size_t i = 0U; i < amount; i++) {
+        xtrbench_sink += xtr_find(haystacks[i], needle);
+    });
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    snprintf(name, sizeof(name), "find, %zu x 128 B, %zu-byte needle (pattern)", amount,
+             needle_len);
+    XTRBENCH_RUN(name, iterations, xtr_length(text), for (size_t i = 0U; i < amount; i++) {
+        xtrbench_sink += xtr_pattern_find(haystacks[i], pattern);
+    });
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+    for (size_t i = 0U; i < amount; i++)
+    {
+        xtr_free(&haystacks[i]);
+    }
+    free(haystacks);
+}
+
+static void
+bench_adversarial(const size_t needle_len, const size_t iterations)
+{
+    // aaa...a haystack and aaa...ab needle: every position almost matches
+    xtr_t* haystack = xtr_from_byte_repeat('a', HAYSTACK_LEN / 8U);
+    xtr_t* as = xtr_from_byte_repeat('a', needle_len - 1U);
+    xtr_t* b = xtr_from_str("b");
+    xtr_t* needle = xtr_concat(as, b);
+    xtr_free(&as);
+    xtr_free(&b);
+    const uint8_t* const bytes = xtr_bytes(haystack);
+    const size_t len = xtr_length(haystack);
+    char name[64];
+    snprintf(name, sizeof(name), "find, a..ab, %zu-byte needle (baseline)", needle_len);
+    XTRBENCH_RUN(name,
+                 iterations,
+                 len,
+                 xtrbench_sink += (size_t) memchr_naive_search(
+                     bytes, len, xtr_bytes(needle), needle_len));
+    snprintf(name, sizeof(name), "find, a..ab, %zu-byte needle (xtr_find)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_find(haystack, needle));
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+static void
+bench_keywords(const xtr_t* const text, const size_t amount, const size_t iterations)
+{
+    // Pseudo-random lowercase keywords of 5 to 12 letters, rarely in the text
+    xtr_t** keywords = malloc(amount * sizeof(xtr_t*));
+    size_t* counts = malloc(amount * sizeof(size_t));
+    if (keywords == NULL || counts == NULL)
+    {
+        free(keywords);
+        free(counts);
+        return;
+    }
+    uint32_t state = 0xCAFEU;
+    for (size_t k = 0U; k < amount; k++)
+    {
+        uint8_t word[12];
+        state = state * 1103515245U + 12345U;
+        const size_t len = 5U + (state >> 16U) % 8U;
+        for (size_t i = 0U; i < len; i++)
+        {
+            state = state * 1103515245U + 12345U;
+            word[i] = (uint8_t) ('a' + (state >> 16U) % 26U);
+        }
+        keywords[k] = xtr_from_bytes(word, len);
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "count, text, %zu keywords (xtr_occurrences)", amount);
+    XTRBENCH_RUN(name, iterations, xtr_length(text), for (size_t k = 0U; k < amount; k++) {
+        xtrbench_sink += xtr_occurrences(text, keywords[k]);
+    });
+    xtr_multipattern_t* patterns = xtr_multipattern_new((const xtr_t* const*) keywords, amount);
+    snprintf(name, sizeof(name), "count, text, %zu keywords (xtr_count_each)", amount);
+    XTRBENCH_RUN(name, iterations, xtr_length(text),
+                 xtrbench_sink += xtr_count_each(counts, text, patterns));
+    snprintf(name, sizeof(name), "find, text, %zu keywords (xtr_find_any)", amount);
+    XTRBENCH_RUN(name, iterations, xtr_length(text),
+                 xtrbench_sink += xtr_find_any(text, patterns, NULL));
+    xtr_multipattern_free(&patterns);
+    for (size_t k = 0U; k < amount; k++)
+    {
+        xtr_free(&keywords[k]);
+    }
+    free(keywords);
+    free(counts);
+}
+
+static void
+bench_stream(const xtr_t* const text, const size_t chunk_len, const size_t iterations)
+{
+    // Network-sized chunks of the text, a delimiter straddling the chunks
+    const size_t amount = xtr_length(text) / chunk_len;
+    xtr_t** chunks = malloc(amount * sizeof(xtr_t*));
+    if (chunks == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0U; i < amount; i++)
+    {
+        chunks[i] = xtr_from_bytes(&xtr_bytes(text)[i * chunk_len], chunk_len);
+    }
+    xtr_t* needle = xtr_from_bytes(&xtr_bytes(text)[chunk_len * (amount - 1U) - 4U], 8U);
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    char name[64];
+    // Best case of concatenating the chunks: a single pre-allocated xtring
+    snprintf(name, sizeof(name), "stream, %zu B chunks (concat, xtr_find)", chunk_len);
+    XTRBENCH_RUN(name, iterations, amount * chunk_len, {
+        xtr_t* stream = xtr_new(amount * chunk_len);
+        for (size_t i = 0U; i < amount; i++)
+        {
+            xtr_push_tail(stream, chunks[i]);
+        }
+        xtrbench_sink += xtr_find(stream, needle);
+        xtr_free(&stream);
+    });
+    snprintf(name, sizeof(name), "stream, %zu B chunks (xtr_stream_search)", chunk_len);
+    XTRBENCH_RUN(name, iterations, amount * chunk_len, {
+        xtr_stream_search_t* search = xtr_stream_search_new(pattern);
+        for (size_t i = 0U; i < amount; i++)
+        {
+            xtr_stream_search_feed(search, chunks[i]);
+            xtrbench_sink += xtr_stream_search_next(search);
+        }
+        xtr_stream_search_free(&search);
+    });
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+    for (size_t i = 0U; i < amount; i++)
+    {
+        xtr_free(&chunks[i]);
+    }
+    free(chunks);
+}
+
+static void
+bench_reverse(const xtr_t* const haystack, const size_t needle_len, const size_t iterations)
+{
+    // Needle close to the end, as a file extension or a line's last field
+    const size_t len = xtr_length(haystack);
+    xtr_t* needle = xtr_from_bytes(&xtr_bytes(haystack)[len - 64U], needle_len);
+    char name[64];
+    snprintf(name, sizeof(name), "rfind, text, %zu-byte needle (xtr_find_all)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, {
+        size_t amount = 0U;
+        size_t* const indices = xtr_find_all(&amount, haystack, needle);
+        xtrbench_sink += indices[amount - 1U];
+        free(indices);
+    });
+    snprintf(name, sizeof(name), "rfind, text, %zu-byte needle (xtr_rfind)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_rfind(haystack, needle));
+    xtr_free(&needle);
+}
+
+/** Baseline of the case-insensitive functions: a lowercased copy. */
+static xtr_t*
+lowercase_copy(const xtr_t* const xtr)
+{
+    const size_t len = xtr_length(xtr);
+    uint8_t* const bytes = malloc(len);
+    if (bytes == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0U; i < len; i++)
+    {
+        bytes[i] = (uint8_t) tolower(xtr_bytes(xtr)[i]);
+    }
+    xtr_t* const copy = xtr_from_bytes(bytes, len);
+    free(bytes);
+    return copy;
+}
+
+static void
+bench_icase(const xtr_t* const haystack, const size_t needle_len, const size_t iterations)
+{
+    // Uppercased needle from the end of the lowercase text
+    const size_t len = xtr_length(haystack);
+    uint8_t upper[64];
+    for (size_t i = 0U; i < needle_len; i++)
+    {
+        upper[i] = (uint8_t) toupper(xtr_bytes(haystack)[len - 64U + i]);
+    }
+    xtr_t* needle = xtr_from_bytes(upper, needle_len);
+    char name[64];
+    snprintf(name, sizeof(name), "find icase, text, %zu-byte needle (lowercase)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, {
+        xtr_t* lower_haystack = lowercase_copy(haystack);
+        xtr_t* lower_needle = lowercase_copy(needle);
+        xtrbench_sink += xtr_find(lower_haystack, lower_needle);
+        xtr_free(&lower_haystack);
+        xtr_free(&lower_needle);
+    });
+    snprintf(name, sizeof(name), "find icase, text, %zu-byte needle (xtr_find_icase)", needle_len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_find_icase(haystack, needle));
+    xtr_free(&needle);
+}
+
+static void
+bench_header_names(const size_t iterations)
+{
+    static const char* const NAMES[] = {"Host", "User-Agent", "Accept", "Accept-Encoding",
+                                        "Content-Type", "Content-Length", "Connection",
+                                        "Cache-Control"};
+    const size_t amount = sizeof(NAMES) / sizeof(NAMES[0]);
+    xtr_t* names[sizeof(NAMES) / sizeof(NAMES[0])];
+    for (size_t i = 0U; i < amount; i++)
+    {
+        names[i] = xtr_from_str(NAMES[i]);
+    }
+    xtr_t* wanted = xtr_from_str("content-length");
+    const size_t bytes = 1000U * amount * xtr_length(wanted);
+    XTRBENCH_RUN("equal icase, header names (lowercase)", iterations, bytes, {
+        for (size_t r = 0U; r < 1000U; r++)
+        {
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtr_t* lower = lowercase_copy(names[i]);
+                xtrbench_sink += xtr_is_equal(lower, wanted);
+                xtr_free(&lower);
+            }
+        }
+    });
+    XTRBENCH_RUN("equal icase, header names (xtr_is_equal_icase)", iterations, bytes, {
+        for (size_t r = 0U; r < 1000U; r++)
+        {
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtrbench_sink += xtr_is_equal_icase(names[i], wanted);
+            }
+        }
+    });
+    for (size_t i = 0U; i < amount; i++)
+    {
+        xtr_free(&names[i]);
+    }
+    xtr_free(&wanted);
+}
+
+static void
+bench_first_of(const xtr_t* const haystack, const char* const chars, const size_t iterations)
+{
+    // Scan for HTML-escapable bytes, which the text does not contain
+    const size_t len = xtr_length(haystack);
+    xtr_charset_t set;
+    xtr_charset_init(&set, chars);
+    char name[64];
+    snprintf(name, sizeof(name), "first of, %zu-byte set (strchr loop)", strlen(chars));
+    XTRBENCH_RUN(name, iterations, len, {
+        size_t i = 0U;
+        while (i < len && strchr(chars, xtr_bytes(haystack)[i]) == NULL)
+        {
+            i++;
+        }
+        xtrbench_sink += i;
+    });
+    snprintf(name, sizeof(name), "first of, %zu-byte set (strcspn)", strlen(chars));
+    XTRBENCH_RUN(name, iterations, len,
+                 xtrbench_sink += strcspn(xtr_cstring(haystack), chars));
+    snprintf(name, sizeof(name), "first of, %zu-byte set (xtr_find_first_of)", strlen(chars));
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_find_first_of(haystack, &set));
+}
+
+/** Log lines, one in 16 reporting an error code. */
+static xtr_t*
+log_haystack(void)
+{
+    char* const text = malloc(HAYSTACK_LEN + 128U);
+    if (text == NULL)
+    {
+        return NULL;
+    }
+    size_t len = 0U;
+    for (unsigned int line = 0U; len < HAYSTACK_LEN; line++)
+    {
+        const int written =
+            line % 16U == 15U
+                ? snprintf(&text[len], 128U, "2024-02-%02u 12:%02u:%02u ERR 404-NOTFOUND id=%u\n",
+                           line % 28U + 1U, line % 60U, line % 59U, line)
+                : snprintf(&text[len], 128U, "2024-02-%02u 12:%02u:%02u INFO user=u%u took=%ums\n",
+                           line % 28U + 1U, line % 60U, line % 59U, line, line % 997U);
+        len += (size_t) written;
+    }
+    xtr_t* const haystack = xtr_from_bytes((const uint8_t*) text, HAYSTACK_LEN);
+    free(text);
+    return haystack;
+}
+
+static void
+bench_regex(const xtr_t* const haystack, const char* const pattern, const size_t iterations)
+{
+    xtr_regex_t* regex = xtr_regex_new(pattern);
+    char name[64];
+    snprintf(name, sizeof(name), "regex find all, %s", pattern);
+    XTRBENCH_RUN(name, iterations, xtr_length(haystack), {
+        size_t amount = 0U;
+        free(xtr_regex_find_all(&amount, haystack, regex));
+        xtrbench_sink += amount;
+    });
+    xtr_regex_free(&regex);
+}
+
+static void
+bench_lines(const xtr_t* const text, const size_t iterations)
+{
+    xtr_t* newline = xtr_from_str("\n");
+    XTRBENCH_RUN("lines, iterate (xtr_split_next)", iterations, xtr_length(text), {
+        xtr_split_iter_t iter;
+        xtr_view_t line;
+        xtr_split_iter_init(&iter, text, newline);
+        while (xtr_split_next(&iter, &line))
+        {
+            xtrbench_sink += line.length;
+        }
+    });
+    XTRBENCH_RUN("lines, iterate (xtr_line_next)", iterations, xtr_length(text), {
+        xtr_line_iter_t iter;
+        xtr_view_t line;
+        xtr_line_iter_init(&iter, text);
+        while (xtr_line_next(&iter, &line))
+        {
+            xtrbench_sink += line.length;
+        }
+    });
+    xtr_line_index_t* index = NULL;
+    XTRBENCH_RUN("lines, index build", iterations, xtr_length(text), {
+        xtr_line_index_free(&index);
+        index = xtr_line_index_new(text);
+    });
+    // Lookups counted as scanning the text up to the line, as without index
+    const size_t lines = xtr_line_index_lines(index);
+    XTRBENCH_RUN("lines, index line to offset", 100000U, xtr_length(text) / 2U, {
+        xtrbench_sink += xtr_line_index_offset(index, xtrbench_i * 7919U % lines);
+    });
+    XTRBENCH_RUN("lines, index offset to line", 100000U, xtr_length(text) / 2U, {
+        xtrbench_sink += xtr_line_index_line_at(index, xtrbench_i * 7919U % xtr_length(text));
+    });
+    xtr_line_index_free(&index);
+    xtr_free(&newline);
+}
+
+static void
+bench_approx(const xtr_t* const haystack,
+             const size_t needle_len,
+             const size_t max_edits,
+             const size_t iterations)
+{
+    // Needle with a typo taken from the haystack's end, to scan it entirely
+    const uint8_t* const bytes = xtr_bytes(haystack);
+    const size_t len = xtr_length(haystack);
+    uint8_t typo[256];
+    memcpy(typo, &bytes[len - needle_len], needle_len);
+    typo[needle_len / 2U] ^= 0x40U;
+    xtr_t* needle = xtr_from_bytes(typo, needle_len);
+    char name[64];
+    snprintf(name, sizeof(name), "find approx, %zu-byte needle, %zu edits", needle_len, max_edits);
+    XTRBENCH_RUN(name,
+                 iterations,
+                 len,
+                 xtrbench_sink += xtr_find_approx(haystack, needle, max_edits, NULL));
+    xtr_free(&needle);
+}
+
+static void
+bench_edit_distance(const xtr_t* const text, const size_t len, const size_t iterations)
+{
+    // A copy with an edit every 1 KiB: narrow band
+    uint8_t* const edited = malloc(len);
+    if (edited == NULL)
+    {
+        return;
+    }
+    memcpy(edited, xtr_bytes(text), len);
+    for (size_t i = 0U; i < len; i += 1024U)
+    {
+        edited[i] ^= 0x40U;
+    }
+    xtr_t* a = xtr_from_bytes(xtr_bytes(text), len);
+    xtr_t* b = xtr_from_bytes(edited, len);
+    free(edited);
+    char name[64];
+    snprintf(name, sizeof(name), "edit distance, %zu bytes, few edits", len);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_edit_distance(a, b));
+    // Unrelated sections: whole quadratic matrix, so shorter ones
+    const size_t short_len = len / 4U;
+    xtr_free(&a);
+    xtr_free(&b);
+    a = xtr_from_bytes(xtr_bytes(text), short_len);
+    b = xtr_from_bytes(&xtr_bytes(text)[short_len], short_len);
+    snprintf(name, sizeof(name), "edit distance, %zu bytes, unrelated", short_len);
+    XTRBENCH_RUN(name, iterations, short_len, xtrbench_sink += xtr_edit_distance(a, b));
+    xtr_free(&a);
+    xtr_free(&b);
+}
+
+static void
+bench_index(const xtr_t* const text, const size_t needle_len, const size_t queries)
+{
+    const uint8_t* const bytes = xtr_bytes(text);
+    const size_t len = xtr_length(text);
+    xtr_index_t* index = NULL;
+    XTRBENCH_RUN("index, build", 1U, len, index = xtr_index_new(text));
+    // Queries counted as scanning the whole text, as xtr_occurrences() does
+    char name[64];
+    snprintf(name, sizeof(name), "index, occurrences, %zu-byte needles", needle_len);
+    XTRBENCH_RUN(name, queries, len, {
+        xtr_t* needle = xtr_from_bytes(&bytes[(xtrbench_i * 7919U) % (len - needle_len)],
+                                       needle_len);
+        xtrbench_sink += xtr_index_occurrences(index, needle);
+        xtr_free(&needle);
+    });
+    snprintf(name, sizeof(name), "occurrences, %zu-byte needles (scan)", needle_len);
+    XTRBENCH_RUN(name, queries / 100U, len, {
+        xtr_t* needle = xtr_from_bytes(&bytes[(xtrbench_i * 7919U) % (len - needle_len)],
+                                       needle_len);
+        xtrbench_sink += xtr_occurrences(text, needle);
+        xtr_free(&needle);
+    });
+    xtr_index_free(&index);
+}
+
+static void
+bench_split(const size_t fields, const size_t iterations)
+{
+    // CSV line of short fields, split many times
+    xtr_t* head = xtr_from_str_repeat("field,", fields - 1U);
+    xtr_t* last = xtr_from_str("last");
+    xtr_t* line = xtr_concat(head, last);
+    xtr_free(&head);
+    xtr_free(&last);
+    xtr_t* comma = xtr_from_str(",");
+    const size_t lines = 1000U;
+    const size_t bytes = lines * xtr_length(line);
+    char name[64];
+    snprintf(name, sizeof(name), "split, %zu fields (xtr_split)", fields);
+    XTRBENCH_RUN(name, iterations, bytes, {
+        for (size_t r = 0U; r < lines; r++)
+        {
+            size_t amount = 0U;
+            xtr_t** chunks = xtr_split(&amount, line, comma);
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtrbench_sink += xtr_length(chunks[i]);
+                xtr_free(&chunks[i]);
+            }
+            free(chunks);
+        }
+    });
+    snprintf(name, sizeof(name), "split, %zu fields (xtr_split_packed)", fields);
+    XTRBENCH_RUN(name, iterations, bytes, {
+        for (size_t r = 0U; r < lines; r++)
+        {
+            size_t amount = 0U;
+            xtr_t** chunks = xtr_split_packed(&amount, line, comma);
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtrbench_sink += xtr_length(chunks[i]);
+            }
+            free(chunks);
+        }
+    });
+    snprintf(name, sizeof(name), "split, %zu fields (xtr_split_views)", fields);
+    XTRBENCH_RUN(name, iterations, bytes, {
+        for (size_t r = 0U; r < lines; r++)
+        {
+            size_t amount = 0U;
+            xtr_view_t* chunks = xtr_split_views(&amount, line, comma);
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtrbench_sink += chunks[i].length;
+            }
+            free(chunks);
+        }
+    });
+    snprintf(name, sizeof(name), "split, %zu fields (xtr_split_slices)", fields);
+    XTRBENCH_RUN(name, iterations, bytes, {
+        for (size_t r = 0U; r < lines; r++)
+        {
+            size_t amount = 0U;
+            xtr_slice_t* chunks = xtr_split_slices(&amount, line, comma);
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtrbench_sink += chunks[i].view.length;
+            }
+            xtr_slices_free(&chunks, amount);
+        }
+    });
+    xtr_view_t* views = malloc(fields * sizeof(xtr_view_t));
+    snprintf(name, sizeof(name), "split, %zu fields (xtr_split_views_into)", fields);
+    XTRBENCH_RUN(name, iterations, bytes, {
+        for (size_t r = 0U; r < lines; r++)
+        {
+            const size_t amount = xtr_split_views_into(views, fields, line, comma);
+            for (size_t i = 0U; i < amount; i++)
+            {
+                xtrbench_sink += views[i].length;
+            }
+        }
+    });
+    free(views);
+    snprintf(name, sizeof(name), "split, %zu fields (xtr_split_next)", fields);
+    XTRBENCH_RUN(name, iterations, bytes, {
+        for (size_t r = 0U; r < lines; r++)
+        {
+            xtr_split_iter_t iter;
+            xtr_view_t field;
+            xtr_split_iter_init(&iter, line, comma);
+            while (xtr_split_next(&iter, &field))
+            {
+                xtrbench_sink += field.length;
+            }
+        }
+    });
+    xtr_free(&line);
+    xtr_free(&comma);
+}
+
+static void
+bench_csv(const size_t records, const size_t iterations)
+{
+    // Mix of plain and quoted fields, some with separators and quotes inside
+    xtr_t* record = xtr_from_str("1042,\"Smith, John\",john@example.com,2024-01-31,"
+                                 "\"said \"\"hi\"\"\",42.5,,true,\"multi\nline\",end\r\n");
+    xtr_t* text = xtr_repeated(record, records);
+    xtr_free(&record);
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    XTRBENCH_RUN("csv, parse", iterations, xtr_length(text), {
+        xtr_csv_parse(csv, text);
+        xtrbench_sink += xtr_csv_records(csv);
+    });
+    XTRBENCH_RUN("csv, parse and read all fields", iterations, xtr_length(text), {
+        xtr_csv_parse(csv, text);
+        xtr_view_t field;
+        for (size_t r = 0U; r < xtr_csv_records(csv); r++)
+        {
+            for (size_t f = 0U; f < xtr_csv_fields(csv, r); f++)
+            {
+                xtr_csv_field(&field, csv, r, f);
+                xtrbench_sink += field.length;
+            }
+        }
+    });
+    xtr_csv_free(&csv);
+    xtr_free(&text);
+}
+
+static void
+bench_parallel(const xtr_t* const text, const size_t repetitions, const size_t iterations)
+{
+    // Multi-MiB haystack, a short needle with many occurrences
+    xtr_t* haystack = xtr_from_bytes_repeat(xtr_bytes(text), xtr_length(text), repetitions);
+    xtr_t* needle = xtr_from_bytes(&xtr_bytes(text)[HAYSTACK_LEN / 2U], 3U);
+    const size_t len = xtr_length(haystack);
+    char name[64];
+    snprintf(name, sizeof(name), "count, %zu MiB text (xtr_occurrences)", len >> 20U);
+    XTRBENCH_RUN(name, iterations, len, xtrbench_sink += xtr_occurrences(haystack, needle));
+    snprintf(name, sizeof(name), "count, %zu MiB text (parallel)", len >> 20U);
+    XTRBENCH_RUN(name, iterations, len,
+                 xtrbench_sink += xtr_occurrences_parallel(haystack, needle, 0U));
+    snprintf(name, sizeof(name), "find all, %zu MiB text (parallel)", len >> 20U);
+    XTRBENCH_RUN(name, iterations, len, {
+        size_t amount = 0U;
+        free(xtr_find_all_parallel(&amount, haystack, needle, 0U));
+        xtrbench_sink += amount;
+    });
+    xtr_free(&needle);
+    xtr_free(&haystack);
+}
+
+void
+xtrbench_find(void)
+{
+    xtr_t* haystack = text_haystack();
+    static const size_t needle_lens[] = {1U, 2U, 3U, 4U, 8U, 16U, 32U, 64U, 128U, 256U};
+    for (size_t i = 0U; i < sizeof(needle_lens) / sizeof(needle_lens[0]); i++)
+    {
+        bench_needle(haystack, needle_lens[i], 50U);
+    }
+    bench_many_haystacks(haystack, 16U, 50U);
+    bench_many_haystacks(haystack, 100U, 50U);
+    bench_keywords(haystack, 10U, 10U);
+    bench_keywords(haystack, 300U, 10U);
+    bench_stream(haystack, 1500U, 20U);
+    bench_reverse(haystack, 1U, 20U);
+    bench_reverse(haystack, 8U, 20U);
+    bench_reverse(haystack, 32U, 20U);
+    bench_icase(haystack, 8U, 20U);
+    bench_icase(haystack, 32U, 20U);
+    bench_header_names(20U);
+    bench_first_of(haystack, "<>&\"'", 20U);
+    bench_split(50U, 20U);
+    bench_csv(10000U, 20U);
+    bench_parallel(haystack, 64U, 5U);
+    xtr_t* logs = log_haystack();
+    bench_regex(logs, "[0-9]{3}-[A-Z]+", 10U);
+    bench_regex(logs, "ERR [0-9]+-\\w+", 10U);
+    bench_regex(logs, "took=[0-9]{3,}ms|ERR", 10U);
+    bench_lines(logs, 10U);
+    xtr_free(&logs);
+    // Exponential for backtracking matchers, linear here
+    xtr_t* as = xtr_from_byte_repeat('a', HAYSTACK_LEN);
+    bench_regex(as, "(a|aa)*b", 10U);
+    xtr_free(&as);
+    // Worst case of find all: quadratic, each match rescans the rest of the run
+    xtr_t* xs = xtr_from_byte_repeat('x', 4096U);
+    bench_regex(xs, "x*y|x", 3U);
+    xtr_free(&xs);
+    bench_approx(haystack, 16U, 2U, 10U);
+    bench_approx(haystack, 200U, 20U, 5U);
+    bench_edit_distance(haystack, 65536U, 10U);
+    bench_index(haystack, 8U, 10000U);
+    xtr_free(&haystack);
+    bench_adversarial(16U, 5U);
+    bench_adversarial(256U, 5U);
+}
@@ -50,14 +50,59 @@ xtrtest_malloc_disable_failing(void);
 // clang-format off
 // @formatter: off
 // BEGIN OF AUTOMATED LISTING OF ALL XTRTEST TESTCASES
+void xtrtest_approx_fail_malloc(void);
+void xtrtest_approx_valid_edit_distance(void);
+void xtrtest_approx_valid_edit_distance_long(void);
+void xtrtest_approx_valid_edit_distance_random(void);
+void xtrtest_approx_valid_find(void);
+void xtrtest_approx_valid_find_extends(void);
+void xtrtest_approx_valid_find_long_needle(void);
+void xtrtest_approx_valid_null(void);
+void xtrtest_charset_fail_malloc(void);
+void xtrtest_charset_valid_contains(void);
+void xtrtest_charset_valid_find(void);
+void xtrtest_charset_valid_find_long(void);
+void xtrtest_charset_valid_null(void);
+void xtrtest_charset_valid_split_any(void);
+void xtrtest_charset_valid_split_any_edges(void);
 void xtrtest_clone_valid_1_char_xtr(void);
+void xtrtest_clone_valid_6_char_xtr(void);
 void xtrtest_clone_valid_empty_xtr(void);
-void xtrtest_clone_validaaaa_6_char_xtr(void);
 void xtrtest_clone_with_capacity_valid_1_char_xtr_less_capacity(void);
 void xtrtest_clone_with_capacity_valid_1_char_xtr_more_capacity(void);
 void xtrtest_clone_with_capacity_valid_1_char_xtr_same_capacity(void);
 void xtrtest_clone_with_capacity_valid_empty_xtr_more_capacity(void);
 void xtrtest_clone_with_capacity_valid_empty_xtr_same_capacity(void);
+void xtrtest_compress_free_valid_drops_head_room(void);
+void xtrtest_compress_free_valid_shared(void);
+void xtrtest_csv_fail_malloc(void);
+void xtrtest_csv_valid_line_endings(void);
+void xtrtest_csv_valid_null(void);
+void xtrtest_csv_valid_quoted(void);
+void xtrtest_csv_valid_random(void);
+void xtrtest_csv_valid_reuse(void);
+void xtrtest_csv_valid_simple(void);
+void xtrtest_csv_valid_unterminated_quote(void);
+void xtrtest_expand_fail_malloc(void);
+void xtrtest_expand_valid_keeps_content(void);
+void xtrtest_expand_valid_large(void);
+void xtrtest_expand_valid_shared_copies(void);
+void xtrtest_find_all_fail_malloc(void);
+void xtrtest_find_all_valid(void);
+void xtrtest_find_next_valid_needle_longer_than_haystack(void);
+void xtrtest_find_next_valid_null(void);
+void xtrtest_find_next_valid_pattern(void);
+void xtrtest_find_next_valid_successive(void);
+void xtrtest_find_valid_1_byte_needle(void);
+void xtrtest_find_valid_across_vector_blocks(void);
+void xtrtest_find_valid_adversarial_input(void);
+void xtrtest_find_valid_empty(void);
+void xtrtest_find_valid_itself(void);
+void xtrtest_find_valid_long_needle(void);
+void xtrtest_find_valid_needle_longer_than_haystack(void);
+void xtrtest_find_valid_null(void);
+void xtrtest_find_valid_periodic_needle(void);
+void xtrtest_find_valid_short_needle(void);
 void xtrtest_free_valid(void);
 void xtrtest_free_valid_on_null_input(void);
 void xtrtest_from_str_fail_malloc(void);
@@ -103,7 +148,45 @@ void xtrtest_from_str_with_capacity_valid_empty_string_15_bytes(void);
 void xtrtest_from_str_with_capacity_valid_empty_string_1_byte(void);
 void xtrtest_from_str_with_capacity_valid_null_string_0_bytes(void);
 void xtrtest_from_str_with_capacity_valid_null_string_6_bytes(void);
+void xtrtest_gapbuf_fail_malloc(void);
+void xtrtest_gapbuf_valid_conversions_without_copies(void);
+void xtrtest_gapbuf_valid_edit_at_cursor(void);
+void xtrtest_gapbuf_valid_move_farther_than_gap(void);
+void xtrtest_gapbuf_valid_null(void);
+void xtrtest_gapbuf_valid_random_edits(void);
+void xtrtest_gapbuf_valid_shared_xtring_is_copied(void);
 void xtrtest_getters_do_nothing_on_null_input(void);
+void xtrtest_growth_fail_malloc(void);
+void xtrtest_growth_valid_extend_head_keeps_room_before_content(void);
+void xtrtest_growth_valid_extend_tail_reallocates_rarely(void);
+void xtrtest_growth_valid_global_policy(void);
+void xtrtest_growth_valid_per_call_policy(void);
+void xtrtest_growth_valid_size_class_rounding(void);
+void xtrtest_head_room_valid_copies_and_clear(void);
+void xtrtest_head_room_valid_extend_uses_the_room(void);
+void xtrtest_head_room_valid_gapbuf(void);
+void xtrtest_head_room_valid_pop_head_consumes_from_the_front(void);
+void xtrtest_head_room_valid_push_head_reuses_the_room(void);
+void xtrtest_head_room_valid_push_head_without_room_recenters(void);
+void xtrtest_head_room_valid_push_onto_itself(void);
+void xtrtest_head_room_valid_push_tail_compacts_only_when_needed(void);
+void xtrtest_head_room_valid_truncate_head_does_not_move_content(void);
+void xtrtest_icase_valid_cmp(void);
+void xtrtest_icase_valid_find(void);
+void xtrtest_icase_valid_find_long(void);
+void xtrtest_icase_valid_is_equal(void);
+void xtrtest_icase_valid_is_equal_only_letters_folded(void);
+void xtrtest_icase_valid_long(void);
+void xtrtest_icase_valid_null(void);
+void xtrtest_icase_valid_startswith_endswith(void);
+void xtrtest_index_fail_malloc(void);
+void xtrtest_index_valid_empty_text(void);
+void xtrtest_index_valid_find(void);
+void xtrtest_index_valid_longest_repeat(void);
+void xtrtest_index_valid_null(void);
+void xtrtest_index_valid_overlapping(void);
+void xtrtest_index_valid_random(void);
+void xtrtest_index_valid_serialised(void);
 void xtrtest_is_empty_valid_empty(void);
 void xtrtest_is_empty_valid_empty_with_capacity(void);
 void xtrtest_is_empty_valid_non_empty(void);
@@ -116,6 +199,20 @@ void xtrtest_is_spaces_valid_non_spaces(void);
 void xtrtest_is_spaces_valid_not_only_whitespaces(void);
 void xtrtest_is_spaces_valid_null(void);
 void xtrtest_is_spaces_valid_single_space(void);
+void xtrtest_lines_fail_malloc(void);
+void xtrtest_lines_valid_index_compact(void);
+void xtrtest_lines_valid_index_single_line_blocks(void);
+void xtrtest_lines_valid_iter(void);
+void xtrtest_lines_valid_iter_and_index_as_split(void);
+void xtrtest_lines_valid_null(void);
+void xtrtest_multipattern_fail_malloc(void);
+void xtrtest_multipattern_valid_all_byte_values(void);
+void xtrtest_multipattern_valid_count_each(void);
+void xtrtest_multipattern_valid_count_each_non_overlapping(void);
+void xtrtest_multipattern_valid_find_all_any(void);
+void xtrtest_multipattern_valid_find_all_any_many_matches(void);
+void xtrtest_multipattern_valid_find_any(void);
+void xtrtest_multipattern_valid_null(void);
 void xtrtest_new_empty_fail_malloc(void);
 void xtrtest_new_empty_valid(void);
 void xtrtest_new_ensure_fail_size_overflow(void);
@@ -125,6 +222,106 @@ void xtrtest_new_with_capacity_valid_allocate_0_bytes(void);
 void xtrtest_new_with_capacity_valid_allocate_15_bytes(void);
 void xtrtest_new_with_capacity_valid_allocate_1_byte(void);
 void xtrtest_new_with_capacity_valid_allocate_ffff_plus_1_bytes(void);
+void xtrtest_occurrences_valid_across_vector_blocks(void);
+void xtrtest_occurrences_valid_empty_haystack(void);
+void xtrtest_occurrences_valid_multiple(void);
+void xtrtest_occurrences_valid_needle_longer_than_haystack(void);
+void xtrtest_occurrences_valid_non_overlapping(void);
+void xtrtest_occurrences_valid_none(void);
+void xtrtest_occurrences_valid_null(void);
+void xtrtest_parallel_fail_malloc(void);
+void xtrtest_parallel_valid_large_haystack(void);
+void xtrtest_parallel_valid_null(void);
+void xtrtest_parallel_valid_periodic_needle(void);
+void xtrtest_parallel_valid_small_haystack(void);
+void xtrtest_pattern_fail_malloc(void);
+void xtrtest_pattern_valid_empty(void);
+void xtrtest_pattern_valid_long_adversarial_input(void);
+void xtrtest_pattern_valid_long_needle(void);
+void xtrtest_pattern_valid_needle_copied(void);
+void xtrtest_pattern_valid_null(void);
+void xtrtest_pattern_valid_reused_across_haystacks(void);
+void xtrtest_regex_fail_malloc(void);
+void xtrtest_regex_invalid_syntax(void);
+void xtrtest_regex_valid_anchors(void);
+void xtrtest_regex_valid_classes(void);
+void xtrtest_regex_valid_find(void);
+void xtrtest_regex_valid_find_all(void);
+void xtrtest_regex_valid_leftmost_first(void);
+void xtrtest_regex_valid_literal_prefix(void);
+void xtrtest_regex_valid_many_states(void);
+void xtrtest_regex_valid_match(void);
+void xtrtest_regex_valid_null(void);
+void xtrtest_reserve_fail_malloc(void);
+void xtrtest_reserve_valid_extends_without_reallocating(void);
+void xtrtest_reserve_valid_shared(void);
+void xtrtest_resize_free_valid_grows(void);
+void xtrtest_rfind_valid_adversarial(void);
+void xtrtest_rfind_valid_empty(void);
+void xtrtest_rfind_valid_last_occurrence(void);
+void xtrtest_rfind_valid_long_haystack(void);
+void xtrtest_rfind_valid_needle_longer_than_haystack(void);
+void xtrtest_rfind_valid_null(void);
+void xtrtest_rfind_valid_overlapping(void);
+void xtrtest_rfind_valid_within(void);
+void xtrtest_rope_fail_malloc(void);
+void xtrtest_rope_valid_edit(void);
+void xtrtest_rope_valid_empty(void);
+void xtrtest_rope_valid_insert_shared(void);
+void xtrtest_rope_valid_null(void);
+void xtrtest_rope_valid_random_edits(void);
+void xtrtest_rope_valid_split_and_concat(void);
+void xtrtest_share_fail_malloc(void);
+void xtrtest_share_valid_and_release(void);
+void xtrtest_share_valid_clone_is_deep(void);
+void xtrtest_share_valid_copy_on_write(void);
+void xtrtest_share_valid_copy_on_write_null(void);
+void xtrtest_share_valid_in_place_changes_are_refused(void);
+void xtrtest_share_valid_null(void);
+void xtrtest_share_valid_replacing_functions(void);
+void xtrtest_share_valid_unshare(void);
+void xtrtest_slice_fail_malloc(void);
+void xtrtest_slice_valid_compact(void);
+void xtrtest_slice_valid_free_array_of_mixed_parents(void);
+void xtrtest_slice_valid_keeps_parent_alive(void);
+void xtrtest_slice_valid_null(void);
+void xtrtest_slice_valid_out_of_range(void);
+void xtrtest_slice_valid_pop(void);
+void xtrtest_slice_valid_split(void);
+void xtrtest_split_fail_malloc(void);
+void xtrtest_split_fail_malloc_every(void);
+void xtrtest_split_fail_malloc_views_and_packed(void);
+void xtrtest_split_valid_every(void);
+void xtrtest_split_valid_iter_as_split(void);
+void xtrtest_split_valid_iter_early_stop(void);
+void xtrtest_split_valid_iter_every(void);
+void xtrtest_split_valid_iter_null(void);
+void xtrtest_split_valid_many_chunks(void);
+void xtrtest_split_valid_no_separator(void);
+void xtrtest_split_valid_null(void);
+void xtrtest_split_valid_packed_many_chunks(void);
+void xtrtest_split_valid_separators(void);
+void xtrtest_split_valid_views_and_packed_as_split(void);
+void xtrtest_split_valid_views_into(void);
+void xtrtest_split_valid_views_null(void);
+void xtrtest_stream_search_fail_malloc(void);
+void xtrtest_stream_search_valid_non_overlapping(void);
+void xtrtest_stream_search_valid_null(void);
+void xtrtest_stream_search_valid_straddling_chunks(void);
+void xtrtest_stream_search_valid_within_chunks(void);
+void xtrtest_trim_valid_chars(void);
+void xtrtest_trim_valid_everything(void);
+void xtrtest_trim_valid_nothing(void);
+void xtrtest_trim_valid_null(void);
+void xtrtest_trim_valid_whitespace(void);
+void xtrtest_view_fail_malloc(void);
+void xtrtest_view_valid_classifiers(void);
+void xtrtest_view_valid_cmp(void);
+void xtrtest_view_valid_encoding(void);
+void xtrtest_view_valid_find(void);
+void xtrtest_view_valid_null(void);
+void xtrtest_view_valid_range(void);
+void xtrtest_view_valid_same_as_xtr(void);
 void xtrtest_zeros_fail_malloc(void);
 void xtrtest_zeros_valid_1_byte(void);
 void xtrtest_zeros_valid_6_bytes(void);
@@ -47,14 +47,59 @@ main(void)
     // clang-format off
     // @formatter: off
     // BEGIN OF AUTOMATED LISTING OF ALL XTRTEST TESTCASES
+    xtrtest_approx_fail_malloc();
+    xtrtest_approx_valid_edit_distance();
+    xtrtest_approx_valid_edit_distance_long();
+    xtrtest_approx_valid_edit_distance_random();
+    xtrtest_approx_valid_find();
+    xtrtest_approx_valid_find_extends();
+    xtrtest_approx_valid_find_long_needle();
+    xtrtest_approx_valid_null();
+    xtrtest_charset_fail_malloc();
+    xtrtest_charset_valid_contains();
+    xtrtest_charset_valid_find();
+    xtrtest_charset_valid_find_long();
+    xtrtest_charset_valid_null();
+    xtrtest_charset_valid_split_any();
+    xtrtest_charset_valid_split_any_edges();
     xtrtest_clone_valid_1_char_xtr();
+    xtrtest_clone_valid_6_char_xtr();
     xtrtest_clone_valid_empty_xtr();
-    xtrtest_clone_validaaaa_6_char_xtr();
     xtrtest_clone_with_capacity_valid_1_char_xtr_less_capacity();
     xtrtest_clone_with_capacity_valid_1_char_xtr_more_capacity();
     xtrtest_clone_with_capacity_valid_1_char_xtr_same_capacity();
     xtrtest_clone_with_capacity_valid_empty_xtr_more_capacity();
     xtrtest_clone_with_capacity_valid_empty_xtr_same_capacity();
+    xtrtest_compress_free_valid_drops_head_room();
+    xtrtest_compress_free_valid_shared();
+    xtrtest_csv_fail_malloc();
+    xtrtest_csv_valid_line_endings();
+    xtrtest_csv_valid_null();
+    xtrtest_csv_valid_quoted();
+    xtrtest_csv_valid_random();
+    xtrtest_csv_valid_reuse();
+    xtrtest_csv_valid_simple();
+    xtrtest_csv_valid_unterminated_quote();
+    xtrtest_expand_fail_malloc();
+    xtrtest_expand_valid_keeps_content();
+    xtrtest_expand_valid_large();
+    xtrtest_expand_valid_shared_copies();
+    xtrtest_find_all_fail_malloc();
+    xtrtest_find_all_valid();
+    xtrtest_find_next_valid_needle_longer_than_haystack();
+    xtrtest_find_next_valid_null();
+    xtrtest_find_next_valid_pattern();
+    xtrtest_find_next_valid_successive();
+    xtrtest_find_valid_1_byte_needle();
+    xtrtest_find_valid_across_vector_blocks();
+    xtrtest_find_valid_adversarial_input();
+    xtrtest_find_valid_empty();
+    xtrtest_find_valid_itself();
+    xtrtest_find_valid_long_needle();
+    xtrtest_find_valid_needle_longer_than_haystack();
+    xtrtest_find_valid_null();
+    xtrtest_find_valid_periodic_needle();
+    xtrtest_find_valid_short_needle();
     xtrtest_free_valid();
     xtrtest_free_valid_on_null_input();
     xtrtest_from_str_fail_malloc();
@@ -100,7 +145,45 @@ main(void)
     xtrtest_from_str_with_capacity_valid_empty_string_1_byte();
     xtrtest_from_str_with_capacity_valid_null_string_0_bytes();
     xtrtest_from_str_with_capacity_valid_null_string_6_bytes();
+    xtrtest_gapbuf_fail_malloc();
+    xtrtest_gapbuf_valid_conversions_without_copies();
+    xtrtest_gapbuf_valid_edit_at_cursor();
+    xtrtest_gapbuf_valid_move_farther_than_gap();
+    xtrtest_gapbuf_valid_null();
+    xtrtest_gapbuf_valid_random_edits();
+    xtrtest_gapbuf_valid_shared_xtring_is_copied();
     xtrtest_getters_do_nothing_on_null_input();
+    xtrtest_growth_fail_malloc();
+    xtrtest_growth_valid_extend_head_keeps_room_before_content();
+    xtrtest_growth_valid_extend_tail_reallocates_rarely();
+    xtrtest_growth_valid_global_policy();
+    xtrtest_growth_valid_per_call_policy();
+    xtrtest_growth_valid_size_class_rounding();
+    xtrtest_head_room_valid_copies_and_clear();
+    xtrtest_head_room_valid_extend_uses_the_room();
+    xtrtest_head_room_valid_gapbuf();
+    xtrtest_head_room_valid_pop_head_consumes_from_the_front();
+    xtrtest_head_room_valid_push_head_reuses_the_room();
+    xtrtest_head_room_valid_push_head_without_room_recenters();
+    xtrtest_head_room_valid_push_onto_itself();
+    xtrtest_head_room_valid_push_tail_compacts_only_when_needed();
+    xtrtest_head_room_valid_truncate_head_does_not_move_content();
+    xtrtest_icase_valid_cmp();
+    xtrtest_icase_valid_find();
+    xtrtest_icase_valid_find_long();
+    xtrtest_icase_valid_is_equal();
+    xtrtest_icase_valid_is_equal_only_letters_folded();
+    xtrtest_icase_valid_long();
+    xtrtest_icase_valid_null();
+    xtrtest_icase_valid_startswith_endswith();
+    xtrtest_index_fail_malloc();
+    xtrtest_index_valid_empty_text();
+    xtrtest_index_valid_find();
+    xtrtest_index_valid_longest_repeat();
+    xtrtest_index_valid_null();
+    xtrtest_index_valid_overlapping();
+    xtrtest_index_valid_random();
+    xtrtest_index_valid_serialised();
     xtrtest_is_empty_valid_empty();
     xtrtest_is_empty_valid_empty_with_capacity();
     xtrtest_is_empty_valid_non_empty();
@@ -113,6 +196,20 @@ main(void)
     xtrtest_is_spaces_valid_not_only_whitespaces();
     xtrtest_is_spaces_valid_null();
     xtrtest_is_spaces_valid_single_space();
+    xtrtest_lines_fail_malloc();
+    xtrtest_lines_valid_index_compact();
+    xtrtest_lines_valid_index_single_line_blocks();
+    xtrtest_lines_valid_iter();
+    xtrtest_lines_valid_iter_and_index_as_split();
+    xtrtest_lines_valid_null();
+    xtrtest_multipattern_fail_malloc();
+    xtrtest_multipattern_valid_all_byte_values();
+    xtrtest_multipattern_valid_count_each();
+    xtrtest_multipattern_valid_count_each_non_overlapping();
+    xtrtest_multipattern_valid_find_all_any();
+    xtrtest_multipattern_valid_find_all_any_many_matches();
+    xtrtest_multipattern_valid_find_any();
+    xtrtest_multipattern_valid_null();
     xtrtest_new_empty_fail_malloc();
     xtrtest_new_empty_valid();
     xtrtest_new_ensure_fail_size_overflow();
@@ -122,6 +219,106 @@ main(void)
     xtrtest_new_with_capacity_valid_allocate_15_bytes();
     xtrtest_new_with_capacity_valid_allocate_1_byte();
     xtrtest_new_with_capacity_valid_allocate_ffff_plus_1_bytes();
+    xtrtest_occurrences_valid_across_vector_blocks();
+    xtrtest_occurrences_valid_empty_haystack();
+    xtrtest_occurrences_valid_multiple();
+    xtrtest_occurrences_valid_needle_longer_than_haystack();
+    xtrtest_occurrences_valid_non_overlapping();
+    xtrtest_occurrences_valid_none();
+    xtrtest_occurrences_valid_null();
+    xtrtest_parallel_fail_malloc();
+    xtrtest_parallel_valid_large_haystack();
+    xtrtest_parallel_valid_null();
+    xtrtest_parallel_valid_periodic_needle();
+    xtrtest_parallel_valid_small_haystack();
+    xtrtest_pattern_fail_malloc();
+    xtrtest_pattern_valid_empty();
+    xtrtest_pattern_valid_long_adversarial_input();
+    xtrtest_pattern_valid_long_needle();
+    xtrtest_pattern_valid_needle_copied();
+    xtrtest_pattern_valid_null();
+    xtrtest_pattern_valid_reused_across_haystacks();
+    xtrtest_regex_fail_malloc();
+    xtrtest_regex_invalid_syntax();
+    xtrtest_regex_valid_anchors();
+    xtrtest_regex_valid_classes();
+    xtrtest_regex_valid_find();
+    xtrtest_regex_valid_find_all();
+    xtrtest_regex_valid_leftmost_first();
+    xtrtest_regex_valid_literal_prefix();
+    xtrtest_regex_valid_many_states();
+    xtrtest_regex_valid_match();
+    xtrtest_regex_valid_null();
+    xtrtest_reserve_fail_malloc();
+    xtrtest_reserve_valid_extends_without_reallocating();
+    xtrtest_reserve_valid_shared();
+    xtrtest_resize_free_valid_grows();
+    xtrtest_rfind_valid_adversarial();
+    xtrtest_rfind_valid_empty();
+    xtrtest_rfind_valid_last_occurrence();
+    xtrtest_rfind_valid_long_haystack();
+    xtrtest_rfind_valid_needle_longer_than_haystack();
+    xtrtest_rfind_valid_null();
+    xtrtest_rfind_valid_overlapping();
+    xtrtest_rfind_valid_within();
+    xtrtest_rope_fail_malloc();
+    xtrtest_rope_valid_edit();
+    xtrtest_rope_valid_empty();
+    xtrtest_rope_valid_insert_shared();
+    xtrtest_rope_valid_null();
+    xtrtest_rope_valid_random_edits();
+    xtrtest_rope_valid_split_and_concat();
+    xtrtest_share_fail_malloc();
+    xtrtest_share_valid_and_release();
+    xtrtest_share_valid_clone_is_deep();
+    xtrtest_share_valid_copy_on_write();
+    xtrtest_share_valid_copy_on_write_null();
+    xtrtest_share_valid_in_place_changes_are_refused();
+    xtrtest_share_valid_null();
+    xtrtest_share_valid_replacing_functions();
+    xtrtest_share_valid_unshare();
+    xtrtest_slice_fail_malloc();
+    xtrtest_slice_valid_compact();
+    xtrtest_slice_valid_free_array_of_mixed_parents();
+    xtrtest_slice_valid_keeps_parent_alive();
+    xtrtest_slice_valid_null();
+    xtrtest_slice_valid_out_of_range();
+    xtrtest_slice_valid_pop();
+    xtrtest_slice_valid_split();
+    xtrtest_split_fail_malloc();
+    xtrtest_split_fail_malloc_every();
+    xtrtest_split_fail_malloc_views_and_packed();
+    xtrtest_split_valid_every();
+    xtrtest_split_valid_iter_as_split();
+    xtrtest_split_valid_iter_early_stop();
+    xtrtest_split_valid_iter_every();
+    xtrtest_split_valid_iter_null();
+    xtrtest_split_valid_many_chunks();
+    xtrtest_split_valid_no_separator();
+    xtrtest_split_valid_null();
+    xtrtest_split_valid_packed_many_chunks();
+    xtrtest_split_valid_separators();
+    xtrtest_split_valid_views_and_packed_as_split();
+    xtrtest_split_valid_views_into();
+    xtrtest_split_valid_views_null();
+    xtrtest_stream_search_fail_malloc();
+    xtrtest_stream_search_valid_non_overlapping();
+    xtrtest_stream_search_valid_null();
+    xtrtest_stream_search_valid_straddling_chunks();
+    xtrtest_stream_search_valid_within_chunks();
+    xtrtest_trim_valid_chars();
+    xtrtest_trim_valid_everything();
+    xtrtest_trim_valid_nothing();
+    xtrtest_trim_valid_null();
+    xtrtest_trim_valid_whitespace();
+    xtrtest_view_fail_malloc();
+    xtrtest_view_valid_classifiers();
+    xtrtest_view_valid_cmp();
+    xtrtest_view_valid_encoding();
+    xtrtest_view_valid_find();
+    xtrtest_view_valid_null();
+    xtrtest_view_valid_range();
+    xtrtest_view_valid_same_as_xtr();
     xtrtest_zeros_fail_malloc();
     xtrtest_zeros_valid_1_byte();
     xtrtest_zeros_valid_6_bytes();
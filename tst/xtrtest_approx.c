@@ -0,0 +1,289 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+/** Edit distance with the textbook quadratic dynamic programming. */
+static size_t
+reference_distance(const uint8_t* const a,
+                   const size_t a_len,
+                   const uint8_t* const b,
+                   const size_t b_len)
+{
+    size_t* const row = malloc((b_len + 1) * sizeof(size_t));
+    if (row == NULL)
+    {
+        return XTR_NOT_FOUND;
+    }
+    for (size_t j = 0; j <= b_len; j++)
+    {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a_len; i++)
+    {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b_len; j++)
+        {
+            const size_t above = row[j];
+            const size_t substitution = diagonal + (a[i - 1] != b[j - 1]);
+            const size_t indel = (above < row[j - 1] ? above : row[j - 1]) + 1;
+            row[j] = substitution < indel ? substitution : indel;
+            diagonal = above;
+        }
+    }
+    const size_t distance = row[b_len];
+    free(row);
+    return distance;
+}
+
+/** Fills with pseudo-random bytes of a small alphabet. */
+static void
+fill_random(uint8_t* const bytes, const size_t len, uint32_t* const random, const uint8_t letters)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        *random = *random * 1103515245U + 12345U;
+        bytes[i] = (uint8_t) ('a' + (*random >> 16U) % letters);
+    }
+}
+
+void
+xtrtest_approx_valid_null(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    size_t length = 42;
+    atto_eq(xtr_find_approx(NULL, haystack, 1, &length), XTR_NOT_FOUND);
+    atto_eq(length, 0);
+    atto_eq(xtr_find_approx(haystack, NULL, 1, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_edit_distance(NULL, haystack), XTR_NOT_FOUND);
+    atto_eq(xtr_edit_distance(haystack, NULL), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_approx_valid_find(void)
+{
+    xtr_t* haystack = xtr_from_str("the quick brown fox jumps over the lazy dog");
+    xtr_t* exact = xtr_from_str("lazy");
+    xtr_t* typo = xtr_from_str("brwn");
+    xtr_t* swapped = xtr_from_str("jmups");
+    xtr_t* missing = xtr_from_str("cat");
+    xtr_t* empty = xtr_new_empty();
+    size_t length = 42;
+    atto_eq(xtr_find_approx(haystack, exact, 0, &length), 35);
+    atto_eq(length, 4);
+    atto_eq(xtr_find_approx(haystack, typo, 0, &length), XTR_NOT_FOUND);
+    atto_eq(length, 0);
+    atto_eq(xtr_find_approx(haystack, typo, 1, &length), 10);
+    atto_eq(length, 5);
+    atto_eq(xtr_find_approx(haystack, swapped, 1, &length), XTR_NOT_FOUND);
+    atto_eq(xtr_find_approx(haystack, swapped, 2, &length), 20);
+    atto_eq(length, 5);
+    atto_eq(xtr_find_approx(haystack, missing, 1, &length), XTR_NOT_FOUND);
+    atto_eq(xtr_find_approx(haystack, missing, 2, &length), 0);
+    atto_eq(length, 1);
+    atto_eq(xtr_find_approx(haystack, missing, 3, &length), 0);
+    atto_eq(length, 0);
+    atto_eq(xtr_find_approx(haystack, empty, 0, &length), 0);
+    atto_eq(length, 0);
+    atto_eq(xtr_find_approx(empty, exact, 2, &length), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&exact);
+    xtr_free(&typo);
+    xtr_free(&swapped);
+    xtr_free(&missing);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_approx_valid_find_extends(void)
+{
+    xtr_t* haystack = xtr_from_str("xabcx");
+    xtr_t* needle = xtr_from_str("abc");
+    size_t length = 42;
+    // The distance first drops to 1 at "ab", then to 0 at "abc"
+    atto_eq(xtr_find_approx(haystack, needle, 1, &length), 1);
+    atto_eq(length, 3);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+/** Counts whether the found section is not within the edit distance. */
+static size_t
+wrong_section(const uint8_t* const bytes,
+              const size_t index,
+              const size_t length,
+              const xtr_t* const needle,
+              const size_t max_edits)
+{
+    xtr_t* section = xtr_from_bytes(&bytes[index], length);
+    const size_t distance = xtr_edit_distance(section, needle);
+    xtr_free(&section);
+    return distance > max_edits;
+}
+
+void
+xtrtest_approx_valid_find_long_needle(void)
+{
+    // Needles of multiple 64-bit blocks, found after a few edits
+    uint8_t bytes[5000];
+    uint32_t random = 7;
+    size_t mismatches = 0;
+    for (size_t needle_len = 60; needle_len <= 300; needle_len += 40)
+    {
+        fill_random(bytes, sizeof(bytes), &random, 4);
+        const size_t index = 4000 - needle_len;
+        uint8_t needle_bytes[300];
+        memcpy(needle_bytes, &bytes[index], needle_len);
+        needle_bytes[5] = 'x';
+        needle_bytes[needle_len / 2] = 'y';
+        needle_bytes[needle_len - 6] = 'z';
+        xtr_t* haystack = xtr_from_bytes(bytes, sizeof(bytes));
+        xtr_t* needle = xtr_from_bytes(needle_bytes, needle_len);
+        size_t length = 42;
+        mismatches += xtr_find_approx(haystack, needle, 2, &length) != XTR_NOT_FOUND;
+        mismatches += xtr_find_approx(haystack, needle, 3, &length) != index;
+        mismatches += wrong_section(bytes, index, length, needle, 3);
+        // Deleting a byte from the haystack costs one more edit
+        xtr_free(&haystack);
+        memmove(&bytes[index + 10], &bytes[index + 11], sizeof(bytes) - index - 11);
+        haystack = xtr_from_bytes(bytes, sizeof(bytes) - 1);
+        mismatches += xtr_find_approx(haystack, needle, 3, &length) != XTR_NOT_FOUND;
+        mismatches += xtr_find_approx(haystack, needle, 4, &length) != index;
+        mismatches += wrong_section(bytes, index, length, needle, 4);
+        xtr_free(&haystack);
+        xtr_free(&needle);
+    }
+    atto_eq(mismatches, 0);
+}
+
+void
+xtrtest_approx_valid_edit_distance(void)
+{
+    xtr_t* kitten = xtr_from_str("kitten");
+    xtr_t* sitting = xtr_from_str("sitting");
+    xtr_t* empty = xtr_new_empty();
+    atto_eq(xtr_edit_distance(kitten, sitting), 3);
+    atto_eq(xtr_edit_distance(sitting, kitten), 3);
+    atto_eq(xtr_edit_distance(kitten, kitten), 0);
+    atto_eq(xtr_edit_distance(kitten, empty), 6);
+    atto_eq(xtr_edit_distance(empty, sitting), 7);
+    atto_eq(xtr_edit_distance(empty, empty), 0);
+    xtr_free(&kitten);
+    xtr_free(&sitting);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_approx_valid_edit_distance_random(void)
+{
+    uint8_t a[400];
+    uint8_t b[400];
+    uint32_t random = 3;
+    size_t mismatches = 0;
+    for (size_t round = 0; round < 300; round++)
+    {
+        const size_t a_len = (round * 37) % sizeof(a);
+        const size_t b_len = (round * 91) % sizeof(b);
+        fill_random(a, a_len, &random, (uint8_t) (2 + round % 5));
+        fill_random(b, b_len, &random, (uint8_t) (2 + round % 5));
+        if (round % 2 == 0)
+        {
+            memcpy(b, a, a_len < b_len ? a_len : b_len);  // Similar ones
+        }
+        xtr_t* xa = xtr_from_bytes(a, a_len);
+        xtr_t* xb = xtr_from_bytes(b, b_len);
+        mismatches += xtr_edit_distance(xa, xb) != reference_distance(a, a_len, b, b_len);
+        xtr_free(&xa);
+        xtr_free(&xb);
+    }
+    atto_eq(mismatches, 0);
+}
+
+void
+xtrtest_approx_valid_edit_distance_long(void)
+{
+    // Few edits between long xtrings, within the narrowest band
+    static uint8_t a[3000];
+    static uint8_t b[3000];
+    uint32_t random = 11;
+    fill_random(a, sizeof(a), &random, 26);
+    memcpy(b, a, sizeof(b));
+    size_t b_len = sizeof(b);
+    for (size_t i = 100; i < 2800; i += 150)
+    {
+        b[i] = '#';
+        memmove(&b[i + 50], &b[i + 51], b_len - i - 51);
+        b_len--;
+    }
+    xtr_t* xa = xtr_from_bytes(a, sizeof(a));
+    xtr_t* xb = xtr_from_bytes(b, b_len);
+    atto_eq(xtr_edit_distance(xa, xb), reference_distance(a, sizeof(a), b, b_len));
+    // Unrelated ones, widening the band to the whole matrix
+    fill_random(b, sizeof(b), &random, 26);
+    xtr_free(&xb);
+    xb = xtr_from_bytes(b, 2000);
+    atto_eq(xtr_edit_distance(xa, xb), reference_distance(a, sizeof(a), b, 2000));
+    xtr_free(&xa);
+    xtr_free(&xb);
+}
+
+void
+xtrtest_approx_fail_malloc(void)
+{
+    // Needles of a single block need no allocation
+    xtr_t* haystack = xtr_from_str_repeat("abcd", 40);
+    xtr_t* needle = xtr_from_str("bcda");
+    xtr_t* long_needle = xtr_from_str_repeat("bcda", 20);
+    size_t length = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_find_approx(haystack, needle, 1, &length), 1);
+    atto_eq(length, 4);
+    atto_eq(xtr_edit_distance(haystack, needle), 156);
+    xtrtest_malloc_disable_failing();
+    for (size_t successes = 0; successes < 2; successes++)
+    {
+        xtrtest_malloc_fail_after(successes);
+        atto_eq(xtr_find_approx(haystack, long_needle, 1, &length), XTR_NOT_FOUND);
+        atto_eq(length, 0);
+    }
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_edit_distance(haystack, long_needle), XTR_NOT_FOUND);
+    xtrtest_malloc_disable_failing();
+    atto_eq(xtr_find_approx(haystack, long_needle, 1, &length), 1);
+    atto_eq(length, 80);
+    atto_eq(xtr_edit_distance(haystack, long_needle), 80);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&long_needle);
+}
@@ -0,0 +1,193 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+
+void
+xtrtest_charset_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_charset_t set;
+    xtr_charset_init(NULL, "abc");
+    xtr_charset_init_bytes(NULL, NULL, 0);
+    xtr_charset_init(&set, "b");
+    atto_false(xtr_charset_contains(NULL, 'b'));
+    atto_eq(xtr_find_first_of(NULL, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_find_first_of(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find_first_not_of(NULL, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_find_first_not_of(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find_last_of(NULL, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_find_last_of(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find_last_not_of(NULL, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_find_last_not_of(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_span(NULL, &set), 0);
+    atto_eq(xtr_span(xtr, NULL), 0);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_charset_valid_contains(void)
+{
+    xtr_charset_t set;
+    xtr_charset_init(&set, "az09\x7F\x80\xFF");
+    size_t members = 0;
+    for (unsigned int byte = 0; byte <= UINT8_MAX; byte++)
+    {
+        members += xtr_charset_contains(&set, (uint8_t) byte);
+    }
+    atto_eq(members, 7);
+    atto_true(xtr_charset_contains(&set, 'a'));
+    atto_true(xtr_charset_contains(&set, '9'));
+    atto_true(xtr_charset_contains(&set, 0x80));
+    atto_true(xtr_charset_contains(&set, 0xFF));
+    atto_false(xtr_charset_contains(&set, 'b'));
+    atto_false(xtr_charset_contains(&set, 0));
+    xtr_charset_init(&set, NULL);
+    atto_true(xtr_charset_contains(&set, ' '));
+    atto_true(xtr_charset_contains(&set, '\t'));
+    atto_true(xtr_charset_contains(&set, '\r'));
+    atto_false(xtr_charset_contains(&set, 'a'));
+    const uint8_t zero = 0;
+    xtr_charset_init_bytes(&set, &zero, 1);
+    atto_true(xtr_charset_contains(&set, 0));
+    atto_false(xtr_charset_contains(&set, ' '));
+}
+
+void
+xtrtest_charset_valid_find(void)
+{
+    xtr_t* xtr = xtr_from_str("key=value;x");
+    xtr_charset_t set;
+    xtr_charset_init(&set, "=;");
+    atto_eq(xtr_find_first_of(xtr, &set), 3);
+    atto_eq(xtr_find_last_of(xtr, &set), 9);
+    atto_eq(xtr_find_first_not_of(xtr, &set), 0);
+    atto_eq(xtr_find_last_not_of(xtr, &set), 10);
+    xtr_charset_init(&set, "keyvalux=;");
+    atto_eq(xtr_find_first_not_of(xtr, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_find_last_not_of(xtr, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_span(xtr, &set), 11);
+    xtr_charset_init(&set, "#");
+    atto_eq(xtr_find_first_of(xtr, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_find_last_of(xtr, &set), XTR_NOT_FOUND);
+    atto_eq(xtr_span(xtr, &set), 0);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_charset_valid_find_long(void)
+{
+    // Members at both ends of an xtring longer than any SIMD vector
+    xtr_t* xtr = xtr_from_str_repeat("0123456789", 20);
+    xtr_charset_t digits;
+    xtr_charset_t high;
+    xtr_charset_init(&digits, "012345678");
+    xtr_charset_init(&high, "9\xFF");
+    atto_eq(xtr_span(xtr, &digits), 9);
+    atto_eq(xtr_find_first_of(xtr, &high), 9);
+    atto_eq(xtr_find_last_of(xtr, &high), 199);
+    atto_eq(xtr_find_last_not_of(xtr, &high), 198);
+    atto_eq(xtr_find_last_not_of(xtr, &digits), 199);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_charset_valid_split_any(void)
+{
+    xtr_t* xtr = xtr_from_str("a, b;c");
+    xtr_charset_t set;
+    xtr_charset_init(&set, ",; ");
+    size_t amount = 42;
+    atto_eq(xtr_split_any(NULL, xtr, &set), NULL);
+    atto_eq(xtr_split_any(&amount, NULL, &set), NULL);
+    atto_eq(xtr_split_any(&amount, xtr, NULL), NULL);
+    xtr_t** chunks = xtr_split_any(&amount, xtr, &set);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 4);
+    atto_streq(xtr_cstring(chunks[0]), "a", 10);
+    atto_streq(xtr_cstring(chunks[1]), "", 10);
+    atto_streq(xtr_cstring(chunks[2]), "b", 10);
+    atto_streq(xtr_cstring(chunks[3]), "c", 10);
+    for (size_t i = 0; i < amount; i++)
+    {
+        xtr_free(&chunks[i]);
+    }
+    free(chunks);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_charset_valid_split_any_edges(void)
+{
+    xtr_t* xtr = xtr_from_str(";x;");
+    xtr_t* empty = xtr_new_empty();
+    xtr_charset_t set;
+    xtr_charset_init(&set, ";");
+    size_t amount = 42;
+    xtr_t** chunks = xtr_split_any(&amount, xtr, &set);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 3);
+    atto_streq(xtr_cstring(chunks[0]), "", 10);
+    atto_streq(xtr_cstring(chunks[1]), "x", 10);
+    atto_streq(xtr_cstring(chunks[2]), "", 10);
+    for (size_t i = 0; i < amount; i++)
+    {
+        xtr_free(&chunks[i]);
+    }
+    free(chunks);
+    chunks = xtr_split_any(&amount, empty, &set);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 1);
+    atto_eq(xtr_length(chunks[0]), 0);
+    xtr_free(&chunks[0]);
+    free(chunks);
+    xtr_free(&xtr);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_charset_fail_malloc(void)
+{
+    xtr_t* xtr = xtr_from_str_repeat("ab;", 20);
+    xtr_charset_t set;
+    xtr_charset_init(&set, ";");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_split_any(&amount, xtr, &set), NULL);
+    xtrtest_malloc_fail_after(5);
+    atto_eq(xtr_split_any(&amount, xtr, &set), NULL);
+    xtrtest_malloc_fail_after(9);
+    atto_eq(xtr_split_any(&amount, xtr, &set), NULL);
+    atto_eq(amount, 42);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&xtr);
+}
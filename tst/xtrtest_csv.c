@@ -0,0 +1,312 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+/** Checks a field of the last parsing against a C-string. */
+static bool
+field_is(const xtr_csv_t* const csv, const size_t record, const size_t field, const char* const str)
+{
+    xtr_view_t expected;
+    xtr_view_t actual;
+    xtr_view_from_str(&expected, str);
+    return xtr_csv_field(&actual, csv, record, field) && xtr_view_is_equal(actual, expected);
+}
+
+void
+xtrtest_csv_valid_null(void)
+{
+    xtr_t* text = xtr_from_str("a,b\n");
+    xtr_csv_t* csv = NULL;
+    atto_eq(xtr_csv_new(',', ','), NULL);
+    atto_eq(xtr_csv_new('\n', '"'), NULL);
+    atto_eq(xtr_csv_new(',', '\r'), NULL);
+    xtr_csv_free(NULL);
+    xtr_csv_free(&csv);
+    atto_false(xtr_csv_parse(NULL, text));
+    atto_eq(xtr_csv_records(NULL), 0);
+    atto_eq(xtr_csv_fields(NULL, 0U), 0);
+    xtr_view_t field;
+    atto_false(xtr_csv_field(&field, NULL, 0U, 0U));
+    atto_eq(field.bytes, NULL);
+    atto_eq(xtr_csv_field_unescaped(NULL, 0U, 0U), NULL);
+    csv = xtr_csv_new(',', '"');
+    atto_neq(csv, NULL);
+    atto_false(xtr_csv_parse(csv, NULL));
+    atto_eq(xtr_csv_records(csv), 0);
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_fields(csv, 1U), 0);
+    atto_false(xtr_csv_field(NULL, csv, 0U, 0U));
+    atto_false(xtr_csv_field(&field, csv, 0U, 2U));
+    atto_eq(field.bytes, NULL);
+    atto_false(xtr_csv_field(&field, csv, 1U, 0U));
+    atto_eq(field.bytes, NULL);
+    atto_eq(xtr_csv_field_unescaped(csv, 0U, 2U), NULL);
+    xtr_csv_free(&csv);
+    atto_eq(csv, NULL);
+    xtr_free(&text);
+}
+
+void
+xtrtest_csv_valid_simple(void)
+{
+    xtr_t* text = xtr_from_str("name,age\nalice,30\nbob,\n");
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 3);
+    atto_eq(xtr_csv_fields(csv, 0U), 2);
+    atto_eq(xtr_csv_fields(csv, 1U), 2);
+    atto_eq(xtr_csv_fields(csv, 2U), 2);
+    atto_true(field_is(csv, 0U, 0U, "name"));
+    atto_true(field_is(csv, 0U, 1U, "age"));
+    atto_true(field_is(csv, 1U, 0U, "alice"));
+    atto_true(field_is(csv, 1U, 1U, "30"));
+    atto_true(field_is(csv, 2U, 0U, "bob"));
+    atto_true(field_is(csv, 2U, 1U, ""));
+    // Views into the text, no copies
+    xtr_view_t field;
+    atto_true(xtr_csv_field(&field, csv, 1U, 0U));
+    atto_eq(field.bytes, xtr_bytes(text) + 9);
+    xtr_csv_free(&csv);
+    xtr_free(&text);
+}
+
+void
+xtrtest_csv_valid_line_endings(void)
+{
+    xtr_csv_t* csv = xtr_csv_new('\t', '"');
+    // CRLF, empty line, no trailing newline
+    xtr_t* text = xtr_from_str("a\tb\r\n\r\n\nc\r");
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 4);
+    atto_eq(xtr_csv_fields(csv, 0U), 2);
+    atto_true(field_is(csv, 0U, 1U, "b"));
+    atto_eq(xtr_csv_fields(csv, 1U), 1);
+    atto_true(field_is(csv, 1U, 0U, ""));
+    atto_eq(xtr_csv_fields(csv, 2U), 1);
+    atto_true(field_is(csv, 2U, 0U, ""));
+    // A lone carriage return is content
+    atto_true(field_is(csv, 3U, 0U, "c\r"));
+    xtr_free(&text);
+    // Empty text
+    text = xtr_new_empty();
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 0);
+    xtr_free(&text);
+    text = xtr_from_str("\n");
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 1);
+    atto_true(field_is(csv, 0U, 0U, ""));
+    xtr_free(&text);
+    xtr_csv_free(&csv);
+}
+
+void
+xtrtest_csv_valid_quoted(void)
+{
+    xtr_t* text = xtr_from_str("\"a,b\",\"line\nbreak\",\"say \"\"hi\"\"\"\r\n\"\",x\"y\"\n");
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 2);
+    atto_eq(xtr_csv_fields(csv, 0U), 3);
+    atto_true(field_is(csv, 0U, 0U, "a,b"));
+    atto_true(field_is(csv, 0U, 1U, "line\nbreak"));
+    atto_true(field_is(csv, 0U, 2U, "say \"\"hi\"\""));
+    xtr_t* unescaped = xtr_csv_field_unescaped(csv, 0U, 2U);
+    atto_streq(xtr_cstring(unescaped), "say \"hi\"", 20);
+    xtr_free(&unescaped);
+    unescaped = xtr_csv_field_unescaped(csv, 0U, 0U);
+    atto_streq(xtr_cstring(unescaped), "a,b", 20);
+    xtr_free(&unescaped);
+    atto_eq(xtr_csv_fields(csv, 1U), 2);
+    atto_true(field_is(csv, 1U, 0U, ""));
+    // Not quoted, as it does not start with a quote: kept as-is
+    atto_true(field_is(csv, 1U, 1U, "x\"y\""));
+    unescaped = xtr_csv_field_unescaped(csv, 1U, 1U);
+    atto_streq(xtr_cstring(unescaped), "x\"y\"", 20);
+    xtr_free(&unescaped);
+    xtr_csv_free(&csv);
+    xtr_free(&text);
+}
+
+void
+xtrtest_csv_valid_unterminated_quote(void)
+{
+    xtr_t* text = xtr_from_str("a,\"b\nc,d\n");
+    xtr_t* valid = xtr_from_str("a,b\n");
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    atto_true(xtr_csv_parse(csv, valid));
+    atto_false(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 0);
+    xtr_view_t field;
+    atto_false(xtr_csv_field(&field, csv, 0U, 0U));
+    atto_eq(field.bytes, NULL);
+    xtr_csv_free(&csv);
+    xtr_free(&text);
+    xtr_free(&valid);
+}
+
+/** Field boundaries by a byte-at-a-time state machine, to compare with. */
+static size_t
+reference_field_ends(size_t* const ends, size_t* const record_ends, const uint8_t* const text,
+                     const size_t len)
+{
+    size_t fields = 0U;
+    size_t records = 0U;
+    bool inside = false;
+    for (size_t i = 0U; i < len; i++)
+    {
+        if (text[i] == '"')
+        {
+            inside = !inside;
+        }
+        else if (!inside && (text[i] == ',' || text[i] == '\n'))
+        {
+            ends[fields++] = i;
+            if (text[i] == '\n')
+            {
+                record_ends[records++] = fields;
+            }
+        }
+    }
+    if (len > 0U && text[len - 1U] != '\n')
+    {
+        ends[fields++] = len;
+        record_ends[records++] = fields;
+    }
+    return records;
+}
+
+void
+xtrtest_csv_valid_random(void)
+{
+    // Structural bytes dense enough to straddle the 64-byte blocks in any way
+    static const uint8_t ALPHABET[] = {'a', 'b', ',', ',', '\n', '"', '"', '\r'};
+    const size_t max_len = 700U;
+    uint8_t* bytes = malloc(max_len);
+    size_t* ends = malloc((max_len + 1U) * sizeof(size_t));
+    size_t* record_ends = malloc((max_len + 1U) * sizeof(size_t));
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    uint32_t random = 42U;
+    size_t mismatches = 0U;
+    for (size_t round = 0U; round < 300U; round++)
+    {
+        const size_t len = round * 7U % max_len;
+        for (size_t i = 0U; i < len; i++)
+        {
+            random = random * 1103515245U + 12345U;
+            bytes[i] = ALPHABET[(random >> 16U) % sizeof(ALPHABET)];
+        }
+        // Balanced quotes: drop the first one if odd
+        size_t quotes = 0U;
+        for (size_t i = 0U; i < len; i++)
+        {
+            quotes += bytes[i] == '"';
+        }
+        for (size_t i = 0U; i < len && quotes % 2U == 1U; i++)
+        {
+            if (bytes[i] == '"')
+            {
+                bytes[i] = 'a';
+                quotes--;
+            }
+        }
+        xtr_t* text = xtr_from_bytes(bytes, len);
+        const size_t records = reference_field_ends(ends, record_ends, bytes, len);
+        mismatches += !xtr_csv_parse(csv, text);
+        mismatches += xtr_csv_records(csv) != records;
+        size_t index = 0U;
+        for (size_t r = 0U; r < records && r < xtr_csv_records(csv); r++)
+        {
+            const size_t fields = record_ends[r] - (r == 0U ? 0U : record_ends[r - 1U]);
+            mismatches += xtr_csv_fields(csv, r) != fields;
+            for (size_t f = 0U; f < fields; f++, index++)
+            {
+                // Field views end where the reference fields end, minus CR or quote
+                xtr_view_t field;
+                mismatches += !xtr_csv_field(&field, csv, r, f);
+                const size_t end = (size_t) (field.bytes - xtr_bytes(text)) + field.length;
+                mismatches += end > ends[index] || end + 2U < ends[index];
+            }
+        }
+        xtr_free(&text);
+    }
+    atto_eq(mismatches, 0);
+    xtr_csv_free(&csv);
+    free(bytes);
+    free(ends);
+    free(record_ends);
+}
+
+void
+xtrtest_csv_valid_reuse(void)
+{
+    xtr_t* large = xtr_from_str_repeat("a,\"b\",c\n", 1000);
+    xtr_t* small = xtr_from_str("x,y");
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    atto_true(xtr_csv_parse(csv, large));
+    atto_eq(xtr_csv_records(csv), 1000);
+    atto_eq(xtr_csv_fields(csv, 999U), 3);
+    atto_true(field_is(csv, 999U, 1U, "b"));
+    // No allocation after a larger text
+    xtrtest_malloc_fail_after(0);
+    atto_true(xtr_csv_parse(csv, small));
+    atto_true(xtr_csv_parse(csv, large));
+    xtrtest_malloc_disable_failing();
+    atto_true(xtr_csv_parse(csv, small));
+    atto_eq(xtr_csv_records(csv), 1);
+    atto_eq(xtr_csv_fields(csv, 0U), 2);
+    atto_true(field_is(csv, 0U, 1U, "y"));
+    xtr_csv_free(&csv);
+    xtr_free(&large);
+    xtr_free(&small);
+}
+
+void
+xtrtest_csv_fail_malloc(void)
+{
+    xtr_t* text = xtr_from_str_repeat("a,\"b\",c\n", 100);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_csv_new(',', '"'), NULL);
+    xtr_csv_t* csv = xtr_csv_new(',', '"');
+    xtrtest_malloc_fail_after(0);
+    atto_false(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 0);
+    xtrtest_malloc_fail_after(1);
+    atto_false(xtr_csv_parse(csv, text));
+    atto_true(xtr_csv_parse(csv, text));
+    atto_eq(xtr_csv_records(csv), 100);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_csv_field_unescaped(csv, 0U, 1U), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_csv_free(&csv);
+    xtr_free(&text);
+}
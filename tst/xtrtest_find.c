@@ -0,0 +1,152 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_find_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    atto_eq(xtr_find(NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find(NULL, xtr), XTR_NOT_FOUND);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_find_valid_empty(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    atto_eq(xtr_find(haystack, empty), XTR_NOT_FOUND);
+    atto_eq(xtr_find(empty, haystack), XTR_NOT_FOUND);
+    atto_eq(xtr_find(empty, empty), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_find_valid_needle_longer_than_haystack(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* needle = xtr_from_str("abcd");
+    atto_eq(xtr_find(haystack, needle), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_valid_itself(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world!");
+    atto_eq(xtr_find(haystack, haystack), 0);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_find_valid_1_byte_needle(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world!");
+    xtr_t* needle = xtr_from_str("o");
+    atto_eq(xtr_find(haystack, needle), 4);
+    atto_eq(xtr_find_from(haystack, needle, 5), 7);
+    atto_eq(xtr_find_from(haystack, needle, 8), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_valid_short_needle(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world!");
+    xtr_t* needle = xtr_from_str("ld!");
+    atto_eq(xtr_find(haystack, needle), 9);
+    atto_eq(xtr_find_within(haystack, needle, 0, 11), XTR_NOT_FOUND);
+    atto_eq(xtr_find_within(haystack, needle, 0, 12), 9);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_valid_long_needle(void)
+{
+    xtr_t* haystack = xtr_from_str("The quick brown fox jumps over the lazy dog");
+    xtr_t* needle = xtr_from_str("jumps over");
+    xtr_t* absent = xtr_from_str("jumps under");
+    atto_eq(xtr_find(haystack, needle), 20);
+    atto_eq(xtr_find(haystack, absent), XTR_NOT_FOUND);
+    atto_true(xtr_contains(haystack, needle));
+    atto_false(xtr_contains(haystack, absent));
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&absent);
+}
+
+void
+xtrtest_find_valid_periodic_needle(void)
+{
+    xtr_t* haystack = xtr_from_str("abababcabababababc");
+    xtr_t* needle = xtr_from_str("abababababc");
+    atto_eq(xtr_find(haystack, needle), 7);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_valid_adversarial_input(void)
+{
+    // Quadratic for naive searches: each position matches almost the entire needle
+    xtr_t* as = xtr_from_byte_repeat('a', 100000);
+    xtr_t* b = xtr_from_str("b");
+    xtr_t* haystack = xtr_concat(as, b);
+    xtr_truncate_tail(as, 100000 - 999);
+    xtr_t* needle = xtr_concat(as, b);
+    atto_eq(xtr_length(needle), 1000);
+    atto_eq(xtr_find_within(haystack, needle, 0, 100000), XTR_NOT_FOUND);
+    atto_eq(xtr_find(haystack, needle), 100000 - 999);
+    xtr_free(&as);
+    xtr_free(&b);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_valid_across_vector_blocks(void)
+{
+    // Long enough for multiple SIMD blocks, needles straddle block borders
+    xtr_t* haystack = xtr_from_str_repeat("0123456789abcdefghijklmnopqrstuvwxyz", 10);
+    xtr_t* needle = xtr_from_str("xyz0123");
+    atto_eq(xtr_find(haystack, needle), 33);
+    atto_eq(xtr_find_from(haystack, needle, 34), 69);
+    atto_eq(xtr_find_from(haystack, needle, 322), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
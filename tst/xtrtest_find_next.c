@@ -0,0 +1,143 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+void
+xtrtest_find_next_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    xtr_cursor_t cursor;
+    atto_eq(xtr_find_next(NULL), XTR_NOT_FOUND);
+    xtr_cursor_init(NULL, xtr, xtr);
+    xtr_cursor_init(&cursor, NULL, xtr);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_cursor_init(&cursor, xtr, NULL);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_cursor_init(&cursor, xtr, empty);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_cursor_init_pattern(&cursor, xtr, NULL);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_free(&xtr);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_find_next_valid_successive(void)
+{
+    xtr_t* haystack = xtr_from_str("abcaaaabcaa");
+    xtr_t* needle = xtr_from_str("aa");
+    xtr_cursor_t cursor;
+    xtr_cursor_init(&cursor, haystack, needle);
+    atto_eq(xtr_find_next(&cursor), 3);
+    atto_eq(xtr_find_next(&cursor), 5);
+    atto_eq(xtr_find_next(&cursor), 9);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_next_valid_pattern(void)
+{
+    xtr_t* haystack = xtr_from_str("one two one two one");
+    xtr_t* needle = xtr_from_str("one");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    xtr_cursor_t cursor;
+    xtr_cursor_init_pattern(&cursor, haystack, pattern);
+    atto_eq(xtr_find_next(&cursor), 0);
+    atto_eq(xtr_find_next(&cursor), 8);
+    atto_eq(xtr_find_next(&cursor), 16);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_pattern_free(&pattern);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_next_valid_needle_longer_than_haystack(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* needle = xtr_from_str("abcd");
+    xtr_cursor_t cursor;
+    xtr_cursor_init(&cursor, haystack, needle);
+    atto_eq(xtr_find_next(&cursor), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_find_all_valid(void)
+{
+    xtr_t* haystack = xtr_from_str_repeat("ab", 100);
+    xtr_t* needle = xtr_from_str("ba");
+    xtr_t* absent = xtr_from_str("c");
+    size_t amount = 42;
+    atto_eq(xtr_find_all(NULL, haystack, needle), NULL);
+    atto_eq(xtr_find_all(&amount, NULL, needle), NULL);
+    atto_eq(xtr_find_all(&amount, haystack, NULL), NULL);
+    size_t* indices = xtr_find_all(&amount, haystack, needle);
+    atto_neq(indices, NULL);
+    atto_eq(amount, 99);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < amount; i++)
+    {
+        mismatches += indices[i] != 2 * i + 1;
+    }
+    atto_eq(mismatches, 0);
+    free(indices);
+    indices = xtr_find_all(&amount, haystack, absent);
+    atto_neq(indices, NULL);
+    atto_eq(amount, 0);
+    free(indices);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&absent);
+}
+
+void
+xtrtest_find_all_fail_malloc(void)
+{
+    xtr_t* haystack = xtr_from_str_repeat("ab", 100);
+    xtr_t* needle = xtr_from_str("ab");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_find_all(&amount, haystack, needle), NULL);
+    atto_eq(amount, 0);
+    xtrtest_malloc_fail_after(1);
+    atto_eq(xtr_find_all(&amount, haystack, needle), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
@@ -0,0 +1,286 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+/** Reference content of the random gap buffer test. */
+#define GAPBUF_REFERENCE_LEN 8192U
+
+/** Inserts a C-string at the cursor. */
+static bool
+insert_str(xtr_gapbuf_t* const gapbuf, const char* const str)
+{
+    xtr_view_t text;
+    xtr_view_from_str(&text, str);
+    return xtr_gapbuf_insert(gapbuf, text);
+}
+
+void
+xtrtest_gapbuf_valid_null(void)
+{
+    xtr_gapbuf_t gapbuf;
+    xtr_t* null = NULL;
+    atto_false(xtr_gapbuf_init(NULL, &null));
+    atto_false(xtr_gapbuf_init(&gapbuf, NULL));
+    atto_false(xtr_gapbuf_init(&gapbuf, &null));
+    xtr_gapbuf_free(NULL);
+    atto_eq(xtr_gapbuf_to_xtr(NULL), NULL);
+    atto_eq(xtr_gapbuf_length(NULL), 0U);
+    atto_eq(xtr_gapbuf_cursor(NULL), 0U);
+    atto_false(xtr_gapbuf_move(NULL, 0U));
+    atto_false(insert_str(NULL, "a"));
+    atto_eq(xtr_gapbuf_delete(NULL, 1U), 0U);
+    atto_eq(xtr_gapbuf_backspace(NULL, 1U), 0U);
+    xtr_view_t view;
+    atto_false(xtr_gapbuf_before(&view, NULL));
+    atto_eq(view.bytes, NULL);
+    atto_false(xtr_gapbuf_after(&view, NULL));
+    atto_eq(view.bytes, NULL);
+
+    xtr_t* text = xtr_from_str("abc");
+    atto_neq(text, NULL);
+    atto_true(xtr_gapbuf_init(&gapbuf, &text));
+    atto_false(xtr_gapbuf_before(NULL, &gapbuf));
+    atto_false(xtr_gapbuf_after(NULL, &gapbuf));
+    atto_false(insert_str(&gapbuf, NULL));
+    atto_false(xtr_gapbuf_move(&gapbuf, 4U));
+    xtr_gapbuf_free(&gapbuf);
+    xtr_gapbuf_free(&gapbuf);
+    atto_eq(xtr_gapbuf_to_xtr(&gapbuf), NULL);
+    atto_eq(xtr_gapbuf_length(&gapbuf), 0U);
+    atto_false(xtr_gapbuf_move(&gapbuf, 0U));
+    atto_false(insert_str(&gapbuf, "a"));
+    atto_eq(xtr_gapbuf_delete(&gapbuf, 1U), 0U);
+    atto_false(xtr_gapbuf_before(&view, &gapbuf));
+    atto_eq(view.bytes, NULL);
+}
+
+void
+xtrtest_gapbuf_valid_conversions_without_copies(void)
+{
+    xtr_t* text = xtr_from_str_capac("Hello", 32U);
+    atto_neq(text, NULL);
+    const xtr_t* const original = text;
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &text));
+    atto_eq(text, NULL);
+    atto_eq(xtr_gapbuf_cursor(&gapbuf), 5U);
+    atto_eq(xtr_gapbuf_length(&gapbuf), 5U);
+    atto_true(insert_str(&gapbuf, " world!"));
+    text = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_eq(text, original);
+    atto_eq(xtr_length(text), 12U);
+    atto_streq(xtr_cstring(text), "Hello world!", 13);
+    atto_eq(xtr_gapbuf_to_xtr(&gapbuf), NULL);
+    xtr_free(&text);
+}
+
+void
+xtrtest_gapbuf_valid_shared_xtring_is_copied(void)
+{
+    xtr_t* original = xtr_from_str("abc");
+    atto_neq(original, NULL);
+    xtr_t* shared = xtr_share(original);
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &shared));
+    atto_eq(shared, NULL);
+    atto_false(xtr_is_shared(original));
+    atto_true(xtr_gapbuf_move(&gapbuf, 0U));
+    atto_true(insert_str(&gapbuf, "x"));
+    xtr_t* edited = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_streq(xtr_cstring(edited), "xabc", 5);
+    atto_streq(xtr_cstring(original), "abc", 4);
+    xtr_free(&edited);
+    xtr_free(&original);
+}
+
+void
+xtrtest_gapbuf_valid_edit_at_cursor(void)
+{
+    xtr_t* text = xtr_from_str("Hello!");
+    atto_neq(text, NULL);
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &text));
+    atto_true(xtr_gapbuf_move(&gapbuf, 5U));
+    atto_true(insert_str(&gapbuf, " wordl"));
+    atto_eq(xtr_gapbuf_backspace(&gapbuf, 2U), 2U);
+    atto_true(insert_str(&gapbuf, "ld"));
+    atto_eq(xtr_gapbuf_cursor(&gapbuf), 11U);
+    xtr_view_t view;
+    atto_true(xtr_gapbuf_before(&view, &gapbuf));
+    atto_eq(view.length, 11U);
+    atto_eq(memcmp(view.bytes, "Hello world", 11U), 0);
+    atto_true(xtr_gapbuf_after(&view, &gapbuf));
+    atto_eq(view.length, 1U);
+    atto_eq(memcmp(view.bytes, "!", 1U), 0);
+
+    atto_true(xtr_gapbuf_move(&gapbuf, 0U));
+    atto_eq(xtr_gapbuf_delete(&gapbuf, 6U), 6U);
+    atto_eq(xtr_gapbuf_backspace(&gapbuf, 1U), 0U);
+    atto_true(xtr_gapbuf_move(&gapbuf, 6U));
+    atto_eq(xtr_gapbuf_delete(&gapbuf, 100U), 0U);
+    atto_eq(xtr_gapbuf_backspace(&gapbuf, 100U), 6U);
+    atto_eq(xtr_gapbuf_length(&gapbuf), 0U);
+    text = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_neq(text, NULL);
+    atto_eq(xtr_length(text), 0U);
+    atto_streq(xtr_cstring(text), "", 1);
+    xtr_free(&text);
+}
+
+void
+xtrtest_gapbuf_valid_move_farther_than_gap(void)
+{
+    // 1-byte gap: moving the cursor shifts overlapping regions
+    xtr_t* text = xtr_from_str_capac("hello world", 12U);
+    atto_neq(text, NULL);
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &text));
+    atto_true(xtr_gapbuf_move(&gapbuf, 0U));
+    xtr_view_t view;
+    atto_true(xtr_gapbuf_after(&view, &gapbuf));
+    atto_eq(view.length, 11U);
+    atto_eq(memcmp(view.bytes, "hello world", 11U), 0);
+    atto_true(xtr_gapbuf_move(&gapbuf, 8U));
+    atto_true(xtr_gapbuf_before(&view, &gapbuf));
+    atto_eq(memcmp(view.bytes, "hello wo", 8U), 0);
+    atto_true(xtr_gapbuf_after(&view, &gapbuf));
+    atto_eq(memcmp(view.bytes, "rld", 3U), 0);
+    atto_true(xtr_gapbuf_move(&gapbuf, 2U));
+    text = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_neq(text, NULL);
+    atto_streq(xtr_cstring(text), "hello world", 12);
+    xtr_free(&text);
+}
+
+void
+xtrtest_gapbuf_valid_random_edits(void)
+{
+    // Same edits on the gap buffer and on a plain array, compared at the end
+    static uint8_t reference[GAPBUF_REFERENCE_LEN];
+    size_t reference_len = 0U;
+    size_t cursor = 0U;
+    uint8_t bytes[40];
+    xtr_view_t inserted;
+    xtr_t* text = xtr_new_empty();
+    atto_neq(text, NULL);
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &text));
+    uint32_t random = 42U;
+    size_t mismatches = 0U;
+    for (size_t round = 0U; round < 20000U; round++)
+    {
+        random = random * 1103515245U + 12345U;
+        const size_t len = (random >> 16U) % sizeof(bytes);
+        switch ((random >> 8U) % 4U)
+        {
+            case 0U:
+                cursor = (random >> 4U) % (reference_len + 1U);
+                mismatches += !xtr_gapbuf_move(&gapbuf, cursor);
+                break;
+            case 1U:
+                if (reference_len + len > GAPBUF_REFERENCE_LEN)
+                {
+                    break;
+                }
+                for (size_t i = 0U; i < len; i++)
+                {
+                    bytes[i] = (uint8_t) ('a' + (round + i) % 26U);
+                }
+                xtr_view_from_bytes(&inserted, bytes, len);
+                mismatches += !xtr_gapbuf_insert(&gapbuf, inserted);
+                memmove(&reference[cursor + len], &reference[cursor], reference_len - cursor);
+                memcpy(&reference[cursor], bytes, len);
+                reference_len += len;
+                cursor += len;
+                break;
+            case 2U:
+            {
+                const size_t deleted = len < reference_len - cursor ? len : reference_len - cursor;
+                mismatches += xtr_gapbuf_delete(&gapbuf, len) != deleted;
+                memmove(&reference[cursor],
+                        &reference[cursor + deleted],
+                        reference_len - cursor - deleted);
+                reference_len -= deleted;
+                break;
+            }
+            default:
+            {
+                const size_t deleted = len < cursor ? len : cursor;
+                mismatches += xtr_gapbuf_backspace(&gapbuf, len) != deleted;
+                memmove(&reference[cursor - deleted], &reference[cursor], reference_len - cursor);
+                reference_len -= deleted;
+                cursor -= deleted;
+                break;
+            }
+        }
+        mismatches += xtr_gapbuf_cursor(&gapbuf) != cursor;
+        mismatches += xtr_gapbuf_length(&gapbuf) != reference_len;
+    }
+    xtr_view_t before;
+    xtr_view_t after;
+    atto_true(xtr_gapbuf_before(&before, &gapbuf));
+    atto_true(xtr_gapbuf_after(&after, &gapbuf));
+    atto_eq(memcmp(before.bytes, reference, cursor), 0);
+    atto_eq(memcmp(after.bytes, &reference[cursor], after.length), 0);
+    text = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_neq(text, NULL);
+    atto_eq(xtr_length(text), reference_len);
+    atto_eq(memcmp(xtr_cstring(text), reference, reference_len), 0);
+    atto_eq(mismatches, 0U);
+    xtr_free(&text);
+}
+
+void
+xtrtest_gapbuf_fail_malloc(void)
+{
+    xtr_t* text = xtr_from_str("abc");
+    atto_neq(text, NULL);
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &text));
+    xtrtest_malloc_fail_after(0);
+    atto_false(insert_str(&gapbuf, "def"));
+    xtrtest_malloc_disable_failing();
+    atto_true(xtr_gapbuf_move(&gapbuf, 1U));
+    atto_true(insert_str(&gapbuf, "def"));
+    text = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_streq(xtr_cstring(text), "adefbc", 7);
+    xtr_free(&text);
+
+    xtr_t* original = xtr_from_str("abc");
+    xtr_t* shared = xtr_share(original);
+    xtrtest_malloc_fail_after(0);
+    atto_false(xtr_gapbuf_init(&gapbuf, &shared));
+    xtrtest_malloc_disable_failing();
+    atto_eq(shared, original);
+    xtr_free(&shared);
+    xtr_free(&original);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_growth_valid_extend_tail_reallocates_rarely(void)
+{
+    xtr_t* xtr = xtr_new_empty();
+    xtr_t* byte = xtr_from_str("a");
+    atto_neq(xtr, NULL);
+    atto_neq(byte, NULL);
+    size_t reallocations = 0U;
+    size_t failures = 0U;
+    for (size_t i = 0U; i < 10000U; i++)
+    {
+        const xtr_t* const before = xtr;
+        failures += xtr_extend_tail(&xtr, byte) == NULL;
+        reallocations += xtr != before;
+    }
+    atto_eq(failures, 0U);
+    atto_eq(xtr_length(xtr), 10000U);
+    atto_true(reallocations < 20U);
+    atto_true(xtr_capacity(xtr) < 2U * 10000U + 16U);
+    xtr_t* expected = xtr_from_byte_repeat('a', 10000U);
+    atto_true(xtr_is_equal(xtr, expected));
+    xtr_free(&expected);
+    xtr_free(&byte);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_growth_valid_extend_head_keeps_room_before_content(void)
+{
+    xtr_t* xtr = xtr_from_str("world!");
+    xtr_t* word = xtr_from_str("Hello ");
+    atto_neq(xtr, NULL);
+    atto_neq(word, NULL);
+    const xtr_growth_t doubling = {200U, 0U, 0U};
+    atto_neq(xtr_extend_head_growth(&xtr, word, &doubling), NULL);
+    atto_streq(xtr_cstring(xtr), "Hello world!", 13);
+    atto_eq(xtr_capacity(xtr), 24U);
+    atto_eq(xtr_push_head(xtr, word), 6U);
+    atto_streq(xtr_cstring(xtr), "Hello Hello world!", 19);
+    xtr_free(&word);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_growth_valid_per_call_policy(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* extension = xtr_from_byte_repeat('x', 997U);
+    atto_neq(xtr, NULL);
+    atto_neq(extension, NULL);
+
+    const xtr_growth_t exact = {100U, 0U, 0U};
+    atto_neq(xtr_extend_tail_growth(&xtr, extension, &exact), NULL);
+    atto_eq(xtr_length(xtr), 1000U);
+    atto_eq(xtr_capacity(xtr), 1000U);
+
+    const xtr_growth_t bounded = {150U, 100U, 0U};
+    atto_neq(xtr_extend_tail_growth(&xtr, extension, &bounded), NULL);
+    atto_eq(xtr_length(xtr), 1997U);
+    atto_eq(xtr_capacity(xtr), 2097U);
+
+    const xtr_growth_t half = {150U, 0U, 0U};
+    atto_neq(xtr_extend_tail_growth(&xtr, extension, &half), NULL);
+    atto_eq(xtr_length(xtr), 2994U);
+    atto_eq(xtr_capacity(xtr), 4491U);
+    xtr_free(&extension);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_growth_valid_size_class_rounding(void)
+{
+    const xtr_growth_t rounded = {100U, 0U, 64U};
+    size_t capacities[2] = {0U, 0U};
+    for (size_t i = 0U; i < 2U; i++)
+    {
+        xtr_t* xtr = xtr_new_empty();
+        xtr_t* extension = xtr_from_byte_repeat('x', 10U + i);
+        atto_neq(xtr_extend_tail_growth(&xtr, extension, &rounded), NULL);
+        atto_eq(xtr_length(xtr), 10U + i);
+        capacities[i] = xtr_capacity(xtr);
+        xtr_free(&extension);
+        xtr_free(&xtr);
+    }
+    atto_true(capacities[0] >= 11U);
+    atto_eq(capacities[0], capacities[1]);
+}
+
+void
+xtrtest_growth_valid_global_policy(void)
+{
+    xtr_growth_t original;
+    xtr_growth(NULL);
+    xtr_growth(&original);
+    atto_eq(original.factor_percent, 200U);
+    atto_eq(original.max_slack, 0U);
+    atto_eq(original.size_class, 16U);
+    const xtr_growth_t exact = {100U, 0U, 0U};
+    xtr_set_growth(exact);
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* extension = xtr_from_str("def");
+    atto_neq(xtr_extend_tail(&xtr, extension), NULL);
+    atto_eq(xtr_capacity(xtr), 6U);
+    xtr_set_growth(original);
+    xtr_growth_t restored;
+    xtr_growth(&restored);
+    atto_eq(restored.factor_percent, 200U);
+    atto_neq(xtr_extend_tail(&xtr, extension), NULL);
+    atto_true(xtr_capacity(xtr) >= 18U);
+    atto_streq(xtr_cstring(xtr), "abcdefdef", 10);
+    xtr_free(&extension);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_growth_fail_malloc(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* extension = xtr_from_str("def");
+    const xtr_t* const original = xtr;
+    xtrtest_malloc_fail_after(0);
+    const xtr_t* const extended_tail = xtr_extend_tail(&xtr, extension);
+    xtrtest_malloc_disable_failing();
+    atto_eq(extended_tail, NULL);
+    xtrtest_malloc_fail_after(0);
+    const xtr_t* const extended_head = xtr_extend_head(&xtr, extension);
+    xtrtest_malloc_disable_failing();
+    atto_eq(extended_head, NULL);
+    atto_eq(xtr, original);
+    atto_streq(xtr_cstring(xtr), "abc", 4);
+    xtr_free(&extension);
+    xtr_free(&xtr);
+}
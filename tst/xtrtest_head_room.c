@@ -0,0 +1,223 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_head_room_valid_truncate_head_does_not_move_content(void)
+{
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    atto_neq(xtr, NULL);
+    const char* const start = xtr_cstring(xtr);
+    xtr_truncate_head(xtr, 3U);
+    atto_eq(xtr_cstring(xtr), start + 3U);
+    atto_streq(xtr_cstring(xtr), "lo world!", 10);
+    atto_eq(xtr_length(xtr), 9U);
+    atto_eq(xtr_capacity(xtr), 12U);
+    atto_eq(xtr_available(xtr), 3U);
+
+    xtr_trim_head(xtr, "lo ");
+    atto_eq(xtr_cstring(xtr), start + 6U);
+    atto_streq(xtr_cstring(xtr), "world!", 7);
+    xtr_truncate_head(xtr, 100U);
+    atto_eq(xtr_length(xtr), 0U);
+    atto_eq(xtr_cstring(xtr), start);  // Empty: back to the start for free
+    atto_streq(xtr_cstring(xtr), "", 1);
+    atto_eq(xtr_available(xtr), 12U);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_pop_head_consumes_from_the_front(void)
+{
+    xtr_t* xtr = xtr_from_str("GET / HTTP/1.1\r\n");
+    atto_neq(xtr, NULL);
+    const char* const start = xtr_cstring(xtr);
+    xtr_t* method = xtr_pop_head(xtr, 4U);
+    atto_streq(xtr_cstring(method), "GET ", 5);
+    atto_eq(xtr_cstring(xtr), start + 4U);
+    xtr_t* path = xtr_pop_head(xtr, 2U);
+    atto_streq(xtr_cstring(path), "/ ", 3);
+    atto_streq(xtr_cstring(xtr), "HTTP/1.1\r\n", 11);
+    atto_eq(xtr_cstring(xtr), start + 6U);
+    xtr_free(&method);
+    xtr_free(&path);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_push_head_reuses_the_room(void)
+{
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    xtr_t* hel = xtr_from_str("Hel");
+    atto_neq(xtr, NULL);
+    atto_neq(hel, NULL);
+    const char* const start = xtr_cstring(xtr);
+    xtr_truncate_head(xtr, 3U);
+    atto_eq(xtr_push_head(xtr, hel), 3U);
+    atto_eq(xtr_cstring(xtr), start);
+    atto_streq(xtr_cstring(xtr), "Hello world!", 13);
+    atto_eq(xtr_push_head(xtr, hel), 0U);  // Full
+    atto_streq(xtr_cstring(xtr), "Hello world!", 13);
+    xtr_free(&hel);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_push_head_without_room_recenters(void)
+{
+    xtr_t* xtr = xtr_from_str_capac("abc", 13U);
+    xtr_t* x = xtr_from_str("x");
+    atto_neq(xtr, NULL);
+    atto_neq(x, NULL);
+    const char* const start = xtr_cstring(xtr);
+    atto_eq(xtr_push_head(xtr, x), 1U);
+    // 10 free bytes: the pushed one plus half of the other 9 before the content
+    atto_eq(xtr_cstring(xtr), start + 4U);
+    atto_streq(xtr_cstring(xtr), "xabc", 5);
+    for (size_t i = 0U; i < 4U; i++)
+    {
+        atto_eq(xtr_push_head(xtr, x), 1U);
+    }
+    atto_eq(xtr_cstring(xtr), start);
+    atto_streq(xtr_cstring(xtr), "xxxxxabc", 9);
+    for (size_t i = 0U; i < 5U; i++)
+    {
+        atto_eq(xtr_push_head(xtr, x), 1U);
+    }
+    atto_eq(xtr_push_head(xtr, x), 0U);
+    atto_streq(xtr_cstring(xtr), "xxxxxxxxxxabc", 14);
+    atto_eq(xtr_available(xtr), 0U);
+    xtr_free(&x);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_push_onto_itself(void)
+{
+    xtr_t* xtr = xtr_from_str_capac("ab", 16U);
+    atto_neq(xtr, NULL);
+    atto_eq(xtr_push_head(xtr, xtr), 2U);  // Recentering
+    atto_streq(xtr_cstring(xtr), "abab", 5);
+    atto_eq(xtr_push_head(xtr, xtr), 4U);  // Into the head room
+    atto_streq(xtr_cstring(xtr), "abababab", 9);
+    atto_eq(xtr_push_tail(xtr, xtr), 8U);  // Compacting
+    atto_streq(xtr_cstring(xtr), "abababababababab", 17);
+    atto_eq(xtr_length(xtr), 16U);
+    xtr_truncate_head(xtr, 14U);
+    atto_neq(xtr_extend_head(&xtr, xtr), NULL);
+    atto_streq(xtr_cstring(xtr), "abab", 5);
+    atto_neq(xtr_extend_tail(&xtr, xtr), NULL);
+    atto_streq(xtr_cstring(xtr), "abababab", 9);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_push_tail_compacts_only_when_needed(void)
+{
+    xtr_t* xtr = xtr_from_str_capac("Hello", 10U);
+    xtr_t* bang = xtr_from_str("!");
+    xtr_t* world = xtr_from_str(" world");
+    atto_neq(xtr, NULL);
+    atto_neq(bang, NULL);
+    atto_neq(world, NULL);
+    const char* const start = xtr_cstring(xtr);
+    xtr_truncate_head(xtr, 2U);
+    atto_eq(xtr_push_tail(xtr, bang), 1U);
+    atto_eq(xtr_cstring(xtr), start + 2U);  // Room at the tail: no move
+    atto_streq(xtr_cstring(xtr), "llo!", 5);
+    atto_eq(xtr_push_tail(xtr, world), 6U);
+    atto_eq(xtr_cstring(xtr), start);  // Compacted to make room
+    atto_streq(xtr_cstring(xtr), "llo! world", 11);
+    atto_eq(xtr_push_tail(xtr, bang), 0U);
+    xtr_free(&bang);
+    xtr_free(&world);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_extend_uses_the_room(void)
+{
+    xtr_t* xtr = xtr_from_str("abcdef");
+    xtr_t* xy = xtr_from_str("xy");
+    atto_neq(xtr, NULL);
+    atto_neq(xy, NULL);
+    const xtr_t* const original = xtr;
+    xtr_truncate_head(xtr, 2U);
+    atto_eq(xtr_extend_tail(&xtr, xy), original);
+    atto_streq(xtr_cstring(xtr), "cdefxy", 7);
+    atto_neq(xtr_extend_head(&xtr, xy), NULL);
+    atto_neq(xtr, original);  // Full: reallocated
+    atto_streq(xtr_cstring(xtr), "xycdefxy", 9);
+    xtr_free(&xy);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_copies_and_clear(void)
+{
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    atto_neq(xtr, NULL);
+    xtr_truncate_head(xtr, 6U);
+    xtr_t* clone = xtr_clone(xtr);
+    atto_streq(xtr_cstring(clone), "world!", 7);
+    atto_eq(xtr_capacity(clone), 6U);
+    xtr_t* shared = xtr_share(xtr);
+    atto_neq(xtr_unshare(&shared), NULL);
+    atto_streq(xtr_cstring(shared), "world!", 7);
+    atto_eq(xtr_capacity(shared), 12U);
+
+    const char* const content = xtr_cstring(xtr);
+    xtr_clear(xtr);
+    atto_eq(xtr_cstring(xtr), content - 6U);
+    atto_eq(xtr_available(xtr), 12U);
+    xtr_free(&shared);
+    xtr_free(&clone);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_head_room_valid_gapbuf(void)
+{
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    atto_neq(xtr, NULL);
+    xtr_truncate_head(xtr, 6U);
+    xtr_gapbuf_t gapbuf;
+    atto_true(xtr_gapbuf_init(&gapbuf, &xtr));
+    atto_true(xtr_gapbuf_move(&gapbuf, 0U));
+    xtr_view_t big;
+    xtr_view_from_str(&big, "big ");
+    atto_true(xtr_gapbuf_insert(&gapbuf, big));
+    xtr = xtr_gapbuf_to_xtr(&gapbuf);
+    atto_streq(xtr_cstring(xtr), "big world!", 11);
+    atto_eq(xtr_length(xtr), 10U);
+    xtr_free(&xtr);
+}
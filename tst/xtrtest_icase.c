@@ -0,0 +1,176 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+
+void
+xtrtest_icase_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    atto_eq(xtr_find_icase(NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find_icase(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find_icase(NULL, xtr), XTR_NOT_FOUND);
+    atto_eq(xtr_cmp_icase(NULL, NULL), 0);
+    atto_eq(xtr_cmp_icase(NULL, xtr), -1);
+    atto_eq(xtr_cmp_icase(xtr, NULL), +1);
+    atto_true(xtr_is_equal_icase(NULL, NULL));
+    atto_false(xtr_is_equal_icase(xtr, NULL));
+    atto_false(xtr_is_equal_icase(NULL, xtr));
+    atto_true(xtr_startswith_icase(NULL, NULL));
+    atto_false(xtr_startswith_icase(xtr, NULL));
+    atto_false(xtr_startswith_icase(NULL, xtr));
+    atto_true(xtr_endswith_icase(NULL, NULL));
+    atto_false(xtr_endswith_icase(xtr, NULL));
+    atto_false(xtr_endswith_icase(NULL, xtr));
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_icase_valid_is_equal(void)
+{
+    xtr_t* lower = xtr_from_str("content-length: 42");
+    xtr_t* mixed = xtr_from_str("Content-Length: 42");
+    xtr_t* other = xtr_from_str("Content-Length: 43");
+    xtr_t* shorter = xtr_from_str("Content-Length");
+    atto_true(xtr_is_equal_icase(lower, mixed));
+    atto_true(xtr_is_equal_icase(mixed, mixed));
+    atto_false(xtr_is_equal_icase(lower, other));
+    atto_false(xtr_is_equal_icase(lower, shorter));
+    xtr_free(&lower);
+    xtr_free(&mixed);
+    xtr_free(&other);
+    xtr_free(&shorter);
+}
+
+void
+xtrtest_icase_valid_is_equal_only_letters_folded(void)
+{
+    // Bytes differing by 0x20 but not letters are different
+    xtr_t* a = xtr_from_str("@[`{\xC0");
+    xtr_t* b = xtr_from_str("`{@[\xE0");
+    xtr_t* a_lower = xtr_from_str("`{@[\xC0");
+    atto_false(xtr_is_equal_icase(a, b));
+    atto_false(xtr_is_equal_icase(a, a_lower));
+    xtr_free(&a);
+    xtr_free(&b);
+    xtr_free(&a_lower);
+}
+
+void
+xtrtest_icase_valid_long(void)
+{
+    // Longer than any SIMD vector, differing in the last byte
+    xtr_t* lower = xtr_from_str_repeat("abcdefghijklmnopqrstuvwxyz", 10);
+    xtr_t* upper = xtr_from_str_repeat("ABCDEFGHIJKLMNOPQRSTUVWXYZ", 10);
+    char bytes[260];
+    memcpy(bytes, xtr_cstring(upper), sizeof(bytes));
+    bytes[259] = '!';
+    xtr_t* differing = xtr_from_bytes((const uint8_t*) bytes, sizeof(bytes));
+    atto_true(xtr_is_equal_icase(lower, upper));
+    atto_false(xtr_is_equal_icase(lower, differing));
+    atto_eq(xtr_cmp_icase(lower, upper), 0);
+    atto_eq(xtr_cmp_icase(lower, differing), +3);
+    atto_eq(xtr_cmp_icase(differing, lower), -3);
+    xtr_free(&lower);
+    xtr_free(&upper);
+    xtr_free(&differing);
+}
+
+void
+xtrtest_icase_valid_cmp(void)
+{
+    xtr_t* abc = xtr_from_str("ABC");
+    xtr_t* abcd = xtr_from_str("abcd");
+    xtr_t* abd = xtr_from_str("abD");
+    xtr_t* underscore = xtr_from_str("_");
+    atto_eq(xtr_cmp_icase(abc, abcd), -2);
+    atto_eq(xtr_cmp_icase(abcd, abc), +2);
+    atto_eq(xtr_cmp_icase(abc, abd), -3);
+    atto_eq(xtr_cmp_icase(abd, abc), +3);
+    atto_eq(xtr_cmp_icase(underscore, abc), -3);
+    xtr_free(&abc);
+    xtr_free(&abcd);
+    xtr_free(&abd);
+    xtr_free(&underscore);
+}
+
+void
+xtrtest_icase_valid_startswith_endswith(void)
+{
+    xtr_t* host = xtr_from_str("WWW.Example.COM");
+    xtr_t* prefix = xtr_from_str("www.");
+    xtr_t* suffix = xtr_from_str(".com");
+    xtr_t* longer = xtr_from_str("www.example.com.");
+    atto_true(xtr_startswith_icase(host, prefix));
+    atto_false(xtr_startswith_icase(host, suffix));
+    atto_true(xtr_endswith_icase(host, suffix));
+    atto_false(xtr_endswith_icase(host, prefix));
+    atto_false(xtr_startswith_icase(host, longer));
+    atto_false(xtr_endswith_icase(host, longer));
+    xtr_free(&host);
+    xtr_free(&prefix);
+    xtr_free(&suffix);
+    xtr_free(&longer);
+}
+
+void
+xtrtest_icase_valid_find(void)
+{
+    xtr_t* haystack = xtr_from_str("Accept: */*\r\nHOST: example.com\r\n");
+    xtr_t* host = xtr_from_str("host:");
+    xtr_t* h = xtr_from_str("h");
+    xtr_t* colon = xtr_from_str(":");
+    xtr_t* absent = xtr_from_str("cookie");
+    atto_eq(xtr_find_icase(haystack, host), 13);
+    atto_eq(xtr_find_icase(haystack, h), 13);
+    atto_eq(xtr_find_icase(haystack, colon), 6);
+    atto_eq(xtr_find_icase(haystack, absent), XTR_NOT_FOUND);
+    atto_eq(xtr_find_icase(host, haystack), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&host);
+    xtr_free(&h);
+    xtr_free(&colon);
+    xtr_free(&absent);
+}
+
+void
+xtrtest_icase_valid_find_long(void)
+{
+    xtr_t* haystack = xtr_from_str_repeat("aBcDeFgHiJ", 100);
+    xtr_t* needle = xtr_from_str("jabcdefghijABCDEFGHIJabc");
+    xtr_t* absent = xtr_from_str("jabcdefghijABCDEFGHIJabd");
+    atto_eq(xtr_find_icase(haystack, needle), 9);
+    atto_eq(xtr_find_icase(haystack, absent), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&absent);
+}
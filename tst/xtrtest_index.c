@@ -0,0 +1,325 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+/** Fills with pseudo-random bytes of a small alphabet. */
+static void
+fill_random(uint8_t* const bytes, const size_t len, uint32_t* const random, const uint8_t letters)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        *random = *random * 1103515245U + 12345U;
+        bytes[i] = (uint8_t) ('a' + (*random >> 16U) % letters);
+    }
+}
+
+/** Counts the searches in the index differing from a scan of the text. */
+static size_t
+mismatches_with_scan(const xtr_index_t* const index,
+                     const uint8_t* const text,
+                     const size_t text_len,
+                     const uint8_t* const needle_bytes,
+                     const size_t needle_len)
+{
+    xtr_t* needle = xtr_from_bytes(needle_bytes, needle_len);
+    size_t expected_amount = 0;
+    size_t expected_first = XTR_NOT_FOUND;
+    size_t amount = 42;
+    size_t* indices = xtr_index_find_all(&amount, index, needle);
+    size_t mismatches = indices == NULL;
+    for (size_t i = 0; indices != NULL && i + needle_len <= text_len; i++)
+    {
+        if (memcmp(&text[i], needle_bytes, needle_len) == 0)
+        {
+            mismatches += expected_amount >= amount || indices[expected_amount] != i;
+            expected_first = expected_amount == 0 ? i : expected_first;
+            expected_amount++;
+        }
+    }
+    mismatches += amount != expected_amount;
+    mismatches += xtr_index_occurrences(index, needle) != expected_amount;
+    mismatches += xtr_index_contains(index, needle) != (expected_amount > 0);
+    mismatches += xtr_index_find(index, needle) != expected_first;
+    free(indices);
+    xtr_free(&needle);
+    return mismatches;
+}
+
+void
+xtrtest_index_valid_null(void)
+{
+    xtr_t* text = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    xtr_index_t* index = xtr_index_new(text);
+    size_t amount = 42;
+    size_t size = 42;
+    atto_neq(index, NULL);
+    atto_eq(xtr_index_new(NULL), NULL);
+    atto_eq(xtr_index_from_bytes(NULL, 100), NULL);
+    atto_eq(xtr_index_bytes(NULL, &size), NULL);
+    atto_eq(size, 0);
+    atto_false(xtr_index_contains(NULL, text));
+    atto_false(xtr_index_contains(index, NULL));
+    atto_false(xtr_index_contains(index, empty));
+    atto_eq(xtr_index_occurrences(NULL, text), XTR_NOT_FOUND);
+    atto_eq(xtr_index_occurrences(index, empty), XTR_NOT_FOUND);
+    atto_eq(xtr_index_find(index, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_index_find(index, empty), XTR_NOT_FOUND);
+    atto_eq(xtr_index_find_all(NULL, index, text), NULL);
+    atto_eq(xtr_index_find_all(&amount, NULL, text), NULL);
+    atto_eq(amount, 0);
+    atto_eq(xtr_index_find_all(&amount, index, empty), NULL);
+    atto_eq(xtr_index_longest_repeat(NULL, &size), XTR_NOT_FOUND);
+    atto_eq(size, 0);
+    xtr_index_free(&index);
+    atto_eq(index, NULL);
+    xtr_index_free(&index);
+    xtr_index_free(NULL);
+    xtr_free(&text);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_index_valid_find(void)
+{
+    xtr_t* text = xtr_from_str("abracadabra");
+    xtr_t* abra = xtr_from_str("abra");
+    xtr_t* a = xtr_from_str("a");
+    xtr_t* missing = xtr_from_str("abrab");
+    xtr_t* longer = xtr_from_str("abracadabrax");
+    xtr_index_t* index = xtr_index_new(text);
+    size_t amount = 42;
+    atto_true(xtr_index_contains(index, abra));
+    atto_eq(xtr_index_occurrences(index, abra), 2);
+    atto_eq(xtr_index_find(index, abra), 0);
+    atto_eq(xtr_index_occurrences(index, a), 5);
+    size_t* indices = xtr_index_find_all(&amount, index, a);
+    atto_neq(indices, NULL);
+    atto_eq(amount, 5);
+    atto_eq(indices[0], 0);
+    atto_eq(indices[1], 3);
+    atto_eq(indices[2], 5);
+    atto_eq(indices[3], 7);
+    atto_eq(indices[4], 10);
+    free(indices);
+    atto_false(xtr_index_contains(index, missing));
+    atto_eq(xtr_index_occurrences(index, missing), 0);
+    atto_eq(xtr_index_find(index, missing), XTR_NOT_FOUND);
+    indices = xtr_index_find_all(&amount, index, longer);
+    atto_neq(indices, NULL);
+    atto_eq(amount, 0);
+    free(indices);
+    xtr_index_free(&index);
+    xtr_free(&text);
+    xtr_free(&abra);
+    xtr_free(&a);
+    xtr_free(&missing);
+    xtr_free(&longer);
+}
+
+void
+xtrtest_index_valid_overlapping(void)
+{
+    xtr_t* text = xtr_from_str("aaaaa");
+    xtr_t* needle = xtr_from_str("aa");
+    xtr_index_t* index = xtr_index_new(text);
+    atto_eq(xtr_index_occurrences(index, needle), 4);
+    atto_eq(xtr_occurrences(text, needle), 2);
+    xtr_index_free(&index);
+    xtr_free(&text);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_index_valid_empty_text(void)
+{
+    xtr_t* text = xtr_new_empty();
+    xtr_t* needle = xtr_from_str("a");
+    xtr_index_t* index = xtr_index_new(text);
+    size_t length = 42;
+    atto_neq(index, NULL);
+    atto_false(xtr_index_contains(index, needle));
+    atto_eq(xtr_index_find(index, needle), XTR_NOT_FOUND);
+    atto_eq(xtr_index_longest_repeat(index, &length), XTR_NOT_FOUND);
+    atto_eq(length, 0);
+    xtr_index_free(&index);
+    xtr_free(&text);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_index_valid_random(void)
+{
+    // Small alphabets give long repetitions, thus deep recursions of SA-IS
+    static uint8_t text_bytes[20000];
+    uint32_t random = 5;
+    size_t mismatches = 0;
+    for (uint8_t letters = 1; letters <= 26; letters += 5)
+    {
+        fill_random(text_bytes, sizeof(text_bytes), &random, letters);
+        xtr_t* text = xtr_from_bytes(text_bytes, sizeof(text_bytes));
+        xtr_index_t* index = xtr_index_new(text);
+        atto_neq(index, NULL);
+        for (size_t i = 0; i < 50; i++)
+        {
+            uint8_t needle[12];
+            const size_t needle_len = 1 + i % sizeof(needle);
+            if (i % 2 == 0)
+            {
+                const size_t start = (i * 397) % (sizeof(text_bytes) - needle_len);
+                memcpy(needle, &text_bytes[start], needle_len);
+            }
+            else
+            {
+                fill_random(needle, needle_len, &random, letters);
+            }
+            mismatches +=
+                mismatches_with_scan(index, text_bytes, sizeof(text_bytes), needle, needle_len);
+        }
+        xtr_index_free(&index);
+        xtr_free(&text);
+    }
+    atto_eq(mismatches, 0);
+}
+
+void
+xtrtest_index_valid_longest_repeat(void)
+{
+    xtr_t* text = xtr_from_str("banana");
+    xtr_t* unique = xtr_from_str("abc");
+    xtr_index_t* index = xtr_index_new(text);
+    size_t length = 42;
+    const size_t start = xtr_index_longest_repeat(index, &length);
+    atto_eq(length, 3);
+    atto_true(start == 1 || start == 3);
+    xtr_index_free(&index);
+    index = xtr_index_new(unique);
+    atto_eq(xtr_index_longest_repeat(index, &length), XTR_NOT_FOUND);
+    atto_eq(length, 0);
+    xtr_index_free(&index);
+    xtr_free(&text);
+    xtr_free(&unique);
+}
+
+void
+xtrtest_index_valid_serialised(void)
+{
+    xtr_t* text = xtr_from_str("mississippi river");
+    xtr_t* needle = xtr_from_str("ssi");
+    xtr_index_t* index = xtr_index_new(text);
+    size_t size = 0;
+    const uint8_t* const bytes = xtr_index_bytes(index, &size);
+    atto_neq(bytes, NULL);
+    atto_eq(size, 24 + 20 + 17 * 8);
+    // Copied to aligned memory, as a file read or mapped
+    uint32_t* copy = malloc(size + sizeof(uint32_t));
+    atto_neq(copy, NULL);
+    memcpy(copy, bytes, size);
+    xtr_index_free(&index);
+    index = xtr_index_from_bytes((const uint8_t*) copy, size);
+    atto_neq(index, NULL);
+    atto_eq(xtr_index_occurrences(index, needle), 2);
+    atto_eq(xtr_index_find(index, needle), 2);
+    xtr_index_free(&index);
+    // Invalid ones
+    atto_eq(xtr_index_from_bytes((const uint8_t*) copy, size - 1), NULL);
+    atto_eq(xtr_index_from_bytes((const uint8_t*) copy, 10), NULL);
+    memmove((uint8_t*) copy + 1, copy, size);
+    atto_eq(xtr_index_from_bytes((const uint8_t*) copy + 1, size), NULL);
+    memmove(copy, (uint8_t*) copy + 1, size);
+    ((uint8_t*) copy)[0] = 'X';
+    atto_eq(xtr_index_from_bytes((const uint8_t*) copy, size), NULL);
+    ((uint8_t*) copy)[0] = 'x';
+    ((uint8_t*) copy)[12] ^= 0xFF;
+    atto_eq(xtr_index_from_bytes((const uint8_t*) copy, size), NULL);
+    ((uint8_t*) copy)[12] ^= 0xFF;
+    // Corrupted arrays give wrong results, but no invalid reads nor positions
+    size_t invalid = 0U;
+    const uint32_t corruptions[] = {UINT32_MAX, 16U, 15U};
+    for (size_t i = 0U; i < 17U * 3U; i++)
+    {
+        uint32_t* const suffix = (uint32_t*) ((uint8_t*) copy + 44) + i / 3U;
+        const uint32_t original = *suffix;
+        *suffix = corruptions[i % 3U];
+        index = xtr_index_from_bytes((const uint8_t*) copy, size);
+        const size_t found = xtr_index_find(index, needle);
+        invalid += found != XTR_NOT_FOUND && found >= 17U;
+        size_t amount = 0U;
+        size_t* const all = xtr_index_find_all(&amount, index, needle);
+        for (size_t j = 0U; j < amount; j++)
+        {
+            invalid += all[j] >= 17U;
+        }
+        free(all);
+        xtr_index_free(&index);
+        *suffix = original;
+    }
+    atto_eq(invalid, 0);
+    memset((uint8_t*) copy + 44, 0xFF, size - 44);
+    index = xtr_index_from_bytes((const uint8_t*) copy, size);
+    atto_neq(index, NULL);
+    xtr_index_contains(index, needle);
+    xtr_index_longest_repeat(index, NULL);
+    xtr_index_free(&index);
+    free(copy);
+    xtr_free(&text);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_index_fail_malloc(void)
+{
+    xtr_t* text = xtr_from_str("abracadabra");
+    xtr_t* needle = xtr_from_str("a");
+    size_t created = 0;
+    for (size_t successes = 0; successes < 5; successes++)
+    {
+        xtrtest_malloc_fail_after(successes);
+        xtr_index_t* index = xtr_index_new(text);
+        created += index != NULL;
+        xtr_index_free(&index);
+    }
+    xtrtest_malloc_disable_failing();
+    atto_eq(created, 0);
+    xtr_index_t* index = xtr_index_new(text);
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_index_find_all(&amount, index, needle), NULL);
+    atto_eq(amount, 0);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_index_from_bytes(xtr_index_bytes(index, NULL), 24 + 12 + 11 * 8), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_index_free(&index);
+    xtr_free(&text);
+    xtr_free(&needle);
+}
@@ -0,0 +1,275 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+/** Checks a line against a C-string. */
+static bool
+line_is(const xtr_view_t line, const char* const str)
+{
+    xtr_view_t expected;
+    xtr_view_from_str(&expected, str);
+    return xtr_view_is_equal(line, expected);
+}
+
+void
+xtrtest_lines_valid_null(void)
+{
+    xtr_line_iter_t iter;
+    xtr_view_t line;
+    xtr_line_index_t* index = NULL;
+    xtr_line_iter_init(NULL, NULL);
+    xtr_line_iter_init(&iter, NULL);
+    atto_false(xtr_line_next(&iter, &line));
+    atto_false(xtr_line_next(NULL, &line));
+    atto_eq(xtr_line_index_new(NULL), NULL);
+    xtr_line_index_free(NULL);
+    xtr_line_index_free(&index);
+    atto_eq(xtr_line_index_lines(NULL), 0);
+    atto_eq(xtr_line_index_offset(NULL, 0U), XTR_NOT_FOUND);
+    atto_eq(xtr_line_index_line_at(NULL, 0U), XTR_NOT_FOUND);
+    atto_false(xtr_line_index_line(&line, NULL, 0U));
+    atto_eq(line.bytes, NULL);
+    xtr_t* text = xtr_from_str("a");
+    index = xtr_line_index_new(text);
+    atto_false(xtr_line_index_line(NULL, index, 0U));
+    atto_false(xtr_line_index_line(&line, index, 1U));
+    atto_eq(line.bytes, NULL);
+    xtr_line_index_free(&index);
+    xtr_free(&text);
+}
+
+void
+xtrtest_lines_valid_iter(void)
+{
+    xtr_t* text = xtr_from_str("first\r\n\nthird\r\r\nlast");
+    xtr_line_iter_t iter;
+    xtr_view_t line;
+    xtr_line_iter_init(&iter, text);
+    atto_true(xtr_line_next(&iter, &line));
+    atto_true(line_is(line, "first"));
+    atto_true(xtr_line_next(&iter, &line));
+    atto_true(line_is(line, ""));
+    atto_true(xtr_line_next(&iter, &line));
+    atto_true(line_is(line, "third\r"));
+    atto_true(xtr_line_next(&iter, &line));
+    atto_true(line_is(line, "last"));
+    atto_eq(line.bytes, xtr_bytes(text) + 16);
+    atto_false(xtr_line_next(&iter, &line));
+    atto_false(xtr_line_next(&iter, &line));
+    xtr_free(&text);
+    // Trailing newline, single newline, empty
+    text = xtr_from_str("a\n");
+    xtr_line_iter_init(&iter, text);
+    atto_true(xtr_line_next(&iter, &line));
+    atto_true(line_is(line, "a"));
+    atto_false(xtr_line_next(&iter, &line));
+    xtr_free(&text);
+    text = xtr_from_str("\n");
+    xtr_line_iter_init(&iter, text);
+    atto_true(xtr_line_next(&iter, &line));
+    atto_eq(line.length, 0);
+    atto_false(xtr_line_next(&iter, &line));
+    xtr_free(&text);
+    // CR without LF after it, also at the end
+    text = xtr_from_str("a\rb\r");
+    xtr_line_iter_init(&iter, text);
+    atto_true(xtr_line_next(&iter, &line));
+    atto_true(line_is(line, "a\rb\r"));
+    atto_false(xtr_line_next(&iter, &line));
+    xtr_line_index_t* index = xtr_line_index_new(text);
+    atto_true(xtr_line_index_line(&line, index, 0U));
+    atto_true(line_is(line, "a\rb\r"));
+    xtr_line_index_free(&index);
+    xtr_free(&text);
+    text = xtr_from_str("a\r\nb\r\n");
+    index = xtr_line_index_new(text);
+    atto_true(xtr_line_index_line(&line, index, 1U));
+    atto_true(line_is(line, "b"));
+    xtr_line_index_free(&index);
+    xtr_free(&text);
+    text = xtr_new_empty();
+    xtr_line_iter_init(&iter, text);
+    atto_false(xtr_line_next(&iter, &line));
+    xtr_free(&text);
+}
+
+/** Random text of lines of varied lengths, from empty to longer than the scanned blocks. */
+static xtr_t*
+random_lines(const size_t len, uint32_t random)
+{
+    uint8_t* bytes = malloc(len);
+    for (size_t i = 0U; i < len; i++)
+    {
+        random = random * 1103515245U + 12345U;
+        const uint32_t value = (random >> 16U) % 200U;
+        bytes[i] = value < 6U ? '\n' : value < 8U ? '\r' : (uint8_t) ('a' + value % 26U);
+        // Sometimes long lines
+        if (value == 199U)
+        {
+            const size_t long_line = len - i < 300U ? len - i : 300U;
+            memset(&bytes[i], 'x', long_line);
+            i += long_line - 1U;
+        }
+    }
+    xtr_t* text = xtr_from_bytes(bytes, len);
+    free(bytes);
+    return text;
+}
+
+void
+xtrtest_lines_valid_iter_and_index_as_split(void)
+{
+    xtr_t* newline = xtr_from_str("\n");
+    size_t mismatches = 0U;
+    for (size_t len = 0U; len < 3000U; len += 37U)
+    {
+        xtr_t* text = random_lines(len, (uint32_t) len);
+        // Reference: split on the newlines, without the trailing empty chunk
+        size_t amount = 0U;
+        xtr_view_t* chunks = xtr_split_views(&amount, text, newline);
+        // All chunks but the last one were followed by a newline
+        const size_t terminated = amount > 0U ? amount - 1U : 0U;
+        if (amount > 0U && chunks[amount - 1U].length == 0U)
+        {
+            amount--;
+        }
+        xtr_line_index_t* index = xtr_line_index_new(text);
+        mismatches += index == NULL || xtr_line_index_lines(index) != amount;
+        xtr_line_iter_t iter;
+        xtr_view_t line;
+        xtr_line_iter_init(&iter, text);
+        size_t i = 0U;
+        while (xtr_line_next(&iter, &line))
+        {
+            xtr_view_t expected = chunks[i];
+            if (i < terminated && expected.length > 0U &&
+                expected.bytes[expected.length - 1U] == '\r')
+            {
+                expected.length--;
+            }
+            mismatches += i >= amount || !xtr_view_is_equal(line, expected);
+            mismatches += line.bytes != expected.bytes;
+            xtr_view_t indexed;
+            mismatches += !xtr_line_index_line(&indexed, index, i);
+            mismatches += !xtr_view_is_equal(indexed, expected);
+            const size_t offset = (size_t) (chunks[i].bytes - xtr_bytes(text));
+            mismatches += xtr_line_index_offset(index, i) != offset;
+            // First and last byte of the line with its newline
+            mismatches += xtr_line_index_line_at(index, offset) != i;
+            if (offset + chunks[i].length < len)
+            {
+                mismatches += xtr_line_index_line_at(index, offset + chunks[i].length) != i;
+            }
+            i++;
+        }
+        mismatches += i != amount;
+        mismatches += xtr_line_index_offset(index, amount) != XTR_NOT_FOUND;
+        mismatches += xtr_line_index_line_at(index, len) != XTR_NOT_FOUND;
+        xtr_line_index_free(&index);
+        free(chunks);
+        xtr_free(&text);
+    }
+    atto_eq(mismatches, 0);
+    xtr_free(&newline);
+}
+
+void
+xtrtest_lines_valid_index_compact(void)
+{
+    // 80-byte lines: distances of 13 bits within each block of 64 lines
+    xtr_t* line = xtr_from_byte_repeat('x', 79U);
+    xtr_t* newline = xtr_from_str("\n");
+    xtr_t* single = xtr_concat(line, newline);
+    xtr_t* text = xtr_repeated(single, 10000U);
+    xtr_line_index_t* index = xtr_line_index_new(text);
+    atto_eq(xtr_line_index_lines(index), 10000);
+    atto_eq(xtr_line_index_offset(index, 0U), 0);
+    atto_eq(xtr_line_index_offset(index, 9999U), 9999U * 80U);
+    atto_eq(xtr_line_index_line_at(index, 80U * 5000U + 79U), 5000);
+    xtr_view_t view;
+    atto_true(xtr_line_index_line(&view, index, 1234U));
+    atto_eq(view.length, 79);
+    size_t mismatches = 0U;
+    for (size_t i = 0U; i < 10000U; i++)
+    {
+        mismatches += xtr_line_index_offset(index, i) != i * 80U;
+        mismatches += xtr_line_index_line_at(index, i * 80U + i % 80U) != i;
+    }
+    atto_eq(mismatches, 0);
+    xtr_line_index_free(&index);
+    xtr_free(&text);
+    xtr_free(&single);
+    xtr_free(&line);
+    xtr_free(&newline);
+}
+
+void
+xtrtest_lines_valid_index_single_line_blocks(void)
+{
+    // Blocks of one line pack no distances
+    xtr_t* text = xtr_from_str("single line");
+    xtr_line_index_t* index = xtr_line_index_new(text);
+    atto_neq(index, NULL);
+    atto_eq(xtr_line_index_lines(index), 1);
+    atto_eq(xtr_line_index_offset(index, 0U), 0);
+    atto_eq(xtr_line_index_line_at(index, 10U), 0);
+    xtr_view_t view;
+    atto_true(xtr_line_index_line(&view, index, 0U));
+    atto_eq(view.length, 11);
+    xtr_line_index_free(&index);
+    xtr_free(&text);
+
+    // 65 lines: the last block holds only the 65th
+    text = xtr_from_str_repeat("ab\n", 65U);
+    index = xtr_line_index_new(text);
+    atto_neq(index, NULL);
+    atto_eq(xtr_line_index_lines(index), 65);
+    atto_eq(xtr_line_index_offset(index, 63U), 63U * 3U);
+    atto_eq(xtr_line_index_offset(index, 64U), 64U * 3U);
+    atto_eq(xtr_line_index_line_at(index, 64U * 3U + 2U), 64);
+    xtr_line_index_free(&index);
+    xtr_free(&text);
+}
+
+void
+xtrtest_lines_fail_malloc(void)
+{
+    xtr_t* text = xtr_from_str_repeat("line\n", 1000U);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_line_index_new(text), NULL);
+    xtrtest_malloc_fail_after(1);
+    atto_eq(xtr_line_index_new(text), NULL);
+    xtrtest_malloc_fail_after(2);
+    atto_eq(xtr_line_index_new(text), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&text);
+}
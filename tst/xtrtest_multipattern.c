@@ -0,0 +1,249 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+void
+xtrtest_multipattern_valid_null(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    const xtr_t* needles[] = {haystack};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 1);
+    size_t counts[1];
+    size_t amount = 42;
+    size_t id = 42;
+    atto_neq(patterns, NULL);
+    atto_eq(xtr_multipattern_new(NULL, 1), NULL);
+    atto_eq(xtr_multipattern_new(needles, 0), NULL);
+    atto_eq(xtr_multipattern_amount(NULL), 0);
+    atto_eq(xtr_find_any(NULL, patterns, &id), XTR_NOT_FOUND);
+    atto_eq(id, XTR_NOT_FOUND);
+    atto_eq(xtr_find_any(haystack, NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_find_all_any(NULL, haystack, patterns), NULL);
+    atto_eq(xtr_find_all_any(&amount, NULL, patterns), NULL);
+    atto_eq(amount, 0);
+    atto_eq(xtr_find_all_any(&amount, haystack, NULL), NULL);
+    atto_eq(xtr_count_each(NULL, haystack, patterns), XTR_NOT_FOUND);
+    atto_eq(xtr_count_each(counts, NULL, patterns), XTR_NOT_FOUND);
+    atto_eq(xtr_count_each(counts, haystack, NULL), XTR_NOT_FOUND);
+    xtr_multipattern_free(&patterns);
+    atto_eq(patterns, NULL);
+    xtr_multipattern_free(&patterns);
+    xtr_multipattern_free(NULL);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_multipattern_valid_find_any(void)
+{
+    xtr_t* haystack = xtr_from_str("The quick brown fox jumps over the lazy dog");
+    xtr_t* lazy = xtr_from_str("lazy");
+    xtr_t* fox = xtr_from_str("fox");
+    xtr_t* fo = xtr_from_str("fo");
+    xtr_t* cat = xtr_from_str("cat");
+    const xtr_t* needles[] = {lazy, fo, fox, cat};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 4);
+    size_t id = 42;
+    atto_eq(xtr_multipattern_amount(patterns), 4);
+    // Leftmost occurrence, the longest one on ties
+    atto_eq(xtr_find_any(haystack, patterns, &id), 16);
+    atto_eq(id, 2);
+    atto_eq(xtr_find_any(lazy, patterns, NULL), 0);
+    atto_eq(xtr_find_any(cat, patterns, &id), 0);
+    atto_eq(id, 3);
+    atto_eq(xtr_find_any(fo, patterns, &id), 0);
+    atto_eq(id, 1);
+    xtr_truncate_head(haystack, 20);
+    atto_eq(xtr_find_any(haystack, patterns, &id), 35 - 20);
+    atto_eq(id, 0);
+    xtr_truncate_tail(haystack, 10);
+    atto_eq(xtr_find_any(haystack, patterns, &id), XTR_NOT_FOUND);
+    atto_eq(id, XTR_NOT_FOUND);
+    xtr_multipattern_free(&patterns);
+    xtr_free(&haystack);
+    xtr_free(&lazy);
+    xtr_free(&fox);
+    xtr_free(&fo);
+    xtr_free(&cat);
+}
+
+void
+xtrtest_multipattern_valid_find_all_any(void)
+{
+    // Classic Aho-Corasick example
+    xtr_t* haystack = xtr_from_str("ushers");
+    xtr_t* he = xtr_from_str("he");
+    xtr_t* she = xtr_from_str("she");
+    xtr_t* his = xtr_from_str("his");
+    xtr_t* hers = xtr_from_str("hers");
+    const xtr_t* needles[] = {he, she, his, hers};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 4);
+    size_t amount = 0;
+    xtr_match_t* matches = xtr_find_all_any(&amount, haystack, patterns);
+    atto_neq(matches, NULL);
+    atto_eq(amount, 3);
+    atto_eq(matches[0].index, 1);
+    atto_eq(matches[0].needle_id, 1);
+    atto_eq(matches[1].index, 2);
+    atto_eq(matches[1].needle_id, 0);
+    atto_eq(matches[2].index, 2);
+    atto_eq(matches[2].needle_id, 3);
+    free(matches);
+    matches = xtr_find_all_any(&amount, his, patterns);
+    atto_eq(amount, 1);
+    free(matches);
+    matches = xtr_find_all_any(&amount, he, patterns);
+    atto_eq(amount, 1);
+    free(matches);
+    xtr_multipattern_free(&patterns);
+    xtr_free(&haystack);
+    xtr_free(&he);
+    xtr_free(&she);
+    xtr_free(&his);
+    xtr_free(&hers);
+}
+
+void
+xtrtest_multipattern_valid_find_all_any_many_matches(void)
+{
+    // More matches than the initial array capacity
+    xtr_t* haystack = xtr_from_byte_repeat('a', 100);
+    xtr_t* a = xtr_from_str("a");
+    xtr_t* aa = xtr_from_str("aa");
+    const xtr_t* needles[] = {a, aa};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 2);
+    size_t amount = 0;
+    xtr_match_t* matches = xtr_find_all_any(&amount, haystack, patterns);
+    atto_eq(amount, 100 + 99);
+    atto_eq(matches[198].index, 99);
+    atto_eq(matches[198].needle_id, 0);
+    free(matches);
+    xtr_multipattern_free(&patterns);
+    xtr_free(&haystack);
+    xtr_free(&a);
+    xtr_free(&aa);
+}
+
+void
+xtrtest_multipattern_valid_count_each(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world! Hello again, hello!");
+    xtr_t* hello = xtr_from_str("Hello");
+    xtr_t* ello = xtr_from_str("ello");
+    xtr_t* l = xtr_from_str("l");
+    xtr_t* empty = xtr_new_empty();
+    xtr_t* absent = xtr_from_str("xyz");
+    const xtr_t* needles[] = {hello, ello, l, NULL, empty, absent, hello};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 7);
+    size_t counts[7];
+    atto_eq(xtr_count_each(counts, haystack, patterns), 2 + 3 + 7 + 2);
+    atto_eq(counts[0], 2);
+    atto_eq(counts[1], 3);
+    atto_eq(counts[2], 7);
+    atto_eq(counts[3], 0);
+    atto_eq(counts[4], 0);
+    atto_eq(counts[5], 0);
+    atto_eq(counts[6], 2);
+    xtr_multipattern_free(&patterns);
+    xtr_free(&haystack);
+    xtr_free(&hello);
+    xtr_free(&ello);
+    xtr_free(&l);
+    xtr_free(&empty);
+    xtr_free(&absent);
+}
+
+void
+xtrtest_multipattern_valid_count_each_non_overlapping(void)
+{
+    xtr_t* haystack = xtr_from_str("aaaaa");
+    xtr_t* aa = xtr_from_str("aa");
+    xtr_t* aaa = xtr_from_str("aaa");
+    const xtr_t* needles[] = {aa, aaa};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 2);
+    size_t counts[2];
+    atto_eq(xtr_count_each(counts, haystack, patterns), 3);
+    atto_eq(counts[0], xtr_occurrences(haystack, aa));
+    atto_eq(counts[1], xtr_occurrences(haystack, aaa));
+    xtr_multipattern_free(&patterns);
+    xtr_free(&haystack);
+    xtr_free(&aa);
+    xtr_free(&aaa);
+}
+
+void
+xtrtest_multipattern_valid_all_byte_values(void)
+{
+    uint8_t bytes[256];
+    for (size_t i = 0; i < sizeof(bytes); i++)
+    {
+        bytes[i] = (uint8_t) i;
+    }
+    xtr_t* haystack = xtr_from_bytes(bytes, sizeof(bytes));
+    xtr_t* low = xtr_from_bytes(&bytes[0], 3);
+    xtr_t* high = xtr_from_bytes(&bytes[253], 3);
+    xtr_t* all = xtr_clone(haystack);
+    const xtr_t* needles[] = {high, all, low};
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 3);
+    size_t id = 42;
+    size_t counts[3];
+    atto_eq(xtr_find_any(haystack, patterns, &id), 0);
+    atto_eq(id, 1);
+    atto_eq(xtr_count_each(counts, haystack, patterns), 3);
+    xtr_multipattern_free(&patterns);
+    xtr_free(&haystack);
+    xtr_free(&low);
+    xtr_free(&high);
+    xtr_free(&all);
+}
+
+void
+xtrtest_multipattern_fail_malloc(void)
+{
+    xtr_t* needle = xtr_from_str("abc");
+    const xtr_t* needles[] = {needle};
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_multipattern_new(needles, 1), NULL);
+    xtrtest_malloc_fail_after(6);
+    atto_eq(xtr_multipattern_new(needles, 1), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_multipattern_t* patterns = xtr_multipattern_new(needles, 1);
+    size_t amount = 42;
+    size_t counts[1];
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_find_all_any(&amount, needle, patterns), NULL);
+    atto_eq(amount, 0);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_count_each(counts, needle, patterns), XTR_NOT_FOUND);
+    xtr_multipattern_free(&patterns);
+    xtr_free(&needle);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_occurrences_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    atto_eq(xtr_occurrences(NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_occurrences(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_occurrences(NULL, xtr), XTR_NOT_FOUND);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_occurrences_valid_empty_haystack(void)
+{
+    xtr_t* haystack = xtr_new_empty();
+    xtr_t* needle = xtr_from_str("a");
+    atto_eq(xtr_occurrences(haystack, needle), 0);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_occurrences_valid_needle_longer_than_haystack(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* needle = xtr_from_str("abcd");
+    atto_eq(xtr_occurrences(haystack, needle), 0);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_occurrences_valid_none(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world!");
+    xtr_t* needle = xtr_from_str("xyz");
+    atto_eq(xtr_occurrences(haystack, needle), 0);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_occurrences_valid_multiple(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world! Hello again, hello!");
+    xtr_t* needle = xtr_from_str("ello");
+    atto_eq(xtr_occurrences(haystack, needle), 3);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_occurrences_valid_non_overlapping(void)
+{
+    xtr_t* haystack = xtr_from_str("aaaaa");
+    xtr_t* needle = xtr_from_str("aa");
+    atto_eq(xtr_occurrences(haystack, needle), 2);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_occurrences_valid_across_vector_blocks(void)
+{
+    // Long enough for multiple SIMD blocks, needles straddle block borders
+    xtr_t* haystack = xtr_from_str_repeat("0123456789abcdefghijklmnopqrstuvwxyz", 10);
+    xtr_t* needle = xtr_from_str("xyz0123");
+    atto_eq(xtr_occurrences(haystack, needle), 9);
+    atto_eq(xtr_find(haystack, needle), 33);
+    atto_eq(xtr_find_from(haystack, needle, 34), 69);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
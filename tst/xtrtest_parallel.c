@@ -0,0 +1,154 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+/** Compares the parallel searches with the serial non-overlapping search. */
+static void
+assert_same_as_serial(const xtr_t* const haystack, const xtr_t* const needle, const size_t threads)
+{
+    size_t serial_amount = 0;
+    size_t mismatches = 0;
+    size_t amount = 42;
+    size_t* indices = xtr_find_all_parallel(&amount, haystack, needle, threads);
+    atto_neq(indices, NULL);
+    for (size_t i = xtr_find(haystack, needle); i != XTR_NOT_FOUND;
+         i = xtr_find_from(haystack, needle, i + xtr_length(needle)))
+    {
+        if (serial_amount >= amount || indices[serial_amount] != i)
+        {
+            mismatches++;
+        }
+        serial_amount++;
+    }
+    atto_eq(mismatches, 0);
+    atto_eq(amount, serial_amount);
+    atto_eq(xtr_occurrences_parallel(haystack, needle, threads), serial_amount);
+    atto_eq(xtr_occurrences(haystack, needle), serial_amount);
+    free(indices);
+}
+
+void
+xtrtest_parallel_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    size_t amount = 42;
+    atto_eq(xtr_occurrences_parallel(NULL, xtr, 2), XTR_NOT_FOUND);
+    atto_eq(xtr_occurrences_parallel(xtr, NULL, 2), XTR_NOT_FOUND);
+    atto_eq(xtr_occurrences_parallel(xtr, empty, 2), XTR_NOT_FOUND);
+    atto_eq(xtr_occurrences_parallel(xtr, empty, 2), xtr_occurrences(xtr, empty));
+    atto_eq(xtr_find_all_parallel(NULL, xtr, xtr, 2), NULL);
+    atto_eq(xtr_find_all_parallel(&amount, NULL, xtr, 2), NULL);
+    atto_eq(xtr_find_all_parallel(&amount, xtr, NULL, 2), NULL);
+    atto_eq(xtr_find_all_parallel(&amount, xtr, empty, 2), NULL);
+    xtr_free(&xtr);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_parallel_valid_small_haystack(void)
+{
+    xtr_t* haystack = xtr_from_str("abcaaaabcaa");
+    xtr_t* needle = xtr_from_str("aa");
+    xtr_t* longer = xtr_from_str("abcaaaabcaaa");
+    size_t amount = 42;
+    size_t* indices = xtr_find_all_parallel(&amount, haystack, needle, 4);
+    atto_neq(indices, NULL);
+    atto_eq(amount, 3);
+    atto_eq(indices[0], 3);
+    atto_eq(indices[1], 5);
+    atto_eq(indices[2], 9);
+    free(indices);
+    atto_eq(xtr_occurrences_parallel(haystack, needle, 0), 3);
+    indices = xtr_find_all_parallel(&amount, haystack, longer, 4);
+    atto_neq(indices, NULL);
+    atto_eq(amount, 0);
+    free(indices);
+    atto_eq(xtr_occurrences_parallel(haystack, longer, 4), 0);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&longer);
+}
+
+void
+xtrtest_parallel_valid_large_haystack(void)
+{
+    // Occurrences straddle the boundaries of any split into ranges
+    xtr_t* haystack = xtr_from_str_repeat("abcdefghij", 4U * XTR_PARALLEL_MIN_LEN / 10U + 3U);
+    xtr_t* needle = xtr_from_str("hijabcd");
+    xtr_t* absent = xtr_from_str("abcdx");
+    for (size_t threads = 0; threads <= 7; threads++)
+    {
+        assert_same_as_serial(haystack, needle, threads);
+        assert_same_as_serial(haystack, absent, threads);
+    }
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&absent);
+}
+
+void
+xtrtest_parallel_valid_periodic_needle(void)
+{
+    // Threads starting mid-occurrence find a chain of occurrences
+    // never coinciding with the serial one
+    xtr_t* haystack = xtr_from_str_repeat("a", 3U * XTR_PARALLEL_MIN_LEN + 5U);
+    xtr_t* pair = xtr_from_str("aa");
+    xtr_t* triple = xtr_from_str("aaa");
+    for (size_t threads = 2; threads <= 4; threads++)
+    {
+        assert_same_as_serial(haystack, pair, threads);
+        assert_same_as_serial(haystack, triple, threads);
+    }
+    xtr_free(&haystack);
+    xtr_free(&pair);
+    xtr_free(&triple);
+}
+
+void
+xtrtest_parallel_fail_malloc(void)
+{
+    xtr_t* haystack = xtr_from_str("abcabc");
+    xtr_t* needle = xtr_from_str("bc");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_occurrences_parallel(haystack, needle, 2), XTR_NOT_FOUND);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_find_all_parallel(&amount, haystack, needle, 2), NULL);
+    atto_eq(amount, 0);
+    xtrtest_malloc_fail_after(3);
+    atto_eq(xtr_find_all_parallel(&amount, haystack, needle, 2), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
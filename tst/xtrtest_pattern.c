@@ -0,0 +1,150 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+void
+xtrtest_pattern_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_pattern_t* pattern = xtr_pattern_new(xtr);
+    atto_neq(pattern, NULL);
+    atto_eq(xtr_pattern_new(NULL), NULL);
+    atto_eq(xtr_pattern_find(NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_find(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_find(NULL, pattern), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_count(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_count(NULL, pattern), XTR_NOT_FOUND);
+    atto_false(xtr_pattern_contains(NULL, pattern));
+    xtr_pattern_free(&pattern);
+    atto_eq(pattern, NULL);
+    xtr_pattern_free(&pattern);
+    xtr_pattern_free(NULL);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_pattern_valid_empty(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    xtr_pattern_t* pattern = xtr_pattern_new(haystack);
+    atto_eq(xtr_pattern_new(empty), NULL);
+    atto_eq(xtr_pattern_find(empty, pattern), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_count(empty, pattern), 0);
+    xtr_pattern_free(&pattern);
+    xtr_free(&haystack);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_pattern_valid_needle_copied(void)
+{
+    xtr_t* haystack = xtr_from_str("Hello world!");
+    xtr_t* needle = xtr_from_str("world");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    xtr_free(&needle);
+    atto_eq(xtr_pattern_find(haystack, pattern), 6);
+    atto_eq(xtr_pattern_find_from(haystack, pattern, 6), 6);
+    atto_eq(xtr_pattern_find_from(haystack, pattern, 7), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_find_from(haystack, pattern, 12), XTR_NOT_FOUND);
+    atto_true(xtr_pattern_contains(haystack, pattern));
+    xtr_pattern_free(&pattern);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_pattern_valid_reused_across_haystacks(void)
+{
+    xtr_t* needle = xtr_from_str("ab");
+    xtr_t* first = xtr_from_str("xxabxxab");
+    xtr_t* second = xtr_from_str("ba");
+    xtr_t* third = xtr_from_str("a");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    atto_eq(xtr_pattern_find(first, pattern), 2);
+    atto_eq(xtr_pattern_count(first, pattern), 2);
+    atto_eq(xtr_pattern_find(second, pattern), XTR_NOT_FOUND);
+    atto_eq(xtr_pattern_count(second, pattern), 0);
+    atto_eq(xtr_pattern_count(third, pattern), 0);
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+    xtr_free(&first);
+    xtr_free(&second);
+    xtr_free(&third);
+}
+
+void
+xtrtest_pattern_valid_long_needle(void)
+{
+    // Long enough for the shift table, when used
+    xtr_t* haystack = xtr_from_str_repeat("0123456789abcdefghijklmnopqrstuvwxyz", 10);
+    xtr_t* needle = xtr_from_str("6789abcdefghijklmnopqrstuvwxyz"
+                                 "0123456789abcdefghijklmnopqrstuvwxyz01");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    atto_eq(xtr_pattern_find(haystack, pattern), 6);
+    atto_eq(xtr_pattern_find_from(haystack, pattern, 7), 42);
+    atto_eq(xtr_pattern_count(haystack, pattern), 4);
+    atto_eq(xtr_pattern_count(haystack, pattern), xtr_occurrences(haystack, needle));
+    xtr_pattern_free(&pattern);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_pattern_valid_long_adversarial_input(void)
+{
+    xtr_t* as = xtr_from_byte_repeat('a', 100000);
+    xtr_t* b = xtr_from_str("b");
+    xtr_t* haystack = xtr_concat(as, b);
+    xtr_truncate_tail(as, 100000 - 999);
+    xtr_t* needle = xtr_concat(as, b);
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    atto_eq(xtr_pattern_find(haystack, pattern), 100000 - 999);
+    atto_eq(xtr_pattern_count(haystack, pattern), 1);
+    xtr_truncate_tail(haystack, 1);
+    atto_false(xtr_pattern_contains(haystack, pattern));
+    xtr_pattern_free(&pattern);
+    xtr_free(&as);
+    xtr_free(&b);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_pattern_fail_malloc(void)
+{
+    xtr_t* needle = xtr_from_str("abc");
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_pattern_new(needle), NULL);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&needle);
+}
@@ -0,0 +1,337 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+
+void
+xtrtest_regex_valid_null(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_regex_t* regex = xtr_regex_new("b");
+    size_t amount = 42;
+    size_t length = 42;
+    atto_neq(regex, NULL);
+    atto_eq(xtr_regex_new(NULL), NULL);
+    atto_false(xtr_regex_match(NULL, regex));
+    atto_false(xtr_regex_match(haystack, NULL));
+    atto_eq(xtr_regex_find(NULL, regex, &length), XTR_NOT_FOUND);
+    atto_eq(length, 0);
+    atto_eq(xtr_regex_find(haystack, NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_regex_find_from(haystack, regex, 4, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_regex_find_all(NULL, haystack, regex), NULL);
+    atto_eq(xtr_regex_find_all(&amount, NULL, regex), NULL);
+    atto_eq(amount, 0);
+    atto_eq(xtr_regex_find_all(&amount, haystack, NULL), NULL);
+    xtr_regex_free(&regex);
+    atto_eq(regex, NULL);
+    xtr_regex_free(&regex);
+    xtr_regex_free(NULL);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_regex_invalid_syntax(void)
+{
+    static const char* const INVALID[] = {
+        "(",    "a)",    "[a",     "[]",   "[b-a]", "*a",    "a**",   "a{2",
+        "a{3,2}", "a{1001}", "a{,2}", "\\",   "\\q",   "\\x4",  "\\xZZ", "a^",
+        "$a",   "^a|b",  "a|b$",  "(a$)",  "[a-\\d]", "{",   "a|*",   "(?:",
+    };
+    size_t compiled = 0;
+    for (size_t i = 0; i < sizeof(INVALID) / sizeof(INVALID[0]); i++)
+    {
+        xtr_regex_t* regex = xtr_regex_new(INVALID[i]);
+        compiled += regex != NULL;
+        xtr_regex_free(&regex);
+    }
+    atto_eq(compiled, 0);
+}
+
+void
+xtrtest_regex_valid_match(void)
+{
+    xtr_t* date = xtr_from_str("2024-02-29");
+    xtr_t* not_date = xtr_from_str("2024-02-29Z");
+    xtr_t* empty = xtr_new_empty();
+    xtr_regex_t* regex = xtr_regex_new("\\d{4}-[01]\\d-[0-3]\\d");
+    atto_true(xtr_regex_match(date, regex));
+    atto_false(xtr_regex_match(not_date, regex));
+    atto_false(xtr_regex_match(empty, regex));
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("(a|ab)(c|bcd)");
+    xtr_t* abcd = xtr_from_str("abcd");
+    atto_true(xtr_regex_match(abcd, regex));  // Not only the preferred match
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("x*");
+    atto_true(xtr_regex_match(empty, regex));
+    atto_false(xtr_regex_match(abcd, regex));
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("^[a-d]+$");  // Anchors at the edges change nothing
+    atto_true(xtr_regex_match(abcd, regex));
+    xtr_regex_free(&regex);
+    xtr_free(&date);
+    xtr_free(&not_date);
+    xtr_free(&empty);
+    xtr_free(&abcd);
+}
+
+void
+xtrtest_regex_valid_find(void)
+{
+    xtr_t* line = xtr_from_str("2024-02-29 12:00:01 ERR 404-NOTFOUND /index.html");
+    xtr_regex_t* regex = xtr_regex_new("[0-9]{3}-[A-Z]+");
+    size_t length = 42;
+    atto_eq(xtr_regex_find(line, regex, &length), 24);
+    atto_eq(length, 12);
+    atto_eq(xtr_regex_find(line, regex, NULL), 24);
+    atto_eq(xtr_regex_find_from(line, regex, 24, &length), 24);
+    atto_eq(xtr_regex_find_from(line, regex, 25, &length), XTR_NOT_FOUND);
+    atto_eq(length, 0);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("\\s/\\w+\\.(html?|css)");
+    atto_eq(xtr_regex_find(line, regex, &length), 36);
+    atto_eq(length, 12);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("WARN|DEBUG");
+    atto_eq(xtr_regex_find(line, regex, &length), XTR_NOT_FOUND);
+    xtr_regex_free(&regex);
+    xtr_free(&line);
+}
+
+void
+xtrtest_regex_valid_leftmost_first(void)
+{
+    xtr_t* haystack = xtr_from_str("xabcd <b>bold</b>");
+    size_t length = 42;
+    xtr_regex_t* regex = xtr_regex_new("ab|abcd");  // Left alternative preferred
+    atto_eq(xtr_regex_find(haystack, regex, &length), 1);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("bcd|ab");  // Leftmost start before alternatives
+    atto_eq(xtr_regex_find(haystack, regex, &length), 1);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("<.+>");  // Greedy
+    atto_eq(xtr_regex_find(haystack, regex, &length), 6);
+    atto_eq(length, 11);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("<.+?>");  // Lazy
+    atto_eq(xtr_regex_find(haystack, regex, &length), 6);
+    atto_eq(length, 3);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("a{2,3}");
+    xtr_t* as = xtr_from_str("baaaaa");
+    atto_eq(xtr_regex_find(as, regex, &length), 1);
+    atto_eq(length, 3);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("a{2,3}?");
+    atto_eq(xtr_regex_find(as, regex, &length), 1);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+    xtr_free(&as);
+}
+
+void
+xtrtest_regex_valid_anchors(void)
+{
+    xtr_t* haystack = xtr_from_str("abcabc");
+    size_t length = 42;
+    xtr_regex_t* regex = xtr_regex_new("^abc");
+    atto_eq(xtr_regex_find(haystack, regex, &length), 0);
+    atto_eq(length, 3);
+    atto_eq(xtr_regex_find_from(haystack, regex, 1, &length), XTR_NOT_FOUND);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("b?c$");
+    atto_eq(xtr_regex_find(haystack, regex, &length), 4);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("a\\$");  // Escaped: not an anchor
+    atto_eq(xtr_regex_find(haystack, regex, &length), XTR_NOT_FOUND);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("^(abc)+$");
+    atto_eq(xtr_regex_find(haystack, regex, &length), 0);
+    atto_eq(length, 6);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("^$");
+    atto_eq(xtr_regex_find(haystack, regex, &length), XTR_NOT_FOUND);
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_regex_valid_classes(void)
+{
+    const uint8_t bytes[] = {'a', '\n', 0x00, 0xE9, '_', ' ', '-', ']'};
+    xtr_t* haystack = xtr_from_bytes(bytes, sizeof(bytes));
+    size_t length = 42;
+    xtr_regex_t* regex = xtr_regex_new("a.");  // Dot does not match newlines
+    atto_eq(xtr_regex_find(haystack, regex, &length), XTR_NOT_FOUND);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("a[^x]\\x00[\\x80-\\xFF]");  // Negated classes do
+    atto_eq(xtr_regex_find(haystack, regex, &length), 0);
+    atto_eq(length, 4);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("\\w\\s");
+    atto_eq(xtr_regex_find(haystack, regex, &length), 0);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("[\\w\\s]{2}");
+    atto_eq(xtr_regex_find_from(haystack, regex, 1, &length), 4);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("[]-]+");  // Leading ] and trailing - are literal
+    atto_eq(xtr_regex_find(haystack, regex, &length), 6);
+    atto_eq(length, 2);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("\\D\\W\\S");
+    atto_eq(xtr_regex_find(haystack, regex, &length), 0);
+    atto_eq(length, 3);
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_regex_valid_find_all(void)
+{
+    xtr_t* haystack = xtr_from_str("id=12, id=345,id=6");
+    xtr_regex_t* regex = xtr_regex_new("id=(\\d+)");
+    size_t amount = 42;
+    xtr_region_t* regions = xtr_regex_find_all(&amount, haystack, regex);
+    atto_neq(regions, NULL);
+    atto_eq(amount, 3);
+    atto_eq(regions[0].index, 0);
+    atto_eq(regions[0].length, 5);
+    atto_eq(regions[1].index, 7);
+    atto_eq(regions[1].length, 6);
+    atto_eq(regions[2].index, 14);
+    atto_eq(regions[2].length, 4);
+    free(regions);
+    xtr_regex_free(&regex);
+    // Empty matches, also right after non-empty ones
+    regex = xtr_regex_new("\\d*");
+    regions = xtr_regex_find_all(&amount, haystack, regex);
+    atto_neq(regions, NULL);
+    atto_eq(amount, 16);
+    atto_eq(regions[3].index, 3);
+    atto_eq(regions[3].length, 2);
+    atto_eq(regions[4].index, 5);
+    atto_eq(regions[4].length, 0);
+    atto_eq(regions[15].index, 18);
+    atto_eq(regions[15].length, 0);
+    free(regions);
+    xtr_regex_free(&regex);
+    regex = xtr_regex_new("x");
+    regions = xtr_regex_find_all(&amount, haystack, regex);
+    atto_neq(regions, NULL);
+    atto_eq(amount, 0);
+    free(regions);
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_regex_valid_many_states(void)
+{
+    // 2^13 DFA states, more than fit the cache, which gets flushed
+    uint8_t bytes[20000];
+    uint32_t random = 1;
+    for (size_t i = 0; i < sizeof(bytes); i++)
+    {
+        random = random * 1103515245U + 12345U;
+        bytes[i] = (random >> 16U) & 1U ? 'a' : 'b';
+    }
+    xtr_t* haystack = xtr_from_bytes(bytes, sizeof(bytes));
+    xtr_regex_t* regex = xtr_regex_new("a[ab]{12}b");
+    size_t amount = 0;
+    xtr_region_t* regions = xtr_regex_find_all(&amount, haystack, regex);
+    atto_neq(regions, NULL);
+    size_t expected = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i + 14 <= sizeof(bytes); i++)
+    {
+        if (bytes[i] == 'a' && bytes[i + 13] == 'b')
+        {
+            mismatches += expected >= amount || regions[expected].index != i ||
+                          regions[expected].length != 14;
+            expected++;
+            i += 13;
+        }
+    }
+    atto_eq(amount, expected);
+    atto_eq(mismatches, 0);
+    free(regions);
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+}
+
+void
+xtrtest_regex_valid_literal_prefix(void)
+{
+    // Prefix found with the substring search, false candidates skipped
+    xtr_t* haystack = xtr_from_str_repeat("GET /a ", 1000);
+    xtr_t* tail = xtr_from_str("GET /index.html HTTP/1.1");
+    xtr_t* line = xtr_concat(haystack, tail);
+    xtr_regex_t* regex = xtr_regex_new("GET /\\w+\\.html HTTP/1\\.[01]");
+    size_t length = 42;
+    atto_eq(xtr_regex_find(line, regex, &length), 7000);
+    atto_eq(length, 24);
+    atto_eq(xtr_regex_find(haystack, regex, &length), XTR_NOT_FOUND);
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+    xtr_free(&tail);
+    xtr_free(&line);
+}
+
+void
+xtrtest_regex_fail_malloc(void)
+{
+    xtr_t* haystack = xtr_from_str("aab");
+    size_t created = 0;
+    for (size_t successes = 0; successes < 8; successes++)
+    {
+        xtrtest_malloc_fail_after(successes);
+        xtr_regex_t* regex = xtr_regex_new("a+b");
+        created += regex != NULL;
+        xtr_regex_free(&regex);
+    }
+    xtrtest_malloc_disable_failing();
+    atto_eq(created, 0);
+    xtr_regex_t* regex = xtr_regex_new("a+b");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_regex_find_all(&amount, haystack, regex), NULL);
+    atto_eq(amount, 0);
+    xtrtest_malloc_disable_failing();
+    xtr_regex_free(&regex);
+    xtr_free(&haystack);
+}
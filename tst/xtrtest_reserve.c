@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_reserve_valid_extends_without_reallocating(void)
+{
+    atto_eq(xtr_reserve(NULL, 1U), NULL);
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* byte = xtr_from_str("x");
+    atto_neq(xtr, NULL);
+    atto_neq(byte, NULL);
+    atto_neq(xtr_reserve(&xtr, 100U), NULL);
+    atto_eq(xtr_capacity(xtr), 103U);
+    atto_streq(xtr_cstring(xtr), "abc", 4);
+    const xtr_t* const reserved = xtr;
+    atto_eq(xtr_reserve(&xtr, 50U), reserved);  // Enough room already
+    size_t reallocations = 0U;
+    for (size_t i = 0U; i < 100U; i++)
+    {
+        reallocations += xtr_extend_tail(&xtr, byte) != reserved;
+    }
+    atto_eq(reallocations, 0U);
+    atto_eq(xtr_length(xtr), 103U);
+    atto_eq(xtr_reserve(&xtr, SIZE_MAX), NULL);
+    atto_eq(xtr, reserved);
+    xtr_free(&byte);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_reserve_valid_shared(void)
+{
+    xtr_t* original = xtr_from_str_capac("abc", 10U);
+    atto_neq(original, NULL);
+    xtr_t* shared = xtr_share(original);
+    atto_neq(xtr_reserve(&shared, 1U), NULL);
+    atto_neq(shared, original);
+    atto_eq(xtr_references(original), 1U);
+    atto_streq(xtr_cstring(shared), "abc", 4);
+    atto_true(xtr_available(shared) >= 1U);
+    xtr_free(&shared);
+    xtr_free(&original);
+}
+
+void
+xtrtest_reserve_fail_malloc(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    atto_neq(xtr, NULL);
+    const xtr_t* const original = xtr;
+    xtrtest_malloc_fail_after(0);
+    const xtr_t* const reserved = xtr_reserve(&xtr, 100U);
+    xtrtest_malloc_disable_failing();
+    atto_eq(reserved, NULL);
+    atto_eq(xtr, original);
+    atto_streq(xtr_cstring(xtr), "abc", 4);
+    xtr_free(&xtr);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_expand_valid_keeps_content(void)
+{
+    atto_eq(xtr_expand(NULL, 10U), NULL);
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    atto_neq(xtr, NULL);
+    atto_neq(xtr_expand(&xtr, 100U), NULL);
+    atto_eq(xtr_capacity(xtr), 100U);
+    atto_eq(xtr_available(xtr), 88U);
+    atto_streq(xtr_cstring(xtr), "Hello world!", 13);
+    atto_neq(xtr_expand(&xtr, 1U), NULL);  // Never truncates the content
+    atto_eq(xtr_capacity(xtr), 12U);
+    atto_streq(xtr_cstring(xtr), "Hello world!", 13);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_expand_valid_large(void)
+{
+    xtr_t* xtr = xtr_from_byte_repeat('a', 1U << 20U);
+    atto_neq(xtr, NULL);
+    xtr_truncate_head(xtr, 1U);
+    atto_neq(xtr_expand(&xtr, 8U << 20U), NULL);
+    atto_eq(xtr_capacity(xtr), 8U << 20U);
+    atto_eq(xtr_length(xtr), (1U << 20U) - 1U);
+    xtr_view_t tail;
+    xtr_view_t aaa;
+    xtr_view_range(&tail, xtr, xtr_length(xtr) - 3U, 3U);
+    xtr_view_from_str(&aaa, "aaa");
+    atto_true(xtr_view_is_equal(tail, aaa));
+    atto_eq(xtr_cstring(xtr)[xtr_length(xtr)], '\0');
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_expand_valid_shared_copies(void)
+{
+    xtr_t* original = xtr_from_str("shared");
+    atto_neq(original, NULL);
+    xtr_t* expanded = xtr_share(original);
+    atto_neq(xtr_expand(&expanded, 20U), NULL);
+    atto_neq(expanded, original);
+    atto_eq(xtr_references(original), 1U);
+    atto_eq(xtr_capacity(expanded), 20U);
+    atto_streq(xtr_cstring(expanded), "shared", 7);
+    atto_streq(xtr_cstring(original), "shared", 7);
+    xtr_free(&expanded);
+    xtr_free(&original);
+}
+
+void
+xtrtest_expand_fail_malloc(void)
+{
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    atto_neq(xtr, NULL);
+    xtr_truncate_head(xtr, 6U);
+    xtrtest_malloc_fail_after(0);
+    const xtr_t* const expanded = xtr_expand(&xtr, 1000U);
+    xtrtest_malloc_disable_failing();
+    atto_eq(expanded, NULL);
+    atto_neq(xtr, NULL);
+    atto_streq(xtr_cstring(xtr), "world!", 7);
+    atto_eq(xtr_capacity(xtr), 12U);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_compress_free_valid_drops_head_room(void)
+{
+    xtr_t* xtr = xtr_from_str_capac("Hello world!", 100U);
+    atto_neq(xtr, NULL);
+    xtr_truncate_head(xtr, 6U);
+    xtr_t* compressed = xtr_compress_free(&xtr);
+    atto_eq(xtr, NULL);
+    atto_neq(compressed, NULL);
+    atto_eq(xtr_capacity(compressed), 6U);
+    atto_eq(xtr_available(compressed), 0U);
+    atto_streq(xtr_cstring(compressed), "world!", 7);
+    atto_eq(xtr_compress_free(&compressed), NULL);  // Nothing to compress
+    atto_neq(compressed, NULL);
+    xtr_free(&compressed);
+}
+
+void
+xtrtest_compress_free_valid_shared(void)
+{
+    xtr_t* original = xtr_from_str_capac("abc", 10U);
+    atto_neq(original, NULL);
+    xtr_t* shared = xtr_share(original);
+    xtr_t* compressed = xtr_compress_free(&shared);
+    atto_eq(shared, NULL);
+    atto_neq(compressed, original);
+    atto_eq(xtr_capacity(compressed), 3U);
+    atto_eq(xtr_capacity(original), 10U);
+    atto_eq(xtr_references(original), 1U);
+    xtr_free(&compressed);
+    xtr_free(&original);
+}
+
+void
+xtrtest_resize_free_valid_grows(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    atto_neq(xtr, NULL);
+    xtr_t* resized = xtr_resize_free(&xtr, 50U);
+    atto_eq(xtr, NULL);
+    atto_neq(resized, NULL);
+    atto_eq(xtr_capacity(resized), 50U);
+    atto_streq(xtr_cstring(resized), "abc", 4);
+    xtr_t* doubled = xtr_resize_free_double(&resized);
+    atto_neq(doubled, NULL);
+    atto_eq(doubled, resized);
+    atto_eq(xtr_capacity(doubled), 6U);
+    atto_streq(xtr_cstring(doubled), "abc", 4);
+    xtr_free(&doubled);
+}
@@ -0,0 +1,146 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+
+void
+xtrtest_rfind_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    atto_eq(xtr_rfind(NULL, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind(xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind(NULL, xtr), XTR_NOT_FOUND);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_rfind_valid_empty(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    atto_eq(xtr_rfind(haystack, empty), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind(empty, haystack), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind(empty, empty), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_rfind_valid_needle_longer_than_haystack(void)
+{
+    xtr_t* haystack = xtr_from_str("abc");
+    xtr_t* needle = xtr_from_str("abcd");
+    atto_eq(xtr_rfind(haystack, needle), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_rfind_valid_last_occurrence(void)
+{
+    xtr_t* haystack = xtr_from_str("archive.tar.gz");
+    xtr_t* dot = xtr_from_str(".");
+    xtr_t* ar = xtr_from_str("ar");
+    xtr_t* absent = xtr_from_str("zip");
+    atto_eq(xtr_rfind(haystack, dot), 11);
+    atto_eq(xtr_rfind(haystack, ar), 9);
+    atto_eq(xtr_rfind(haystack, haystack), 0);
+    atto_eq(xtr_rfind(haystack, absent), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&dot);
+    xtr_free(&ar);
+    xtr_free(&absent);
+}
+
+void
+xtrtest_rfind_valid_overlapping(void)
+{
+    xtr_t* haystack = xtr_from_str("aaaaa");
+    xtr_t* needle = xtr_from_str("aa");
+    atto_eq(xtr_rfind(haystack, needle), 3);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_rfind_valid_within(void)
+{
+    xtr_t* haystack = xtr_from_str("ab-ab-ab-ab");
+    xtr_t* needle = xtr_from_str("ab");
+    atto_eq(xtr_rfind_within(haystack, needle, 0, 11), 9);
+    atto_eq(xtr_rfind_within(haystack, needle, 0, 10), 6);
+    atto_eq(xtr_rfind_within(haystack, needle, 4, 8), 6);
+    atto_eq(xtr_rfind_within(haystack, needle, 4, 7), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind_within(haystack, needle, 7, 7), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind_within(haystack, needle, 0, 12), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+}
+
+void
+xtrtest_rfind_valid_long_haystack(void)
+{
+    // Occurrences at both ends of a haystack longer than any SIMD vector
+    xtr_t* haystack = xtr_from_str_repeat("0123456789", 100);
+    xtr_t* first = xtr_from_str("0123");
+    xtr_t* last = xtr_from_str("6789");
+    xtr_t* longer = xtr_from_str("9012345678901234567");
+    atto_eq(xtr_rfind(haystack, first), 990);
+    atto_eq(xtr_rfind(haystack, last), 996);
+    atto_eq(xtr_rfind(haystack, longer), 979);
+    atto_eq(xtr_rfind_within(haystack, first, 0, 993), 980);
+    atto_eq(xtr_rfind_within(haystack, last, 0, 9), XTR_NOT_FOUND);
+    atto_eq(xtr_rfind_within(haystack, last, 0, 10), 6);
+    xtr_free(&haystack);
+    xtr_free(&first);
+    xtr_free(&last);
+    xtr_free(&longer);
+}
+
+void
+xtrtest_rfind_valid_adversarial(void)
+{
+    // Many candidates matching the first and last byte, found only at the start
+    uint8_t bytes[2000];
+    memset(bytes, 'a', sizeof(bytes));
+    bytes[0] = 'b';
+    xtr_t* haystack = xtr_from_bytes(bytes, sizeof(bytes));
+    xtr_t* needle = xtr_from_bytes(bytes, 40);
+    atto_eq(xtr_rfind(haystack, needle), 0);
+    bytes[0] = 'a';
+    bytes[20] = 'b';
+    xtr_t* absent = xtr_from_bytes(bytes, 40);
+    atto_eq(xtr_rfind(haystack, absent), XTR_NOT_FOUND);
+    xtr_free(&haystack);
+    xtr_free(&needle);
+    xtr_free(&absent);
+}
@@ -0,0 +1,315 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+/** Reference content of the random rope test. */
+#define ROPE_REFERENCE_LEN 4096U
+
+void
+xtrtest_rope_valid_null(void)
+{
+    xtr_rope_t* null = NULL;
+    xtr_t* text = xtr_from_str("a");
+    atto_neq(text, NULL);
+    atto_eq(xtr_rope_length(NULL), 0U);
+    atto_false(xtr_rope_insert(NULL, 0U, text));
+    atto_false(xtr_rope_insert_shared(NULL, 0U, text));
+    atto_false(xtr_rope_delete(NULL, 0U, 1U));
+    atto_false(xtr_rope_concat(NULL, &null));
+    atto_eq(xtr_rope_split(NULL, 0U), NULL);
+    atto_eq(xtr_rope_flatten(NULL), NULL);
+    xtr_rope_iter_init(NULL, NULL, 0U);
+    xtr_rope_iter_t iter;
+    xtr_view_t piece;
+    xtr_rope_iter_init(&iter, NULL, 0U);
+    atto_false(xtr_rope_next(&iter, &piece));
+    atto_false(xtr_rope_next(NULL, &piece));
+    xtr_rope_free(NULL);
+    xtr_rope_free(&null);
+
+    xtr_rope_t* rope = xtr_rope_new();
+    atto_neq(rope, NULL);
+    atto_false(xtr_rope_insert(rope, 0U, NULL));
+    atto_false(xtr_rope_insert(rope, 1U, text));
+    atto_false(xtr_rope_insert_shared(rope, 0U, NULL));
+    atto_false(xtr_rope_insert_shared(rope, 1U, text));
+    atto_false(xtr_rope_delete(rope, 1U, 1U));
+    atto_false(xtr_rope_concat(rope, NULL));
+    atto_false(xtr_rope_concat(rope, &null));
+    atto_false(xtr_rope_concat(rope, &rope));
+    atto_eq(xtr_rope_split(rope, 1U), NULL);
+    xtr_rope_iter_init(&iter, rope, 0U);
+    atto_false(xtr_rope_next(&iter, NULL));
+    xtr_rope_free(&rope);
+    atto_eq(rope, NULL);
+    xtr_free(&text);
+}
+
+void
+xtrtest_rope_valid_empty(void)
+{
+    xtr_rope_t* rope = xtr_rope_new();
+    xtr_t* empty = xtr_new_empty();
+    atto_neq(rope, NULL);
+    atto_neq(empty, NULL);
+    atto_true(xtr_rope_insert(rope, 0U, empty));
+    atto_true(xtr_rope_delete(rope, 0U, 10U));
+    atto_eq(xtr_rope_length(rope), 0U);
+    xtr_t* flat = xtr_rope_flatten(rope);
+    atto_neq(flat, NULL);
+    atto_eq(xtr_length(flat), 0U);
+    atto_streq(xtr_cstring(flat), "", 1);
+    xtr_rope_iter_t iter;
+    xtr_view_t piece;
+    xtr_rope_iter_init(&iter, rope, 0U);
+    atto_false(xtr_rope_next(&iter, &piece));
+    xtr_free(&flat);
+    xtr_free(&empty);
+    xtr_rope_free(&rope);
+}
+
+void
+xtrtest_rope_valid_edit(void)
+{
+    xtr_rope_t* rope = xtr_rope_new();
+    xtr_t* world = xtr_from_str("world");
+    xtr_t* hello = xtr_from_str("Hello ");
+    xtr_t* bang = xtr_from_str("!");
+    xtr_t* big = xtr_from_str_repeat("0123456789", 100U);
+    atto_neq(rope, NULL);
+    atto_neq(world, NULL);
+    atto_neq(hello, NULL);
+    atto_neq(bang, NULL);
+    atto_neq(big, NULL);
+
+    atto_true(xtr_rope_insert(rope, 0U, world));
+    atto_true(xtr_rope_insert(rope, 0U, hello));
+    atto_true(xtr_rope_insert(rope, xtr_rope_length(rope), bang));
+    atto_eq(xtr_rope_length(rope), 12U);
+    xtr_t* flat = xtr_rope_flatten(rope);
+    atto_streq(xtr_cstring(flat), "Hello world!", 13);
+    xtr_free(&flat);
+
+    atto_true(xtr_rope_insert(rope, 6U, big));
+    atto_true(xtr_rope_delete(rope, 8U, 995U));
+    flat = xtr_rope_flatten(rope);
+    atto_streq(xtr_cstring(flat), "Hello 01789world!", 18);
+    xtr_free(&flat);
+    atto_true(xtr_rope_delete(rope, 5U, SIZE_MAX));
+    flat = xtr_rope_flatten(rope);
+    atto_streq(xtr_cstring(flat), "Hello", 6);
+    xtr_free(&flat);
+
+    xtr_free(&world);
+    xtr_free(&hello);
+    xtr_free(&bang);
+    xtr_free(&big);
+    xtr_rope_free(&rope);
+}
+
+void
+xtrtest_rope_valid_insert_shared(void)
+{
+    xtr_rope_t* rope = xtr_rope_new();
+    xtr_t* big = xtr_from_str_repeat("0123456789", 100U);
+    atto_neq(rope, NULL);
+    atto_neq(big, NULL);
+    atto_true(xtr_rope_insert(rope, 0U, big));
+    atto_false(xtr_is_shared(big));  // Copied
+    atto_true(xtr_rope_delete(rope, 0U, SIZE_MAX));
+    atto_true(xtr_rope_insert_shared(rope, 0U, big));
+    atto_eq(xtr_references(big), 2U);
+    atto_true(xtr_rope_delete(rope, 500U, 10U));
+    atto_eq(xtr_references(big), 3U);  // Both halves are slices of it
+
+    xtr_rope_iter_t iter;
+    xtr_view_t piece;
+    xtr_rope_iter_init(&iter, rope, 0U);
+    atto_true(xtr_rope_next(&iter, &piece));
+    atto_eq(piece.bytes, (const uint8_t*) xtr_cstring(big));
+    atto_eq(piece.length, 500U);
+    atto_true(xtr_rope_next(&iter, &piece));
+    atto_eq(piece.bytes, (const uint8_t*) xtr_cstring(big) + 510U);
+    atto_eq(piece.length, 490U);
+    atto_false(xtr_rope_next(&iter, &piece));
+
+    xtr_rope_iter_init(&iter, rope, 495U);
+    atto_true(xtr_rope_next(&iter, &piece));
+    atto_eq(piece.length, 5U);
+    atto_eq(memcmp(piece.bytes, "56789", 5U), 0);
+
+    xtr_rope_free(&rope);
+    atto_eq(xtr_references(big), 1U);
+    xtr_free(&big);
+}
+
+void
+xtrtest_rope_valid_split_and_concat(void)
+{
+    xtr_rope_t* rope = xtr_rope_new();
+    xtr_t* text = xtr_from_str("abcdefghij");
+    atto_neq(rope, NULL);
+    atto_neq(text, NULL);
+    for (size_t i = 0U; i < 100U; i++)
+    {
+        atto_true(xtr_rope_insert(rope, xtr_rope_length(rope), text));
+    }
+    xtr_rope_t* tail = xtr_rope_split(rope, 995U);
+    atto_neq(tail, NULL);
+    atto_eq(xtr_rope_length(rope), 995U);
+    atto_eq(xtr_rope_length(tail), 5U);
+    xtr_t* flat = xtr_rope_flatten(tail);
+    atto_streq(xtr_cstring(flat), "fghij", 6);
+    xtr_free(&flat);
+
+    xtr_rope_t* empty = xtr_rope_split(tail, 5U);
+    atto_neq(empty, NULL);
+    atto_eq(xtr_rope_length(empty), 0U);
+    atto_true(xtr_rope_concat(tail, &empty));
+    atto_eq(empty, NULL);
+    atto_true(xtr_rope_concat(tail, &rope));
+    atto_eq(rope, NULL);
+    atto_eq(xtr_rope_length(tail), 1000U);
+    flat = xtr_rope_flatten(tail);
+    atto_neq(flat, NULL);
+    atto_eq(memcmp(xtr_cstring(flat), "fghijabcdefghij", 15U), 0);
+    atto_eq(memcmp(xtr_cstring(flat) + 990U, "fghij", 5U), 0);
+    xtr_free(&flat);
+    xtr_free(&text);
+    xtr_rope_free(&tail);
+}
+
+void
+xtrtest_rope_valid_random_edits(void)
+{
+    // Same edits on the rope and on a plain array, compared after each one
+    static uint8_t reference[ROPE_REFERENCE_LEN];
+    size_t reference_len = 0U;
+    uint8_t bytes[300];
+    xtr_rope_t* rope = xtr_rope_new();
+    atto_neq(rope, NULL);
+    uint32_t random = 42U;
+    size_t mismatches = 0U;
+    for (size_t round = 0U; round < 3000U; round++)
+    {
+        random = random * 1103515245U + 12345U;
+        const size_t offset = (random >> 8U) % (reference_len + 1U);
+        random = random * 1103515245U + 12345U;
+        size_t len = (random >> 16U) % ((random & 1U) ? 300U : 8U);
+        if (reference_len + len <= ROPE_REFERENCE_LEN && (random & 6U) != 0U)
+        {
+            for (size_t i = 0U; i < len; i++)
+            {
+                bytes[i] = (uint8_t) ('a' + (round + i) % 26U);
+            }
+            xtr_t* text = xtr_from_bytes(bytes, len);
+            mismatches += !xtr_rope_insert(rope, offset, text);
+            xtr_free(&text);
+            memmove(&reference[offset + len], &reference[offset], reference_len - offset);
+            memcpy(&reference[offset], bytes, len);
+            reference_len += len;
+        }
+        else if ((random & 8U) != 0U)
+        {
+            len = len > reference_len - offset ? reference_len - offset : len;
+            mismatches += !xtr_rope_delete(rope, offset, len);
+            memmove(&reference[offset], &reference[offset + len], reference_len - offset - len);
+            reference_len -= len;
+        }
+        else
+        {
+            xtr_rope_t* tail = xtr_rope_split(rope, offset);
+            mismatches += tail == NULL;
+            mismatches += xtr_rope_length(rope) != offset;
+            mismatches += !xtr_rope_concat(rope, &tail);
+        }
+        mismatches += xtr_rope_length(rope) != reference_len;
+        xtr_rope_iter_t iter;
+        xtr_view_t piece;
+        size_t position = offset;
+        xtr_rope_iter_init(&iter, rope, offset);
+        while (xtr_rope_next(&iter, &piece))
+        {
+            mismatches += piece.length == 0U;
+            mismatches += memcmp(piece.bytes, &reference[position], piece.length) != 0;
+            position += piece.length;
+        }
+        mismatches += position != (offset > reference_len ? offset : reference_len);
+    }
+    xtr_t* flat = xtr_rope_flatten(rope);
+    atto_neq(flat, NULL);
+    atto_eq(xtr_length(flat), reference_len);
+    atto_eq(memcmp(xtr_cstring(flat), reference, reference_len), 0);
+    atto_eq(mismatches, 0U);
+    xtr_free(&flat);
+    xtr_rope_free(&rope);
+}
+
+void
+xtrtest_rope_fail_malloc(void)
+{
+    xtr_rope_t* rope = xtr_rope_new();
+    xtr_t* text = xtr_from_str_repeat("0123456789", 40U);
+    atto_neq(rope, NULL);
+    atto_neq(text, NULL);
+    for (size_t i = 0U; i < 20U; i++)
+    {
+        atto_true(xtr_rope_insert(rope, i * 7U, text));
+    }
+    xtr_t* before = xtr_rope_flatten(rope);
+    atto_neq(before, NULL);
+    size_t mismatches = 0U;
+    for (size_t fail_after = 0U; fail_after < 12U; fail_after++)
+    {
+        xtrtest_malloc_fail_after(fail_after);
+        const bool inserted = xtr_rope_insert(rope, 1234U, text);
+        xtrtest_malloc_disable_failing();
+        if (inserted)
+        {
+            mismatches += !xtr_rope_delete(rope, 1234U, xtr_length(text));
+        }
+        xtrtest_malloc_fail_after(fail_after);
+        xtr_rope_t* tail = xtr_rope_split(rope, 777U);
+        xtrtest_malloc_disable_failing();
+        if (tail != NULL)
+        {
+            mismatches += !xtr_rope_concat(rope, &tail);
+        }
+        xtr_t* after = xtr_rope_flatten(rope);
+        mismatches += !xtr_is_equal(before, after);
+        xtr_free(&after);
+    }
+    atto_eq(mismatches, 0U);
+    xtr_free(&before);
+    xtr_free(&text);
+    xtr_rope_free(&rope);
+}
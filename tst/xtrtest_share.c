@@ -0,0 +1,366 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_share_valid_null(void)
+{
+    xtr_t* null = NULL;
+    atto_eq(xtr_share(NULL), NULL);
+    atto_false(xtr_is_shared(NULL));
+    atto_eq(xtr_references(NULL), 0U);
+    atto_eq(xtr_unshare(NULL), NULL);
+    atto_eq(xtr_unshare(&null), NULL);
+    xtr_release(NULL);
+    xtr_release(&null);
+    atto_eq(null, NULL);
+}
+
+void
+xtrtest_share_valid_and_release(void)
+{
+    xtr_t* original = xtr_from_str("payload");
+    atto_neq(original, NULL);
+    atto_false(xtr_is_shared(original));
+    atto_eq(xtr_references(original), 1U);
+
+    xtr_t* first = xtr_share(original);
+    xtr_t* second = xtr_share(original);
+    atto_eq(first, original);
+    atto_eq(second, original);
+    atto_true(xtr_is_shared(original));
+    atto_eq(xtr_references(original), 3U);
+
+    xtr_release(&first);
+    atto_eq(first, NULL);
+    atto_eq(xtr_references(original), 2U);
+    xtr_free(&original);
+    atto_eq(original, NULL);
+    atto_false(xtr_is_shared(second));
+    atto_streq(xtr_cstring(second), "payload", 8);
+    xtr_release(&second);
+    atto_eq(second, NULL);
+}
+
+void
+xtrtest_share_valid_clone_is_deep(void)
+{
+    xtr_t* original = xtr_from_str("  payload  ");
+    atto_neq(original, NULL);
+    xtr_t* shared = xtr_share(original);
+    xtr_t* clone = xtr_clone(original);
+    atto_neq(clone, NULL);
+    atto_neq(clone, original);
+    atto_eq(xtr_references(original), 2U);
+    atto_eq(xtr_references(clone), 1U);
+    atto_true(xtr_trim(clone, NULL));
+    atto_streq(xtr_cstring(clone), "payload", 8);
+    atto_streq(xtr_cstring(original), "  payload  ", 12);
+
+    xtr_free(&clone);
+    xtr_free(&shared);
+    xtr_free(&original);
+}
+
+/** Applies an in-place mutator to a shared xtring, then to its private copy. */
+#define XTRTEST_SHARE_MUTATOR(call, private_expected)                                              \
+    do                                                                                             \
+    {                                                                                              \
+        xtr_t* original = xtr_from_str_capac("  payload  ", 30U);                                  \
+        xtr_t* xtr = xtr_share(original);                                                          \
+        applied_while_shared += (call);                                                            \
+        altered_while_shared += strcmp(xtr_cstring(original), "  payload  ") != 0;                 \
+        altered_while_shared += xtr_references(original) != 2U;                                    \
+        xtr_unshare(&xtr);                                                                         \
+        not_applied += !(call);                                                                    \
+        not_applied += strcmp(xtr_cstring(xtr), (private_expected)) != 0;                          \
+        altered_while_shared += strcmp(xtr_cstring(original), "  payload  ") != 0;                 \
+        xtr_free(&xtr);                                                                            \
+        xtr_free(&original);                                                                       \
+    } while (0)
+
+void
+xtrtest_share_valid_in_place_changes_are_refused(void)
+{
+    xtr_t* extension = xtr_from_str("!");
+    atto_neq(extension, NULL);
+    size_t applied_while_shared = 0U;
+    size_t altered_while_shared = 0U;
+    size_t not_applied = 0U;
+    XTRTEST_SHARE_MUTATOR(xtr_push_tail(xtr, extension) != 0U, "  payload  !");
+    XTRTEST_SHARE_MUTATOR(xtr_push_head(xtr, extension) != 0U, "!  payload  ");
+    XTRTEST_SHARE_MUTATOR(xtr_truncate_head(xtr, 2U), "payload  ");
+    XTRTEST_SHARE_MUTATOR(xtr_truncate_tail(xtr, 2U), "  payload");
+    XTRTEST_SHARE_MUTATOR(xtr_truncate_prefix(xtr, "  "), "payload  ");
+    XTRTEST_SHARE_MUTATOR(xtr_truncate_suffix(xtr, "  "), "  payload");
+    XTRTEST_SHARE_MUTATOR(xtr_trim_head(xtr, NULL), "payload  ");
+    XTRTEST_SHARE_MUTATOR(xtr_trim_tail(xtr, NULL), "  payload");
+    XTRTEST_SHARE_MUTATOR(xtr_trim(xtr, NULL), "payload");
+    XTRTEST_SHARE_MUTATOR(xtr_reverse(xtr), "  daolyap  ");
+    XTRTEST_SHARE_MUTATOR(xtr_clear(xtr), "");
+    atto_eq(applied_while_shared, 0U);
+    atto_eq(altered_while_shared, 0U);
+    atto_eq(not_applied, 0U);
+
+    xtr_t* original = xtr_from_str("  payload  ");
+    xtr_t* shared = xtr_share(original);
+    atto_eq(xtr_pop_head(shared, 2U), NULL);
+    atto_eq(xtr_pop_tail(shared, 2U), NULL);
+    atto_streq(xtr_cstring(original), "  payload  ", 12);
+    atto_false(xtr_reverse(original));
+    xtr_free(&shared);
+
+    // A slice of it is another owner too
+    xtr_slice_t slice;
+    atto_true(xtr_slice_shared(&slice, original, 2U, 7U));
+    atto_false(xtr_trim(original, NULL));
+    atto_streq(xtr_cstring(original), "  payload  ", 12);
+    xtr_slice_free(&slice);
+    atto_true(xtr_trim(original, NULL));
+    atto_streq(xtr_cstring(original), "payload", 8);
+    xtr_free(&original);
+    xtr_free(&extension);
+}
+
+/** Applies a copy-on-write mutator to a shared xtring, then to a private one. */
+#define XTRTEST_SHARE_COW(call, expected)                                                          \
+    do                                                                                             \
+    {                                                                                              \
+        xtr_t* original = xtr_from_str_capac("  payload  ", 30U);                                  \
+        xtr_t* xtr = xtr_share(original);                                                          \
+        not_applied += !(call);                                                                    \
+        not_applied += xtr == original;                                                            \
+        not_applied += strcmp(xtr_cstring(xtr), (expected)) != 0;                                  \
+        altered_while_shared += strcmp(xtr_cstring(original), "  payload  ") != 0;                 \
+        altered_while_shared += xtr_references(original) != 1U;                                    \
+        xtr_free(&xtr);                                                                            \
+        xtr = original;                                                                            \
+        not_applied += !(call);                                                                    \
+        copied_while_private += xtr != original;                                                   \
+        not_applied += strcmp(xtr_cstring(xtr), (expected)) != 0;                                  \
+        xtr_free(&xtr);                                                                            \
+    } while (0)
+
+void
+xtrtest_share_valid_copy_on_write(void)
+{
+    xtr_t* extension = xtr_from_str("!");
+    atto_neq(extension, NULL);
+    size_t altered_while_shared = 0U;
+    size_t copied_while_private = 0U;
+    size_t not_applied = 0U;
+    XTRTEST_SHARE_COW(xtr_push_tail_cow(&xtr, extension) == 1U, "  payload  !");
+    XTRTEST_SHARE_COW(xtr_push_head_cow(&xtr, extension) == 1U, "!  payload  ");
+    XTRTEST_SHARE_COW(xtr_truncate_head_cow(&xtr, 2U), "payload  ");
+    XTRTEST_SHARE_COW(xtr_truncate_tail_cow(&xtr, 2U), "  payload");
+    XTRTEST_SHARE_COW(xtr_truncate_head_cow(&xtr, 100U), "");
+    XTRTEST_SHARE_COW(xtr_truncate_prefix_cow(&xtr, "  "), "payload  ");
+    XTRTEST_SHARE_COW(xtr_truncate_suffix_cow(&xtr, "  "), "  payload");
+    XTRTEST_SHARE_COW(xtr_trim_head_cow(&xtr, NULL), "payload  ");
+    XTRTEST_SHARE_COW(xtr_trim_tail_cow(&xtr, NULL), "  payload");
+    XTRTEST_SHARE_COW(xtr_trim_cow(&xtr, NULL), "payload");
+    XTRTEST_SHARE_COW(xtr_trim_cow(&xtr, " payload"), "");
+    XTRTEST_SHARE_COW(xtr_reverse_cow(&xtr), "  daolyap  ");
+    XTRTEST_SHARE_COW(xtr_clear_cow(&xtr), "");
+    atto_eq(altered_while_shared, 0U);
+    atto_eq(copied_while_private, 0U);
+    atto_eq(not_applied, 0U);
+
+    // Pops return the removed bytes, the remaining ones are in the copy
+    xtr_t* original = xtr_from_str("  payload  ");
+    xtr_t* shared = xtr_share(original);
+    xtr_t* head = xtr_pop_head_cow(&shared, 2U);
+    xtr_t* tail = xtr_pop_tail_cow(&shared, 2U);
+    atto_streq(xtr_cstring(head), "  ", 3);
+    atto_streq(xtr_cstring(tail), "  ", 3);
+    atto_streq(xtr_cstring(shared), "payload", 8);
+    atto_streq(xtr_cstring(original), "  payload  ", 12);
+    atto_eq(xtr_references(original), 1U);
+    atto_eq(xtr_references(shared), 1U);
+    xtr_free(&tail);
+    xtr_free(&head);
+    xtr_free(&shared);
+
+    // Not matching prefix/suffix: nothing to copy
+    shared = xtr_share(original);
+    atto_true(xtr_truncate_prefix_cow(&shared, "abc"));
+    atto_true(xtr_truncate_suffix_cow(&shared, NULL));
+    atto_eq(shared, original);
+    atto_eq(xtr_references(original), 2U);
+    xtr_free(&shared);
+
+    // Pushing onto itself
+    shared = xtr_share(original);
+    atto_eq(xtr_push_tail_cow(&shared, original), 0U);  // Not enough capacity
+    atto_eq(shared, original);
+    xtr_free(&shared);
+    xtr_t* roomy = xtr_from_str_capac("ab", 10U);
+    shared = xtr_share(roomy);
+    atto_eq(xtr_push_tail_cow(&shared, shared), 2U);
+    atto_streq(xtr_cstring(shared), "abab", 5);
+    atto_streq(xtr_cstring(roomy), "ab", 3);
+    xtr_free(&shared);
+    xtr_free(&roomy);
+
+    xtr_free(&original);
+    xtr_free(&extension);
+}
+
+void
+xtrtest_share_valid_copy_on_write_null(void)
+{
+    xtr_t* null = NULL;
+    xtr_t* extension = xtr_from_str("!");
+    atto_false(xtr_clear_cow(NULL));
+    atto_false(xtr_clear_cow(&null));
+    atto_false(xtr_truncate_head_cow(&null, 1U));
+    atto_false(xtr_truncate_tail_cow(&null, 1U));
+    atto_false(xtr_truncate_prefix_cow(&null, "a"));
+    atto_false(xtr_truncate_suffix_cow(&null, "a"));
+    atto_false(xtr_trim_cow(&null, NULL));
+    atto_false(xtr_trim_head_cow(NULL, NULL));
+    atto_false(xtr_trim_tail_cow(&null, NULL));
+    atto_false(xtr_reverse_cow(&null));
+    atto_eq(xtr_pop_head_cow(&null, 1U), NULL);
+    atto_eq(xtr_pop_tail_cow(NULL, 1U), NULL);
+    atto_eq(xtr_push_head_cow(&null, extension), 0U);
+    atto_eq(xtr_push_tail_cow(&null, extension), 0U);
+    atto_false(xtr_clear(NULL));
+    atto_false(xtr_trim(NULL, NULL));
+    atto_false(xtr_truncate_prefix(NULL, "a"));
+    atto_false(xtr_reverse(NULL));
+    atto_eq(null, NULL);
+    xtr_free(&extension);
+}
+
+void
+xtrtest_share_fail_malloc(void)
+{
+    xtr_t* original = xtr_from_str_capac("  payload  ", 30U);
+    xtr_t* extension = xtr_from_str("!");
+    atto_neq(original, NULL);
+    atto_neq(extension, NULL);
+    xtr_t* shared = xtr_share(original);
+
+    xtrtest_malloc_fail_after(0);
+    atto_false(xtr_trim_cow(&shared, NULL));
+    xtrtest_malloc_fail_after(0);
+    atto_false(xtr_clear_cow(&shared));
+    xtrtest_malloc_fail_after(0);
+    atto_false(xtr_reverse_cow(&shared));
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_push_tail_cow(&shared, extension), 0U);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_pop_head_cow(&shared, 2U), NULL);
+    xtrtest_malloc_fail_after(1);  // Popped bytes allocated, copy fails
+    atto_eq(xtr_pop_tail_cow(&shared, 2U), NULL);
+    xtrtest_malloc_disable_failing();
+    atto_eq(shared, original);
+    atto_eq(xtr_references(original), 2U);
+    atto_streq(xtr_cstring(original), "  payload  ", 12);
+
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_unshare(&shared), NULL);
+    xtrtest_malloc_disable_failing();
+    atto_eq(shared, original);
+    atto_eq(xtr_references(original), 2U);
+
+    xtr_free(&shared);
+    xtr_free(&original);
+    xtr_free(&extension);
+}
+
+void
+xtrtest_share_valid_replacing_functions(void)
+{
+    xtr_t* original = xtr_from_str_capac("payload", 30U);
+    xtr_t* extension = xtr_from_str("!");
+    atto_neq(original, NULL);
+    atto_neq(extension, NULL);
+
+    xtr_t* extended = xtr_share(original);
+    atto_neq(xtr_extend_tail(&extended, extension), NULL);
+    atto_neq(extended, original);
+    atto_streq(xtr_cstring(extended), "payload!", 9);
+    atto_eq(xtr_references(original), 1U);
+
+    xtr_t* prefixed = xtr_share(original);
+    atto_neq(xtr_extend_head(&prefixed, extension), NULL);
+    atto_neq(prefixed, original);
+    atto_streq(xtr_cstring(prefixed), "!payload", 9);
+
+    xtr_t* truncated = xtr_share(original);
+    atto_neq(xtr_truncate(&truncated, 3U), NULL);
+    atto_neq(truncated, original);
+    atto_streq(xtr_cstring(truncated), "pay", 4);
+
+    xtr_t* shared = xtr_share(original);
+    xtr_t* resized = xtr_resize(shared, 3U);
+    atto_neq(resized, original);
+    atto_streq(xtr_cstring(resized), "pay", 4);
+    xtr_free(&shared);
+
+    atto_streq(xtr_cstring(original), "payload", 8);
+    atto_eq(xtr_references(original), 1U);
+    atto_eq(xtr_push_tail(original, extension), 1U);
+    atto_streq(xtr_cstring(original), "payload!", 9);
+
+    xtr_free(&resized);
+    xtr_free(&truncated);
+    xtr_free(&prefixed);
+    xtr_free(&extended);
+    xtr_free(&original);
+    xtr_free(&extension);
+}
+
+void
+xtrtest_share_valid_unshare(void)
+{
+    xtr_t* original = xtr_from_str_capac("  payload  ", 30U);
+    atto_neq(original, NULL);
+    xtr_t* alias = original;
+    atto_eq(xtr_unshare(&alias), original);
+    atto_eq(alias, original);
+
+    xtr_t* consumer = xtr_share(original);
+    atto_neq(xtr_unshare(&consumer), NULL);
+    atto_neq(consumer, original);
+    atto_eq(xtr_references(original), 1U);
+    atto_eq(xtr_references(consumer), 1U);
+    atto_eq(xtr_capacity(consumer), xtr_capacity(original));
+    xtr_trim(consumer, NULL);
+    atto_streq(xtr_cstring(consumer), "payload", 8);
+    atto_streq(xtr_cstring(original), "  payload  ", 12);
+
+    xtr_free(&consumer);
+    xtr_free(&original);
+}
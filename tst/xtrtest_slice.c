@@ -0,0 +1,260 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+void
+xtrtest_slice_valid_null(void)
+{
+    xtr_t* parent = xtr_from_str("abc");
+    atto_neq(parent, NULL);
+    xtr_slice_t slice;
+    atto_false(xtr_slice_shared(NULL, parent, 0U, 1U));
+    atto_false(xtr_is_shared(parent));
+    atto_false(xtr_slice_shared(&slice, NULL, 0U, 1U));
+    atto_eq(slice.view.bytes, NULL);
+    atto_eq(slice.parent, NULL);
+    xtr_slice_t sub;
+    atto_false(xtr_slice_sub(&sub, NULL, 0U, 1U));
+    atto_eq(sub.parent, NULL);
+    atto_false(xtr_slice_sub(NULL, &slice, 0U, 1U));
+    xtr_slice_t popped;
+    atto_false(xtr_slice_pop_head(&popped, NULL, 1U));
+    atto_eq(popped.parent, NULL);
+    atto_false(xtr_slice_pop_tail(&popped, NULL, 1U));
+    atto_eq(popped.parent, NULL);
+    atto_false(xtr_slice_pop_head(&popped, &slice, 1U));
+    atto_eq(popped.parent, NULL);
+    atto_false(xtr_slice_pop_tail(&popped, &slice, 1U));
+    atto_eq(popped.parent, NULL);
+    atto_false(xtr_slice_compact(NULL));
+    atto_false(xtr_slice_compact(&slice));
+    xtr_slice_free(NULL);
+    xtr_slice_free(&slice);
+    xtr_slices_free(NULL, 1U);
+    size_t amount = 0U;
+    atto_eq(xtr_split_slices(NULL, NULL, NULL), NULL);
+    atto_eq(xtr_split_slices(&amount, NULL, NULL), NULL);
+
+    // A NULL destination leaves the source slice untouched
+    atto_true(xtr_slice_shared(&slice, parent, 0U, SIZE_MAX));
+    atto_false(xtr_slice_pop_head(NULL, &slice, 1U));
+    atto_false(xtr_slice_pop_tail(NULL, &slice, 1U));
+    atto_eq(slice.view.length, 3U);
+    atto_eq(xtr_references(parent), 2U);
+    xtr_slice_free(&slice);
+    xtr_free(&parent);
+}
+
+void
+xtrtest_slice_valid_keeps_parent_alive(void)
+{
+    xtr_t* received = xtr_from_str("key=value");
+    atto_neq(received, NULL);
+    xtr_slice_t key;
+    xtr_slice_t value;
+    atto_true(xtr_slice_shared(&key, received, 0U, 3U));
+    atto_true(xtr_slice_shared(&value, received, 4U, SIZE_MAX));
+    atto_eq(key.parent, received);
+    atto_eq(key.view.bytes, (const uint8_t*) xtr_cstring(received));
+    atto_eq(key.view.length, 3U);
+    atto_eq(value.view.length, 5U);
+    atto_eq(xtr_references(received), 3U);
+    atto_eq(xtr_push_tail(received, received), 0U);  // Read-only while sliced
+
+    xtr_free(&received);
+    atto_eq(memcmp(key.view.bytes, "key", 3U), 0);
+    atto_eq(memcmp(value.view.bytes, "value", 5U), 0);
+    xtr_slice_free(&key);
+    atto_eq(key.parent, NULL);
+    atto_eq(key.view.bytes, NULL);
+    atto_eq(xtr_references(value.parent), 1U);
+    xtr_slice_free(&value);
+}
+
+void
+xtrtest_slice_valid_out_of_range(void)
+{
+    xtr_t* parent = xtr_from_str("abc");
+    atto_neq(parent, NULL);
+    xtr_slice_t past;
+    atto_false(xtr_slice_shared(&past, parent, 4U, 1U));
+    atto_eq(past.parent, NULL);
+    xtr_slice_t end;
+    atto_true(xtr_slice_shared(&end, parent, 3U, 1U));
+    atto_eq(end.parent, parent);
+    atto_eq(end.view.length, 0U);
+    xtr_slice_t sub;
+    atto_false(xtr_slice_sub(&sub, &end, 1U, 1U));
+    atto_eq(sub.parent, NULL);
+    atto_eq(xtr_references(parent), 2U);
+    xtr_slice_free(&end);
+    atto_false(xtr_is_shared(parent));
+    xtr_free(&parent);
+}
+
+void
+xtrtest_slice_valid_pop(void)
+{
+    xtr_t* parent = xtr_from_str("GET /index.html HTTP/1.1");
+    atto_neq(parent, NULL);
+    xtr_slice_t line;
+    atto_true(xtr_slice_shared(&line, parent, 0U, SIZE_MAX));
+    xtr_free(&parent);
+
+    xtr_slice_t method;
+    xtr_slice_t version;
+    atto_true(xtr_slice_pop_head(&method, &line, 3U));
+    atto_true(xtr_slice_pop_tail(&version, &line, 8U));
+    atto_eq(method.parent, line.parent);
+    atto_eq(version.parent, line.parent);
+    atto_eq(xtr_references(line.parent), 3U);
+    atto_eq(method.view.length, 3U);
+    atto_eq(memcmp(method.view.bytes, "GET", 3U), 0);
+    atto_eq(version.view.length, 8U);
+    atto_eq(memcmp(version.view.bytes, "HTTP/1.1", 8U), 0);
+    atto_eq(line.view.length, 13U);
+    atto_eq(memcmp(line.view.bytes, " /index.html ", 13U), 0);
+
+    xtr_slice_t all;
+    atto_true(xtr_slice_pop_head(&all, &line, 100U));
+    atto_eq(all.view.length, 13U);
+    atto_eq(line.view.length, 0U);
+    xtr_slice_t none;
+    atto_true(xtr_slice_pop_tail(&none, &line, 100U));
+    atto_eq(none.view.length, 0U);
+    atto_neq(none.parent, NULL);
+
+    xtr_slice_free(&none);
+    xtr_slice_free(&all);
+    xtr_slice_free(&line);
+    xtr_slice_free(&version);
+    atto_eq(xtr_references(method.parent), 1U);
+    xtr_slice_free(&method);
+}
+
+void
+xtrtest_slice_valid_split(void)
+{
+    xtr_t* parent = xtr_from_str("a,bc,,def");
+    xtr_t* comma = xtr_from_str(",");
+    atto_neq(parent, NULL);
+    atto_neq(comma, NULL);
+    size_t amount = 0U;
+    xtr_slice_t* slices = xtr_split_slices(&amount, parent, comma);
+    atto_neq(slices, NULL);
+    atto_eq(amount, 4U);
+    atto_eq(xtr_references(parent), 5U);
+    xtr_free(&parent);
+    static const char* const expected[] = {"a", "bc", "", "def"};
+    size_t mismatches = 0U;
+    for (size_t i = 0U; i < amount; i++)
+    {
+        mismatches += slices[i].view.length != strlen(expected[i]);
+        mismatches += memcmp(slices[i].view.bytes, expected[i], slices[i].view.length) != 0;
+    }
+    atto_eq(mismatches, 0U);
+    xtr_slice_free(&slices[0]);
+    xtr_slices_free(&slices, amount);
+    atto_eq(slices, NULL);
+    xtr_free(&comma);
+}
+
+void
+xtrtest_slice_fail_malloc(void)
+{
+    xtr_t* parent = xtr_from_str("a,b");
+    xtr_t* comma = xtr_from_str(",");
+    atto_neq(parent, NULL);
+    atto_neq(comma, NULL);
+    size_t amount = 0U;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_split_slices(&amount, parent, comma), NULL);
+    xtrtest_malloc_disable_failing();
+    atto_eq(amount, 0U);
+    atto_false(xtr_is_shared(parent));
+    xtr_free(&parent);
+    xtr_free(&comma);
+}
+
+void
+xtrtest_slice_valid_compact(void)
+{
+    xtr_t* parent = xtr_from_str_capac("header: value", 1000U);
+    atto_neq(parent, NULL);
+    xtr_slice_t name;
+    xtr_slice_t value;
+    atto_true(xtr_slice_shared(&name, parent, 0U, 6U));
+    atto_true(xtr_slice_shared(&value, parent, 8U, 5U));
+    xtr_free(&parent);
+
+    xtrtest_malloc_fail_after(0);
+    atto_false(xtr_slice_compact(&name));
+    xtrtest_malloc_disable_failing();
+    atto_eq(name.parent, value.parent);
+
+    atto_true(xtr_slice_compact(&name));
+    atto_neq(name.parent, value.parent);
+    atto_eq(xtr_capacity(name.parent), 6U);
+    atto_eq(xtr_references(value.parent), 1U);
+    atto_eq(name.view.bytes, (const uint8_t*) xtr_cstring(name.parent));
+    atto_streq(xtr_cstring(name.parent), "header", 7);
+    xtr_t* const compacted = name.parent;
+    atto_true(xtr_slice_compact(&name));
+    atto_eq(name.parent, compacted);
+
+    xtr_slice_free(&name);
+    xtr_slice_free(&value);
+}
+
+void
+xtrtest_slice_valid_free_array_of_mixed_parents(void)
+{
+    xtr_t* first = xtr_from_str("first");
+    xtr_t* second = xtr_from_str("second");
+    atto_neq(first, NULL);
+    atto_neq(second, NULL);
+    xtr_slice_t* slices = malloc(5U * sizeof(xtr_slice_t));
+    atto_neq(slices, NULL);
+    atto_true(xtr_slice_shared(&slices[0], first, 0U, 1U));
+    atto_true(xtr_slice_shared(&slices[1], first, 1U, 1U));
+    atto_true(xtr_slice_shared(&slices[2], second, 0U, 1U));
+    atto_false(xtr_slice_shared(&slices[3], NULL, 0U, 1U));
+    atto_true(xtr_slice_shared(&slices[4], first, 2U, 1U));
+    atto_eq(xtr_references(first), 4U);
+    atto_eq(xtr_references(second), 2U);
+    xtr_slices_free(&slices, 5U);
+    atto_eq(slices, NULL);
+    atto_eq(xtr_references(first), 1U);
+    atto_eq(xtr_references(second), 1U);
+    xtr_free(&first);
+    xtr_free(&second);
+}
@@ -0,0 +1,406 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+void
+xtrtest_split_valid_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    size_t amount = 42;
+    atto_eq(xtr_split(NULL, xtr, xtr), NULL);
+    atto_eq(xtr_split(&amount, NULL, xtr), NULL);
+    atto_eq(xtr_split(&amount, xtr, NULL), NULL);
+    atto_eq(xtr_split(&amount, xtr, empty), NULL);
+    atto_eq(amount, 42);
+    xtr_free(&xtr);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_split_valid_separators(void)
+{
+    xtr_t* xtr = xtr_from_str(",a,,bc,");
+    xtr_t* separator = xtr_from_str(",");
+    size_t amount = 42;
+    xtr_t** chunks = xtr_split(&amount, xtr, separator);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 5);
+    atto_streq(xtr_cstring(chunks[0]), "", 10);
+    atto_streq(xtr_cstring(chunks[1]), "a", 10);
+    atto_streq(xtr_cstring(chunks[2]), "", 10);
+    atto_streq(xtr_cstring(chunks[3]), "bc", 10);
+    atto_streq(xtr_cstring(chunks[4]), "", 10);
+    for (size_t i = 0; i < amount; i++)
+    {
+        xtr_free(&chunks[i]);
+    }
+    free(chunks);
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_no_separator(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* separator = xtr_from_str("--");
+    size_t amount = 42;
+    xtr_t** chunks = xtr_split(&amount, xtr, separator);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 1);
+    atto_streq(xtr_cstring(chunks[0]), "abc", 10);
+    xtr_free(&chunks[0]);
+    free(chunks);
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_many_chunks(void)
+{
+    xtr_t* xtr = xtr_from_str_repeat("ab--", 50);
+    xtr_t* separator = xtr_from_str("--");
+    size_t amount = 42;
+    xtr_t** chunks = xtr_split(&amount, xtr, separator);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 51);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < amount; i++)
+    {
+        mismatches += strcmp(xtr_cstring(chunks[i]), i < 50 ? "ab" : "") != 0;
+        xtr_free(&chunks[i]);
+    }
+    atto_eq(mismatches, 0);
+    free(chunks);
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_fail_malloc(void)
+{
+    xtr_t* xtr = xtr_from_str_repeat("ab--", 50);
+    xtr_t* separator = xtr_from_str("--");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_split(&amount, xtr, separator), NULL);
+    xtrtest_malloc_fail_after(3);
+    atto_eq(xtr_split(&amount, xtr, separator), NULL);
+    xtrtest_malloc_fail_after(9);
+    atto_eq(xtr_split(&amount, xtr, separator), NULL);
+    atto_eq(amount, 42);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_views_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    xtr_view_t views[2];
+    size_t amount = 42;
+    atto_eq(xtr_split_views_into(NULL, 1U, xtr, xtr), XTR_NOT_FOUND);
+    atto_eq(xtr_split_views_into(views, 2U, NULL, xtr), XTR_NOT_FOUND);
+    atto_eq(xtr_split_views_into(views, 2U, xtr, NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_split_views_into(views, 2U, xtr, empty), XTR_NOT_FOUND);
+    atto_eq(xtr_split_views(NULL, xtr, xtr), NULL);
+    atto_eq(xtr_split_views(&amount, NULL, xtr), NULL);
+    atto_eq(xtr_split_views(&amount, xtr, empty), NULL);
+    atto_eq(xtr_split_packed(NULL, xtr, xtr), NULL);
+    atto_eq(xtr_split_packed(&amount, NULL, xtr), NULL);
+    atto_eq(xtr_split_packed(&amount, xtr, empty), NULL);
+    atto_eq(amount, 42);
+    xtr_free(&xtr);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_split_valid_views_into(void)
+{
+    xtr_t* xtr = xtr_from_str(",a,,bc,");
+    xtr_t* separator = xtr_from_str(",");
+    // Counting only
+    atto_eq(xtr_split_views_into(NULL, 0U, xtr, separator), 5);
+    // Only the first chunks fit, all are counted
+    xtr_view_t views[5];
+    atto_eq(xtr_split_views_into(views, 2U, xtr, separator), 5);
+    atto_eq(views[0].length, 0);
+    atto_eq(views[1].length, 1);
+    atto_eq(views[1].bytes, xtr_bytes(xtr) + 1);
+    atto_eq(xtr_split_views_into(views, 5U, xtr, separator), 5);
+    atto_eq(views[2].length, 0);
+    atto_eq(views[3].bytes, xtr_bytes(xtr) + 4);
+    atto_eq(views[3].length, 2);
+    atto_eq(views[4].bytes, xtr_bytes(xtr) + 7);
+    atto_eq(views[4].length, 0);
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_views_and_packed_as_split(void)
+{
+    const char* const texts[] = {"", "--", "ab", "--ab", "ab--", "a----b", "ab--cd--ef", "-a-"};
+    const size_t amount_of_texts = sizeof(texts) / sizeof(texts[0]);
+    xtr_t* separator = xtr_from_str("--");
+    size_t mismatches = 0U;
+    for (size_t t = 0U; t < amount_of_texts; t++)
+    {
+        xtr_t* xtr = xtr_from_str(texts[t]);
+        size_t amount = 0U;
+        size_t views_amount = 0U;
+        size_t packed_amount = 0U;
+        xtr_t** chunks = xtr_split(&amount, xtr, separator);
+        xtr_view_t* views = xtr_split_views(&views_amount, xtr, separator);
+        xtr_t** packed = xtr_split_packed(&packed_amount, xtr, separator);
+        mismatches += chunks == NULL || views == NULL || packed == NULL;
+        mismatches += views_amount != amount || packed_amount != amount;
+        for (size_t i = 0U; i < amount && views != NULL && packed != NULL; i++)
+        {
+            xtr_view_t chunk;
+            xtr_view(&chunk, chunks[i]);
+            mismatches += !xtr_view_is_equal(views[i], chunk);
+            mismatches += !xtr_is_equal(packed[i], chunks[i]);
+            // Null-terminated and aligned like any other xtring
+            mismatches += strlen(xtr_cstring(packed[i])) != xtr_length(packed[i]);
+            mismatches += xtr_available(packed[i]) != 0U;
+            mismatches += (uintptr_t) packed[i] % sizeof(size_t) != 0U;
+            xtr_free(&chunks[i]);
+        }
+        free(chunks);
+        free(views);
+        free(packed);
+        xtr_free(&xtr);
+    }
+    atto_eq(mismatches, 0);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_packed_many_chunks(void)
+{
+    xtr_t* xtr = xtr_from_str_repeat("abc,", 1000);
+    xtr_t* separator = xtr_from_str(",");
+    size_t amount = 0U;
+    xtr_t** packed = xtr_split_packed(&amount, xtr, separator);
+    atto_neq(packed, NULL);
+    atto_eq(amount, 1001);
+    size_t mismatches = 0U;
+    for (size_t i = 0U; i < amount; i++)
+    {
+        mismatches += strcmp(xtr_cstring(packed[i]), i < 1000U ? "abc" : "") != 0;
+    }
+    atto_eq(mismatches, 0);
+    // Usable as any xtring without reallocation
+    xtr_t* clone = xtr_clone(packed[3]);
+    atto_true(xtr_is_equal(clone, packed[0]));
+    xtr_free(&clone);
+    free(packed);
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_fail_malloc_views_and_packed(void)
+{
+    xtr_t* xtr = xtr_from_str_repeat("ab--", 50);
+    xtr_t* separator = xtr_from_str("--");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_split_views(&amount, xtr, separator), NULL);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_split_packed(&amount, xtr, separator), NULL);
+    atto_eq(amount, 42);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&xtr);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_iter_null(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_t* empty = xtr_new_empty();
+    xtr_split_iter_t iter;
+    xtr_view_t chunk;
+    xtr_split_iter_init(NULL, xtr, xtr);
+    xtr_split_iter_init_every(NULL, xtr, 1U);
+    atto_false(xtr_split_next(NULL, &chunk));
+    xtr_split_iter_init(&iter, xtr, xtr);
+    atto_false(xtr_split_next(&iter, NULL));
+    xtr_split_iter_init(&iter, NULL, xtr);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_split_iter_init(&iter, xtr, NULL);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_split_iter_init(&iter, xtr, empty);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_split_iter_init_every(&iter, NULL, 1U);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_split_iter_init_every(&iter, empty, 1U);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_split_iter_init_every(&iter, xtr, 0U);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_free(&xtr);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_split_valid_iter_as_split(void)
+{
+    const char* const texts[] = {"", "--", "ab", "--ab", "ab--", "a----b", "ab--cd--ef", "-a-"};
+    const size_t amount_of_texts = sizeof(texts) / sizeof(texts[0]);
+    xtr_t* separator = xtr_from_str("--");
+    size_t mismatches = 0U;
+    for (size_t t = 0U; t < amount_of_texts; t++)
+    {
+        xtr_t* xtr = xtr_from_str(texts[t]);
+        size_t amount = 0U;
+        xtr_t** chunks = xtr_split(&amount, xtr, separator);
+        xtr_split_iter_t iter;
+        xtr_split_iter_init(&iter, xtr, separator);
+        xtr_view_t chunk;
+        size_t i = 0U;
+        while (xtr_split_next(&iter, &chunk))
+        {
+            xtr_view_t expected;
+            xtr_view(&expected, i < amount ? chunks[i] : NULL);
+            mismatches += i >= amount || !xtr_view_is_equal(chunk, expected);
+            i++;
+        }
+        mismatches += i != amount;
+        // Exhausted also for the following calls
+        mismatches += xtr_split_next(&iter, &chunk);
+        for (i = 0U; i < amount; i++)
+        {
+            xtr_free(&chunks[i]);
+        }
+        free(chunks);
+        xtr_free(&xtr);
+    }
+    atto_eq(mismatches, 0);
+    xtr_free(&separator);
+}
+
+void
+xtrtest_split_valid_iter_every(void)
+{
+    xtr_t* xtr = xtr_from_str("abcdefg");
+    xtr_split_iter_t iter;
+    xtr_view_t chunk;
+    xtr_split_iter_init_every(&iter, xtr, 3U);
+    atto_true(xtr_split_next(&iter, &chunk));
+    atto_eq(chunk.bytes, xtr_bytes(xtr));
+    atto_eq(chunk.length, 3);
+    atto_true(xtr_split_next(&iter, &chunk));
+    atto_eq(chunk.bytes, xtr_bytes(xtr) + 3);
+    atto_eq(chunk.length, 3);
+    atto_true(xtr_split_next(&iter, &chunk));
+    atto_eq(chunk.bytes, xtr_bytes(xtr) + 6);
+    atto_eq(chunk.length, 1);
+    atto_false(xtr_split_next(&iter, &chunk));
+    // Exact multiple and longer than the xtring
+    xtr_split_iter_init_every(&iter, xtr, 7U);
+    atto_true(xtr_split_next(&iter, &chunk));
+    atto_eq(chunk.length, 7);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_split_iter_init_every(&iter, xtr, SIZE_MAX);
+    atto_true(xtr_split_next(&iter, &chunk));
+    atto_eq(chunk.length, 7);
+    atto_false(xtr_split_next(&iter, &chunk));
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_split_valid_iter_early_stop(void)
+{
+    // Third field of a long line: the rest is never scanned
+    xtr_t* line = xtr_from_str_repeat("a,bb,ccc,", 10000);
+    xtr_t* comma = xtr_from_str(",");
+    xtr_split_iter_t iter;
+    xtr_view_t field;
+    xtr_view(&field, NULL);
+    xtr_split_iter_init(&iter, line, comma);
+    for (size_t i = 0U; i < 3U && xtr_split_next(&iter, &field); i++)
+    {
+    }
+    xtr_view_t ccc;
+    xtr_view_from_str(&ccc, "ccc");
+    atto_true(xtr_view_is_equal(field, ccc));
+    atto_eq(iter.chunk_start, 9);
+    xtr_free(&line);
+    xtr_free(&comma);
+}
+
+void
+xtrtest_split_valid_every(void)
+{
+    xtr_t* xtr = xtr_from_str("abcdefg");
+    size_t amount = 42;
+    atto_eq(xtr_split_every(&amount, NULL, 3U), NULL);
+    atto_eq(xtr_split_every(&amount, xtr, 0U), NULL);
+    atto_eq(amount, 42);
+    xtr_t** chunks = xtr_split_every(&amount, xtr, 3U);
+    atto_neq(chunks, NULL);
+    atto_eq(amount, 3);
+    atto_streq(xtr_cstring(chunks[0]), "abc", 10);
+    atto_streq(xtr_cstring(chunks[1]), "def", 10);
+    atto_streq(xtr_cstring(chunks[2]), "g", 10);
+    for (size_t i = 0; i < amount; i++)
+    {
+        xtr_free(&chunks[i]);
+    }
+    free(chunks);
+    chunks = xtr_split_every(NULL, xtr, 7U);
+    atto_neq(chunks, NULL);
+    atto_streq(xtr_cstring(chunks[0]), "abcdefg", 10);
+    xtr_free(&chunks[0]);
+    free(chunks);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_split_fail_malloc_every(void)
+{
+    xtr_t* xtr = xtr_from_str("abcdefg");
+    size_t amount = 42;
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_split_every(&amount, xtr, 3U), NULL);
+    xtrtest_malloc_fail_after(2);
+    atto_eq(xtr_split_every(&amount, xtr, 3U), NULL);
+    atto_eq(amount, 42);
+    xtrtest_malloc_disable_failing();
+    xtr_free(&xtr);
+}
@@ -0,0 +1,147 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "xtrtest.h"
+
+void
+xtrtest_stream_search_valid_null(void)
+{
+    xtr_t* chunk = xtr_from_str("abc");
+    xtr_pattern_t* pattern = xtr_pattern_new(chunk);
+    xtr_stream_search_t* search = xtr_stream_search_new(pattern);
+    atto_neq(search, NULL);
+    atto_eq(xtr_stream_search_new(NULL), NULL);
+    xtr_stream_search_feed(NULL, chunk);
+    xtr_stream_search_feed(search, NULL);
+    xtr_stream_search_reset(NULL);
+    atto_eq(xtr_stream_search_next(NULL), XTR_NOT_FOUND);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_free(&search);
+    atto_eq(search, NULL);
+    xtr_stream_search_free(&search);
+    xtr_stream_search_free(NULL);
+    xtr_pattern_free(&pattern);
+    xtr_free(&chunk);
+}
+
+void
+xtrtest_stream_search_valid_within_chunks(void)
+{
+    xtr_t* needle = xtr_from_str("\r\n");
+    xtr_t* first = xtr_from_str("GET / HTTP/1.1\r\nHost: x\r\n");
+    xtr_t* second = xtr_from_str("\r\n");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    xtr_stream_search_t* search = xtr_stream_search_new(pattern);
+    xtr_stream_search_feed(search, first);
+    atto_eq(xtr_stream_search_next(search), 14);
+    atto_eq(xtr_stream_search_next(search), 23);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_feed(search, second);
+    atto_eq(xtr_stream_search_next(search), 25);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_free(&search);
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+    xtr_free(&first);
+    xtr_free(&second);
+}
+
+void
+xtrtest_stream_search_valid_straddling_chunks(void)
+{
+    xtr_t* needle = xtr_from_str("boundary");
+    xtr_t* first = xtr_from_str("--bou");
+    xtr_t* second = xtr_from_str("nd");
+    xtr_t* third = xtr_from_str("ary--boundar");
+    xtr_t* fourth = xtr_from_str("y");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    xtr_stream_search_t* search = xtr_stream_search_new(pattern);
+    xtr_stream_search_feed(search, first);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_feed(search, second);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_feed(search, third);
+    atto_eq(xtr_stream_search_next(search), 2);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_feed(search, fourth);
+    atto_eq(xtr_stream_search_next(search), 12);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    // Restart on a new stream
+    xtr_stream_search_reset(search);
+    xtr_stream_search_feed(search, fourth);
+    atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    xtr_stream_search_free(&search);
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+    xtr_free(&first);
+    xtr_free(&second);
+    xtr_free(&third);
+    xtr_free(&fourth);
+}
+
+void
+xtrtest_stream_search_valid_non_overlapping(void)
+{
+    // Same as xtr_occurrences("aaaaa", "aa"), fed one byte at a time
+    xtr_t* needle = xtr_from_str("aa");
+    xtr_t* chunk = xtr_from_str("a");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    xtr_stream_search_t* search = xtr_stream_search_new(pattern);
+    size_t found[5];
+    for (size_t i = 0; i < 5; i++)
+    {
+        xtr_stream_search_feed(search, chunk);
+        found[i] = xtr_stream_search_next(search);
+        atto_eq(xtr_stream_search_next(search), XTR_NOT_FOUND);
+    }
+    atto_eq(found[0], XTR_NOT_FOUND);
+    atto_eq(found[1], 0);
+    atto_eq(found[2], XTR_NOT_FOUND);
+    atto_eq(found[3], 2);
+    atto_eq(found[4], XTR_NOT_FOUND);
+    xtr_stream_search_free(&search);
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+    xtr_free(&chunk);
+}
+
+void
+xtrtest_stream_search_fail_malloc(void)
+{
+    xtr_t* needle = xtr_from_str("abc");
+    xtr_pattern_t* pattern = xtr_pattern_new(needle);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_stream_search_new(pattern), NULL);
+    xtr_pattern_free(&pattern);
+    xtr_free(&needle);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+
+void
+xtrtest_trim_valid_null(void)
+{
+    xtr_t* empty = xtr_new_empty();
+    xtr_trim(NULL, NULL);
+    xtr_trim_head(NULL, "a");
+    xtr_trim_tail(NULL, "a");
+    xtr_trim(empty, "a");
+    atto_eq(xtr_length(empty), 0);
+    xtr_free(&empty);
+}
+
+void
+xtrtest_trim_valid_whitespace(void)
+{
+    xtr_t* xtr = xtr_from_str("\r\n Hello world!\r\n");
+    xtr_trim_head(xtr, NULL);
+    atto_streq(xtr_cstring(xtr), "Hello world!\r\n", 100);
+    xtr_trim_tail(xtr, "");
+    atto_streq(xtr_cstring(xtr), "Hello world!", 100);
+    atto_eq(xtr_length(xtr), 12);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_trim_valid_chars(void)
+{
+    xtr_t* xtr = xtr_from_str("===Hello world!===");
+    xtr_trim(xtr, "=-+");
+    atto_streq(xtr_cstring(xtr), "Hello world!", 100);
+    xtr_trim_tail(xtr, ".,!d");
+    atto_streq(xtr_cstring(xtr), "Hello worl", 100);
+    xtr_trim_head(xtr, "eHl");
+    atto_streq(xtr_cstring(xtr), "o worl", 100);
+    atto_eq(xtr_length(xtr), 6);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_trim_valid_everything(void)
+{
+    xtr_t* xtr = xtr_from_str_repeat(" \t", 40);
+    xtr_trim_tail(xtr, NULL);
+    atto_eq(xtr_length(xtr), 0);
+    atto_streq(xtr_cstring(xtr), "", 10);
+    xtr_free(&xtr);
+    xtr = xtr_from_str_repeat(" \t", 40);
+    xtr_trim_head(xtr, NULL);
+    atto_eq(xtr_length(xtr), 0);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_trim_valid_nothing(void)
+{
+    xtr_t* xtr = xtr_from_str("abc");
+    xtr_trim(xtr, NULL);
+    atto_streq(xtr_cstring(xtr), "abc", 10);
+    atto_eq(xtr_length(xtr), 3);
+    xtr_free(&xtr);
+}
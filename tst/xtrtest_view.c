@@ -0,0 +1,286 @@
+/**
+ * @file
+ *
+ * @copyright Copyright © 2022-2024, Matjaž Guštin <dev@matjaz.it>
+ * <https://matjaz.it>. All rights reserved.
+ * @license BSD 3-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS “AS IS”
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xtrtest.h"
+
+/** Classifies a section of a view. */
+static bool
+section_is(bool (*const is_class)(xtr_view_t), const xtr_view_t view, const size_t start,
+           const size_t len)
+{
+    xtr_view_t section;
+    xtr_view_sub(&section, view, start, len);
+    return is_class(section);
+}
+
+void
+xtrtest_view_valid_null(void)
+{
+    xtr_view_t null_view;
+    atto_false(xtr_view(&null_view, NULL));
+    atto_eq(null_view.bytes, NULL);
+    atto_eq(null_view.length, 0);
+    xtr_view_t view;
+    atto_false(xtr_view_from_str(&view, NULL));
+    atto_eq(view.bytes, NULL);
+    atto_false(xtr_view_from_bytes(&view, NULL, 5U));
+    atto_eq(view.length, 0);
+    atto_false(xtr_view_range(&view, NULL, 0U, 1U));
+    atto_eq(view.bytes, NULL);
+    atto_false(xtr_view_sub(&view, null_view, 0U, 1U));
+    atto_eq(view.bytes, NULL);
+    atto_false(xtr_view(NULL, NULL));
+    atto_false(xtr_view_from_str(NULL, "abc"));
+    atto_false(xtr_view_sub(NULL, null_view, 0U, 0U));
+    atto_eq(xtr_from_view(null_view), NULL);
+    atto_eq(xtr_view_to_hex(null_view, true, NULL), NULL);
+    atto_eq(xtr_view_base64_encode(null_view), NULL);
+    xtr_view_t abc;
+    atto_true(xtr_view_from_str(&abc, "abc"));
+    atto_eq(xtr_view_cmp(null_view, null_view), 0);
+    atto_eq(xtr_view_cmp(null_view, abc), -1);
+    atto_eq(xtr_view_cmp(abc, null_view), +1);
+    atto_true(xtr_view_is_equal(null_view, null_view));
+    atto_false(xtr_view_is_equal(abc, null_view));
+    atto_true(xtr_view_startswith(null_view, null_view));
+    atto_false(xtr_view_startswith(abc, null_view));
+    atto_false(xtr_view_endswith(null_view, abc));
+    atto_eq(xtr_view_find(null_view, abc), XTR_NOT_FOUND);
+    atto_eq(xtr_view_find(abc, null_view), XTR_NOT_FOUND);
+    atto_eq(xtr_view_rfind(abc, null_view), XTR_NOT_FOUND);
+    atto_true(xtr_view_is_empty(null_view));
+    atto_false(xtr_view_is_spaces(null_view));
+    atto_false(xtr_view_is_zeros(null_view));
+}
+
+void
+xtrtest_view_valid_range(void)
+{
+    xtr_t* xtr = xtr_from_str("Hello world!");
+    xtr_view_t all;
+    atto_true(xtr_view(&all, xtr));
+    atto_eq(all.bytes, xtr_bytes(xtr));
+    atto_eq(all.length, 12);
+    xtr_view_t world;
+    atto_true(xtr_view_range(&world, xtr, 6U, 5U));
+    atto_eq(world.bytes, xtr_bytes(xtr) + 6);
+    atto_eq(world.length, 5);
+    // Clamped at the end
+    xtr_view_t view;
+    atto_true(xtr_view_range(&view, xtr, 6U, SIZE_MAX));
+    atto_eq(view.length, 6);
+    atto_true(xtr_view_range(&view, xtr, 12U, 3U));
+    atto_eq(view.length, 0);
+    atto_neq(view.bytes, NULL);
+    atto_false(xtr_view_range(&view, xtr, 13U, 0U));
+    atto_eq(view.bytes, NULL);
+    xtr_view_t orl;
+    atto_true(xtr_view_sub(&orl, world, 1U, 3U));
+    atto_eq(orl.bytes, xtr_bytes(xtr) + 7);
+    atto_eq(orl.length, 3);
+    atto_true(xtr_view_sub(&view, world, 4U, 100U));
+    atto_eq(view.length, 1);
+    atto_false(xtr_view_sub(&view, world, 6U, 0U));
+    atto_eq(view.bytes, NULL);
+    // Section of itself
+    atto_true(xtr_view_sub(&world, world, 1U, SIZE_MAX));
+    atto_eq(world.bytes, xtr_bytes(xtr) + 7);
+    atto_eq(world.length, 4);
+    // Copy outliving the source
+    xtr_t* copy = xtr_from_view(world);
+    xtr_free(&xtr);
+    atto_neq(copy, NULL);
+    atto_streq(xtr_cstring(copy), "orld", 5);
+    xtr_free(&copy);
+}
+
+void
+xtrtest_view_valid_cmp(void)
+{
+    xtr_view_t abc;
+    xtr_view_t abcd;
+    xtr_view_t abd;
+    xtr_view_t empty;
+    xtr_view_from_str(&abc, "abc");
+    xtr_view_from_str(&abcd, "abcd");
+    xtr_view_from_str(&abd, "abd");
+    atto_true(xtr_view_from_str(&empty, ""));
+    xtr_view_t abcd_head;
+    xtr_view_t abcd_tail;
+    xtr_view_sub(&abcd_head, abcd, 0U, 3U);
+    xtr_view_sub(&abcd_tail, abcd, 2U, 2U);
+    atto_eq(xtr_view_cmp(abc, abc), 0);
+    atto_eq(xtr_view_cmp(abc, abcd_head), 0);
+    atto_eq(xtr_view_cmp(abc, abcd), -2);
+    atto_eq(xtr_view_cmp(abcd, abc), +2);
+    atto_lt(xtr_view_cmp(abc, abd), 0);
+    atto_gt(xtr_view_cmp(abd, abcd), 0);
+    atto_eq(xtr_view_cmp(empty, abc), -2);
+    atto_true(xtr_view_is_equal(abc, abcd_head));
+    atto_false(xtr_view_is_equal(abc, abcd));
+    atto_false(xtr_view_is_equal(abc, abd));
+    atto_true(xtr_view_startswith(abcd, abc));
+    atto_false(xtr_view_startswith(abc, abcd));
+    atto_true(xtr_view_startswith(abc, empty));
+    atto_true(xtr_view_endswith(abcd, abcd_tail));
+    atto_false(xtr_view_endswith(abcd, abc));
+    atto_false(xtr_view_endswith(abc, abcd));
+}
+
+void
+xtrtest_view_valid_same_as_xtr(void)
+{
+    // Views give the same results as the xtrings they view
+    const char* const words[] = {"", "a", "ab", "abc", "b", "ba", "bab", "aba", "abab"};
+    const size_t amount = sizeof(words) / sizeof(words[0]);
+    size_t mismatches = 0U;
+    for (size_t i = 0U; i < amount; i++)
+    {
+        for (size_t j = 0U; j < amount; j++)
+        {
+            xtr_t* a = xtr_from_str(words[i]);
+            xtr_t* b = xtr_from_str(words[j]);
+            xtr_view_t va;
+            xtr_view_t vb;
+            mismatches += !xtr_view(&va, a);
+            mismatches += !xtr_view(&vb, b);
+            mismatches += xtr_view_cmp(va, vb) != xtr_cmp(a, b);
+            mismatches += xtr_view_is_equal(va, vb) != xtr_is_equal(a, b);
+            mismatches += xtr_view_startswith(va, vb) != xtr_startswith(a, b);
+            mismatches += xtr_view_endswith(va, vb) != xtr_endswith(a, b);
+            mismatches += xtr_view_find(va, vb) != xtr_find(a, b);
+            mismatches += xtr_view_rfind(va, vb) != xtr_rfind(a, b);
+            mismatches += xtr_view_contains(va, vb) != xtr_contains(a, b);
+            xtr_free(&a);
+            xtr_free(&b);
+        }
+    }
+    atto_eq(mismatches, 0);
+}
+
+void
+xtrtest_view_valid_find(void)
+{
+    // Searches limited to the view, not seeing the bytes around it
+    xtr_view_t text;
+    xtr_view_t needle;
+    xtr_view_t a;
+    xtr_view_t empty;
+    xtr_view_from_str(&text, "needle in a haystack with a needle");
+    xtr_view_from_str(&needle, "needle");
+    xtr_view_from_str(&a, "a");
+    xtr_view_from_str(&empty, "");
+    xtr_view_t inner;
+    xtr_view_sub(&inner, text, 1U, 32U);
+    atto_eq(xtr_view_find(text, needle), 0);
+    atto_eq(xtr_view_rfind(text, needle), 28);
+    atto_eq(xtr_view_find(inner, needle), XTR_NOT_FOUND);
+    atto_eq(xtr_view_rfind(inner, needle), XTR_NOT_FOUND);
+    atto_false(xtr_view_contains(inner, needle));
+    atto_eq(xtr_view_find(inner, a), 9);
+    atto_eq(xtr_view_rfind(inner, a), 25);
+    atto_eq(xtr_view_find(text, empty), XTR_NOT_FOUND);
+    atto_eq(xtr_view_find(needle, text), XTR_NOT_FOUND);
+}
+
+void
+xtrtest_view_valid_classifiers(void)
+{
+    xtr_view_t text;
+    xtr_view_from_str(&text, "ABC def 123 \t\n");
+    atto_true(section_is(xtr_view_is_upper, text, 0U, 3U));
+    atto_false(section_is(xtr_view_is_upper, text, 0U, 4U));
+    atto_true(section_is(xtr_view_is_lower, text, 4U, 3U));
+    atto_true(section_is(xtr_view_is_alpha, text, 4U, 3U));
+    atto_false(section_is(xtr_view_is_alpha, text, 4U, 4U));
+    atto_true(section_is(xtr_view_is_digits, text, 8U, 3U));
+    atto_true(section_is(xtr_view_is_alphanum, text, 6U, 1U));
+    atto_true(section_is(xtr_view_is_alphanum, text, 8U, 3U));
+    atto_true(section_is(xtr_view_is_spaces, text, 11U, 3U));
+    atto_false(section_is(xtr_view_is_printable, text, 11U, 3U));
+    atto_true(section_is(xtr_view_is_printable, text, 0U, 11U));
+    atto_false(section_is(xtr_view_is_digits, text, 8U, 0U));
+    atto_true(section_is(xtr_view_is_empty, text, 8U, 0U));
+    const uint8_t zeros[] = {0, 0, 0, 1};
+    xtr_view_t view;
+    xtr_view_from_bytes(&view, zeros, 3U);
+    atto_true(xtr_view_is_zeros(view));
+    xtr_view_from_bytes(&view, zeros, 4U);
+    atto_false(xtr_view_is_zeros(view));
+}
+
+void
+xtrtest_view_valid_encoding(void)
+{
+    const uint8_t bytes[] = {0x0D, 0x01, 0x82, 'M', 'a', 'n'};
+    xtr_view_t view;
+    xtr_view_from_bytes(&view, bytes, 3U);
+    xtr_t* hex = xtr_view_to_hex(view, true, " ");
+    atto_streq(xtr_cstring(hex), "0D 01 82 ", 10);
+    xtr_free(&hex);
+    hex = xtr_view_to_hex(view, false, NULL);
+    atto_streq(xtr_cstring(hex), "0d0182", 7);
+    xtr_free(&hex);
+    const char* const expected[] = {"", "TQ==", "TWE=", "TWFu"};
+    for (size_t len = 0U; len <= 3U; len++)
+    {
+        xtr_view_from_bytes(&view, &bytes[3], len);
+        xtr_t* b64 = xtr_view_base64_encode(view);
+        atto_neq(b64, NULL);
+        atto_eq(xtr_length(b64), strlen(expected[len]));
+        atto_streq(xtr_cstring(b64), expected[len], strlen(expected[len]) + 1U);
+        xtr_free(&b64);
+    }
+    // Same as encoding the xtring
+    xtr_t* xtr = xtr_from_bytes(bytes, sizeof(bytes));
+    xtr_t* from_xtr = xtr_base64_encode(xtr);
+    xtr_view(&view, xtr);
+    xtr_t* from_view = xtr_view_base64_encode(view);
+    atto_true(xtr_is_equal(from_xtr, from_view));
+    atto_streq(xtr_cstring(from_view), "DQGCTWFu", 9);
+    xtr_free(&from_xtr);
+    xtr_free(&from_view);
+    xtr_free(&xtr);
+}
+
+void
+xtrtest_view_fail_malloc(void)
+{
+    xtr_view_t view;
+    xtr_view_from_str(&view, "abc");
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_from_view(view), NULL);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_view_to_hex(view, false, NULL), NULL);
+    xtrtest_malloc_fail_after(0);
+    atto_eq(xtr_view_base64_encode(view), NULL);
+    xtrtest_malloc_disable_failing();
+}